@@ -614,7 +614,7 @@ void ClassDB::get_method_list(StringName p_class, List<MethodInfo> *p_methods, b
 	}
 }
 
-MethodBind *ClassDB::get_method(StringName p_class, StringName p_name) {
+MethodBind *ClassDB::get_method(const StringName &p_class, const StringName &p_name) {
 	OBJTYPE_RLOCK;
 
 	ClassInfo *type = classes.getptr(p_class);
@@ -628,6 +628,15 @@ MethodBind *ClassDB::get_method(StringName p_class, StringName p_name) {
 	return NULL;
 }
 
+MethodBind *ClassDB::get_method(const StringName &p_class, const Utf8Range &p_name) {
+	// Bound methods keep their names interned, so a name that is not interned is not a method.
+	StringName name = StringName::search(p_name);
+	if (!name) {
+		return NULL;
+	}
+	return get_method(p_class, name);
+}
+
 void ClassDB::bind_integer_constant(const StringName &p_class, const StringName &p_enum, const StringName &p_name, int p_constant) {
 	OBJTYPE_WLOCK;
 
@@ -1090,6 +1099,25 @@ StringName ClassDB::get_property_getter(StringName p_class, const StringName &p_
 	return StringName();
 }
 
+MethodBind *ClassDB::get_property_getter_bind(const StringName &p_class, const StringName &p_property) {
+	ClassInfo *type = classes.getptr(p_class);
+	ClassInfo *check = type;
+	while (check) {
+		const PropertySetGet *psg = check->property_setget.getptr(p_property);
+		if (psg) {
+			return psg->index < 0 ? psg->_getptr : NULL;
+		}
+
+		if (check->constant_map.has(p_property)) {
+			return NULL;
+		}
+
+		check = check->inherits_ptr;
+	}
+
+	return NULL;
+}
+
 bool ClassDB::has_property(const StringName &p_class, const StringName &p_property, bool p_no_inheritance) {
 	ClassInfo *type = classes.getptr(p_class);
 	ClassInfo *check = type;
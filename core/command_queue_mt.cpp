@@ -33,6 +33,26 @@
 #include "core/os/os.h"
 #include "core/project_settings.h"
 
+thread_local CommandQueueMT::ThreadStagings CommandQueueMT::thread_stagings;
+SafeNumeric<uint32_t> CommandQueueMT::last_queue_id;
+
+CommandQueueMT::ThreadStagings::ThreadStagings() {
+	for (int i = 0; i < THREAD_STAGING_SLOTS; i++) {
+		queue_ids[i] = 0;
+		stagings[i] = NULL;
+	}
+}
+
+CommandQueueMT::ThreadStagings::~ThreadStagings() {
+	// Whatever is still staged gets committed by the next sync, the queue keeps the buffer.
+	for (int i = 0; i < THREAD_STAGING_SLOTS; i++) {
+		if (stagings[i] && stagings[i]->refcount.unref()) {
+			memfree(stagings[i]->mem);
+			memdelete(stagings[i]);
+		}
+	}
+}
+
 void CommandQueueMT::lock() {
 	mutex.lock();
 }
@@ -70,6 +90,197 @@ CommandQueueMT::SyncSemaphore *CommandQueueMT::_alloc_sync_sem() {
 	return &sync_sems[idx];
 }
 
+void CommandQueueMT::_wait_sync_sem(SyncSemaphore *p_sem) {
+	uint64_t from = OS::get_singleton()->get_ticks_usec();
+	p_sem->sem.wait();
+	p_sem->in_use = false;
+	stat_stall_usec.add(OS::get_singleton()->get_ticks_usec() - from);
+}
+
+void CommandQueueMT::_update_depth(uint32_t p_added) {
+	uint32_t depth = stat_depth.add(p_added);
+	if (depth > stat_max_depth) {
+		stat_max_depth = depth; // only written under the queue lock
+	}
+}
+
+CommandQueueMT::Staging *CommandQueueMT::_get_thread_staging() {
+	// The main thread keeps pushing directly, so the consumer can start on its commands right away.
+	// Its pushes commit the stagings first, a worker may have staged commands before signaling it.
+	if (Thread::get_caller_id() == Thread::get_main_id()) {
+		return NULL;
+	}
+
+	ThreadStagings &ts = thread_stagings;
+	int free_slot = -1;
+	for (int i = 0; i < THREAD_STAGING_SLOTS; i++) {
+		if (ts.queue_ids[i] == queue_id) {
+			return ts.stagings[i];
+		}
+		if (free_slot == -1 && ts.queue_ids[i] == 0) {
+			free_slot = i;
+		}
+	}
+	if (free_slot == -1) {
+		return NULL;
+	}
+
+	Staging *staging = NULL;
+	lock();
+	for (uint32_t i = 0; i < staging_count; i++) {
+		// Left behind by a thread that exited.
+		if (stagings[i]->refcount.get() == 1) {
+			staging = stagings[i];
+			break;
+		}
+	}
+	if (!staging && staging_count < MAX_STAGINGS) {
+		staging = memnew(Staging);
+		staging->refcount.init();
+		staging->mem = (uint8_t *)memalloc(STAGING_SIZE);
+		staging->used = 0;
+		staging->commands = 0;
+		stagings[staging_count++] = staging;
+	}
+	if (staging) {
+		staging->refcount.ref();
+	}
+	unlock();
+
+	if (!staging) {
+		return NULL;
+	}
+
+	ts.queue_ids[free_slot] = queue_id;
+	ts.stagings[free_slot] = staging;
+	return staging;
+}
+
+void CommandQueueMT::_post_committed(uint32_t p_count) {
+	if (!sync) {
+		return;
+	}
+	for (uint32_t i = 0; i < p_count; i++) {
+		sync->post();
+	}
+}
+
+void CommandQueueMT::_lock_stagings(uint32_t *r_reads, uint32_t *r_committed) {
+	for (uint32_t i = 0; i < staging_count; i++) {
+		stagings[i]->lock.lock();
+		r_reads[i] = 0;
+		r_committed[i] = 0;
+	}
+}
+
+void CommandQueueMT::_commit_stagings(bool p_consumer) {
+	// Called with the queue locked, the stagings are always locked after the queue.
+	uint32_t reads[MAX_STAGINGS];
+	uint32_t committed[MAX_STAGINGS];
+	uint32_t total = 0;
+	_lock_stagings(reads, committed);
+
+	while (true) {
+		// Merge by sequence number, the oldest staged command goes first.
+		int next = -1;
+		uint32_t next_sequence = 0;
+		for (uint32_t i = 0; i < staging_count; i++) {
+			if (reads[i] < stagings[i]->used) {
+				uint32_t sequence = *(uint32_t *)&stagings[i]->mem[reads[i] + 4];
+				if (next == -1 || int32_t(sequence - next_sequence) < 0) {
+					next = i;
+					next_sequence = sequence;
+				}
+			}
+		}
+		if (next == -1) {
+			break;
+		}
+
+		Staging *staging = stagings[next];
+		uint32_t size = *(uint32_t *)&staging->mem[reads[next]];
+		uint8_t *dst = allocate_raw(size);
+
+		if (!dst) {
+			if (p_consumer) {
+				// Nobody else will make room, run what is already in the ring.
+				if (!flush_one(false)) {
+					break; // command too big for the ring, already reported
+				}
+				continue;
+			}
+
+			// Drop the committed parts and let go of every lock while the consumer catches up.
+			for (uint32_t i = 0; i < staging_count; i++) {
+				Staging *s = stagings[i];
+				memmove(s->mem, &s->mem[reads[i]], s->used - reads[i]);
+				s->used -= reads[i];
+				s->commands -= committed[i];
+				staged_commands.sub(committed[i]);
+				s->lock.unlock();
+			}
+			_post_committed(total);
+			total = 0;
+
+			unlock();
+			uint64_t from = OS::get_singleton()->get_ticks_usec();
+			wait_for_flush();
+			stat_stall_usec.add(OS::get_singleton()->get_ticks_usec() - from);
+			lock();
+			_lock_stagings(reads, committed);
+			continue;
+		}
+
+		// Commands are relocatable, the same assumption the ring makes when it wraps.
+		memcpy(dst, &staging->mem[reads[next] + 8], size);
+		reads[next] += size + 8;
+		committed[next]++;
+		total++;
+	}
+
+	for (uint32_t i = 0; i < staging_count; i++) {
+		Staging *s = stagings[i];
+		s->used = 0;
+		staged_commands.sub(s->commands);
+		s->commands = 0;
+		s->lock.unlock();
+	}
+	_post_committed(total);
+}
+
+void CommandQueueMT::commit_stagings() {
+	lock();
+	_commit_stagings(false);
+	unlock();
+}
+
+void CommandQueueMT::flush_thread_staging() {
+	Staging *staging = _get_thread_staging();
+	if (!staging) {
+		return;
+	}
+	lock();
+	_commit_stagings(false);
+	unlock();
+}
+
+CommandQueueMT::Stats CommandQueueMT::get_stats() {
+	Stats stats;
+	lock();
+	stats.commands = stat_commands.get();
+	stats.depth = stat_depth.get();
+	stats.max_depth = stat_max_depth;
+	stats.staged = 0;
+	for (uint32_t i = 0; i < staging_count; i++) {
+		stagings[i]->lock.lock();
+		stats.staged += stagings[i]->commands;
+		stagings[i]->lock.unlock();
+	}
+	stats.stall_usec = stat_stall_usec.get();
+	unlock();
+	return stats;
+}
+
 bool CommandQueueMT::dealloc_one() {
 tryagain:
 	if (dealloc_ptr == (write_ptr_and_epoch >> 1)) {
@@ -107,6 +318,16 @@ CommandQueueMT::CommandQueueMT(bool p_sync) {
 	for (int i = 0; i < SYNC_SEMAPHORES; i++) {
 		sync_sems[i].in_use = false;
 	}
+
+	queue_id = last_queue_id.increment();
+	staging_count = 0;
+	staged_commands.set(0);
+	staged_sequence.set(0);
+	stat_commands.set(0);
+	stat_depth.set(0);
+	stat_max_depth = 0;
+	stat_stall_usec.set(0);
+
 	if (p_sync) {
 		sync = memnew(Semaphore);
 	} else {
@@ -115,6 +336,13 @@ CommandQueueMT::CommandQueueMT(bool p_sync) {
 }
 
 CommandQueueMT::~CommandQueueMT() {
+	for (uint32_t i = 0; i < staging_count; i++) {
+		if (stagings[i]->refcount.unref()) {
+			memfree(stagings[i]->mem);
+			memdelete(stagings[i]);
+		}
+	}
+
 	if (sync)
 		memdelete(sync);
 	memfree(command_mem);
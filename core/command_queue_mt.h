@@ -34,6 +34,8 @@
 #include "core/os/memory.h"
 #include "core/os/mutex.h"
 #include "core/os/semaphore.h"
+#include "core/os/thread.h"
+#include "core/safe_refcount.h"
 #include "core/simple_type.h"
 #include "core/typedefs.h"
 
@@ -225,16 +227,21 @@
 #define CMD_TYPE(N) Command##N<T, M COMMA(N) COMMA_SEP_LIST(TYPE_ARG, N)>
 #define CMD_ASSIGN_PARAM(N) cmd->p##N = p##N
 
-#define DECL_PUSH(N)                                                         \
-	template <class T, class M COMMA(N) COMMA_SEP_LIST(TYPE_PARAM, N)>       \
-	void push(T *p_instance, M p_method COMMA(N) COMMA_SEP_LIST(PARAM, N)) { \
-		CMD_TYPE(N) *cmd = allocate_and_lock<CMD_TYPE(N)>();                 \
-		cmd->instance = p_instance;                                          \
-		cmd->method = p_method;                                              \
-		SEMIC_SEP_LIST(CMD_ASSIGN_PARAM, N);                                 \
-		unlock();                                                            \
-		if (sync)                                                            \
-			sync->post();                                                    \
+#define DECL_PUSH(N)                                                                                               \
+	template <class T, class M COMMA(N) COMMA_SEP_LIST(TYPE_PARAM, N)>                                             \
+	void push(T *p_instance, M p_method COMMA(N) COMMA_SEP_LIST(PARAM, N)) {                                       \
+		Staging *staging = sizeof(CMD_TYPE(N)) + 8 <= STAGING_SIZE ? _get_thread_staging() : NULL;                 \
+		CMD_TYPE(N) *cmd = staging ? allocate_staged<CMD_TYPE(N)>(staging) : allocate_and_lock<CMD_TYPE(N)>(true); \
+		cmd->instance = p_instance;                                                                                \
+		cmd->method = p_method;                                                                                    \
+		SEMIC_SEP_LIST(CMD_ASSIGN_PARAM, N);                                                                       \
+		if (staging) {                                                                                             \
+			staging->lock.unlock();                                                                                \
+		} else {                                                                                                   \
+			unlock();                                                                                              \
+			if (sync)                                                                                              \
+				sync->post();                                                                                      \
+		}                                                                                                          \
 	}
 
 #define CMD_RET_TYPE(N) CommandRet##N<T, M, COMMA_SEP_LIST(TYPE_ARG, N) COMMA(N) R>
@@ -243,7 +250,7 @@
 	template <class T, class M, COMMA_SEP_LIST(TYPE_PARAM, N) COMMA(N) class R>                \
 	void push_and_ret(T *p_instance, M p_method, COMMA_SEP_LIST(PARAM, N) COMMA(N) R *r_ret) { \
 		SyncSemaphore *ss = _alloc_sync_sem();                                                 \
-		CMD_RET_TYPE(N) *cmd = allocate_and_lock<CMD_RET_TYPE(N)>();                           \
+		CMD_RET_TYPE(N) *cmd = allocate_and_lock<CMD_RET_TYPE(N)>(true);                       \
 		cmd->instance = p_instance;                                                            \
 		cmd->method = p_method;                                                                \
 		SEMIC_SEP_LIST(CMD_ASSIGN_PARAM, N);                                                   \
@@ -252,8 +259,7 @@
 		unlock();                                                                              \
 		if (sync)                                                                              \
 			sync->post();                                                                      \
-		ss->sem.wait();                                                                        \
-		ss->in_use = false;                                                                    \
+		_wait_sync_sem(ss);                                                                    \
 	}
 
 #define CMD_SYNC_TYPE(N) CommandSync##N<T, M COMMA(N) COMMA_SEP_LIST(TYPE_ARG, N)>
@@ -262,7 +268,7 @@
 	template <class T, class M COMMA(N) COMMA_SEP_LIST(TYPE_PARAM, N)>                \
 	void push_and_sync(T *p_instance, M p_method COMMA(N) COMMA_SEP_LIST(PARAM, N)) { \
 		SyncSemaphore *ss = _alloc_sync_sem();                                        \
-		CMD_SYNC_TYPE(N) *cmd = allocate_and_lock<CMD_SYNC_TYPE(N)>();                \
+		CMD_SYNC_TYPE(N) *cmd = allocate_and_lock<CMD_SYNC_TYPE(N)>(true);            \
 		cmd->instance = p_instance;                                                   \
 		cmd->method = p_method;                                                       \
 		SEMIC_SEP_LIST(CMD_ASSIGN_PARAM, N);                                          \
@@ -270,8 +276,7 @@
 		unlock();                                                                     \
 		if (sync)                                                                     \
 			sync->post();                                                             \
-		ss->sem.wait();                                                               \
-		ss->in_use = false;                                                           \
+		_wait_sync_sem(ss);                                                           \
 	}
 
 #define MAX_CMD_PARAMS 13
@@ -311,9 +316,36 @@ class CommandQueueMT {
 
 	enum {
 		DEFAULT_COMMAND_MEM_SIZE_KB = 256,
-		SYNC_SEMAPHORES = 8
+		SYNC_SEMAPHORES = 8,
+		STAGING_SIZE = 16 * 1024,
+		MAX_STAGINGS = 64,
+		THREAD_STAGING_SLOTS = 4
 	};
 
+	// Commands pushed from worker threads are laid out like in the ring, in a buffer owned by the
+	// thread, and copied into the ring in batches. Each one is stamped with a sequence number in
+	// the spare header bytes, and every commit merges all stagings by it, so commands from different
+	// threads reach the ring in the order they were staged. Anything that waits on the consumer
+	// commits the stagings first, so commands never overtake a sync point they were pushed before.
+	struct Staging {
+		SafeRefCount refcount; // held by the queue and by the thread using it
+		Mutex lock;
+		uint8_t *mem;
+		uint32_t used;
+		uint32_t commands;
+	};
+
+	struct ThreadStagings {
+		uint32_t queue_ids[THREAD_STAGING_SLOTS];
+		Staging *stagings[THREAD_STAGING_SLOTS];
+
+		ThreadStagings();
+		~ThreadStagings();
+	};
+
+	static thread_local ThreadStagings thread_stagings;
+	static SafeNumeric<uint32_t> last_queue_id;
+
 	uint8_t *command_mem;
 	uint32_t read_ptr_and_epoch;
 	uint32_t write_ptr_and_epoch;
@@ -323,10 +355,20 @@ class CommandQueueMT {
 	Mutex mutex;
 	Semaphore *sync;
 
-	template <class T>
-	T *allocate() {
+	uint32_t queue_id;
+	Staging *stagings[MAX_STAGINGS];
+	uint32_t staging_count;
+	SafeNumeric<uint32_t> staged_commands; // lets direct pushes skip the commit when nothing is staged
+	SafeNumeric<uint32_t> staged_sequence;
+
+	SafeNumeric<uint64_t> stat_commands;
+	SafeNumeric<uint32_t> stat_depth;
+	uint32_t stat_max_depth;
+	SafeNumeric<uint64_t> stat_stall_usec;
+
+	uint8_t *allocate_raw(uint32_t p_size) {
 		// alloc size is size+T+safeguard
-		uint32_t alloc_size = ((sizeof(T) + 8 - 1) & ~(8 - 1)) + 8;
+		uint32_t alloc_size = ((p_size + 8 - 1) & ~(8 - 1)) + 8;
 
 		// Assert that the buffer is big enough to hold at least two messages.
 		ERR_FAIL_COND_V(alloc_size * 2 + sizeof(uint32_t) > command_mem_size, NULL);
@@ -376,22 +418,35 @@ class CommandQueueMT {
 		// Allocate the size and the 'in use' bit.
 		// First bit used to mark if command is still in use (1)
 		// or if it has been destroyed and can be deallocated (0).
-		uint32_t size = (sizeof(T) + 8 - 1) & ~(8 - 1);
+		uint32_t size = (p_size + 8 - 1) & ~(8 - 1);
 		uint32_t *p = (uint32_t *)&command_mem[write_ptr];
 		*p = (size << 1) | 1;
 		write_ptr += 8;
-		// allocate the command
-		T *cmd = memnew_placement(&command_mem[write_ptr], T);
+		uint8_t *cmd = &command_mem[write_ptr];
 		write_ptr += size;
 		write_ptr_and_epoch = (write_ptr << 1) | (write_ptr_and_epoch & 1);
+		_update_depth(1);
 		return cmd;
 	}
 
 	template <class T>
-	T *allocate_and_lock() {
+	T *allocate() {
+		uint8_t *mem = allocate_raw(sizeof(T));
+		if (!mem) {
+			return NULL;
+		}
+		return memnew_placement(mem, T);
+	}
+
+	template <class T>
+	T *allocate_and_lock(bool p_commit_stagings = false) {
 		lock();
-		T *ret;
+		if (p_commit_stagings && staged_commands.get()) {
+			_commit_stagings(false);
+		}
+		stat_commands.increment();
 
+		T *ret;
 		while ((ret = allocate<T>()) == NULL) {
 			unlock();
 			// sleep a little until fetch happened and some room is made
@@ -402,6 +457,31 @@ class CommandQueueMT {
 		return ret;
 	}
 
+	// Returns with the staging locked, the caller unlocks it once the command is filled.
+	template <class T>
+	T *allocate_staged(Staging *p_staging) {
+		uint32_t size = (sizeof(T) + 8 - 1) & ~(8 - 1);
+		stat_commands.increment();
+
+		p_staging->lock.lock();
+		while (p_staging->used + size + 8 > STAGING_SIZE) {
+			p_staging->lock.unlock();
+			lock();
+			_commit_stagings(false);
+			unlock();
+			p_staging->lock.lock();
+		}
+
+		// Taken with the staging locked, a commit holding it sees every command with a lower number.
+		*(uint32_t *)&p_staging->mem[p_staging->used] = size;
+		*(uint32_t *)&p_staging->mem[p_staging->used + 4] = staged_sequence.increment();
+		T *cmd = memnew_placement(&p_staging->mem[p_staging->used + 8], T);
+		p_staging->used += size + 8;
+		p_staging->commands++;
+		staged_commands.increment();
+		return cmd;
+	}
+
 	bool flush_one(bool p_lock = true) {
 		if (p_lock)
 			lock();
@@ -442,6 +522,7 @@ class CommandQueueMT {
 		cmd->post();
 		cmd->~CommandBase();
 		*(uint32_t *)&command_mem[size_ptr] &= ~1;
+		stat_depth.decrement();
 
 		if (p_lock)
 			unlock();
@@ -452,8 +533,15 @@ class CommandQueueMT {
 	void unlock();
 	void wait_for_flush();
 	SyncSemaphore *_alloc_sync_sem();
+	void _wait_sync_sem(SyncSemaphore *p_sem);
 	bool dealloc_one();
 
+	Staging *_get_thread_staging();
+	void _lock_stagings(uint32_t *r_reads, uint32_t *r_committed);
+	void _commit_stagings(bool p_consumer);
+	void _post_committed(uint32_t p_count);
+	void _update_depth(uint32_t p_added);
+
 public:
 	/* NORMAL PUSH COMMANDS */
 	DECL_PUSH(0)
@@ -476,11 +564,27 @@ public:
 	void flush_all() {
 		//ERR_FAIL_COND(sync);
 		lock();
+		_commit_stagings(true);
 		while (flush_one(false))
 			;
 		unlock();
 	}
 
+	// Commits the calling thread's staged commands to the ring, along with everything staged before them.
+	void flush_thread_staging();
+	// Commits the commands staged by every thread, for points the consumer must see them by.
+	void commit_stagings();
+
+	struct Stats {
+		uint64_t commands; // pushed since creation
+		uint32_t depth; // in the ring, waiting for the consumer
+		uint32_t max_depth;
+		uint32_t staged; // still in thread stagings
+		uint64_t stall_usec; // producers blocked on a full ring or on a result
+	};
+
+	Stats get_stats();
+
 	CommandQueueMT(bool p_sync);
 	~CommandQueueMT();
 };
@@ -0,0 +1,265 @@
+/*************************************************************************/
+/*  frame_allocator.cpp                                                  */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-present Godot Engine contributors (cf. AUTHORS.md).*/
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+
+#include "frame_allocator.h"
+
+#include "core/os/copymem.h"
+
+namespace {
+
+enum {
+	BLOCK_SIZE = 64 * 1024,
+	HEADER_SIZE = 16,
+	MAX_RESERVED = 64 * 1024 * 1024,
+};
+
+struct Arena;
+
+struct AllocHeader {
+	Arena *arena; // NULL when the allocation came from the heap.
+	uint32_t size;
+};
+
+static_assert(sizeof(AllocHeader) <= HEADER_SIZE, "Frame allocation header does not fit.");
+
+struct Block {
+	Block *next;
+	size_t size;
+
+	uint8_t *get_data() { return (uint8_t *)this + HEADER_SIZE; }
+};
+
+static_assert(sizeof(Block) <= HEADER_SIZE, "Frame block header does not fit.");
+
+struct Arena {
+	Block *first = nullptr;
+	Block *current = nullptr;
+	uint8_t *top = nullptr;
+	uint8_t *end = nullptr;
+	AllocHeader *last = nullptr;
+	size_t reserved = 0;
+	uint64_t frame = 0;
+	// Live allocations plus one held by the owning thread. Allocations can be freed from other
+	// threads, rewinding is left to the owner, the last free after the thread exited releases the arena.
+	SafeNumeric<uint32_t> refs;
+
+	Arena() :
+			refs(1) {}
+
+	void rewind() {
+		current = first;
+		top = first ? first->get_data() : nullptr;
+		end = first ? first->get_data() + first->size : nullptr;
+		last = nullptr;
+	}
+
+	void release() {
+		while (first) {
+			Block *next = first->next;
+			Memory::free_static(first);
+			first = next;
+		}
+		reserved = 0;
+		rewind();
+	}
+
+	// Keeps a single block large enough for everything the previous frames needed at once.
+	void trim() {
+		if (first && first->next) {
+			size_t size = reserved;
+			release();
+			_add_block(size);
+		}
+		rewind();
+	}
+
+	bool _add_block(size_t p_size) {
+		if (reserved + p_size > MAX_RESERVED) {
+			return false;
+		}
+		Block *block = (Block *)Memory::alloc_static(HEADER_SIZE + p_size);
+		if (!block) {
+			return false;
+		}
+		block->size = p_size;
+		reserved += p_size;
+
+		if (current) {
+			block->next = current->next;
+			current->next = block;
+		} else {
+			block->next = first;
+			first = block;
+		}
+		current = block;
+		top = block->get_data();
+		end = top + p_size;
+		return true;
+	}
+
+	uint8_t *bump(size_t p_bytes) {
+		while (top + p_bytes > end) {
+			if (current && current->next && current->next->size >= p_bytes) {
+				current = current->next;
+				top = current->get_data();
+				end = top + current->size;
+			} else if (!_add_block(MAX(p_bytes, (size_t)BLOCK_SIZE))) {
+				return nullptr;
+			}
+		}
+		uint8_t *mem = top;
+		top += p_bytes;
+		return mem;
+	}
+};
+
+struct ThreadArena {
+	Arena *arena = nullptr;
+
+	~ThreadArena() {
+		if (arena && arena->refs.decrement() == 0) {
+			arena->release();
+			memdelete(arena);
+		}
+		arena = nullptr;
+	}
+};
+
+thread_local ThreadArena thread_arena;
+
+_FORCE_INLINE_ Arena &_get_arena() {
+	if (unlikely(!thread_arena.arena)) {
+		thread_arena.arena = memnew(Arena);
+	}
+	return *thread_arena.arena;
+}
+
+_FORCE_INLINE_ size_t _round_size(size_t p_bytes) {
+	return (p_bytes + HEADER_SIZE - 1) & ~(size_t)(HEADER_SIZE - 1);
+}
+
+_FORCE_INLINE_ AllocHeader *_get_header(void *p_ptr) {
+	return (AllocHeader *)((uint8_t *)p_ptr - HEADER_SIZE);
+}
+
+} // namespace
+
+SafeNumeric<uint64_t> FrameAllocator::frame;
+
+void *FrameAllocator::alloc(size_t p_bytes) {
+	Arena &a = _get_arena();
+
+	if (a.refs.get() == 1) {
+		if (a.frame != frame.get()) {
+			a.frame = frame.get();
+			a.trim();
+		} else {
+			a.rewind();
+		}
+	}
+
+	size_t size = _round_size(p_bytes);
+	AllocHeader *header = (AllocHeader *)a.bump(HEADER_SIZE + size);
+	if (unlikely(!header)) {
+		// Over the arena budget, most likely allocations that are never freed.
+		header = (AllocHeader *)Memory::alloc_static(HEADER_SIZE + size);
+		ERR_FAIL_COND_V(!header, nullptr);
+		header->arena = nullptr;
+		header->size = p_bytes;
+		return (uint8_t *)header + HEADER_SIZE;
+	}
+
+	header->arena = &a;
+	header->size = p_bytes;
+	a.last = header;
+	a.refs.increment();
+	return (uint8_t *)header + HEADER_SIZE;
+}
+
+void *FrameAllocator::realloc(void *p_ptr, size_t p_bytes) {
+	if (!p_ptr) {
+		return alloc(p_bytes);
+	}
+	if (p_bytes == 0) {
+		free(p_ptr);
+		return nullptr;
+	}
+
+	AllocHeader *header = _get_header(p_ptr);
+	Arena &a = _get_arena();
+
+	if (header->arena == &a && header == a.last) {
+		// Most recent allocation of this thread, grow or shrink in place.
+		uint8_t *new_top = (uint8_t *)p_ptr + _round_size(p_bytes);
+		if (new_top <= a.end) {
+			a.top = new_top;
+			header->size = p_bytes;
+			return p_ptr;
+		}
+	}
+
+	void *mem = alloc(p_bytes);
+	ERR_FAIL_COND_V(!mem, nullptr);
+	copymem(mem, p_ptr, MIN((size_t)header->size, p_bytes));
+	free(p_ptr);
+	return mem;
+}
+
+void FrameAllocator::free(void *p_ptr) {
+	ERR_FAIL_COND(!p_ptr);
+
+	AllocHeader *header = _get_header(p_ptr);
+	Arena *owner = header->arena;
+
+	if (!owner) {
+		Memory::free_static(header);
+		return;
+	}
+
+	if (owner != thread_arena.arena) {
+		if (owner->refs.decrement() == 0) {
+			// Last allocation of an arena whose thread already exited.
+			owner->release();
+			memdelete(owner);
+		}
+		return;
+	}
+
+	if (header == owner->last) {
+		owner->top = (uint8_t *)header;
+		owner->last = nullptr;
+	}
+	if (owner->refs.decrement() == 1) {
+		owner->rewind();
+	}
+}
+
+void FrameAllocator::next_frame() {
+	frame.increment();
+}
@@ -0,0 +1,60 @@
+/*************************************************************************/
+/*  frame_allocator.h                                                    */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-present Godot Engine contributors (cf. AUTHORS.md).*/
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+
+#ifndef FRAME_ALLOCATOR_H
+#define FRAME_ALLOCATOR_H
+
+#include "core/list.h"
+#include "core/local_vector.h"
+#include "core/os/memory.h"
+#include "core/safe_refcount.h"
+
+// Bump allocator for temporaries that do not outlive the current frame.
+// Each thread allocates from its own blocks, which are rewound as soon as every allocation
+// made from them is freed. Main::iteration advances the frame, after which blocks are trimmed.
+
+class FrameAllocator {
+	static SafeNumeric<uint64_t> frame;
+
+public:
+	static void *alloc(size_t p_bytes);
+	static void *realloc(void *p_ptr, size_t p_bytes);
+	static void free(void *p_ptr);
+
+	static void next_frame();
+	static uint64_t get_frame() { return frame.get(); }
+};
+
+template <class T>
+using FrameVector = LocalVector<T, uint32_t, false, FrameAllocator>;
+
+template <class T>
+using FrameList = List<T, FrameAllocator>;
+
+#endif // FRAME_ALLOCATOR_H
@@ -37,7 +37,7 @@
 #include "core/sort_array.h"
 #include "core/vector.h"
 
-template <class T, class U = uint32_t, bool force_trivial = false>
+template <class T, class U = uint32_t, bool force_trivial = false, class A = DefaultAllocator>
 class LocalVector {
 private:
 	U count = 0;
@@ -60,7 +60,7 @@ public:
 			} else {
 				capacity <<= 1;
 			}
-			data = (T *)memrealloc(data, capacity * sizeof(T));
+			data = (T *)A::realloc(data, capacity * sizeof(T));
 			CRASH_COND_MSG(!data, "Out of memory");
 		}
 
@@ -112,7 +112,7 @@ public:
 	_FORCE_INLINE_ void reset() {
 		clear();
 		if (data) {
-			memfree(data);
+			A::free(data);
 			data = nullptr;
 			capacity = 0;
 		}
@@ -122,7 +122,7 @@ public:
 		p_size = nearest_power_of_2_templated(p_size);
 		if (p_size > capacity) {
 			capacity = p_size;
-			data = (T *)memrealloc(data, capacity * sizeof(T));
+			data = (T *)A::realloc(data, capacity * sizeof(T));
 			CRASH_COND_MSG(!data, "Out of memory");
 		}
 	}
@@ -144,7 +144,7 @@ public:
 				while (capacity < p_size) {
 					capacity <<= 1;
 				}
-				data = (T *)memrealloc(data, capacity * sizeof(T));
+				data = (T *)A::realloc(data, capacity * sizeof(T));
 				CRASH_COND_MSG(!data, "Out of memory");
 			}
 			if (!std::is_trivially_constructible<T>::value && !force_trivial) {
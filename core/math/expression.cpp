@@ -2085,7 +2085,7 @@ bool Expression::_execute(const Array &p_inputs, Object *p_instance, Expression:
 			}
 
 			Variant::CallError ce;
-			r_ret = base.call(call->method, (const Variant **)argp.ptr(), argp.size(), ce);
+			base.call_cached(call->method, call->call_cache, (const Variant **)argp.ptr(), argp.size(), &r_ret, ce);
 
 			if (ce.error != Variant::CallError::CALL_OK) {
 				r_error_str = vformat(RTR("On call to '%s':"), String(call->method));
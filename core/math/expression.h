@@ -296,6 +296,7 @@ private:
 		ENode *base;
 		StringName method;
 		Vector<ENode *> arguments;
+		mutable Variant::CallSiteCache call_cache;
 
 		CallNode() {
 			type = TYPE_CALL;
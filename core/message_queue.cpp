@@ -30,13 +30,30 @@
 
 #include "message_queue.h"
 
+#include "core/local_vector.h"
 #include "core/project_settings.h"
 #include "core/script_language.h"
 
 MessageQueue *MessageQueue::singleton = NULL;
+thread_local MessageQueue *MessageQueue::thread_capture = NULL;
 
 MessageQueue *MessageQueue::get_singleton() {
-	return singleton;
+	return thread_capture ? thread_capture : singleton;
+}
+
+void MessageQueue::set_thread_capture(MessageQueue *p_queue) {
+	ERR_FAIL_COND(p_queue && !p_queue->capture);
+	thread_capture = p_queue;
+}
+
+void MessageQueue::_grow(uint32_t p_room_needed) {
+	uint32_t new_size = buffer_size;
+	while (buffer_end + p_room_needed >= new_size) {
+		new_size <<= 1;
+	}
+	// Messages and variants are relocatable, same as in the engine containers.
+	buffer = (uint8_t *)memrealloc(buffer, new_size);
+	buffer_size = new_size;
 }
 
 Error MessageQueue::push_call(ObjectID p_id, const StringName &p_method, const Variant **p_args, int p_argcount, bool p_show_error) {
@@ -44,6 +61,10 @@ Error MessageQueue::push_call(ObjectID p_id, const StringName &p_method, const V
 
 	int room_needed = sizeof(Message) + sizeof(Variant) * p_argcount;
 
+	if (capture && (buffer_end + room_needed) >= buffer_size) {
+		_grow(room_needed);
+	}
+
 	if ((buffer_end + room_needed) >= buffer_size) {
 		String type;
 		if (ObjectDB::get_instance(p_id))
@@ -91,6 +112,10 @@ Error MessageQueue::push_set(ObjectID p_id, const StringName &p_prop, const Vari
 
 	uint8_t room_needed = sizeof(Message) + sizeof(Variant);
 
+	if (capture && (buffer_end + room_needed) >= buffer_size) {
+		_grow(room_needed);
+	}
+
 	if ((buffer_end + room_needed) >= buffer_size) {
 		String type;
 		if (ObjectDB::get_instance(p_id))
@@ -122,6 +147,10 @@ Error MessageQueue::push_notification(ObjectID p_id, int p_notification) {
 
 	uint8_t room_needed = sizeof(Message);
 
+	if (capture && (buffer_end + room_needed) >= buffer_size) {
+		_grow(room_needed);
+	}
+
 	if ((buffer_end + room_needed) >= buffer_size) {
 		print_line("Failed notification: " + itos(p_notification) + " target ID: " + itos(p_id));
 		statistics();
@@ -151,6 +180,46 @@ Error MessageQueue::push_set(Object *p_object, const StringName &p_prop, const V
 	return push_set(p_object->get_instance_id(), p_prop, p_value);
 }
 
+void MessageQueue::transfer_to(MessageQueue *p_queue) {
+	ERR_FAIL_COND(p_queue == this);
+
+	// Reused for every call, alloca in the loop would keep growing the stack.
+	LocalVector<const Variant *> argptrs;
+
+	uint32_t read_pos = 0;
+	while (read_pos < buffer_end) {
+		Message *message = (Message *)&buffer[read_pos];
+		Variant *args = (Variant *)(message + 1);
+
+		read_pos += sizeof(Message);
+		switch (message->type & FLAG_MASK) {
+			case TYPE_CALL: {
+				argptrs.resize(message->args);
+				for (int i = 0; i < message->args; i++) {
+					argptrs[i] = &args[i];
+				}
+				p_queue->push_call(message->instance_id, message->target, message->args ? argptrs.ptr() : NULL, message->args, message->type & FLAG_SHOW_ERROR);
+			} break;
+			case TYPE_NOTIFICATION: {
+				p_queue->push_notification(message->instance_id, message->notification);
+			} break;
+			case TYPE_SET: {
+				p_queue->push_set(message->instance_id, message->target, *args);
+			} break;
+		}
+
+		if ((message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
+			for (int i = 0; i < message->args; i++) {
+				args[i].~Variant();
+			}
+			read_pos += sizeof(Variant) * message->args;
+		}
+		message->~Message();
+	}
+
+	buffer_end = 0;
+}
+
 void MessageQueue::statistics() {
 	Map<StringName, int> set_count;
 	Map<int, int> notify_count;
@@ -314,6 +383,7 @@ MessageQueue::MessageQueue() {
 	ERR_FAIL_COND_MSG(singleton != NULL, "A MessageQueue singleton already exists.");
 	singleton = this;
 	flushing = false;
+	capture = false;
 
 	buffer_end = 0;
 	buffer_max_used = 0;
@@ -323,6 +393,16 @@ MessageQueue::MessageQueue() {
 	buffer = memnew_arr(uint8_t, buffer_size);
 }
 
+MessageQueue::MessageQueue(uint32_t p_capture_size) {
+	flushing = false;
+	capture = true;
+
+	buffer_end = 0;
+	buffer_max_used = 0;
+	buffer_size = MAX(p_capture_size, (uint32_t)sizeof(Message));
+	buffer = (uint8_t *)memalloc(buffer_size);
+}
+
 MessageQueue::~MessageQueue() {
 	uint32_t read_pos = 0;
 
@@ -341,6 +421,11 @@ MessageQueue::~MessageQueue() {
 			read_pos += sizeof(Variant) * message->args;
 	}
 
+	if (capture) {
+		memfree(buffer);
+		return;
+	}
+
 	singleton = NULL;
 	memdelete_arr(buffer);
 }
@@ -68,12 +68,19 @@ class MessageQueue {
 	void _call_function(Object *p_target, const StringName &p_func, const Variant *p_args, int p_argcount, bool p_show_error);
 
 	static MessageQueue *singleton;
+	static thread_local MessageQueue *thread_capture;
 
 	bool flushing;
+	bool capture;
+
+	void _grow(uint32_t p_room_needed);
 
 public:
 	static MessageQueue *get_singleton();
 
+	// Redirects the calling thread's deferred messages into p_queue, NULL restores the global queue.
+	static void set_thread_capture(MessageQueue *p_queue);
+
 	Error push_call(ObjectID p_id, const StringName &p_method, const Variant **p_args, int p_argcount, bool p_show_error = false);
 	Error push_call(ObjectID p_id, const StringName &p_method, VARIANT_ARG_LIST);
 	Error push_notification(ObjectID p_id, int p_notification);
@@ -90,7 +97,10 @@ public:
 
 	int get_max_buffer_usage() const;
 
+	void transfer_to(MessageQueue *p_queue);
+
 	MessageQueue();
+	MessageQueue(uint32_t p_capture_size); // growable capture queue, not the singleton
 	~MessageQueue();
 };
 
@@ -323,37 +323,38 @@ NodePath::NodePath(const String &p_path) {
 	if (p_path.length() == 0)
 		return;
 
-	String path = p_path;
+	// Names are interned straight from ranges of the path, no substrings are built.
+	const char32_t *path = p_path.ptr();
+	int path_len = p_path.length();
 	Vector<StringName> subpath;
 
 	bool absolute = (path[0] == '/');
 	bool last_is_slash = true;
 	bool has_slashes = false;
 	int slices = 0;
-	int subpath_pos = path.find(":");
+	int subpath_pos = p_path.find(":");
 
 	if (subpath_pos != -1) {
 		int from = subpath_pos + 1;
 
-		for (int i = from; i <= path.length(); i++) {
-			if (path[i] == ':' || path[i] == 0) {
-				String str = path.substr(from, i - from);
-				if (str == "") {
-					if (path[i] == 0)
+		for (int i = from; i <= path_len; i++) {
+			if (i == path_len || path[i] == ':') {
+				if (i == from) {
+					if (i == path_len)
 						continue; // Allow end-of-path :
 
 					ERR_FAIL_MSG("Invalid NodePath '" + p_path + "'.");
 				}
-				subpath.push_back(str);
+				subpath.push_back(StringName(StrRange(path + from, i - from)));
 
 				from = i + 1;
 			}
 		}
 
-		path = path.substr(0, subpath_pos);
+		path_len = subpath_pos;
 	}
 
-	for (int i = (int)absolute; i < path.length(); i++) {
+	for (int i = (int)absolute; i < path_len; i++) {
 		if (path[i] == '/') {
 			last_is_slash = true;
 			has_slashes = true;
@@ -382,12 +383,11 @@ NodePath::NodePath(const String &p_path) {
 	int from = (int)absolute;
 	int slice = 0;
 
-	for (int i = (int)absolute; i < path.length() + 1; i++) {
-		if (path[i] == '/' || path[i] == 0) {
+	for (int i = (int)absolute; i < path_len + 1; i++) {
+		if (i == path_len || path[i] == '/') {
 			if (!last_is_slash) {
-				String name = path.substr(from, i - from);
 				ERR_FAIL_INDEX(slice, data->path.size());
-				data->path.write[slice++] = name;
+				data->path.write[slice++] = StringName(StrRange(path + from, i - from));
 			}
 			from = i + 1;
 			last_is_slash = true;
@@ -42,18 +42,6 @@
 
 #ifdef DEBUG_ENABLED
 
-struct _ObjectDebugLock {
-	Object *obj;
-
-	_ObjectDebugLock(Object *p_obj) {
-		obj = p_obj;
-		obj->_lock_index.ref();
-	}
-	~_ObjectDebugLock() {
-		obj->_lock_index.unref();
-	}
-};
-
 #define OBJ_DEBUG_LOCK _ObjectDebugLock _debug_lock(this);
 
 #else
@@ -983,6 +971,7 @@ void Object::set_script(const RefPtr &p_script) {
 		}
 	}
 
+	_script_instance_changed();
 	_change_notify(); //scripts may add variables, so refresh is desired
 	emit_signal(CoreStringNames::get_singleton()->script_changed);
 }
@@ -1000,6 +989,8 @@ void Object::set_script_instance(ScriptInstance *p_instance) {
 		script = p_instance->get_script().get_ref_ptr();
 	else
 		script = RefPtr();
+
+	_script_instance_changed();
 }
 
 RefPtr Object::get_script() const {
@@ -1133,22 +1124,33 @@ Error Object::emit_signal(const StringName &p_name, const Variant **p_args, int
 	List<_ObjectSignalDisconnectData> disconnect_data;
 
 	//copy on write will ensure that disconnecting the signal or even deleting the object will not affect the signal calling.
-	//this happens automatically and will not change the performance of calling.
-	//awesome, isn't it?
-	VMap<Signal::Target, Signal::Slot> slot_map = s->slot_map;
+	//only a reference is taken here, the array is copied if a callback modifies the connections.
+	const Vector<Signal::Dispatch> dispatch = s->dispatch;
+	const Signal::Dispatch *slots = dispatch.ptr();
 
-	int ssize = slot_map.size();
+	int ssize = dispatch.size();
 
 	OBJ_DEBUG_LOCK
 
-	Vector<const Variant *> bind_mem;
+	int max_binds = 0;
+	for (int i = 0; i < ssize; i++) {
+		max_binds = MAX(max_binds, slots[i].binds.size());
+	}
+
+	const Variant **bind_mem = NULL;
+	if (max_binds) {
+		bind_mem = (const Variant **)alloca(sizeof(Variant *) * (p_argcount + max_binds));
+		for (int j = 0; j < p_argcount; j++) {
+			bind_mem[j] = p_args[j];
+		}
+	}
 
 	Error err = OK;
 
 	for (int i = 0; i < ssize; i++) {
-		const Connection &c = slot_map.getv(i).conn;
+		const Signal::Dispatch &c = slots[i];
 
-		Object *target = ObjectDB::get_instance(slot_map.getk(i)._id);
+		Object *target = ObjectDB::get_instance(c._id);
 		if (!target) {
 			// Target might have been deleted during signal callback, this is expected and OK.
 			continue;
@@ -1159,17 +1161,13 @@ Error Object::emit_signal(const StringName &p_name, const Variant **p_args, int
 
 		if (c.binds.size()) {
 			//handle binds
-			bind_mem.resize(p_argcount + c.binds.size());
-
-			for (int j = 0; j < p_argcount; j++) {
-				bind_mem.write[j] = p_args[j];
-			}
+			const Variant *binds = c.binds.ptr();
 			for (int j = 0; j < c.binds.size(); j++) {
-				bind_mem.write[p_argcount + j] = &c.binds[j];
+				bind_mem[p_argcount + j] = &binds[j];
 			}
 
-			args = (const Variant **)bind_mem.ptr();
-			argc = bind_mem.size();
+			args = bind_mem;
+			argc = p_argcount + c.binds.size();
 		}
 
 		if (c.flags & CONNECT_DEFERRED) {
@@ -1177,7 +1175,15 @@ Error Object::emit_signal(const StringName &p_name, const Variant **p_args, int
 		} else {
 			Variant::CallError ce;
 			_emitting = true;
-			target->call(c.method, args, argc, ce);
+			if (c.method_bind && !target->script_instance) {
+				// Native target, skip the method lookup done by call().
+#ifdef DEBUG_ENABLED
+				_ObjectDebugLock target_lock(target);
+#endif
+				c.method_bind->call(target, args, argc, ce);
+			} else {
+				target->call(c.method, args, argc, ce);
+			}
 			_emitting = false;
 
 			if (ce.error != Variant::CallError::CALL_OK) {
@@ -1440,7 +1446,15 @@ Error Object::connect(const StringName &p_signal, Object *p_to_object, const Str
 		slot.reference_count = 1;
 	}
 
-	s->slot_map[target] = slot;
+	Signal::Dispatch dispatch;
+	dispatch._id = target._id;
+	dispatch.method = p_to_method;
+	dispatch.flags = p_flags;
+	dispatch.binds = p_binds;
+	dispatch.method_bind = ClassDB::get_method(p_to_object->get_class_name(), p_to_method);
+
+	int pos = s->slot_map.insert(target, slot);
+	s->dispatch.insert(pos, dispatch);
 
 	return OK;
 }
@@ -1481,9 +1495,10 @@ void Object::_disconnect(const StringName &p_signal, Object *p_to_object, const
 
 	Signal::Target target(p_to_object->get_instance_id(), p_to_method);
 
-	ERR_FAIL_COND_MSG(!s->slot_map.has(target), "Disconnecting nonexistent signal '" + p_signal + "', slot: " + itos(target._id) + ":" + target.method + ".");
+	int pos = s->slot_map.find(target);
+	ERR_FAIL_COND_MSG(pos < 0, "Disconnecting nonexistent signal '" + p_signal + "', slot: " + itos(target._id) + ":" + target.method + ".");
 
-	Signal::Slot *slot = &s->slot_map[target];
+	Signal::Slot *slot = &s->slot_map.getv(pos);
 
 	if (!p_force) {
 		slot->reference_count--; // by default is zero, if it was not referenced it will go below it
@@ -1494,6 +1509,7 @@ void Object::_disconnect(const StringName &p_signal, Object *p_to_object, const
 
 	p_to_object->connections.erase(slot->cE);
 	s->slot_map.erase(target);
+	s->dispatch.remove(pos);
 
 	if (s->slot_map.empty() && ClassDB::has_signal(get_class_name(), p_signal)) {
 		//not user signal, delete
@@ -402,6 +402,7 @@ private:
 
 class ScriptInstance;
 class ObjectRC;
+class MethodBind;
 
 class Object {
 public:
@@ -463,8 +464,25 @@ private:
 			Slot() { reference_count = 0; }
 		};
 
+		// Compact copy of what emission needs, kept in the same order as slot_map.
+		// Emission holds a reference to the array, so connecting or disconnecting
+		// from a callback copies it instead of disturbing the running loop.
+		struct Dispatch {
+			ObjectID _id;
+			StringName method;
+			uint32_t flags;
+			Vector<Variant> binds;
+			MethodBind *method_bind;
+			Dispatch() {
+				_id = 0;
+				flags = 0;
+				method_bind = NULL;
+			}
+		};
+
 		MethodInfo user;
 		VMap<Target, Slot> slot_map;
+		Vector<Dispatch> dispatch;
 		Signal() {}
 	};
 
@@ -546,6 +564,7 @@ protected:
 
 	void property_list_changed_notify();
 	virtual void _changed_callback(Object *p_changed, const char *p_prop);
+	virtual void _script_instance_changed() {}
 
 	//Variant _call_bind(const StringName& p_name, const Variant& p_arg1 = Variant(), const Variant& p_arg2 = Variant(), const Variant& p_arg3 = Variant(), const Variant& p_arg4 = Variant());
 	//void _call_deferred_bind(const StringName& p_name, const Variant& p_arg1 = Variant(), const Variant& p_arg2 = Variant(), const Variant& p_arg3 = Variant(), const Variant& p_arg4 = Variant());
@@ -761,6 +780,23 @@ public:
 	virtual ~Object();
 };
 
+#ifdef DEBUG_ENABLED
+
+// Keeps the object from being freed while one of its methods runs.
+struct _ObjectDebugLock {
+	Object *obj;
+
+	_ObjectDebugLock(Object *p_obj) {
+		obj = p_obj;
+		obj->_lock_index.ref();
+	}
+	~_ObjectDebugLock() {
+		obj->_lock_index.unref();
+	}
+};
+
+#endif
+
 bool predelete_handler(Object *p_object);
 void postinitialize_handler(Object *p_object);
 
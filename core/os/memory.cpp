@@ -34,6 +34,10 @@
 #include "core/os/copymem.h"
 #include "core/safe_refcount.h"
 
+#ifdef SMALL_ALLOCATOR_ENABLED
+#include "core/os/small_allocator.h"
+#endif
+
 #include <stdio.h>
 #include <stdlib.h>
 
@@ -66,6 +70,37 @@ SafeNumeric<uint64_t> Memory::max_usage;
 
 SafeNumeric<uint64_t> Memory::alloc_count;
 
+static _FORCE_INLINE_ void *_raw_alloc(size_t p_bytes) {
+#ifdef SMALL_ALLOCATOR_ENABLED
+	if (p_bytes <= SmallAllocator::MAX_SMALL_SIZE) {
+		void *mem = SmallAllocator::alloc(p_bytes);
+		if (mem) {
+			return mem;
+		}
+	}
+#endif
+	return malloc(p_bytes);
+}
+
+static _FORCE_INLINE_ void *_raw_realloc(void *p_mem, size_t p_bytes) {
+#ifdef SMALL_ALLOCATOR_ENABLED
+	if (SmallAllocator::owns(p_mem)) {
+		return SmallAllocator::realloc(p_mem, p_bytes);
+	}
+#endif
+	return realloc(p_mem, p_bytes);
+}
+
+static _FORCE_INLINE_ void _raw_free(void *p_mem) {
+#ifdef SMALL_ALLOCATOR_ENABLED
+	if (SmallAllocator::owns(p_mem)) {
+		SmallAllocator::free(p_mem);
+		return;
+	}
+#endif
+	free(p_mem);
+}
+
 void *Memory::alloc_static(size_t p_bytes, bool p_pad_align) {
 #ifdef DEBUG_ENABLED
 	bool prepad = true;
@@ -73,7 +108,7 @@ void *Memory::alloc_static(size_t p_bytes, bool p_pad_align) {
 	bool prepad = p_pad_align;
 #endif
 
-	void *mem = malloc(p_bytes + (prepad ? PAD_ALIGN : 0));
+	void *mem = _raw_alloc(p_bytes + (prepad ? PAD_ALIGN : 0));
 
 	ERR_FAIL_COND_V(!mem, NULL);
 
@@ -122,12 +157,12 @@ void *Memory::realloc_static(void *p_memory, size_t p_bytes, bool p_pad_align) {
 #endif
 
 		if (p_bytes == 0) {
-			free(mem);
+			_raw_free(mem);
 			return NULL;
 		} else {
 			*s = p_bytes;
 
-			mem = (uint8_t *)realloc(mem, p_bytes + PAD_ALIGN);
+			mem = (uint8_t *)_raw_realloc(mem, p_bytes + PAD_ALIGN);
 			ERR_FAIL_COND_V(!mem, NULL);
 
 			s = (uint64_t *)mem;
@@ -137,7 +172,7 @@ void *Memory::realloc_static(void *p_memory, size_t p_bytes, bool p_pad_align) {
 			return mem + PAD_ALIGN;
 		}
 	} else {
-		mem = (uint8_t *)realloc(mem, p_bytes);
+		mem = (uint8_t *)_raw_realloc(mem, p_bytes);
 
 		ERR_FAIL_COND_V(mem == NULL && p_bytes > 0, NULL);
 
@@ -166,9 +201,9 @@ void Memory::free_static(void *p_ptr, bool p_pad_align) {
 		mem_usage.sub(*s);
 #endif
 
-		free(mem);
+		_raw_free(mem);
 	} else {
-		free(mem);
+		_raw_free(mem);
 	}
 }
 
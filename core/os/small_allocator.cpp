@@ -0,0 +1,379 @@
+/*************************************************************************/
+/*  small_allocator.cpp                                                  */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-present Godot Engine contributors (cf. AUTHORS.md).*/
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+
+#include "small_allocator.h"
+
+#include "core/error_macros.h"
+#include "core/os/mutex.h"
+
+#include <atomic>
+#include <stdlib.h>
+#include <string.h>
+
+namespace {
+
+enum {
+	SPAN_HEADER_SIZE = 16,
+	SPANS_PER_BLOCK = 64,
+	ADDRESS_BITS = sizeof(void *) == 8 ? 48 : 32,
+	MAP_LEAF_BITS = 16,
+	MAP_LEAF_WORDS = (1 << MAP_LEAF_BITS) / 64,
+	MAP_ROOT_SIZE = 1 << (ADDRESS_BITS - SmallAllocator::SPAN_SHIFT - MAP_LEAF_BITS),
+	MAX_BATCH = 64,
+};
+
+const uint32_t class_sizes[SmallAllocator::SIZE_CLASS_COUNT] = {
+	16, 32, 48, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 384, 448, 512
+};
+
+// Indexed by the size rounded up to 16 bytes, divided by 16.
+const uint8_t class_lookup[SmallAllocator::MAX_SMALL_SIZE / 16 + 1] = {
+	0, 0, 1, 2, 3, 4, 5, 6, 7, 8, 8, 9, 9, 10, 10, 11, 11,
+	12, 12, 12, 12, 13, 13, 13, 13, 14, 14, 14, 14, 15, 15, 15, 15
+};
+
+struct SpanHeader {
+	uint32_t size_class;
+	uint32_t block_size;
+};
+
+struct FreeBlock {
+	FreeBlock *next;
+};
+
+// Initialized members keep this constant initialized, allocations can happen before static constructors run.
+struct CentralList {
+	BinaryMutex mutex;
+	FreeBlock *free_list = nullptr;
+	uint8_t *carve = nullptr;
+	uint8_t *carve_end = nullptr;
+	uint64_t spans = 0;
+	uint64_t blocks_out = 0;
+	uint64_t refills = 0;
+};
+
+// Plain data so it stays usable while other thread_local objects are being destroyed.
+struct ThreadCache {
+	FreeBlock *lists[SmallAllocator::SIZE_CLASS_COUNT];
+	uint32_t counts[SmallAllocator::SIZE_CLASS_COUNT];
+	bool registered;
+	bool released;
+};
+
+CentralList central[SmallAllocator::SIZE_CLASS_COUNT];
+
+BinaryMutex span_mutex;
+uint8_t *span_next = NULL;
+uint8_t *span_end = NULL;
+
+// One bit per span sized piece of address space, set for spans handed out by this allocator.
+std::atomic<uint64_t *> span_map[MAP_ROOT_SIZE];
+
+thread_local ThreadCache thread_cache;
+
+_FORCE_INLINE_ uint32_t _get_batch(int p_class) {
+	return CLAMP(8192 / class_sizes[p_class], 8, (int)MAX_BATCH);
+}
+
+_FORCE_INLINE_ SpanHeader *_get_span(const void *p_ptr) {
+	return (SpanHeader *)((uintptr_t)p_ptr & ~(uintptr_t)(SmallAllocator::SPAN_SIZE - 1));
+}
+
+bool _map_span(uint8_t *p_span) {
+	uintptr_t key = (uintptr_t)p_span >> SmallAllocator::SPAN_SHIFT;
+	uintptr_t root = key >> MAP_LEAF_BITS;
+	if (root >= (uintptr_t)MAP_ROOT_SIZE) {
+		return false;
+	}
+
+	uint64_t *leaf = span_map[root].load(std::memory_order_acquire);
+	if (!leaf) {
+		leaf = (uint64_t *)::calloc(MAP_LEAF_WORDS, sizeof(uint64_t));
+		if (!leaf) {
+			return false;
+		}
+		span_map[root].store(leaf, std::memory_order_release);
+	}
+
+	uint32_t bit = key & ((1 << MAP_LEAF_BITS) - 1);
+	reinterpret_cast<std::atomic<uint64_t> *>(&leaf[bit >> 6])->fetch_or(uint64_t(1) << (bit & 63), std::memory_order_release);
+	return true;
+}
+
+// Called with the class lock held.
+uint8_t *_new_span(int p_class) {
+	MutexLock lock(span_mutex);
+
+	if (span_next == span_end) {
+		uint8_t *block = (uint8_t *)::malloc((SPANS_PER_BLOCK + 1) * SmallAllocator::SPAN_SIZE);
+		if (!block) {
+			return NULL;
+		}
+		span_next = (uint8_t *)(((uintptr_t)block + SmallAllocator::SPAN_SIZE - 1) & ~(uintptr_t)(SmallAllocator::SPAN_SIZE - 1));
+		span_end = span_next + SPANS_PER_BLOCK * SmallAllocator::SPAN_SIZE;
+	}
+
+	uint8_t *span = span_next;
+	if (!_map_span(span)) {
+		// Out of the mapped address range or no memory for the map, the caller falls back to the system allocator.
+		return NULL;
+	}
+	span_next += SmallAllocator::SPAN_SIZE;
+
+	SpanHeader *header = (SpanHeader *)span;
+	header->size_class = p_class;
+	header->block_size = class_sizes[p_class];
+	return span;
+}
+
+// Called with the class lock held.
+FreeBlock *_take_block(int p_class) {
+	CentralList &list = central[p_class];
+
+	FreeBlock *block = list.free_list;
+	if (block) {
+		list.free_list = block->next;
+		return block;
+	}
+
+	uint32_t size = class_sizes[p_class];
+	if (list.carve + size > list.carve_end) {
+		uint8_t *span = _new_span(p_class);
+		if (!span) {
+			return NULL;
+		}
+		list.carve = span + SPAN_HEADER_SIZE;
+		list.carve_end = span + SmallAllocator::SPAN_SIZE;
+		list.spans++;
+	}
+
+	block = (FreeBlock *)list.carve;
+	list.carve += size;
+	return block;
+}
+
+void _release_blocks(int p_class, FreeBlock *p_first, FreeBlock *p_last, uint32_t p_count) {
+	CentralList &list = central[p_class];
+	MutexLock lock(list.mutex);
+	p_last->next = list.free_list;
+	list.free_list = p_first;
+	list.blocks_out -= p_count;
+}
+
+void _release_thread_cache() {
+	ThreadCache &cache = thread_cache;
+	for (int i = 0; i < SmallAllocator::SIZE_CLASS_COUNT; i++) {
+		FreeBlock *first = cache.lists[i];
+		if (!first) {
+			continue;
+		}
+		FreeBlock *last = first;
+		while (last->next) {
+			last = last->next;
+		}
+		_release_blocks(i, first, last, cache.counts[i]);
+		cache.lists[i] = NULL;
+		cache.counts[i] = 0;
+	}
+	cache.released = true;
+}
+
+struct ThreadCacheReleaser {
+	void touch() {}
+	~ThreadCacheReleaser() {
+		_release_thread_cache();
+	}
+};
+
+thread_local ThreadCacheReleaser thread_cache_releaser;
+
+bool _refill(ThreadCache &p_cache, int p_class) {
+	if (!p_cache.registered) {
+		// Constructs the releaser, so the cache is handed back when the thread exits.
+		p_cache.registered = true;
+		thread_cache_releaser.touch();
+	}
+
+	CentralList &list = central[p_class];
+	MutexLock lock(list.mutex);
+
+	uint32_t batch = _get_batch(p_class);
+	uint32_t count = 0;
+	while (count < batch) {
+		FreeBlock *block = _take_block(p_class);
+		if (!block) {
+			break;
+		}
+		block->next = p_cache.lists[p_class];
+		p_cache.lists[p_class] = block;
+		count++;
+	}
+
+	p_cache.counts[p_class] += count;
+	list.blocks_out += count;
+	list.refills++;
+	return count > 0;
+}
+
+} // namespace
+
+void *SmallAllocator::alloc(size_t p_bytes) {
+	if (p_bytes > MAX_SMALL_SIZE) {
+		return NULL;
+	}
+
+	int size_class = class_lookup[(p_bytes + 15) >> 4];
+	ThreadCache &cache = thread_cache;
+
+	if (unlikely(cache.released)) {
+		// Thread is exiting, go straight to the shared pool.
+		CentralList &list = central[size_class];
+		MutexLock lock(list.mutex);
+		FreeBlock *block = _take_block(size_class);
+		if (block) {
+			list.blocks_out++;
+		}
+		return block;
+	}
+
+	FreeBlock *block = cache.lists[size_class];
+	if (unlikely(!block)) {
+		if (!_refill(cache, size_class)) {
+			return NULL;
+		}
+		block = cache.lists[size_class];
+	}
+
+	cache.lists[size_class] = block->next;
+	cache.counts[size_class]--;
+	return block;
+}
+
+void *SmallAllocator::realloc(void *p_ptr, size_t p_bytes) {
+	if (p_bytes == 0) {
+		free(p_ptr);
+		return NULL;
+	}
+
+	size_t block_size = get_block_size(p_ptr);
+	if (p_bytes <= block_size && p_bytes > block_size / 2) {
+		return p_ptr;
+	}
+
+	void *mem = alloc(p_bytes);
+	if (!mem) {
+		mem = ::malloc(p_bytes);
+		if (!mem) {
+			return NULL;
+		}
+	}
+
+	memcpy(mem, p_ptr, MIN(block_size, p_bytes));
+	free(p_ptr);
+	return mem;
+}
+
+void SmallAllocator::free(void *p_ptr) {
+	int size_class = _get_span(p_ptr)->size_class;
+	FreeBlock *block = (FreeBlock *)p_ptr;
+	ThreadCache &cache = thread_cache;
+
+	if (unlikely(cache.released)) {
+		_release_blocks(size_class, block, block, 1);
+		return;
+	}
+
+	block->next = cache.lists[size_class];
+	cache.lists[size_class] = block;
+	cache.counts[size_class]++;
+
+	uint32_t batch = _get_batch(size_class);
+	if (unlikely(cache.counts[size_class] > batch * 2)) {
+		// Give a batch back, so blocks freed on a different thread than they were allocated on return to the pool.
+		FreeBlock *first = cache.lists[size_class];
+		FreeBlock *last = first;
+		for (uint32_t i = 1; i < batch; i++) {
+			last = last->next;
+		}
+		cache.lists[size_class] = last->next;
+		cache.counts[size_class] -= batch;
+		_release_blocks(size_class, first, last, batch);
+	}
+}
+
+bool SmallAllocator::owns(const void *p_ptr) {
+	uintptr_t key = (uintptr_t)p_ptr >> SPAN_SHIFT;
+	uintptr_t root = key >> MAP_LEAF_BITS;
+	if (root >= (uintptr_t)MAP_ROOT_SIZE) {
+		return false;
+	}
+
+	const uint64_t *leaf = span_map[root].load(std::memory_order_acquire);
+	if (!leaf) {
+		return false;
+	}
+
+	uint32_t bit = key & ((1 << MAP_LEAF_BITS) - 1);
+	uint64_t word = reinterpret_cast<const std::atomic<uint64_t> *>(&leaf[bit >> 6])->load(std::memory_order_relaxed);
+	return word & (uint64_t(1) << (bit & 63));
+}
+
+size_t SmallAllocator::get_block_size(const void *p_ptr) {
+	return _get_span(p_ptr)->block_size;
+}
+
+SmallAllocator::SizeClassStats SmallAllocator::get_size_class_stats(int p_class) {
+	SizeClassStats stats;
+	memset(&stats, 0, sizeof(stats));
+	ERR_FAIL_INDEX_V(p_class, SIZE_CLASS_COUNT, stats);
+
+	CentralList &list = central[p_class];
+	MutexLock lock(list.mutex);
+	stats.block_size = class_sizes[p_class];
+	stats.reserved = list.spans * SPAN_SIZE;
+	stats.used = list.blocks_out * class_sizes[p_class];
+	stats.refills = list.refills;
+	return stats;
+}
+
+uint64_t SmallAllocator::get_reserved_bytes() {
+	uint64_t total = 0;
+	for (int i = 0; i < SIZE_CLASS_COUNT; i++) {
+		total += get_size_class_stats(i).reserved;
+	}
+	return total;
+}
+
+uint64_t SmallAllocator::get_used_bytes() {
+	uint64_t total = 0;
+	for (int i = 0; i < SIZE_CLASS_COUNT; i++) {
+		total += get_size_class_stats(i).used;
+	}
+	return total;
+}
@@ -0,0 +1,69 @@
+/*************************************************************************/
+/*  small_allocator.h                                                    */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-present Godot Engine contributors (cf. AUTHORS.md).*/
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+
+#ifndef SMALL_ALLOCATOR_H
+#define SMALL_ALLOCATOR_H
+
+#include "core/typedefs.h"
+
+#include <stddef.h>
+
+// Size class allocator for small blocks, used by Memory when built with small_allocator=yes.
+// Each thread keeps a free list per size class and only locks to exchange batches of blocks
+// with the shared pool. Blocks come from 64 KiB spans that are never given back to the system.
+
+class SmallAllocator {
+public:
+	enum {
+		SIZE_CLASS_COUNT = 16,
+		MAX_SMALL_SIZE = 512,
+		SPAN_SHIFT = 16,
+		SPAN_SIZE = 1 << SPAN_SHIFT,
+	};
+
+	struct SizeClassStats {
+		uint32_t block_size;
+		uint64_t reserved; // Bytes in spans owned by this class.
+		uint64_t used; // Bytes handed out to threads, including their caches.
+		uint64_t refills; // Batches moved from the shared pool to a thread.
+	};
+
+	static void *alloc(size_t p_bytes);
+	static void *realloc(void *p_ptr, size_t p_bytes);
+	static void free(void *p_ptr);
+
+	static bool owns(const void *p_ptr);
+	static size_t get_block_size(const void *p_ptr);
+
+	static SizeClassStats get_size_class_stats(int p_class);
+	static uint64_t get_reserved_bytes();
+	static uint64_t get_used_bytes();
+};
+
+#endif // SMALL_ALLOCATOR_H
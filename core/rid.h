@@ -42,14 +42,17 @@ class RID_OwnerBase;
 class RID_Data {
 	friend class RID_OwnerBase;
 
-#ifndef DEBUG_ENABLED
-	RID_OwnerBase *_owner;
-#endif
+	// Owner tag, lets an owner reject RIDs of other owners before looking at anything else.
+	const RID_OwnerBase *_owner;
 	uint32_t _id;
 
 public:
 	_FORCE_INLINE_ uint32_t get_id() const { return _id; }
 
+	RID_Data() {
+		_owner = NULL;
+		_id = 0;
+	}
 	virtual ~RID_Data();
 };
 
@@ -57,24 +60,25 @@ class RID {
 	friend class RID_OwnerBase;
 
 	mutable RID_Data *_data;
+	uint32_t _generation; // of the RID_Alloc slot when the RID was made, 0 for other owners
 
 public:
 	_FORCE_INLINE_ RID_Data *get_data() const { return _data; }
 
 	_FORCE_INLINE_ bool operator==(const RID &p_rid) const {
-		return _data == p_rid._data;
+		return _data == p_rid._data && _generation == p_rid._generation;
 	}
 	_FORCE_INLINE_ bool operator<(const RID &p_rid) const {
-		return _data < p_rid._data;
+		return _data == p_rid._data ? _generation < p_rid._generation : _data < p_rid._data;
 	}
 	_FORCE_INLINE_ bool operator<=(const RID &p_rid) const {
-		return _data <= p_rid._data;
+		return !(p_rid < *this);
 	}
 	_FORCE_INLINE_ bool operator>(const RID &p_rid) const {
-		return _data > p_rid._data;
+		return p_rid < *this;
 	}
 	_FORCE_INLINE_ bool operator!=(const RID &p_rid) const {
-		return _data != p_rid._data;
+		return !(*this == p_rid);
 	}
 	_FORCE_INLINE_ bool is_valid() const { return _data != NULL; }
 
@@ -82,23 +86,32 @@ public:
 
 	_FORCE_INLINE_ RID() {
 		_data = NULL;
+		_generation = 0;
 	}
 };
 
 class RID_OwnerBase {
 protected:
 	static SafeRefCount refcount;
+	_FORCE_INLINE_ static void _set_pointer(RID &p_rid, RID_Data *p_data) {
+		p_rid._data = p_data;
+	}
+
+	_FORCE_INLINE_ static void _set_generation(RID &p_rid, uint32_t p_generation) {
+		p_rid._generation = p_generation;
+	}
+
+	_FORCE_INLINE_ static uint32_t _get_generation(const RID &p_rid) {
+		return p_rid._generation;
+	}
+
 	_FORCE_INLINE_ void _set_data(RID &p_rid, RID_Data *p_data) {
 		p_rid._data = p_data;
 		refcount.ref();
 		p_data->_id = refcount.get();
-#ifndef DEBUG_ENABLED
 		p_data->_owner = this;
-#endif
 	}
 
-#ifndef DEBUG_ENABLED
-
 	_FORCE_INLINE_ bool _is_owner(const RID &p_rid) const {
 		return this == p_rid._data->_owner;
 	}
@@ -106,7 +119,6 @@ protected:
 	_FORCE_INLINE_ void _remove_owner(RID &p_rid) {
 		p_rid._data->_owner = NULL;
 	}
-#endif
 
 public:
 	virtual void get_owned_list(List<RID> *p_owned) = 0;
@@ -186,4 +198,173 @@ public:
 	}
 };
 
+// Keeps the objects themselves in fixed chunks, so they sit next to each other in memory and can be
+// walked in order. Ownership is checked on the owner tag of the RID_Data first, so RIDs of other
+// owners are rejected before the slot header is looked at. Every slot counts how often it was freed
+// and RIDs carry that generation, so a stale RID is rejected even after its slot was reused.
+template <class T>
+class RID_Alloc : public RID_OwnerBase {
+	struct Slot {
+		const RID_Alloc *owner; // NULL while free
+		uint32_t index;
+		uint32_t generation;
+		uint32_t next_free;
+		alignas(T) uint8_t data[sizeof(T)];
+	};
+
+	enum {
+		CHUNK_BYTES = 65536,
+		INVALID_SLOT = 0xFFFFFFFF
+	};
+
+	Slot **chunks;
+	uint32_t chunk_count;
+	uint32_t slots_per_chunk;
+	uint32_t free_head;
+	uint32_t free_tail;
+	uint32_t alloc_count;
+
+	_FORCE_INLINE_ Slot *_get_slot(uint32_t p_index) const {
+		return &chunks[p_index / slots_per_chunk][p_index % slots_per_chunk];
+	}
+
+	_FORCE_INLINE_ static Slot *_get_slot_of(const T *p_data) {
+		return (Slot *)((uint8_t *)p_data - offsetof(Slot, data));
+	}
+
+	_FORCE_INLINE_ bool _validate(const RID &p_rid, T *&r_data) const {
+		if (!p_rid.is_valid() || !_is_owner(p_rid)) {
+			return false;
+		}
+		r_data = static_cast<T *>(p_rid.get_data());
+		const Slot *slot = _get_slot_of(r_data);
+		return slot->owner == this && slot->generation == _get_generation(p_rid);
+	}
+
+public:
+	// Constructs an object in a free slot, hand it to make_rid() once it is set up.
+	T *alloc() {
+		if (free_head == INVALID_SLOT) {
+			chunks = (Slot **)memrealloc(chunks, sizeof(Slot *) * (chunk_count + 1));
+			Slot *chunk = (Slot *)memalloc(sizeof(Slot) * slots_per_chunk);
+			uint32_t base = chunk_count * slots_per_chunk;
+			for (uint32_t i = 0; i < slots_per_chunk; i++) {
+				chunk[i].owner = NULL;
+				chunk[i].index = base + i;
+				chunk[i].generation = 1;
+				chunk[i].next_free = i + 1 < slots_per_chunk ? base + i + 1 : INVALID_SLOT;
+			}
+			chunks[chunk_count++] = chunk;
+			free_head = base;
+			free_tail = base + slots_per_chunk - 1;
+		}
+
+		Slot *slot = _get_slot(free_head);
+		free_head = slot->next_free;
+		if (free_head == INVALID_SLOT) {
+			free_tail = INVALID_SLOT;
+		}
+		slot->owner = this;
+		alloc_count++;
+		return memnew_placement(slot->data, T);
+	}
+
+	_FORCE_INLINE_ RID make_rid(T *p_data) {
+		RID rid;
+		_set_data(rid, p_data);
+		_set_generation(rid, _get_slot_of(p_data)->generation);
+		return rid;
+	}
+
+	_FORCE_INLINE_ T *get(const RID &p_rid) {
+		T *data = NULL;
+		ERR_FAIL_COND_V(!_validate(p_rid, data), NULL);
+		return data;
+	}
+
+	_FORCE_INLINE_ T *getornull(const RID &p_rid) {
+		if (!p_rid.is_valid()) {
+			return NULL;
+		}
+		T *data = NULL;
+		ERR_FAIL_COND_V(!_validate(p_rid, data), NULL);
+		return data;
+	}
+
+	_FORCE_INLINE_ T *getptr(const RID &p_rid) {
+		return static_cast<T *>(p_rid.get_data());
+	}
+
+	_FORCE_INLINE_ bool owns(const RID &p_rid) const {
+		T *data = NULL;
+		return _validate(p_rid, data);
+	}
+
+	// Unlike RID_Owner this also destroys the object, the slot goes to the back of the free list.
+	void free(RID p_rid) {
+		T *data = NULL;
+		ERR_FAIL_COND(!_validate(p_rid, data));
+
+		Slot *slot = _get_slot_of(data);
+		// Cleared before destruction, the slot memory stays mapped so a stale RID reads NULL here.
+		_remove_owner(p_rid);
+		data->~T();
+		slot->owner = NULL;
+		// Never 0, which is what RIDs of other owners carry.
+		if (++slot->generation == 0) {
+			slot->generation = 1;
+		}
+
+		slot->next_free = INVALID_SLOT;
+		if (free_tail == INVALID_SLOT) {
+			free_head = slot->index;
+		} else {
+			_get_slot(free_tail)->next_free = slot->index;
+		}
+		free_tail = slot->index;
+		alloc_count--;
+	}
+
+	_FORCE_INLINE_ uint32_t get_rid_count() const { return alloc_count; }
+
+	// Dense iteration, returns NULL for free slots.
+	_FORCE_INLINE_ uint32_t get_slot_count() const { return chunk_count * slots_per_chunk; }
+	_FORCE_INLINE_ T *get_slot(uint32_t p_index) const {
+		Slot *slot = _get_slot(p_index);
+		return slot->owner ? (T *)slot->data : NULL;
+	}
+
+	void get_owned_list(List<RID> *p_owned) {
+		for (uint32_t i = 0; i < get_slot_count(); i++) {
+			T *data = get_slot(i);
+			if (data) {
+				RID rid;
+				_set_pointer(rid, data);
+				_set_generation(rid, _get_slot(i)->generation);
+				p_owned->push_back(rid);
+			}
+		}
+	}
+
+	RID_Alloc() {
+		chunks = NULL;
+		chunk_count = 0;
+		slots_per_chunk = MAX(1, CHUNK_BYTES / sizeof(Slot));
+		free_head = INVALID_SLOT;
+		free_tail = INVALID_SLOT;
+		alloc_count = 0;
+	}
+
+	~RID_Alloc() {
+		// Objects still alive are leaks of the owning server, their destructors may reach into
+		// state that is gone by now, so only the memory is released.
+		for (uint32_t i = 0; i < chunk_count; i++) {
+			memfree(chunks[i]);
+		}
+		if (chunks) {
+			memfree(chunks);
+		}
+	}
+};
+
 #endif
@@ -39,30 +39,33 @@ StaticCString StaticCString::create(const char *p_ptr) {
 	return scs;
 }
 
-StringName::_Data *StringName::_table[STRING_TABLE_LEN];
+std::atomic<StringName::_Data *> StringName::_table[STRING_TABLE_LEN];
+StringName::_Stripe StringName::_stripes[STRIPE_COUNT];
+thread_local StringName::_CacheEntry StringName::_thread_cache[THREAD_CACHE_LEN];
 
 StringName _scs_create(const char *p_chr) {
 	return (p_chr[0] ? StringName(StaticCString::create(p_chr)) : StringName());
 }
 
 bool StringName::configured = false;
-Mutex StringName::lock;
 
 void StringName::setup() {
 	ERR_FAIL_COND(configured);
 	for (int i = 0; i < STRING_TABLE_LEN; i++) {
-		_table[i] = NULL;
+		_table[i].store(NULL);
 	}
 	configured = true;
 }
 
 void StringName::cleanup() {
-	lock.lock();
+	for (int i = 0; i < STRIPE_COUNT; i++) {
+		_stripes[i].lock.lock();
+	}
 
 	int lost_strings = 0;
 	for (int i = 0; i < STRING_TABLE_LEN; i++) {
-		while (_table[i]) {
-			_Data *d = _table[i];
+		while (_table[i].load()) {
+			_Data *d = _table[i].load();
 			lost_strings++;
 			if (OS::get_singleton()->is_stdout_verbose()) {
 				if (d->cname) {
@@ -72,36 +75,175 @@ void StringName::cleanup() {
 				}
 			}
 
-			_table[i] = _table[i]->next;
+			_table[i].store(d->next.load());
 			memdelete(d);
 		}
 	}
 	if (lost_strings) {
 		print_verbose("StringName: " + itos(lost_strings) + " unclaimed string names at exit.");
 	}
-	lock.unlock();
+
+	for (int i = 0; i < STRIPE_COUNT; i++) {
+		_free_retired(_stripes[i]);
+		_stripes[i].lock.unlock();
+	}
+}
+
+void StringName::_free_retired(_Stripe &p_stripe) {
+	while (p_stripe.retired) {
+		_Data *d = p_stripe.retired;
+		p_stripe.retired = d->prev;
+		memdelete(d);
+	}
+}
+
+_FORCE_INLINE_ bool StringName::_data_equals(const _Data *p_data, const char *p_name) {
+	return p_data->cname ? strcmp(p_data->cname, p_name) == 0 : p_data->name == p_name;
+}
+
+_FORCE_INLINE_ bool StringName::_data_equals(const _Data *p_data, const char32_t *p_name) {
+	return p_data->cname ? String(p_data->cname) == p_name : p_data->name == p_name;
+}
+
+_FORCE_INLINE_ bool StringName::_data_equals(const _Data *p_data, const String &p_name) {
+	return p_data->cname ? p_name == p_data->cname : p_data->name == p_name;
+}
+
+_FORCE_INLINE_ bool StringName::_data_equals(const _Data *p_data, const StrRange &p_name) {
+	if (!p_data->cname) {
+		return p_data->name == p_name;
+	}
+
+	const char *cname = p_data->cname;
+	for (int i = 0; i < p_name.len; i++) {
+		if ((uint8_t)cname[i] != p_name.c_str[i] || !cname[i]) {
+			return false;
+		}
+	}
+	return cname[p_name.len] == 0;
+}
+
+_FORCE_INLINE_ bool StringName::_data_equals(const _Data *p_data, const Utf8Range &p_name) {
+	if (!p_data->cname) {
+		return p_data->name == p_name;
+	}
+
+	// Static names are plain ASCII, so only an identical byte sequence matches.
+	return strncmp(p_data->cname, p_name.c_str, p_name.len) == 0 && p_data->cname[p_name.len] == 0;
+}
+
+// Returns a referenced entry, or NULL. Never locks.
+template <class T>
+StringName::_Data *StringName::_lookup(uint32_t p_hash, const T &p_name) {
+	uint32_t idx = p_hash & STRING_TABLE_MASK;
+	_Stripe &stripe = _stripes[idx & STRIPE_MASK];
+	_CacheEntry &entry = _thread_cache[p_hash & THREAD_CACHE_MASK];
+
+	// Sequentially consistent on purpose: once a remover sees no readers,
+	// any later reader must see the entries it unlinked as gone.
+	stripe.readers.fetch_add(1);
+
+	_Data *found = NULL;
+
+	if (entry.data && entry.hash == p_hash && entry.removals == stripe.removals.load()) {
+		if (_data_equals(entry.data, p_name) && entry.data->refcount.ref()) {
+			found = entry.data;
+		}
+	}
+
+	if (!found) {
+		// Newer entries are inserted first, so a live duplicate of a dying entry is always met before it.
+		for (_Data *d = _table[idx].load(); d; d = d->next.load()) {
+			if (d->hash == p_hash && _data_equals(d, p_name)) {
+				if (d->refcount.ref()) {
+					found = d;
+					entry.data = d;
+					entry.hash = p_hash;
+					entry.removals = stripe.removals.load();
+				}
+				break;
+			}
+		}
+	}
+
+	stripe.readers.fetch_sub(1);
+
+	return found;
+}
+
+template <class T>
+StringName::_Data *StringName::_intern(uint32_t p_hash, const T &p_name, const char *p_cname) {
+	_Data *found = _lookup(p_hash, p_name);
+	if (found) {
+		return found;
+	}
+
+	uint32_t idx = p_hash & STRING_TABLE_MASK;
+	_Stripe &stripe = _stripes[idx & STRIPE_MASK];
+
+	MutexLock lock(stripe.lock);
+
+	// Another thread may have inserted it since the lookup.
+	for (_Data *d = _table[idx].load(); d; d = d->next.load()) {
+		if (d->hash == p_hash && _data_equals(d, p_name)) {
+			if (d->refcount.ref()) {
+				return d;
+			}
+			break;
+		}
+	}
+
+	_Data *d = memnew(_Data);
+	if (p_cname) {
+		d->cname = p_cname;
+	} else {
+		d->name = p_name;
+	}
+	d->refcount.init();
+	d->hash = p_hash;
+	d->idx = idx;
+	d->prev = NULL;
+
+	_Data *head = _table[idx].load();
+	d->next.store(head);
+	if (head) {
+		head->prev = d;
+	}
+	_table[idx].store(d);
+
+	return d;
 }
 
 void StringName::unref() {
 	ERR_FAIL_COND(!configured);
 
 	if (_data && _data->refcount.unref()) {
-		lock.lock();
+		_Stripe &stripe = _stripes[_data->idx & STRIPE_MASK];
+
+		MutexLock lock(stripe.lock);
 
+		_Data *next = _data->next.load();
 		if (_data->prev) {
-			_data->prev->next = _data->next;
+			_data->prev->next.store(next);
 		} else {
-			if (_table[_data->idx] != _data) {
+			if (_table[_data->idx].load() != _data) {
 				ERR_PRINT("BUG!");
 			}
-			_table[_data->idx] = _data->next;
+			_table[_data->idx].store(next);
+		}
+
+		if (next) {
+			next->prev = _data->prev;
 		}
 
-		if (_data->next) {
-			_data->next->prev = _data->prev;
+		stripe.removals.fetch_add(1);
+
+		_data->prev = stripe.retired;
+		stripe.retired = _data;
+
+		if (stripe.readers.load() == 0) {
+			_free_retired(stripe);
 		}
-		memdelete(_data);
-		lock.unlock();
 	}
 
 	_data = NULL;
@@ -162,42 +304,7 @@ StringName::StringName(const char *p_name) {
 	if (!p_name || p_name[0] == 0)
 		return; //empty, ignore
 
-	lock.lock();
-
-	uint32_t hash = String::hash(p_name);
-
-	uint32_t idx = hash & STRING_TABLE_MASK;
-
-	_data = _table[idx];
-
-	while (_data) {
-		// compare hash first
-		if (_data->hash == hash && _data->get_name() == p_name)
-			break;
-		_data = _data->next;
-	}
-
-	if (_data) {
-		if (_data->refcount.ref()) {
-			// exists
-			lock.unlock();
-			return;
-		}
-	}
-
-	_data = memnew(_Data);
-	_data->name = p_name;
-	_data->refcount.init();
-	_data->hash = hash;
-	_data->idx = idx;
-	_data->cname = NULL;
-	_data->next = _table[idx];
-	_data->prev = NULL;
-	if (_table[idx])
-		_table[idx]->prev = _data;
-	_table[idx] = _data;
-
-	lock.unlock();
+	_data = _intern(String::hash(p_name), p_name, NULL);
 }
 
 StringName::StringName(const StaticCString &p_static_string) {
@@ -207,87 +314,42 @@ StringName::StringName(const StaticCString &p_static_string) {
 
 	ERR_FAIL_COND(!p_static_string.ptr || !p_static_string.ptr[0]);
 
-	lock.lock();
-
-	uint32_t hash = String::hash(p_static_string.ptr);
-
-	uint32_t idx = hash & STRING_TABLE_MASK;
-
-	_data = _table[idx];
-
-	while (_data) {
-		// compare hash first
-		if (_data->hash == hash && _data->get_name() == p_static_string.ptr)
-			break;
-		_data = _data->next;
-	}
+	_data = _intern(String::hash(p_static_string.ptr), p_static_string.ptr, p_static_string.ptr);
+}
 
-	if (_data) {
-		if (_data->refcount.ref()) {
-			// exists
-			lock.unlock();
-			return;
-		}
-	}
+StringName::StringName(const String &p_name) {
+	_data = NULL;
 
-	_data = memnew(_Data);
+	ERR_FAIL_COND(!configured);
 
-	_data->refcount.init();
-	_data->hash = hash;
-	_data->idx = idx;
-	_data->cname = p_static_string.ptr;
-	_data->next = _table[idx];
-	_data->prev = NULL;
-	if (_table[idx])
-		_table[idx]->prev = _data;
-	_table[idx] = _data;
+	if (p_name == String())
+		return;
 
-	lock.unlock();
+	_data = _intern(p_name.hash(), p_name, NULL);
 }
 
-StringName::StringName(const String &p_name) {
+StringName::StringName(const StrRange &p_name) {
 	_data = NULL;
 
 	ERR_FAIL_COND(!configured);
 
-	if (p_name == String())
+	if (!p_name.c_str || p_name.len == 0)
 		return;
 
-	lock.lock();
+	_data = _intern(p_name.hash(), p_name, NULL);
+}
 
-	uint32_t hash = p_name.hash();
+StringName::StringName(const Utf8Range &p_name) {
+	_data = NULL;
 
-	uint32_t idx = hash & STRING_TABLE_MASK;
+	ERR_FAIL_COND(!configured);
 
-	_data = _table[idx];
+	if (!p_name.c_str || p_name.len == 0)
+		return;
 
-	while (_data) {
-		if (_data->hash == hash && _data->get_name() == p_name)
-			break;
-		_data = _data->next;
-	}
+	ERR_FAIL_COND_MSG(!p_name.is_valid(), "Invalid UTF-8 in StringName.");
 
-	if (_data) {
-		if (_data->refcount.ref()) {
-			// exists
-			lock.unlock();
-			return;
-		}
-	}
-
-	_data = memnew(_Data);
-	_data->name = p_name;
-	_data->refcount.init();
-	_data->hash = hash;
-	_data->idx = idx;
-	_data->cname = NULL;
-	_data->next = _table[idx];
-	_data->prev = NULL;
-	if (_table[idx])
-		_table[idx]->prev = _data;
-	_table[idx] = _data;
-
-	lock.unlock();
+	_data = _intern(p_name.hash(), p_name, NULL);
 }
 
 StringName StringName::search(const char *p_name) {
@@ -297,29 +359,7 @@ StringName StringName::search(const char *p_name) {
 	if (!p_name[0])
 		return StringName();
 
-	lock.lock();
-
-	uint32_t hash = String::hash(p_name);
-
-	uint32_t idx = hash & STRING_TABLE_MASK;
-
-	_Data *_data = _table[idx];
-
-	while (_data) {
-		// compare hash first
-		if (_data->hash == hash && _data->get_name() == p_name)
-			break;
-		_data = _data->next;
-	}
-
-	if (_data && _data->refcount.ref()) {
-		lock.unlock();
-
-		return StringName(_data);
-	}
-
-	lock.unlock();
-	return StringName(); //does not exist
+	return StringName(_lookup(String::hash(p_name), p_name)); // NULL if it does not exist
 }
 
 StringName StringName::search(const char32_t *p_name) {
@@ -329,54 +369,30 @@ StringName StringName::search(const char32_t *p_name) {
 	if (!p_name[0])
 		return StringName();
 
-	lock.lock();
-
-	uint32_t hash = String::hash(p_name);
-
-	uint32_t idx = hash & STRING_TABLE_MASK;
-
-	_Data *_data = _table[idx];
-
-	while (_data) {
-		// compare hash first
-		if (_data->hash == hash && _data->get_name() == p_name)
-			break;
-		_data = _data->next;
-	}
-
-	if (_data && _data->refcount.ref()) {
-		lock.unlock();
-		return StringName(_data);
-	}
-
-	lock.unlock();
-	return StringName(); //does not exist
+	return StringName(_lookup(String::hash(p_name), p_name));
 }
 StringName StringName::search(const String &p_name) {
 	ERR_FAIL_COND_V(p_name == "", StringName());
 
-	lock.lock();
+	return StringName(_lookup(p_name.hash(), p_name));
+}
 
-	uint32_t hash = p_name.hash();
+StringName StringName::search(const StrRange &p_name) {
+	ERR_FAIL_COND_V(!configured, StringName());
 
-	uint32_t idx = hash & STRING_TABLE_MASK;
+	if (!p_name.c_str || p_name.len == 0)
+		return StringName();
 
-	_Data *_data = _table[idx];
+	return StringName(_lookup(p_name.hash(), p_name));
+}
 
-	while (_data) {
-		// compare hash first
-		if (_data->hash == hash && p_name == _data->get_name())
-			break;
-		_data = _data->next;
-	}
+StringName StringName::search(const Utf8Range &p_name) {
+	ERR_FAIL_COND_V(!configured, StringName());
 
-	if (_data && _data->refcount.ref()) {
-		lock.unlock();
-		return StringName(_data);
-	}
+	if (!p_name.c_str || p_name.len == 0)
+		return StringName();
 
-	lock.unlock();
-	return StringName(); //does not exist
+	return StringName(_lookup(p_name.hash(), p_name));
 }
 
 StringName::StringName() {
@@ -35,6 +35,8 @@
 #include "core/safe_refcount.h"
 #include "core/ustring.h"
 
+#include <atomic>
+
 struct StaticCString {
 	const char *ptr;
 	static StaticCString create(const char *p_ptr);
@@ -45,7 +47,15 @@ class StringName {
 
 		STRING_TABLE_BITS = 12,
 		STRING_TABLE_LEN = 1 << STRING_TABLE_BITS,
-		STRING_TABLE_MASK = STRING_TABLE_LEN - 1
+		STRING_TABLE_MASK = STRING_TABLE_LEN - 1,
+
+		STRIPE_BITS = 6,
+		STRIPE_COUNT = 1 << STRIPE_BITS,
+		STRIPE_MASK = STRIPE_COUNT - 1,
+
+		THREAD_CACHE_BITS = 8,
+		THREAD_CACHE_LEN = 1 << THREAD_CACHE_BITS,
+		THREAD_CACHE_MASK = THREAD_CACHE_LEN - 1
 	};
 
 	struct _Data {
@@ -56,17 +66,55 @@ class StringName {
 		String get_name() const { return cname ? String(cname) : name; }
 		int idx;
 		uint32_t hash;
-		_Data *prev;
-		_Data *next;
-		_Data() {
+		_Data *prev; // Only touched with the stripe locked, also links retired entries.
+		std::atomic<_Data *> next;
+		_Data() :
+				next(NULL) {
 			cname = NULL;
-			next = prev = NULL;
+			prev = NULL;
 			idx = 0;
 			hash = 0;
 		}
 	};
 
-	static _Data *_table[STRING_TABLE_LEN];
+	// Lookups walk the buckets without locking. Inserting and removing lock the
+	// stripe owning the bucket. Removed entries are only freed once no lookup
+	// of their stripe is in flight, as one may still be walking through them.
+	struct alignas(64) _Stripe {
+		Mutex lock;
+		std::atomic<uint32_t> readers;
+		std::atomic<uint64_t> removals;
+		_Data *retired;
+		_Stripe() :
+				readers(0),
+				removals(0) {
+			retired = NULL;
+		}
+	};
+
+	// Recently interned names of the calling thread. An entry is only trusted
+	// while its stripe has removed nothing since it was cached.
+	struct _CacheEntry {
+		_Data *data;
+		uint32_t hash;
+		uint64_t removals;
+	};
+
+	static std::atomic<_Data *> _table[STRING_TABLE_LEN];
+	static _Stripe _stripes[STRIPE_COUNT];
+	static thread_local _CacheEntry _thread_cache[THREAD_CACHE_LEN];
+
+	static _FORCE_INLINE_ bool _data_equals(const _Data *p_data, const char *p_name);
+	static _FORCE_INLINE_ bool _data_equals(const _Data *p_data, const char32_t *p_name);
+	static _FORCE_INLINE_ bool _data_equals(const _Data *p_data, const String &p_name);
+	static _FORCE_INLINE_ bool _data_equals(const _Data *p_data, const StrRange &p_name);
+	static _FORCE_INLINE_ bool _data_equals(const _Data *p_data, const Utf8Range &p_name);
+
+	template <class T>
+	static _Data *_lookup(uint32_t p_hash, const T &p_name);
+	template <class T>
+	static _Data *_intern(uint32_t p_hash, const T &p_name, const char *p_cname);
+	static void _free_retired(_Stripe &p_stripe);
 
 	_Data *_data;
 
@@ -79,7 +127,6 @@ class StringName {
 	friend void register_core_types();
 	friend void unregister_core_types();
 
-	static Mutex lock;
 	static void setup();
 	static void cleanup();
 	static bool configured;
@@ -125,6 +172,8 @@ public:
 	static StringName search(const char *p_name);
 	static StringName search(const char32_t *p_name);
 	static StringName search(const String &p_name);
+	static StringName search(const StrRange &p_name);
+	static StringName search(const Utf8Range &p_name);
 
 	struct AlphCompare {
 		_FORCE_INLINE_ bool operator()(const StringName &l, const StringName &r) const {
@@ -149,6 +198,8 @@ public:
 	StringName(const char *p_name);
 	StringName(const StringName &p_name);
 	StringName(const String &p_name);
+	StringName(const StrRange &p_name);
+	StringName(const Utf8Range &p_name);
 	StringName(const StaticCString &p_static_string);
 	StringName();
 	~StringName();
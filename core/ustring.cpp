@@ -432,6 +432,86 @@ void String::operator=(const char32_t *p_str) {
 	copy_from(p_str);
 }
 
+// Decodes the code point at r_ofs and advances past it, returns -1 on malformed input.
+static _FORCE_INLINE_ int32_t _utf8_decode_next(const uint8_t *p_utf8, int p_len, int &r_ofs) {
+	uint8_t c = p_utf8[r_ofs++];
+	if (c < 0x80) {
+		return c;
+	}
+
+	int extra;
+	uint32_t code;
+	if ((c & 0xE0) == 0xC0) {
+		extra = 1;
+		code = c & 0x1F;
+	} else if ((c & 0xF0) == 0xE0) {
+		extra = 2;
+		code = c & 0x0F;
+	} else if ((c & 0xF8) == 0xF0) {
+		extra = 3;
+		code = c & 0x07;
+	} else {
+		return -1;
+	}
+
+	if (r_ofs + extra > p_len) {
+		return -1;
+	}
+	for (int i = 0; i < extra; i++) {
+		uint8_t n = p_utf8[r_ofs++];
+		if ((n & 0xC0) != 0x80) {
+			return -1;
+		}
+		code = (code << 6) | (n & 0x3F);
+	}
+	return code;
+}
+
+uint32_t StrRange::hash() const {
+	return String::hash(c_str, len);
+}
+
+uint32_t Utf8Range::hash() const {
+	const uint8_t *utf8 = (const uint8_t *)c_str;
+	uint32_t hashv = 5381;
+	int ofs = 0;
+	while (ofs < len) {
+		int32_t c = _utf8_decode_next(utf8, len, ofs);
+		if (c <= 0) {
+			break;
+		}
+		hashv = ((hashv << 5) + hashv) + c; /* hash * 33 + c */
+	}
+	return hashv;
+}
+
+bool Utf8Range::is_valid() const {
+	const uint8_t *utf8 = (const uint8_t *)c_str;
+	int ofs = 0;
+	while (ofs < len) {
+		if (_utf8_decode_next(utf8, len, ofs) < 0) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool String::operator==(const Utf8Range &p_utf8_range) const {
+	const uint8_t *utf8 = (const uint8_t *)p_utf8_range.c_str;
+	const char32_t *dst = ptr();
+	int len = length();
+	int i = 0;
+	int ofs = 0;
+
+	while (ofs < p_utf8_range.len) {
+		if (i == len || _utf8_decode_next(utf8, p_utf8_range.len, ofs) != (int32_t)dst[i]) {
+			return false;
+		}
+		i++;
+	}
+	return i == len;
+}
+
 bool String::operator==(const StrRange &p_str_range) const {
 	int len = p_str_range.len;
 
@@ -1732,6 +1812,13 @@ String::String(const StrRange &p_range) {
 	copy_from(p_range.c_str, p_range.len);
 }
 
+String::String(const Utf8Range &p_range) {
+	if (!p_range.c_str)
+		return;
+
+	parse_utf8(p_range.c_str, p_range.len);
+}
+
 int String::hex_to_int(bool p_with_prefix) const {
 	int len = length();
 	if (len == 0 || (p_with_prefix && len < 3)) {
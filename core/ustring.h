@@ -153,12 +153,28 @@ struct StrRange {
 	const char32_t *c_str;
 	int len;
 
+	uint32_t hash() const;
+
 	StrRange(const char32_t *p_c_str = NULL, int p_len = 0) {
 		c_str = p_c_str;
 		len = p_len;
 	}
 };
 
+// Non-owning view of UTF-8 text, decoded on the fly by the lookups accepting it.
+struct Utf8Range {
+	const char *c_str;
+	int len;
+
+	uint32_t hash() const; // Same as the hash of the decoded String.
+	bool is_valid() const;
+
+	explicit Utf8Range(const char *p_c_str = NULL, int p_len = -1) {
+		c_str = p_c_str;
+		len = (p_c_str && p_len < 0) ? strlen(p_c_str) : MAX(p_len, 0);
+	}
+};
+
 class String {
 	CowData<char32_t> _cowdata;
 	static const char32_t _null;
@@ -213,6 +229,7 @@ public:
 	bool operator==(const char *p_str) const;
 	bool operator==(const char32_t *p_str) const;
 	bool operator==(const StrRange &p_str_range) const;
+	bool operator==(const Utf8Range &p_utf8_range) const;
 	bool operator!=(const char *p_str) const;
 	bool operator!=(const char32_t *p_str) const;
 	bool operator<(const char32_t *p_str) const;
@@ -405,6 +422,7 @@ public:
 	String(const char *p_str);
 	String(const char32_t *p_str, int p_clip_to_len = -1);
 	String(const StrRange &p_range);
+	String(const Utf8Range &p_range);
 };
 
 bool operator==(const char *p_chr, const String &p_str);
@@ -138,6 +138,7 @@ public:
 
 private:
 	friend struct _VariantCall;
+	friend struct _VariantValidated;
 	// Variant takes 20 bytes when real_t is float, and 36 if double
 	// it only allocates extra memory for aabb/matrix.
 
@@ -364,6 +365,16 @@ public:
 		return res;
 	}
 
+	// Direct implementations for operands whose types were already checked by the caller.
+	// They return NULL when the combination has no such implementation.
+	typedef void (*ValidatedOperatorEvaluator)(const Variant &p_a, const Variant &p_b, Variant &r_ret);
+	typedef void (*ValidatedGetter)(const Variant &p_base, Variant &r_ret);
+	typedef bool (*ValidatedSetter)(Variant &p_base, const Variant &p_value); // False if the value type does not fit.
+
+	static ValidatedOperatorEvaluator get_validated_operator_evaluator(Operator p_op, Type p_a, Type p_b);
+	static ValidatedGetter get_validated_getter(Type p_type, const StringName &p_member);
+	static ValidatedSetter get_validated_setter(Type p_type, const StringName &p_member);
+
 	void zero();
 	Variant duplicate(bool deep = false) const;
 	static void blend(const Variant &a, const Variant &b, float c, Variant &r_dst);
@@ -383,7 +394,15 @@ public:
 		Type expected;
 	};
 
+	// Built-in method a call site resolved last. It is looked up again when the base changes type.
+	struct CallSiteCache {
+		const void *method;
+		CallSiteCache() { method = NULL; }
+	};
+
 	void call_ptr(const StringName &p_method, const Variant **p_args, int p_argcount, Variant *r_ret, CallError &r_error);
+	static bool resolve_call_site(Type p_type, const StringName &p_method, CallSiteCache &r_cache);
+	void call_cached(const StringName &p_method, CallSiteCache &r_cache, const Variant **p_args, int p_argcount, Variant *r_ret, CallError &r_error);
 	Variant call(const StringName &p_method, const Variant **p_args, int p_argcount, CallError &r_error);
 	Variant call(const StringName &p_method, const Variant &p_arg1 = Variant(), const Variant &p_arg2 = Variant(), const Variant &p_arg3 = Variant(), const Variant &p_arg4 = Variant(), const Variant &p_arg5 = Variant());
 
@@ -34,6 +34,7 @@
 #include "core/core_string_names.h"
 #include "core/crypto/crypto_core.h"
 #include "core/io/compression.h"
+#include "core/local_vector.h"
 #include "core/object.h"
 #include "core/object_rc.h"
 #include "core/os/os.h"
@@ -48,6 +49,7 @@ struct _VariantCall {
 	}
 
 	struct FuncData {
+		Variant::Type self_type;
 		int arg_count;
 		Vector<Variant> default_args;
 		Vector<Variant::Type> arg_types;
@@ -119,8 +121,89 @@ struct _VariantCall {
 		}
 	};
 
+	struct LookupEntry {
+		const void *name;
+		FuncData *data;
+	};
+
 	struct TypeFunc {
 		Map<StringName, FuncData> functions;
+
+		// Perfect hash over the method names, built once every method is registered.
+		LookupEntry *lookup;
+		uint32_t lookup_seed;
+		uint32_t lookup_shift;
+
+		_FORCE_INLINE_ static uint32_t lookup_index(uint32_t p_hash, uint32_t p_seed, uint32_t p_shift) {
+			return ((p_hash ^ p_seed) * 0x9E3779B1) >> p_shift;
+		}
+
+		_FORCE_INLINE_ FuncData *find(const StringName &p_name) {
+			if (likely(lookup)) {
+				const LookupEntry &entry = lookup[lookup_index(p_name.hash(), lookup_seed, lookup_shift)];
+				return entry.name == p_name.data_unique_pointer() ? entry.data : NULL;
+			}
+			Map<StringName, FuncData>::Element *E = functions.find(p_name);
+			return E ? &E->get() : NULL;
+		}
+
+		void build_lookup() {
+			int count = functions.size();
+			if (count == 0) {
+				return;
+			}
+
+			uint32_t min_bits = 1;
+			while ((1 << min_bits) < count) {
+				min_bits++;
+			}
+
+			LocalVector<uint8_t> used;
+			for (uint32_t bits = min_bits + 1; bits <= min_bits + 4; bits++) {
+				uint32_t size = 1 << bits;
+				uint32_t shift = 32 - bits;
+				used.resize(size);
+
+				for (uint32_t seed = 0; seed < 1024; seed++) {
+					memset(used.ptr(), 0, size);
+					bool collision = false;
+					for (Map<StringName, FuncData>::Element *E = functions.front(); E; E = E->next()) {
+						uint32_t idx = lookup_index(E->key().hash(), seed, shift);
+						if (used[idx]) {
+							collision = true;
+							break;
+						}
+						used[idx] = 1;
+					}
+					if (collision) {
+						continue;
+					}
+
+					lookup = memnew_arr(LookupEntry, size);
+					memset(lookup, 0, sizeof(LookupEntry) * size);
+					for (Map<StringName, FuncData>::Element *E = functions.front(); E; E = E->next()) {
+						LookupEntry &entry = lookup[lookup_index(E->key().hash(), seed, shift)];
+						entry.name = E->key().data_unique_pointer();
+						entry.data = &E->get();
+					}
+					lookup_seed = seed;
+					lookup_shift = shift;
+					return;
+				}
+			}
+			// No seed found, lookups keep using the map.
+		}
+
+		TypeFunc() {
+			lookup = NULL;
+			lookup_seed = 0;
+			lookup_shift = 0;
+		}
+		~TypeFunc() {
+			if (lookup) {
+				memdelete_arr(lookup);
+			}
+		}
 	};
 
 	static TypeFunc *type_funcs;
@@ -145,6 +228,7 @@ struct _VariantCall {
 
 	static void addfunc(bool p_const, Variant::Type p_type, Variant::Type p_return, bool p_has_return, const StringName &p_name, VariantFunc p_func, const Vector<Variant> &p_defaultarg, const Arg &p_argtype1 = Arg(), const Arg &p_argtype2 = Arg(), const Arg &p_argtype3 = Arg(), const Arg &p_argtype4 = Arg(), const Arg &p_argtype5 = Arg()) {
 		FuncData funcdata;
+		funcdata.self_type = p_type;
 		funcdata.func = p_func;
 		funcdata.default_args = p_defaultarg;
 		funcdata._const = p_const;
@@ -1122,21 +1206,53 @@ void Variant::call_ptr(const StringName &p_method, const Variant **p_args, int p
 	} else {
 		r_error.error = Variant::CallError::CALL_OK;
 
-		Map<StringName, _VariantCall::FuncData>::Element *E = _VariantCall::type_funcs[type].functions.find(p_method);
+		_VariantCall::FuncData *funcdata = _VariantCall::type_funcs[type].find(p_method);
 #ifdef DEBUG_ENABLED
-		if (!E) {
+		if (!funcdata) {
 			r_error.error = Variant::CallError::CALL_ERROR_INVALID_METHOD;
 			return;
 		}
 #endif
-		_VariantCall::FuncData &funcdata = E->get();
-		funcdata.call(ret, *this, p_args, p_argcount, r_error);
+		funcdata->call(ret, *this, p_args, p_argcount, r_error);
 	}
 
 	if (r_error.error == Variant::CallError::CALL_OK && r_ret)
 		*r_ret = ret;
 }
 
+bool Variant::resolve_call_site(Type p_type, const StringName &p_method, CallSiteCache &r_cache) {
+	ERR_FAIL_INDEX_V(p_type, VARIANT_MAX, false);
+	if (p_type == OBJECT) {
+		return false;
+	}
+	r_cache.method = _VariantCall::type_funcs[p_type].find(p_method);
+	return r_cache.method != NULL;
+}
+
+void Variant::call_cached(const StringName &p_method, CallSiteCache &r_cache, const Variant **p_args, int p_argcount, Variant *r_ret, CallError &r_error) {
+	if (type == Variant::OBJECT) {
+		call_ptr(p_method, p_args, p_argcount, r_ret, r_error);
+		return;
+	}
+
+	_VariantCall::FuncData *funcdata = (_VariantCall::FuncData *)r_cache.method;
+	if (unlikely(!funcdata || funcdata->self_type != type)) {
+		funcdata = _VariantCall::type_funcs[type].find(p_method);
+		if (!funcdata) {
+			r_error.error = Variant::CallError::CALL_ERROR_INVALID_METHOD;
+			return;
+		}
+		r_cache.method = funcdata;
+	}
+
+	r_error.error = Variant::CallError::CALL_OK;
+	Variant ret;
+	funcdata->call(ret, *this, p_args, p_argcount, r_error);
+
+	if (r_error.error == Variant::CallError::CALL_OK && r_ret)
+		*r_ret = ret;
+}
+
 #define VCALL(m_type, m_method) _VariantCall::_call_##m_type##_##m_method
 
 Variant Variant::construct(const Variant::Type p_type, const Variant **p_args, int p_argcount, CallError &r_error, bool p_strict) {
@@ -1326,8 +1442,7 @@ bool Variant::has_method(const StringName &p_method) const {
 		return obj->has_method(p_method);
 	}
 
-	const _VariantCall::TypeFunc &tf = _VariantCall::type_funcs[type];
-	return tf.functions.has(p_method);
+	return _VariantCall::type_funcs[type].find(p_method) != NULL;
 }
 
 Vector<Variant::Type> Variant::get_method_argument_types(Variant::Type p_type, const StringName &p_method) {
@@ -2076,6 +2191,10 @@ void register_variant_methods() {
 	_VariantCall::add_variant_constant(Variant::PLANE, "PLANE_XY", Plane(Vector3(0, 0, 1), 0));
 
 	_VariantCall::add_variant_constant(Variant::QUAT, "IDENTITY", Quat(0, 0, 0, 1));
+
+	for (int i = 0; i < Variant::VARIANT_MAX; i++) {
+		_VariantCall::type_funcs[i].build_lookup();
+	}
 }
 
 void unregister_variant_methods() {
@@ -1732,6 +1732,251 @@ Variant Variant::get_named(const StringName &p_index, bool *r_valid) const {
 	return Variant();
 }
 
+struct _VariantValidated {
+	_FORCE_INLINE_ static int64_t i(const Variant &p_v) { return p_v._data._int; }
+	_FORCE_INLINE_ static double r(const Variant &p_v) { return p_v._data._real; }
+	_FORCE_INLINE_ static bool b(const Variant &p_v) { return p_v._data._bool; }
+	template <class T>
+	_FORCE_INLINE_ static const T &m(const Variant &p_v) { return *reinterpret_cast<const T *>(p_v._data._mem); }
+	template <class T>
+	_FORCE_INLINE_ static T &w(Variant &p_v) { return *reinterpret_cast<T *>(p_v._data._mem); }
+
+	// Results are written in place when the destination already holds the right type,
+	// which is the common case for VM temporaries reused across iterations.
+	_FORCE_INLINE_ static void ret(Variant &r_ret, bool p_value) {
+		if (r_ret.type == Variant::BOOL) {
+			r_ret._data._bool = p_value;
+		} else {
+			r_ret = p_value;
+		}
+	}
+	_FORCE_INLINE_ static void ret(Variant &r_ret, int64_t p_value) {
+		if (r_ret.type == Variant::INT) {
+			r_ret._data._int = p_value;
+		} else {
+			r_ret = p_value;
+		}
+	}
+	_FORCE_INLINE_ static void ret(Variant &r_ret, double p_value) {
+		if (r_ret.type == Variant::REAL) {
+			r_ret._data._real = p_value;
+		} else {
+			r_ret = p_value;
+		}
+	}
+	template <class T>
+	_FORCE_INLINE_ static void ret_local(Variant &r_ret, Variant::Type p_type, T p_value) {
+		if (r_ret.type == p_type) {
+			w<T>(r_ret) = p_value;
+		} else {
+			r_ret = p_value;
+		}
+	}
+	_FORCE_INLINE_ static void ret(Variant &r_ret, const Vector2 &p_value) { ret_local<Vector2>(r_ret, Variant::VECTOR2, p_value); }
+	_FORCE_INLINE_ static void ret(Variant &r_ret, const Vector3 &p_value) { ret_local<Vector3>(r_ret, Variant::VECTOR3, p_value); }
+	_FORCE_INLINE_ static void ret(Variant &r_ret, const Basis &p_value) { r_ret = p_value; }
+
+	template <class T>
+	_FORCE_INLINE_ static bool num(const Variant &p_v, T &r_value) {
+		if (p_v.type == Variant::REAL) {
+			r_value = p_v._data._real;
+		} else if (p_v.type == Variant::INT) {
+			r_value = p_v._data._int;
+		} else {
+			return false;
+		}
+		return true;
+	}
+
+#define VALIDATED_OPERATORS(X)                                          \
+	X(OP_EQUAL, BOOL, BOOL, b(p_a) == b(p_b))                           \
+	X(OP_NOT_EQUAL, BOOL, BOOL, b(p_a) != b(p_b))                       \
+	X(OP_NOT, BOOL, BOOL, !b(p_a))                                      \
+	X(OP_EQUAL, INT, INT, i(p_a) == i(p_b))                             \
+	X(OP_NOT_EQUAL, INT, INT, i(p_a) != i(p_b))                         \
+	X(OP_LESS, INT, INT, i(p_a) < i(p_b))                               \
+	X(OP_LESS_EQUAL, INT, INT, i(p_a) <= i(p_b))                        \
+	X(OP_GREATER, INT, INT, i(p_a) > i(p_b))                            \
+	X(OP_GREATER_EQUAL, INT, INT, i(p_a) >= i(p_b))                     \
+	X(OP_ADD, INT, INT, i(p_a) + i(p_b))                                \
+	X(OP_SUBTRACT, INT, INT, i(p_a) - i(p_b))                           \
+	X(OP_MULTIPLY, INT, INT, i(p_a) * i(p_b))                           \
+	X(OP_NEGATE, INT, INT, -i(p_a))                                     \
+	X(OP_POSITIVE, INT, INT, i(p_a))                                    \
+	X(OP_BIT_AND, INT, INT, i(p_a) & i(p_b))                            \
+	X(OP_BIT_OR, INT, INT, i(p_a) | i(p_b))                             \
+	X(OP_BIT_XOR, INT, INT, i(p_a) ^ i(p_b))                            \
+	X(OP_BIT_NEGATE, INT, INT, ~i(p_a))                                 \
+	X(OP_EQUAL, REAL, REAL, r(p_a) == r(p_b))                           \
+	X(OP_NOT_EQUAL, REAL, REAL, r(p_a) != r(p_b))                       \
+	X(OP_LESS, REAL, REAL, r(p_a) < r(p_b))                             \
+	X(OP_LESS_EQUAL, REAL, REAL, r(p_a) <= r(p_b))                      \
+	X(OP_GREATER, REAL, REAL, r(p_a) > r(p_b))                          \
+	X(OP_GREATER_EQUAL, REAL, REAL, r(p_a) >= r(p_b))                   \
+	X(OP_ADD, REAL, REAL, r(p_a) + r(p_b))                              \
+	X(OP_SUBTRACT, REAL, REAL, r(p_a) - r(p_b))                         \
+	X(OP_MULTIPLY, REAL, REAL, r(p_a) * r(p_b))                         \
+	X(OP_NEGATE, REAL, REAL, -r(p_a))                                   \
+	X(OP_POSITIVE, REAL, REAL, r(p_a))                                  \
+	X(OP_EQUAL, INT, REAL, i(p_a) == r(p_b))                            \
+	X(OP_NOT_EQUAL, INT, REAL, i(p_a) != r(p_b))                        \
+	X(OP_LESS, INT, REAL, i(p_a) < r(p_b))                              \
+	X(OP_LESS_EQUAL, INT, REAL, i(p_a) <= r(p_b))                       \
+	X(OP_GREATER, INT, REAL, i(p_a) > r(p_b))                           \
+	X(OP_GREATER_EQUAL, INT, REAL, i(p_a) >= r(p_b))                    \
+	X(OP_ADD, INT, REAL, i(p_a) + r(p_b))                               \
+	X(OP_SUBTRACT, INT, REAL, i(p_a) - r(p_b))                          \
+	X(OP_MULTIPLY, INT, REAL, i(p_a) * r(p_b))                          \
+	X(OP_EQUAL, REAL, INT, r(p_a) == i(p_b))                            \
+	X(OP_NOT_EQUAL, REAL, INT, r(p_a) != i(p_b))                        \
+	X(OP_LESS, REAL, INT, r(p_a) < i(p_b))                              \
+	X(OP_LESS_EQUAL, REAL, INT, r(p_a) <= i(p_b))                       \
+	X(OP_GREATER, REAL, INT, r(p_a) > i(p_b))                           \
+	X(OP_GREATER_EQUAL, REAL, INT, r(p_a) >= i(p_b))                    \
+	X(OP_ADD, REAL, INT, r(p_a) + i(p_b))                               \
+	X(OP_SUBTRACT, REAL, INT, r(p_a) - i(p_b))                          \
+	X(OP_MULTIPLY, REAL, INT, r(p_a) * i(p_b))                          \
+	X(OP_EQUAL, VECTOR2, VECTOR2, m<Vector2>(p_a) == m<Vector2>(p_b))   \
+	X(OP_NOT_EQUAL, VECTOR2, VECTOR2, m<Vector2>(p_a) != m<Vector2>(p_b)) \
+	X(OP_ADD, VECTOR2, VECTOR2, m<Vector2>(p_a) + m<Vector2>(p_b))      \
+	X(OP_SUBTRACT, VECTOR2, VECTOR2, m<Vector2>(p_a) - m<Vector2>(p_b)) \
+	X(OP_MULTIPLY, VECTOR2, VECTOR2, m<Vector2>(p_a) * m<Vector2>(p_b)) \
+	X(OP_MULTIPLY, VECTOR2, REAL, m<Vector2>(p_a) * r(p_b))             \
+	X(OP_MULTIPLY, VECTOR2, INT, m<Vector2>(p_a) * i(p_b))              \
+	X(OP_MULTIPLY, REAL, VECTOR2, r(p_a) * m<Vector2>(p_b))             \
+	X(OP_MULTIPLY, INT, VECTOR2, i(p_a) * m<Vector2>(p_b))              \
+	X(OP_NEGATE, VECTOR2, VECTOR2, -m<Vector2>(p_a))                    \
+	X(OP_EQUAL, VECTOR3, VECTOR3, m<Vector3>(p_a) == m<Vector3>(p_b))   \
+	X(OP_NOT_EQUAL, VECTOR3, VECTOR3, m<Vector3>(p_a) != m<Vector3>(p_b)) \
+	X(OP_ADD, VECTOR3, VECTOR3, m<Vector3>(p_a) + m<Vector3>(p_b))      \
+	X(OP_SUBTRACT, VECTOR3, VECTOR3, m<Vector3>(p_a) - m<Vector3>(p_b)) \
+	X(OP_MULTIPLY, VECTOR3, VECTOR3, m<Vector3>(p_a) * m<Vector3>(p_b)) \
+	X(OP_MULTIPLY, VECTOR3, REAL, m<Vector3>(p_a) * r(p_b))             \
+	X(OP_MULTIPLY, VECTOR3, INT, m<Vector3>(p_a) * i(p_b))              \
+	X(OP_MULTIPLY, REAL, VECTOR3, r(p_a) * m<Vector3>(p_b))             \
+	X(OP_MULTIPLY, INT, VECTOR3, i(p_a) * m<Vector3>(p_b))              \
+	X(OP_NEGATE, VECTOR3, VECTOR3, -m<Vector3>(p_a))
+
+#define VALIDATED_GETTERS(X)                           \
+	X(VECTOR2, x, m<Vector2>(p_base).x)                \
+	X(VECTOR2, y, m<Vector2>(p_base).y)                \
+	X(RECT2, position, m<Rect2>(p_base).position)      \
+	X(RECT2, size, m<Rect2>(p_base).size)              \
+	X(VECTOR3, x, m<Vector3>(p_base).x)                \
+	X(VECTOR3, y, m<Vector3>(p_base).y)                \
+	X(VECTOR3, z, m<Vector3>(p_base).z)                \
+	X(TRANSFORM2D, origin, p_base._data._transform2d->elements[2]) \
+	X(PLANE, normal, m<Plane>(p_base).normal)          \
+	X(PLANE, d, m<Plane>(p_base).d)                    \
+	X(QUAT, x, m<Quat>(p_base).x)                      \
+	X(QUAT, y, m<Quat>(p_base).y)                      \
+	X(QUAT, z, m<Quat>(p_base).z)                      \
+	X(QUAT, w, m<Quat>(p_base).w)                      \
+	X(AABB, position, p_base._data._aabb->position)    \
+	X(AABB, size, p_base._data._aabb->size)            \
+	X(TRANSFORM, basis, p_base._data._transform->basis) \
+	X(TRANSFORM, origin, p_base._data._transform->origin) \
+	X(COLOR, r, m<Color>(p_base).r)                    \
+	X(COLOR, g, m<Color>(p_base).g)                    \
+	X(COLOR, b, m<Color>(p_base).b)                    \
+	X(COLOR, a, m<Color>(p_base).a)
+
+// Scalar members take int or real values, like set_named() does.
+#define VALIDATED_SCALAR_SETTERS(X)   \
+	X(VECTOR2, x, w<Vector2>(p_base).x) \
+	X(VECTOR2, y, w<Vector2>(p_base).y) \
+	X(VECTOR3, x, w<Vector3>(p_base).x) \
+	X(VECTOR3, y, w<Vector3>(p_base).y) \
+	X(VECTOR3, z, w<Vector3>(p_base).z) \
+	X(PLANE, d, w<Plane>(p_base).d)     \
+	X(QUAT, x, w<Quat>(p_base).x)       \
+	X(QUAT, y, w<Quat>(p_base).y)       \
+	X(QUAT, z, w<Quat>(p_base).z)       \
+	X(QUAT, w, w<Quat>(p_base).w)       \
+	X(COLOR, r, w<Color>(p_base).r)     \
+	X(COLOR, g, w<Color>(p_base).g)     \
+	X(COLOR, b, w<Color>(p_base).b)     \
+	X(COLOR, a, w<Color>(p_base).a)
+
+#define VALIDATED_SETTERS(X)                                                   \
+	X(RECT2, position, VECTOR2, w<Rect2>(p_base).position = m<Vector2>(p_value)) \
+	X(RECT2, size, VECTOR2, w<Rect2>(p_base).size = m<Vector2>(p_value))         \
+	X(TRANSFORM2D, origin, VECTOR2, p_base._data._transform2d->elements[2] = m<Vector2>(p_value)) \
+	X(PLANE, normal, VECTOR3, w<Plane>(p_base).normal = m<Vector3>(p_value))     \
+	X(AABB, position, VECTOR3, p_base._data._aabb->position = m<Vector3>(p_value)) \
+	X(AABB, size, VECTOR3, p_base._data._aabb->size = m<Vector3>(p_value))       \
+	X(TRANSFORM, basis, BASIS, p_base._data._transform->basis = *p_value._data._basis) \
+	X(TRANSFORM, origin, VECTOR3, p_base._data._transform->origin = m<Vector3>(p_value))
+
+#define MAKE_OPERATOR(m_op, m_a, m_b, m_expr)                                                \
+	static void m_op##_##m_a##_##m_b(const Variant &p_a, const Variant &p_b, Variant &r_ret) { \
+		ret(r_ret, m_expr);                                                                    \
+	}
+	VALIDATED_OPERATORS(MAKE_OPERATOR)
+#undef MAKE_OPERATOR
+
+#define MAKE_GETTER(m_type, m_member, m_expr)                                    \
+	static void get_##m_type##_##m_member(const Variant &p_base, Variant &r_ret) { \
+		ret(r_ret, m_expr);                                                        \
+	}
+	VALIDATED_GETTERS(MAKE_GETTER)
+#undef MAKE_GETTER
+
+#define MAKE_SCALAR_SETTER(m_type, m_member, m_field)                            \
+	static bool set_##m_type##_##m_member(Variant &p_base, const Variant &p_value) { \
+		return num(p_value, m_field);                                              \
+	}
+	VALIDATED_SCALAR_SETTERS(MAKE_SCALAR_SETTER)
+#undef MAKE_SCALAR_SETTER
+
+#define MAKE_SETTER(m_type, m_member, m_value_type, m_assign)                    \
+	static bool set_##m_type##_##m_member(Variant &p_base, const Variant &p_value) { \
+		if (p_value.type != Variant::m_value_type) {                               \
+			return false;                                                          \
+		}                                                                          \
+		m_assign;                                                                  \
+		return true;                                                               \
+	}
+	VALIDATED_SETTERS(MAKE_SETTER)
+#undef MAKE_SETTER
+};
+
+Variant::ValidatedOperatorEvaluator Variant::get_validated_operator_evaluator(Operator p_op, Type p_a, Type p_b) {
+#define MATCH_OPERATOR(m_op, m_a, m_b, m_expr)      \
+	if (p_op == m_op && p_a == m_a && p_b == m_b) { \
+		return _VariantValidated::m_op##_##m_a##_##m_b; \
+	}
+	VALIDATED_OPERATORS(MATCH_OPERATOR)
+#undef MATCH_OPERATOR
+	return NULL;
+}
+
+Variant::ValidatedGetter Variant::get_validated_getter(Type p_type, const StringName &p_member) {
+#define MATCH_GETTER(m_type, m_member, m_expr)                                 \
+	if (p_type == m_type && p_member == CoreStringNames::singleton->m_member) { \
+		return _VariantValidated::get_##m_type##_##m_member;                    \
+	}
+	VALIDATED_GETTERS(MATCH_GETTER)
+#undef MATCH_GETTER
+	return NULL;
+}
+
+Variant::ValidatedSetter Variant::get_validated_setter(Type p_type, const StringName &p_member) {
+#define MATCH_SETTER(m_type, m_member, ...)                                    \
+	if (p_type == m_type && p_member == CoreStringNames::singleton->m_member) { \
+		return _VariantValidated::set_##m_type##_##m_member;                    \
+	}
+	VALIDATED_SCALAR_SETTERS(MATCH_SETTER)
+	VALIDATED_SETTERS(MATCH_SETTER)
+#undef MATCH_SETTER
+	return NULL;
+}
+
+#undef VALIDATED_OPERATORS
+#undef VALIDATED_GETTERS
+#undef VALIDATED_SCALAR_SETTERS
+#undef VALIDATED_SETTERS
+
 #define DEFAULT_OP_ARRAY_CMD(m_name, m_type, skip_test, cmd)                             \
 	case m_name: {                                                                       \
 		skip_test;                                                                       \
@@ -148,6 +148,8 @@ void RasterizerCanvasBaseGLES2::canvas_end() {
 	state.using_skeleton = false;
 	state.using_ninepatch = false;
 	state.using_transparent_rt = false;
+	state.item_distance_field = false;
+	state.using_distance_field = false;
 }
 
 void RasterizerCanvasBaseGLES2::draw_generic_textured_rect(const Rect2 &p_rect, const Rect2 &p_src) {
@@ -177,6 +179,15 @@ void RasterizerCanvasBaseGLES2::_set_texture_rect_mode(bool p_texture_rect, bool
 	}
 }
 
+// Items can turn the distance field mode on as a whole, glyph runs of distance field fonts turn it on for their own draws.
+void RasterizerCanvasBaseGLES2::_set_distance_field_mode(bool p_enable) {
+	bool distance_field = state.item_distance_field || p_enable;
+	if (state.using_distance_field != distance_field) {
+		state.using_distance_field = distance_field;
+		state.canvas_shader.set_conditional(CanvasShaderGLES2::USE_DISTANCE_FIELD, distance_field);
+	}
+}
+
 RasterizerStorageGLES2::Texture *RasterizerCanvasBaseGLES2::_bind_canvas_texture(const RID &p_texture, const RID &p_normal_map) {
 	RasterizerStorageGLES2::Texture *tex_return = NULL;
 
@@ -517,6 +528,56 @@ void RasterizerCanvasBaseGLES2::_draw_polygon(const int *p_indices, int p_index_
 	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 }
 
+void RasterizerCanvasBaseGLES2::_draw_glyph_run(const Item::CommandGlyphRun *p_run, const Size2 &p_texpixel_size) {
+	// drawn in chunks so that long runs always fit in the polygon buffer
+	const int CHUNK_GLYPHS = 64;
+
+	Vector2 points[CHUNK_GLYPHS * 4];
+	Vector2 uvs[CHUNK_GLYPHS * 4];
+	Color colors[CHUNK_GLYPHS * 4];
+	int indices[CHUNK_GLYPHS * 6];
+
+	for (int i = 0; i < CHUNK_GLYPHS; i++) {
+		int v = i * 4;
+		int *idx = &indices[i * 6];
+		idx[0] = v;
+		idx[1] = v + 1;
+		idx[2] = v + 2;
+		idx[3] = v;
+		idx[4] = v + 2;
+		idx[5] = v + 3;
+	}
+
+	int num_glyphs = p_run->rects.size();
+	const Rect2 *rects = p_run->rects.ptr();
+	const Rect2 *sources = p_run->sources.ptr();
+	const Color *glyph_colors = p_run->colors.ptr();
+
+	for (int from = 0; from < num_glyphs; from += CHUNK_GLYPHS) {
+		int count = MIN(CHUNK_GLYPHS, num_glyphs - from);
+
+		for (int i = 0; i < count; i++) {
+			const Rect2 &rect = rects[from + i];
+			Rect2 src(sources[from + i].position * p_texpixel_size, sources[from + i].size * p_texpixel_size);
+			int v = i * 4;
+
+			points[v] = rect.position;
+			points[v + 1] = rect.position + Vector2(rect.size.x, 0);
+			points[v + 2] = rect.position + rect.size;
+			points[v + 3] = rect.position + Vector2(0, rect.size.y);
+
+			uvs[v] = src.position;
+			uvs[v + 1] = src.position + Vector2(src.size.x, 0);
+			uvs[v + 2] = src.position + src.size;
+			uvs[v + 3] = src.position + Vector2(0, src.size.y);
+
+			colors[v] = colors[v + 1] = colors[v + 2] = colors[v + 3] = glyph_colors[from + i];
+		}
+
+		_draw_polygon(indices, count * 6, count * 4, points, uvs, colors, false);
+	}
+}
+
 void RasterizerCanvasBaseGLES2::_draw_generic(GLuint p_primitive, int p_vertex_count, const Vector2 *p_vertices, const Vector2 *p_uvs, const Color *p_colors, bool p_singlecolor) {
 	glBindBuffer(GL_ARRAY_BUFFER, data.polygon_buffer);
 
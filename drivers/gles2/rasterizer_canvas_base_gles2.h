@@ -86,6 +86,9 @@ public:
 		bool using_ninepatch;
 		bool using_skeleton;
 
+		bool item_distance_field;
+		bool using_distance_field;
+
 		Transform2D skeleton_transform;
 		Transform2D skeleton_transform_inverse;
 		Size2i skeleton_texture_size;
@@ -121,6 +124,7 @@ public:
 
 	void _draw_gui_primitive(int p_points, const Vector2 *p_vertices, const Color *p_colors, const Vector2 *p_uvs, const float *p_light_angles = nullptr);
 	void _draw_polygon(const int *p_indices, int p_index_count, int p_vertex_count, const Vector2 *p_vertices, const Vector2 *p_uvs, const Color *p_colors, bool p_singlecolor, const float *p_weights = NULL, const int *p_bones = NULL);
+	void _draw_glyph_run(const Item::CommandGlyphRun *p_run, const Size2 &p_texpixel_size);
 	void _draw_generic(GLuint p_primitive, int p_vertex_count, const Vector2 *p_vertices, const Vector2 *p_uvs, const Color *p_colors, bool p_singlecolor);
 	void _draw_generic_indices(GLuint p_primitive, const int *p_indices, int p_index_count, int p_vertex_count, const Vector2 *p_vertices, const Vector2 *p_uvs, const Color *p_colors, bool p_singlecolor);
 
@@ -138,6 +142,7 @@ public:
 
 	RasterizerStorageGLES2::Texture *_bind_canvas_texture(const RID &p_texture, const RID &p_normal_map);
 	void _set_texture_rect_mode(bool p_texture_rect, bool p_light_angle = false, bool p_modulate = false, bool p_large_vertex = false);
+	void _set_distance_field_mode(bool p_enable);
 
 	void initialize();
 	void finalize();
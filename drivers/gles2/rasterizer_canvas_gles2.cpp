@@ -182,6 +182,8 @@ void RasterizerCanvasGLES2::_batch_render_generic(const Batch &p_batch, Rasteriz
 		state.canvas_shader.set_conditional(CanvasShaderGLES2::USE_FORCE_REPEAT, true);
 	}
 
+	_set_distance_field_mode(tex.distance_field);
+
 	if (state.canvas_shader.bind()) {
 		_set_uniforms();
 		state.canvas_shader.use_material((void *)p_material);
@@ -281,6 +283,8 @@ void RasterizerCanvasGLES2::_batch_render_generic(const Batch &p_batch, Rasteriz
 		} break;
 	}
 
+	_set_distance_field_mode(false);
+
 	// could these have ifs?
 	glDisableVertexAttribArray(VS::ARRAY_TEX_UV);
 	glDisableVertexAttribArray(VS::ARRAY_COLOR);
@@ -850,6 +854,28 @@ void RasterizerCanvasGLES2::render_batches(Item *p_current_clip, bool &r_reclip,
 							}
 #endif
 						} break;
+						case Item::Command::TYPE_GLYPH_RUN: {
+							Item::CommandGlyphRun *run = static_cast<Item::CommandGlyphRun *>(command);
+
+							_set_texture_rect_mode(false);
+							_set_distance_field_mode(run->distance_field);
+
+							if (state.canvas_shader.bind()) {
+								_set_uniforms();
+								state.canvas_shader.use_material((void *)p_material);
+							}
+
+							RasterizerStorageGLES2::Texture *texture = _bind_canvas_texture(run->texture, RID());
+
+							if (texture) {
+								Size2 texpixel_size(1.0 / texture->width, 1.0 / texture->height);
+								state.canvas_shader.set_uniform(CanvasShaderGLES2::COLOR_TEXPIXEL_SIZE, texpixel_size);
+
+								_draw_glyph_run(run, texpixel_size);
+							}
+
+							_set_distance_field_mode(false);
+						} break;
 						case Item::Command::TYPE_MESH: {
 							Item::CommandMesh *mesh = static_cast<Item::CommandMesh *>(command);
 
@@ -1211,6 +1237,9 @@ void RasterizerCanvasGLES2::canvas_render_items_implementation(Item *p_item_list
 	ris.item_group_base_transform = p_base_transform;
 
 	state.canvas_shader.set_conditional(CanvasShaderGLES2::USE_SKELETON, false);
+	state.canvas_shader.set_conditional(CanvasShaderGLES2::USE_DISTANCE_FIELD, false);
+	state.item_distance_field = false;
+	state.using_distance_field = false;
 
 	state.current_tex = RID();
 	state.current_tex_ptr = NULL;
@@ -1276,6 +1305,12 @@ bool RasterizerCanvasGLES2::try_join_item(Item *p_ci, RenderItemState &r_ris, bo
 		join = false;
 	}
 
+	// the distance field mode is a shader conditional, so it can't change within a batch
+	if (r_ris.prev_distance_field != p_ci->distance_field) {
+		r_ris.prev_distance_field = p_ci->distance_field;
+		join = false;
+	}
+
 	// TODO: copy back buffer
 
 	if (p_ci->copy_back_buffer) {
@@ -1555,6 +1590,14 @@ bool RasterizerCanvasGLES2::try_join_item(Item *p_ci, RenderItemState &r_ris, bo
 void RasterizerCanvasGLES2::_legacy_canvas_render_item(Item *p_ci, RenderItemState &r_ris) {
 	storage->info.render._2d_item_count++;
 
+	if (r_ris.prev_distance_field != p_ci->distance_field) {
+		state.item_distance_field = p_ci->distance_field;
+		state.using_distance_field = p_ci->distance_field;
+		state.canvas_shader.set_conditional(CanvasShaderGLES2::USE_DISTANCE_FIELD, p_ci->distance_field);
+		r_ris.prev_distance_field = p_ci->distance_field;
+		r_ris.rebind_shader = true;
+	}
+
 	if (r_ris.current_clip != p_ci->final_clip_owner) {
 		r_ris.current_clip = p_ci->final_clip_owner;
 
@@ -1912,6 +1955,14 @@ void RasterizerCanvasGLES2::render_joined_item(const BItemJoined &p_bij, RenderI
 	// all the joined items will share the same state with the first item
 	Item *ci = bdata.item_refs[p_bij.first_item_ref].item;
 
+	if (r_ris.prev_distance_field != ci->distance_field) {
+		state.item_distance_field = ci->distance_field;
+		state.using_distance_field = ci->distance_field;
+		state.canvas_shader.set_conditional(CanvasShaderGLES2::USE_DISTANCE_FIELD, ci->distance_field);
+		r_ris.prev_distance_field = ci->distance_field;
+		r_ris.rebind_shader = true;
+	}
+
 	if (r_ris.current_clip != ci->final_clip_owner) {
 		r_ris.current_clip = ci->final_clip_owner;
 
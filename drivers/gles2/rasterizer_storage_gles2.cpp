@@ -696,9 +696,58 @@ void RasterizerStorageGLES2::texture_set_data(RID p_texture, const Ref<Image> &p
 	texture->mipmaps = mipmaps;
 }
 
+// Uploads pixel data to a sub-region of a texture, for the specified mipmap.
+// The texture pixels must have been allocated before with texture_set_data().
 void RasterizerStorageGLES2::texture_set_data_partial(RID p_texture, const Ref<Image> &p_image, int src_x, int src_y, int src_w, int src_h, int dst_x, int dst_y, int p_dst_mip, int p_layer) {
-	// TODO
-	ERR_PRINT("Not implemented (ask Karroffel to do it :p)");
+	Texture *texture = texture_owner.getornull(p_texture);
+
+	ERR_FAIL_COND(!texture);
+	ERR_FAIL_COND(!texture->active);
+	ERR_FAIL_COND(texture->render_target);
+	ERR_FAIL_COND(p_image.is_null());
+	ERR_FAIL_COND(texture->format != p_image->get_format());
+	ERR_FAIL_COND(src_w <= 0 || src_h <= 0);
+	ERR_FAIL_COND(src_x < 0 || src_y < 0 || src_x + src_w > p_image->get_width() || src_y + src_h > p_image->get_height());
+	ERR_FAIL_COND(dst_x < 0 || dst_y < 0 || dst_x + src_w > texture->alloc_width || dst_y + src_h > texture->alloc_height);
+	ERR_FAIL_COND(p_dst_mip < 0 || p_dst_mip >= texture->mipmaps);
+	ERR_FAIL_COND(texture->type == VS::TEXTURE_TYPE_EXTERNAL);
+	// Resized or shrunk textures no longer map 1:1 to the source pixels.
+	ERR_FAIL_COND(texture->resize_to_po2 || texture->alloc_width != texture->width || texture->alloc_height != texture->height);
+
+	GLenum type;
+	GLenum format;
+	GLenum internal_format;
+	bool compressed = false;
+
+	// OpenGL wants data as a dense array, extract the sub-image if the source rect isn't the full image.
+	Ref<Image> sub_img = p_image;
+	if (src_x > 0 || src_y > 0 || src_w != p_image->get_width() || src_h != p_image->get_height()) {
+		sub_img = p_image->get_rect(Rect2(src_x, src_y, src_w, src_h));
+	}
+
+	Image::Format real_format;
+	Ref<Image> img = _get_gl_image_and_format(sub_img, sub_img->get_format(), texture->flags, real_format, format, internal_format, type, compressed, false);
+
+	GLenum blit_target = (texture->target == GL_TEXTURE_CUBE_MAP) ? _cube_side_enum[p_layer] : GL_TEXTURE_2D;
+
+	PoolVector<uint8_t>::Read read = img->get_data().read();
+	ERR_FAIL_COND(!read.ptr());
+
+	glActiveTexture(GL_TEXTURE0);
+	glBindTexture(texture->target, texture->tex_id);
+
+	if (compressed) {
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+		glCompressedTexSubImage2D(blit_target, p_dst_mip, dst_x, dst_y, src_w, src_h, internal_format, img->get_data().size(), read.ptr());
+	} else {
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+		// `format` has to match the internal_format used when the texture was created
+		glTexSubImage2D(blit_target, p_dst_mip, dst_x, dst_y, src_w, src_h, format, type, read.ptr());
+	}
+
+	if ((texture->flags & VS::TEXTURE_FLAG_MIPMAPS) && !texture->ignore_mipmaps && texture->mipmaps == 1) {
+		glGenerateMipmap(texture->target);
+	}
 }
 
 Ref<Image> RasterizerStorageGLES2::texture_get_data(RID p_texture, int p_layer) const {
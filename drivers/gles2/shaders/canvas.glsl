@@ -444,9 +444,20 @@ void main() {
 #endif
 
 #if !defined(COLOR_USED)
+#ifdef USE_DISTANCE_FIELD
+	float distance = texture2D(color_texture, uv).a;
+#ifdef USE_GLES_OVER_GL
+	float smoothing = clamp(fwidth(distance) * 0.75, 1.0 / 255.0, 0.25);
+#else
+	// Derivatives are an extension on GLES2.
+	const float smoothing = 1.0 / 32.0;
+#endif
+	color.a = smoothstep(0.5 - smoothing, 0.5 + smoothing, distance) * color.a;
+#else
 	//default behavior, texture by color
 	color *= texture2D(color_texture, uv);
 #endif
+#endif
 
 #ifdef SCREEN_UV_USED
 	vec2 screen_uv = gl_FragCoord.xy * screen_pixel_size;
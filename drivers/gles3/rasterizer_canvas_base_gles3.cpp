@@ -190,6 +190,9 @@ void RasterizerCanvasBaseGLES3::canvas_begin() {
 	state.using_modulate = false;
 	state.using_large_vertex = false;
 
+	state.item_distance_field = false;
+	state.using_distance_field = false;
+
 	state.using_skeleton = false;
 }
 
@@ -301,6 +304,28 @@ void RasterizerCanvasBaseGLES3::_set_texture_rect_mode(bool p_enable, bool p_nin
 	state.canvas_shader.set_conditional(CanvasShaderGLES3::USE_ATTRIB_MODULATE, p_modulate);
 	state.canvas_shader.set_conditional(CanvasShaderGLES3::USE_ATTRIB_LARGE_VERTEX, p_large_vertex);
 
+	_bind_canvas_shader();
+
+	state.using_texture_rect = p_enable;
+	state.using_ninepatch = p_ninepatch;
+
+	state.using_light_angle = p_light_angle;
+	state.using_modulate = p_modulate;
+	state.using_large_vertex = p_large_vertex;
+}
+
+// Items can turn the distance field mode on as a whole, glyph runs of distance field fonts turn it on for their own draws.
+void RasterizerCanvasBaseGLES3::_set_distance_field_mode(bool p_enable) {
+	bool distance_field = state.item_distance_field || p_enable;
+	if (state.using_distance_field == distance_field)
+		return;
+
+	state.using_distance_field = distance_field;
+	state.canvas_shader.set_conditional(CanvasShaderGLES3::USE_DISTANCE_FIELD, distance_field);
+	_bind_canvas_shader();
+}
+
+void RasterizerCanvasBaseGLES3::_bind_canvas_shader() {
 	state.canvas_shader.bind();
 	state.canvas_shader.set_uniform(CanvasShaderGLES3::FINAL_MODULATE, state.canvas_item_modulate);
 	state.canvas_shader.set_uniform(CanvasShaderGLES3::MODELVIEW_MATRIX, state.final_transform);
@@ -314,13 +339,6 @@ void RasterizerCanvasBaseGLES3::_set_texture_rect_mode(bool p_enable, bool p_nin
 	} else {
 		state.canvas_shader.set_uniform(CanvasShaderGLES3::SCREEN_PIXEL_SIZE, Vector2(1.0, 1.0));
 	}
-
-	state.using_texture_rect = p_enable;
-	state.using_ninepatch = p_ninepatch;
-
-	state.using_light_angle = p_light_angle;
-	state.using_modulate = p_modulate;
-	state.using_large_vertex = p_large_vertex;
 }
 
 void RasterizerCanvasBaseGLES3::_draw_polygon(const int *p_indices, int p_index_count, int p_vertex_count, const Vector2 *p_vertices, const Vector2 *p_uvs, const Color *p_colors, bool p_singlecolor, const int *p_bones, const float *p_weights) {
@@ -404,6 +422,56 @@ void RasterizerCanvasBaseGLES3::_draw_polygon(const int *p_indices, int p_index_
 	glBindBuffer(GL_ARRAY_BUFFER, 0);
 }
 
+void RasterizerCanvasBaseGLES3::_draw_glyph_run(const Item::CommandGlyphRun *p_run, const Size2 &p_texpixel_size) {
+	// drawn in chunks so that long runs always fit in the polygon buffer
+	const int CHUNK_GLYPHS = 64;
+
+	Vector2 points[CHUNK_GLYPHS * 4];
+	Vector2 uvs[CHUNK_GLYPHS * 4];
+	Color colors[CHUNK_GLYPHS * 4];
+	int indices[CHUNK_GLYPHS * 6];
+
+	for (int i = 0; i < CHUNK_GLYPHS; i++) {
+		int v = i * 4;
+		int *idx = &indices[i * 6];
+		idx[0] = v;
+		idx[1] = v + 1;
+		idx[2] = v + 2;
+		idx[3] = v;
+		idx[4] = v + 2;
+		idx[5] = v + 3;
+	}
+
+	int num_glyphs = p_run->rects.size();
+	const Rect2 *rects = p_run->rects.ptr();
+	const Rect2 *sources = p_run->sources.ptr();
+	const Color *glyph_colors = p_run->colors.ptr();
+
+	for (int from = 0; from < num_glyphs; from += CHUNK_GLYPHS) {
+		int count = MIN(CHUNK_GLYPHS, num_glyphs - from);
+
+		for (int i = 0; i < count; i++) {
+			const Rect2 &rect = rects[from + i];
+			Rect2 src(sources[from + i].position * p_texpixel_size, sources[from + i].size * p_texpixel_size);
+			int v = i * 4;
+
+			points[v] = rect.position;
+			points[v + 1] = rect.position + Vector2(rect.size.x, 0);
+			points[v + 2] = rect.position + rect.size;
+			points[v + 3] = rect.position + Vector2(0, rect.size.y);
+
+			uvs[v] = src.position;
+			uvs[v + 1] = src.position + Vector2(src.size.x, 0);
+			uvs[v + 2] = src.position + src.size;
+			uvs[v + 3] = src.position + Vector2(0, src.size.y);
+
+			colors[v] = colors[v + 1] = colors[v + 2] = colors[v + 3] = glyph_colors[from + i];
+		}
+
+		_draw_polygon(indices, count * 6, count * 4, points, uvs, colors, false, NULL, NULL);
+	}
+}
+
 void RasterizerCanvasBaseGLES3::_draw_generic(GLuint p_primitive, int p_vertex_count, const Vector2 *p_vertices, const Vector2 *p_uvs, const Color *p_colors, bool p_singlecolor) {
 	glBindVertexArray(data.polygon_buffer_pointer_array);
 	glBindBuffer(GL_ARRAY_BUFFER, data.polygon_buffer);
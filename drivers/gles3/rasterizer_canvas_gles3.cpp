@@ -81,6 +81,8 @@ void RasterizerCanvasGLES3::_legacy_canvas_render_item(Item *p_ci, RenderItemSta
 	storage->info.render._2d_item_count++;
 
 	if (r_ris.prev_distance_field != p_ci->distance_field) {
+		state.item_distance_field = p_ci->distance_field;
+		state.using_distance_field = p_ci->distance_field;
 		state.canvas_shader.set_conditional(CanvasShaderGLES3::USE_DISTANCE_FIELD, p_ci->distance_field);
 		r_ris.prev_distance_field = p_ci->distance_field;
 		r_ris.rebind_shader = true;
@@ -790,6 +792,22 @@ void RasterizerCanvasGLES3::render_batches(Item *p_current_clip, bool &r_reclip,
 #endif
 
 						} break;
+						case Item::Command::TYPE_GLYPH_RUN: {
+							Item::CommandGlyphRun *run = static_cast<Item::CommandGlyphRun *>(c);
+							_set_texture_rect_mode(false);
+							_set_distance_field_mode(run->distance_field);
+
+							RasterizerStorageGLES3::Texture *texture = _bind_canvas_texture(run->texture, RID());
+
+							if (texture) {
+								Size2 texpixel_size(1.0 / texture->width, 1.0 / texture->height);
+								state.canvas_shader.set_uniform(CanvasShaderGLES3::COLOR_TEXPIXEL_SIZE, texpixel_size);
+
+								_draw_glyph_run(run, texpixel_size);
+							}
+
+							_set_distance_field_mode(false);
+						} break;
 						case Item::Command::TYPE_MESH: {
 							Item::CommandMesh *mesh = static_cast<Item::CommandMesh *>(c);
 							_set_texture_rect_mode(false);
@@ -1148,6 +1166,8 @@ void RasterizerCanvasGLES3::render_joined_item(const BItemJoined &p_bij, RenderI
 	Item *p_ci = bdata.item_refs[p_bij.first_item_ref].item;
 
 	if (r_ris.prev_distance_field != p_ci->distance_field) {
+		state.item_distance_field = p_ci->distance_field;
+		state.using_distance_field = p_ci->distance_field;
 		state.canvas_shader.set_conditional(CanvasShaderGLES3::USE_DISTANCE_FIELD, p_ci->distance_field);
 		r_ris.prev_distance_field = p_ci->distance_field;
 		r_ris.rebind_shader = true;
@@ -1615,6 +1635,12 @@ bool RasterizerCanvasGLES3::try_join_item(Item *p_ci, RenderItemState &r_ris, bo
 		join = false;
 	}
 
+	// the distance field mode is a shader conditional, so it can't change within a batch
+	if (r_ris.prev_distance_field != p_ci->distance_field) {
+		r_ris.prev_distance_field = p_ci->distance_field;
+		join = false;
+	}
+
 	// TODO: copy back buffer
 
 	if (p_ci->copy_back_buffer) {
@@ -1870,6 +1896,10 @@ void RasterizerCanvasGLES3::canvas_render_items_implementation(Item *p_item_list
 	ris.item_group_base_transform = p_base_transform;
 	ris.prev_distance_field = false;
 
+	state.canvas_shader.set_conditional(CanvasShaderGLES3::USE_DISTANCE_FIELD, false);
+	state.item_distance_field = false;
+	state.using_distance_field = false;
+
 	glBindBuffer(GL_UNIFORM_BUFFER, state.canvas_item_ubo);
 	glBufferData(GL_UNIFORM_BUFFER, sizeof(CanvasItemUBO), &state.canvas_item_ubo_data, _buffer_upload_usage_flag);
 	glBindBuffer(GL_UNIFORM_BUFFER, 0);
@@ -2021,7 +2051,11 @@ void RasterizerCanvasGLES3::_batch_render_generic(const Batch &p_batch, Rasteriz
 	const bool &use_large_verts = bdata.use_large_verts;
 	const bool &colored_verts = bdata.use_colored_vertices | use_light_angles | use_modulate | use_large_verts;
 
+	// batch tex
+	const BatchTex &tex = bdata.batch_textures[p_batch.batch_texture_id];
+
 	_set_texture_rect_mode(false, false, use_light_angles, use_modulate, use_large_verts);
+	_set_distance_field_mode(tex.distance_field);
 
 	//	state.canvas_shader.set_uniform(CanvasShaderGLES3::CLIP_RECT_UV, p_rect->flags & CANVAS_RECT_CLIP_UV);
 	state.canvas_shader.set_uniform(CanvasShaderGLES3::CLIP_RECT_UV, false);
@@ -2047,9 +2081,6 @@ void RasterizerCanvasGLES3::_batch_render_generic(const Batch &p_batch, Rasteriz
 			break;
 	}
 
-	// batch tex
-	const BatchTex &tex = bdata.batch_textures[p_batch.batch_texture_id];
-
 	_bind_canvas_texture(tex.RID_texture, tex.RID_normal);
 
 	if (!colored_verts) {
@@ -2116,6 +2147,8 @@ void RasterizerCanvasGLES3::_batch_render_generic(const Batch &p_batch, Rasteriz
 		} break;
 	}
 
+	_set_distance_field_mode(false);
+
 	/*
 	// may not be necessary .. state change optimization still TODO
 	glBindBuffer(GL_ARRAY_BUFFER, 0);
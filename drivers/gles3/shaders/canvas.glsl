@@ -585,8 +585,9 @@ void main() {
 	//default behavior, texture by color
 
 #ifdef USE_DISTANCE_FIELD
-	const float smoothing = 1.0 / 32.0;
+	// Antialias over about one screen pixel, whatever the scale the field is drawn at.
 	float distance = textureLod(color_texture, uv, 0.0).a;
+	float smoothing = clamp(fwidth(distance) * 0.75, 1.0 / 255.0, 0.25);
 	color.a = smoothstep(0.5 - smoothing, 0.5 + smoothing, distance) * color.a;
 #else
 	color *= texture(color_texture, uv);
@@ -229,6 +229,9 @@ public:
 		TileMode tile_mode;
 		BatchVector2 tex_pixel_size;
 		uint32_t flags;
+
+		// glyph runs of distance field fonts, the shader switches mode per batch
+		bool distance_field;
 	};
 
 	// items in a list to be sorted prior to joining
@@ -479,6 +482,8 @@ public:
 			use_software_transform = !is_single_item && !use_attrib_transform;
 
 			extra_matrix_sent = false;
+			glyph_run_resume = 0;
+			distance_field = false;
 		}
 
 		// for batching multiple types, we don't allow mixing RECTs / LINEs etc.
@@ -503,6 +508,12 @@ public:
 		int transform_extra_command_number_p1; // plus one to allow fast checking against zero
 		Transform2D transform_combined; // final * extra
 		Transform2D skeleton_base_inverse_xform; // used in software skinning
+
+		// glyph runs can be split across flushes, this is the glyph to resume from
+		int glyph_run_resume;
+
+		// set while the rects of a distance field glyph run are being filled
+		bool distance_field;
 	};
 
 	// used during try_join
@@ -513,6 +524,7 @@ public:
 			shader_cache = nullptr;
 			rebind_shader = true;
 			prev_use_skeleton = false;
+			prev_distance_field = false;
 			last_blend_mode = -1;
 			canvas_last_material = RID();
 			item_group_z = 0;
@@ -609,9 +621,10 @@ private:
 	bool _prefill_polygon(RasterizerCanvas::Item::CommandPolygon *p_poly, FillState &r_fill_state, int &r_command_start, int command_num, int command_count, RasterizerCanvas::Item *p_item, bool multiply_final_modulate);
 	template <bool SEND_LIGHT_ANGLES>
 	bool _prefill_rect(RasterizerCanvas::Item::CommandRect *rect, FillState &r_fill_state, int &r_command_start, int command_num, int command_count, RasterizerCanvas::Item::Command *const *commands, RasterizerCanvas::Item *p_item, bool multiply_final_modulate);
+	bool _prefill_glyph_run(RasterizerCanvas::Item::CommandGlyphRun *p_run, FillState &r_fill_state, int &r_command_start, int command_num, int command_count, RasterizerCanvas::Item::Command *const *commands, RasterizerCanvas::Item *p_item, bool multiply_final_modulate);
 
 	// dealing with textures
-	int _batch_find_or_create_tex(const RID &p_texture, const RID &p_normal, bool p_tile, int p_previous_match);
+	int _batch_find_or_create_tex(const RID &p_texture, const RID &p_normal, bool p_tile, bool p_distance_field, int p_previous_match);
 
 protected:
 	// legacy support for non batched mode
@@ -919,7 +932,7 @@ PREAMBLE(void)::_prefill_default_batch(FillState &r_fill_state, int p_command_nu
 	}
 }
 
-PREAMBLE(int)::_batch_find_or_create_tex(const RID &p_texture, const RID &p_normal, bool p_tile, int p_previous_match) {
+PREAMBLE(int)::_batch_find_or_create_tex(const RID &p_texture, const RID &p_normal, bool p_tile, bool p_distance_field, int p_previous_match) {
 	// optimization .. in 99% cases the last matched value will be the same, so no need to traverse the list
 	if (p_previous_match > 0) // if it is zero, it will get hit first in the linear search anyway
 	{
@@ -930,7 +943,7 @@ PREAMBLE(int)::_batch_find_or_create_tex(const RID &p_texture, const RID &p_norm
 			// tiling mode must also match
 			bool tiles = batch_texture.tile_mode != BatchTex::TILE_OFF;
 
-			if (tiles == p_tile)
+			if (tiles == p_tile && batch_texture.distance_field == p_distance_field)
 				// match!
 				return p_previous_match;
 		}
@@ -945,7 +958,7 @@ PREAMBLE(int)::_batch_find_or_create_tex(const RID &p_texture, const RID &p_norm
 			// tiling mode must also match
 			bool tiles = batch_texture.tile_mode != BatchTex::TILE_OFF;
 
-			if (tiles == p_tile)
+			if (tiles == p_tile && batch_texture.distance_field == p_distance_field)
 				// match!
 				return n;
 		}
@@ -956,6 +969,7 @@ PREAMBLE(int)::_batch_find_or_create_tex(const RID &p_texture, const RID &p_norm
 	BatchTex new_batch_tex;
 	new_batch_tex.RID_texture = p_texture;
 	new_batch_tex.RID_normal = p_normal;
+	new_batch_tex.distance_field = p_distance_field;
 
 	// get the texture
 	typename T_STORAGE::Texture *texture = _get_canvas_texture(p_texture);
@@ -1665,7 +1679,7 @@ bool C_PREAMBLE::_prefill_polygon(RasterizerCanvas::Item::CommandPolygon *p_poly
 	}
 
 	int old_batch_tex_id = r_fill_state.batch_tex_id;
-	r_fill_state.batch_tex_id = _batch_find_or_create_tex(p_poly->texture, p_poly->normal_map, false, old_batch_tex_id);
+	r_fill_state.batch_tex_id = _batch_find_or_create_tex(p_poly->texture, p_poly->normal_map, false, false, old_batch_tex_id);
 
 	// conditions for creating a new batch
 	if (old_batch_tex_id != r_fill_state.batch_tex_id) {
@@ -1945,12 +1959,13 @@ bool C_PREAMBLE::_prefill_rect(RasterizerCanvas::Item::CommandRect *rect, FillSt
 		// because joined items with more than 1, the command * will be incorrect
 		// NOTE - this is assuming that use_hardware_transform means that it is a non-joined item!!
 		// If that assumption is incorrect this will go horribly wrong.
-		if (bdata.settings_use_single_rect_fallback && r_fill_state.is_single_item) {
+		// glyph runs always contain several rects, so they never take the single rect path
+		if (bdata.settings_use_single_rect_fallback && r_fill_state.is_single_item && (commands[command_num]->type == RasterizerCanvas::Item::Command::TYPE_RECT)) {
 			bool is_single_rect = false;
 			int command_num_next = command_num + 1;
 			if (command_num_next < command_count) {
 				RasterizerCanvas::Item::Command *command_next = commands[command_num_next];
-				if ((command_next->type != RasterizerCanvas::Item::Command::TYPE_RECT) && (command_next->type != RasterizerCanvas::Item::Command::TYPE_TRANSFORM)) {
+				if ((command_next->type != RasterizerCanvas::Item::Command::TYPE_RECT) && (command_next->type != RasterizerCanvas::Item::Command::TYPE_GLYPH_RUN) && (command_next->type != RasterizerCanvas::Item::Command::TYPE_TRANSFORM)) {
 					is_single_rect = true;
 				}
 			} else {
@@ -1995,7 +2010,7 @@ bool C_PREAMBLE::_prefill_rect(RasterizerCanvas::Item::CommandRect *rect, FillSt
 	// This means we have a potentially rather slow step to identify which texture combo
 	// using the RIDs.
 	int old_batch_tex_id = r_fill_state.batch_tex_id;
-	r_fill_state.batch_tex_id = _batch_find_or_create_tex(rect->texture, rect->normal_map, rect->flags & RasterizerCanvas::CANVAS_RECT_TILE, old_batch_tex_id);
+	r_fill_state.batch_tex_id = _batch_find_or_create_tex(rect->texture, rect->normal_map, rect->flags & RasterizerCanvas::CANVAS_RECT_TILE, r_fill_state.distance_field, old_batch_tex_id);
 
 	//r_fill_state.use_light_angles = send_light_angles;
 	if (SEND_LIGHT_ANGLES) {
@@ -2242,6 +2257,37 @@ bool C_PREAMBLE::_prefill_rect(RasterizerCanvas::Item::CommandRect *rect, FillSt
 	return false;
 }
 
+// Glyph runs are fed through the rect path one glyph at a time. If the vertex buffer fills up
+// part way through a run, the glyph we got to is stored so the run can resume after the flush.
+PREAMBLE(bool)::_prefill_glyph_run(RasterizerCanvas::Item::CommandGlyphRun *p_run, FillState &r_fill_state, int &r_command_start, int command_num, int command_count, RasterizerCanvas::Item::Command *const *commands, RasterizerCanvas::Item *p_item, bool multiply_final_modulate) {
+	RasterizerCanvas::Item::CommandRect rect;
+	rect.texture = p_run->texture;
+	rect.flags = RasterizerCanvas::CANVAS_RECT_REGION;
+
+	int num_glyphs = p_run->rects.size();
+	const Rect2 *rects = p_run->rects.ptr();
+	const Rect2 *sources = p_run->sources.ptr();
+	const Color *colors = p_run->colors.ptr();
+
+	r_fill_state.distance_field = p_run->distance_field;
+
+	for (int n = r_fill_state.glyph_run_resume; n < num_glyphs; n++) {
+		rect.rect = rects[n];
+		rect.source = sources[n];
+		rect.modulate = colors[n];
+
+		if (_prefill_rect<false>(&rect, r_fill_state, r_command_start, command_num, command_count, commands, p_item, multiply_final_modulate)) {
+			r_fill_state.glyph_run_resume = n;
+			r_fill_state.distance_field = false;
+			return true;
+		}
+	}
+
+	r_fill_state.glyph_run_resume = 0;
+	r_fill_state.distance_field = false;
+	return false;
+}
+
 // This function may be called MULTIPLE TIMES for each item, so needs to record how far it has got
 PREAMBLE(bool)::prefill_joined_item(FillState &r_fill_state, int &r_command_start, RasterizerCanvas::Item *p_item, RasterizerCanvas::Item *p_current_clip, bool &r_reclip, typename T_STORAGE::Material *p_material) {
 	// we will prefill batches and vertices ready for sending in one go to the vertex buffer
@@ -2332,6 +2378,13 @@ PREAMBLE(bool)::prefill_joined_item(FillState &r_fill_state, int &r_command_star
 				if (buffer_full)
 					return true;
 
+			} break;
+			case RasterizerCanvas::Item::Command::TYPE_GLYPH_RUN: {
+				RasterizerCanvas::Item::CommandGlyphRun *run = static_cast<RasterizerCanvas::Item::CommandGlyphRun *>(command);
+
+				if (_prefill_glyph_run(run, r_fill_state, r_command_start, command_num, command_count, commands, p_item, multiply_final_modulate))
+					return true;
+
 			} break;
 			case RasterizerCanvas::Item::Command::TYPE_NINEPATCH: {
 				RasterizerCanvas::Item::CommandNinePatch *np = static_cast<RasterizerCanvas::Item::CommandNinePatch *>(command);
@@ -3189,7 +3242,8 @@ PREAMBLE(bool)::_detect_item_batch_break(RenderItemState &r_ris, RasterizerCanva
 						return true;
 					}
 				} break;
-				case RasterizerCanvas::Item::Command::TYPE_RECT: {
+				case RasterizerCanvas::Item::Command::TYPE_RECT:
+				case RasterizerCanvas::Item::Command::TYPE_GLYPH_RUN: {
 					if (_disallow_item_join_if_batch_types_too_different(r_ris, RasterizerStorageCommon::BTF_RECT))
 						return true;
 				} break;
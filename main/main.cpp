@@ -32,6 +32,7 @@
 
 #include "configs/version_hash.gen.h"
 #include "core/crypto/crypto.h"
+#include "core/frame_allocator.h"
 #include "core/input_map.h"
 #include "core/io/file_access_network.h"
 #include "core/io/file_access_pack.h"
@@ -69,6 +70,7 @@
 #include "servers/physics_2d_server.h"
 #include "servers/physics_server.h"
 #include "servers/register_server_types.h"
+#include "servers/text/text_helper.h"
 #include "servers/text/text_shaper.h"
 #include "tests/runtime/test_main.h"
 
@@ -176,6 +178,8 @@ void initialize_font() {
 		TextShaperManager::initialize(i);
 	}
 
+	TextHelper::initialize();
+
 	ERR_FAIL_COND(!font_server);
 	font_server->init();
 }
@@ -1902,6 +1906,8 @@ bool Main::iteration() {
 
 	iterating++;
 
+	FrameAllocator::next_frame();
+
 	uint64_t ticks = OS::get_singleton()->get_ticks_usec();
 	Engine::get_singleton()->_frame_ticks = ticks;
 	main_timer_sync.set_cpu_ticks_usec(ticks);
@@ -32,6 +32,7 @@
 
 #include "core/message_queue.h"
 #include "core/os/os.h"
+#include "core/os/small_allocator.h"
 #include "scene/main/node.h"
 #include "scene/main/scene_tree.h"
 #include "servers/audio_server.h"
@@ -43,6 +44,7 @@ Performance *Performance::singleton = NULL;
 
 void Performance::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_monitor", "monitor"), &Performance::get_monitor);
+	ClassDB::bind_method(D_METHOD("get_small_alloc_stats"), &Performance::get_small_alloc_stats);
 
 	BIND_ENUM_CONSTANT(TIME_FPS);
 	BIND_ENUM_CONSTANT(TIME_PROCESS);
@@ -75,6 +77,8 @@ void Performance::_bind_methods() {
 	BIND_ENUM_CONSTANT(PHYSICS_3D_COLLISION_PAIRS);
 	BIND_ENUM_CONSTANT(PHYSICS_3D_ISLAND_COUNT);
 	BIND_ENUM_CONSTANT(AUDIO_OUTPUT_LATENCY);
+	BIND_ENUM_CONSTANT(MEMORY_SMALL_ALLOC_RESERVED);
+	BIND_ENUM_CONSTANT(MEMORY_SMALL_ALLOC_USED);
 
 	BIND_ENUM_CONSTANT(MONITOR_MAX);
 }
@@ -122,6 +126,8 @@ String Performance::get_monitor_name(Monitor p_monitor) const {
 		"physics_3d/collision_pairs",
 		"physics_3d/islands",
 		"audio/output_latency",
+		"memory/small_alloc_reserved",
+		"memory/small_alloc_used",
 
 	};
 
@@ -192,6 +198,10 @@ float Performance::get_monitor(Monitor p_monitor) const {
 			return PhysicsServer::get_singleton()->get_process_info(PhysicsServer::INFO_ISLAND_COUNT);
 		case AUDIO_OUTPUT_LATENCY:
 			return AudioServer::get_singleton()->get_output_latency();
+		case MEMORY_SMALL_ALLOC_RESERVED:
+			return SmallAllocator::get_reserved_bytes();
+		case MEMORY_SMALL_ALLOC_USED:
+			return SmallAllocator::get_used_bytes();
 
 		default: {
 		}
@@ -236,12 +246,30 @@ Performance::MonitorType Performance::get_monitor_type(Monitor p_monitor) const
 		MONITOR_TYPE_QUANTITY,
 		MONITOR_TYPE_QUANTITY,
 		MONITOR_TYPE_TIME,
+		MONITOR_TYPE_MEMORY,
+		MONITOR_TYPE_MEMORY,
 
 	};
 
 	return types[p_monitor];
 }
 
+Array Performance::get_small_alloc_stats() const {
+	Array stats;
+#ifdef SMALL_ALLOCATOR_ENABLED
+	for (int i = 0; i < SmallAllocator::SIZE_CLASS_COUNT; i++) {
+		SmallAllocator::SizeClassStats class_stats = SmallAllocator::get_size_class_stats(i);
+		Dictionary d;
+		d["block_size"] = class_stats.block_size;
+		d["reserved"] = class_stats.reserved;
+		d["used"] = class_stats.used;
+		d["refills"] = class_stats.refills;
+		stats.push_back(d);
+	}
+#endif
+	return stats;
+}
+
 void Performance::set_process_time(float p_pt) {
 	_process_time = p_pt;
 }
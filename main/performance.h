@@ -82,6 +82,8 @@ public:
 		PHYSICS_3D_ISLAND_COUNT,
 		//physics
 		AUDIO_OUTPUT_LATENCY,
+		MEMORY_SMALL_ALLOC_RESERVED,
+		MEMORY_SMALL_ALLOC_USED,
 		MONITOR_MAX
 	};
 
@@ -92,6 +94,7 @@ public:
 	};
 
 	float get_monitor(Monitor p_monitor) const;
+	Array get_small_alloc_stats() const;
 	String get_monitor_name(Monitor p_monitor) const;
 
 	MonitorType get_monitor_type(Monitor p_monitor) const;
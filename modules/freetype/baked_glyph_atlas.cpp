@@ -0,0 +1,264 @@
+/*************************************************************************/
+/*  baked_glyph_atlas.cpp                                                */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-present Godot Engine contributors (cf. AUTHORS.md).*/
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "baked_glyph_atlas.h"
+
+#include "core/io/marshalls.h"
+#include "core/os/file_access.h"
+
+static const uint8_t baked_glyph_atlas_magic[4] = { 'G', 'D', 'G', 'A' };
+
+_FORCE_INLINE_ BakedGlyphAtlas::Glyph BakedGlyphAtlas::_decode_glyph(int p_offset) const {
+	const uint8_t *r = &data[p_offset];
+
+	Glyph glyph;
+	glyph.glyph_index = decode_uint32(&r[0]);
+	glyph.page = decode_uint16(&r[4]);
+	glyph.x = decode_uint16(&r[8]);
+	glyph.y = decode_uint16(&r[10]);
+	glyph.w = decode_uint16(&r[12]);
+	glyph.h = decode_uint16(&r[14]);
+	glyph.offset = Vector2(decode_float(&r[16]), decode_float(&r[20]));
+	glyph.advance = Vector2(decode_float(&r[24]), decode_float(&r[28]));
+	return glyph;
+}
+
+Error BakedGlyphAtlas::load(const String &p_path) {
+	clear();
+
+	Error err;
+	Vector<uint8_t> file_data = FileAccess::get_file_as_array(p_path, &err);
+	ERR_FAIL_COND_V_MSG(err != OK, err, "Cannot open baked glyph atlas '" + p_path + "'.");
+
+	int size = file_data.size();
+	const uint8_t *r = file_data.ptr();
+
+	ERR_FAIL_COND_V(size < HEADER_SIZE, ERR_FILE_CORRUPT);
+	ERR_FAIL_COND_V_MSG(memcmp(r, baked_glyph_atlas_magic, 4) != 0, ERR_FILE_UNRECOGNIZED, "Not a baked glyph atlas: '" + p_path + "'.");
+	ERR_FAIL_COND_V_MSG(decode_uint32(&r[4]) != FORMAT_VERSION, ERR_FILE_UNRECOGNIZED, "Unsupported baked glyph atlas version: '" + p_path + "'.");
+
+	uint32_t set_count = decode_uint32(&r[8]);
+	uint32_t page_count = decode_uint32(&r[12]);
+
+	uint64_t pages_offset = HEADER_SIZE + (uint64_t)set_count * SET_RECORD_SIZE;
+	uint64_t tables_end = pages_offset + (uint64_t)page_count * PAGE_RECORD_SIZE;
+	ERR_FAIL_COND_V(tables_end > (uint64_t)size, ERR_FILE_CORRUPT);
+
+	for (uint32_t i = 0; i < page_count; i++) {
+		const uint8_t *page = &r[pages_offset + i * PAGE_RECORD_SIZE];
+		uint32_t texture_size = decode_uint32(&page[0]);
+		uint32_t format = decode_uint32(&page[4]);
+		uint64_t data_offset = decode_uint32(&page[8]);
+		uint64_t data_size = decode_uint32(&page[12]);
+
+		ERR_FAIL_COND_V(format != Image::FORMAT_LA8 && format != Image::FORMAT_RGBA8, ERR_FILE_CORRUPT);
+		ERR_FAIL_COND_V((uint64_t)texture_size * texture_size * (format == Image::FORMAT_LA8 ? 2 : 4) != data_size, ERR_FILE_CORRUPT);
+		ERR_FAIL_COND_V(data_offset + data_size > (uint64_t)size, ERR_FILE_CORRUPT);
+	}
+
+	Vector<SetRecord> new_sets;
+	new_sets.resize(set_count);
+	for (uint32_t i = 0; i < set_count; i++) {
+		const uint8_t *set = &r[HEADER_SIZE + i * SET_RECORD_SIZE];
+
+		GlyphCacheKey key;
+		key.font_id.font_hash = decode_uint32(&set[0]);
+		key.font_id.font_index = decode_uint32(&set[4]);
+		key.font_size = decode_uint32(&set[8]);
+		key.font_custom_flags = decode_uint32(&set[12]);
+
+		SetRecord &record = new_sets.write[i];
+		record.first_page = decode_uint32(&set[16]);
+		record.page_count = decode_uint32(&set[20]);
+		record.glyph_offset = decode_uint32(&set[24]);
+		record.glyph_count = decode_uint32(&set[28]);
+
+		ERR_FAIL_COND_V((uint64_t)record.first_page + record.page_count > page_count, ERR_FILE_CORRUPT);
+		ERR_FAIL_COND_V(record.glyph_offset < 0 || record.glyph_count < 0, ERR_FILE_CORRUPT);
+		ERR_FAIL_COND_V((uint64_t)record.glyph_offset + (uint64_t)record.glyph_count * GLYPH_RECORD_SIZE > (uint64_t)size, ERR_FILE_CORRUPT);
+
+		set_map[key] = i;
+	}
+
+	data = file_data;
+	sets = new_sets;
+
+	for (int i = 0; i < sets.size(); i++) {
+		for (int j = 0; j < sets[i].glyph_count; j++) {
+			Glyph glyph = _decode_glyph(sets[i].glyph_offset + j * GLYPH_RECORD_SIZE);
+			if (glyph.page >= sets[i].page_count || glyph.x + glyph.w + RECT_RANGE > get_page_texture_size(i, glyph.page) || glyph.y + glyph.h + RECT_RANGE > get_page_texture_size(i, glyph.page) || glyph.x < RECT_RANGE || glyph.y < RECT_RANGE) {
+				clear();
+				ERR_FAIL_V_MSG(ERR_FILE_CORRUPT, "Baked glyph atlas has glyphs outside of their page: '" + p_path + "'.");
+			}
+		}
+	}
+
+	return OK;
+}
+
+void BakedGlyphAtlas::clear() {
+	data.clear();
+	sets.clear();
+	set_map.clear();
+}
+
+int BakedGlyphAtlas::find_set(const GlyphCacheKey &p_glyph_key) const {
+	const int *set = set_map.getptr(_get_set_key(p_glyph_key));
+	return set ? *set : -1;
+}
+
+int BakedGlyphAtlas::get_page_count(int p_set) const {
+	ERR_FAIL_INDEX_V(p_set, sets.size(), 0);
+	return sets[p_set].page_count;
+}
+
+int BakedGlyphAtlas::get_page_texture_size(int p_set, int p_page) const {
+	ERR_FAIL_INDEX_V(p_set, sets.size(), 0);
+	ERR_FAIL_INDEX_V(p_page, sets[p_set].page_count, 0);
+
+	int page = sets[p_set].first_page + p_page;
+	int set_count = sets.size();
+	return decode_uint32(&data[HEADER_SIZE + set_count * SET_RECORD_SIZE + page * PAGE_RECORD_SIZE]);
+}
+
+Image::Format BakedGlyphAtlas::get_page_format(int p_set, int p_page) const {
+	ERR_FAIL_INDEX_V(p_set, sets.size(), Image::FORMAT_LA8);
+	ERR_FAIL_INDEX_V(p_page, sets[p_set].page_count, Image::FORMAT_LA8);
+
+	int page = sets[p_set].first_page + p_page;
+	int set_count = sets.size();
+	return (Image::Format)decode_uint32(&data[HEADER_SIZE + set_count * SET_RECORD_SIZE + page * PAGE_RECORD_SIZE + 4]);
+}
+
+const uint8_t *BakedGlyphAtlas::get_page_data(int p_set, int p_page) const {
+	ERR_FAIL_INDEX_V(p_set, sets.size(), NULL);
+	ERR_FAIL_INDEX_V(p_page, sets[p_set].page_count, NULL);
+
+	int page = sets[p_set].first_page + p_page;
+	int set_count = sets.size();
+	return &data[decode_uint32(&data[HEADER_SIZE + set_count * SET_RECORD_SIZE + page * PAGE_RECORD_SIZE + 8])];
+}
+
+int BakedGlyphAtlas::get_glyph_count(int p_set) const {
+	ERR_FAIL_INDEX_V(p_set, sets.size(), 0);
+	return sets[p_set].glyph_count;
+}
+
+BakedGlyphAtlas::Glyph BakedGlyphAtlas::get_glyph(int p_set, int p_glyph) const {
+	ERR_FAIL_INDEX_V(p_set, sets.size(), Glyph());
+	ERR_FAIL_INDEX_V(p_glyph, sets[p_set].glyph_count, Glyph());
+	return _decode_glyph(sets[p_set].glyph_offset + p_glyph * GLYPH_RECORD_SIZE);
+}
+
+Vector<uint8_t> BakedGlyphAtlas::encode(const Vector<Set> &p_sets) {
+	int page_count = 0;
+	int glyph_count = 0;
+	for (int i = 0; i < p_sets.size(); i++) {
+		page_count += p_sets[i].pages.size();
+		glyph_count += p_sets[i].glyphs.size();
+	}
+
+	int glyphs_offset = HEADER_SIZE + p_sets.size() * SET_RECORD_SIZE + page_count * PAGE_RECORD_SIZE;
+	int pixels_offset = glyphs_offset + glyph_count * GLYPH_RECORD_SIZE;
+
+	int size = pixels_offset;
+	for (int i = 0; i < p_sets.size(); i++) {
+		for (int j = 0; j < p_sets[i].pages.size(); j++) {
+			size += (p_sets[i].pages[j].data.size() + 3) & ~3;
+		}
+	}
+
+	Vector<uint8_t> result;
+	result.resize(size);
+	uint8_t *w = result.ptrw();
+	zeromem(w, size);
+
+	memcpy(w, baked_glyph_atlas_magic, 4);
+	encode_uint32(FORMAT_VERSION, &w[4]);
+	encode_uint32(p_sets.size(), &w[8]);
+	encode_uint32(page_count, &w[12]);
+
+	int page = 0;
+	int glyph_offset = glyphs_offset;
+	int pixel_offset = pixels_offset;
+
+	for (int i = 0; i < p_sets.size(); i++) {
+		const Set &set = p_sets[i];
+
+		Vector<Glyph> glyphs = set.glyphs;
+		glyphs.sort();
+
+		uint8_t *set_w = &w[HEADER_SIZE + i * SET_RECORD_SIZE];
+		encode_uint32(set.glyph_key.font_id.font_hash, &set_w[0]);
+		encode_uint32(set.glyph_key.font_id.font_index, &set_w[4]);
+		encode_uint32(set.glyph_key.font_size * set.glyph_key.font_oversampling, &set_w[8]);
+		encode_uint32(set.glyph_key.font_custom_flags, &set_w[12]);
+		encode_uint32(page, &set_w[16]);
+		encode_uint32(set.pages.size(), &set_w[20]);
+		encode_uint32(glyph_offset, &set_w[24]);
+		encode_uint32(glyphs.size(), &set_w[28]);
+
+		for (int j = 0; j < set.pages.size(); j++) {
+			const Page &src = set.pages[j];
+
+			uint8_t *page_w = &w[HEADER_SIZE + p_sets.size() * SET_RECORD_SIZE + page * PAGE_RECORD_SIZE];
+			encode_uint32(src.texture_size, &page_w[0]);
+			encode_uint32(src.format, &page_w[4]);
+			encode_uint32(pixel_offset, &page_w[8]);
+			encode_uint32(src.data.size(), &page_w[12]);
+
+			PoolVector<uint8_t>::Read r = src.data.read();
+			copymem(&w[pixel_offset], r.ptr(), src.data.size());
+
+			pixel_offset += (src.data.size() + 3) & ~3;
+			page++;
+		}
+
+		for (int j = 0; j < glyphs.size(); j++) {
+			const Glyph &glyph = glyphs[j];
+
+			uint8_t *glyph_w = &w[glyph_offset];
+			encode_uint32(glyph.glyph_index, &glyph_w[0]);
+			encode_uint16(glyph.page, &glyph_w[4]);
+			encode_uint16(glyph.x, &glyph_w[8]);
+			encode_uint16(glyph.y, &glyph_w[10]);
+			encode_uint16(glyph.w, &glyph_w[12]);
+			encode_uint16(glyph.h, &glyph_w[14]);
+			encode_float(glyph.offset.x, &glyph_w[16]);
+			encode_float(glyph.offset.y, &glyph_w[20]);
+			encode_float(glyph.advance.x, &glyph_w[24]);
+			encode_float(glyph.advance.y, &glyph_w[28]);
+
+			glyph_offset += GLYPH_RECORD_SIZE;
+		}
+	}
+
+	return result;
+}
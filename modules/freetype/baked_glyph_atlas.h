@@ -0,0 +1,131 @@
+/*************************************************************************/
+/*  baked_glyph_atlas.h                                                  */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-present Godot Engine contributors (cf. AUTHORS.md).*/
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef BAKED_GLYPH_ATLAS_H
+#define BAKED_GLYPH_ATLAS_H
+
+#include "core/hash_map.h"
+#include "core/image.h"
+#include "core/pool_vector.h"
+#include "core/vector.h"
+#include "servers/font_server.h"
+
+// Glyph pages rasterized at export time. The file is read in one go and
+// glyph records are looked up in place, nothing is unpacked on load.
+//
+// Layout, little endian:
+//   header   magic "GDGA", version, set count, page count
+//   sets     font hash, font index, pixel size, custom flags,
+//            first page, page count, glyph table offset, glyph count
+//   pages    texture size, image format, data offset, data size
+//   glyphs   per set, sorted by glyph index
+//   pixels   page images, 4 byte aligned
+class BakedGlyphAtlas {
+public:
+	enum {
+		FORMAT_VERSION = 1,
+		HEADER_SIZE = 16,
+		SET_RECORD_SIZE = 32,
+		PAGE_RECORD_SIZE = 16,
+		GLYPH_RECORD_SIZE = 32,
+		RECT_RANGE = 1,
+	};
+
+	struct Glyph {
+		uint32_t glyph_index = 0;
+		int page = 0;
+		// Bitmap rect inside the page, without the RECT_RANGE padding.
+		int x = 0;
+		int y = 0;
+		int w = 0;
+		int h = 0;
+		// In pixels of the baked size.
+		Vector2 offset;
+		Vector2 advance;
+
+		_FORCE_INLINE_ bool operator<(const Glyph &p_glyph) const {
+			return glyph_index < p_glyph.glyph_index;
+		}
+	};
+
+	struct Page {
+		int texture_size = 0;
+		Image::Format format = Image::FORMAT_LA8;
+		PoolVector<uint8_t> data;
+	};
+
+	struct Set {
+		GlyphCacheKey glyph_key;
+		Vector<Page> pages;
+		Vector<Glyph> glyphs;
+	};
+
+private:
+	struct SetRecord {
+		int first_page = 0;
+		int page_count = 0;
+		int glyph_offset = 0;
+		int glyph_count = 0;
+	};
+
+	Vector<uint8_t> data;
+	Vector<SetRecord> sets;
+	HashMap<GlyphCacheKey, int, GlyphCacheKeyHasher> set_map;
+
+	static _FORCE_INLINE_ GlyphCacheKey _get_set_key(const GlyphCacheKey &p_glyph_key) {
+		// Mipmaps and filtering only change the texture flags, the pixels are the same.
+		GlyphCacheKey key;
+		key.font_id = p_glyph_key.font_id;
+		key.font_size = p_glyph_key.font_size * p_glyph_key.font_oversampling;
+		key.font_oversampling = 1;
+		key.font_custom_flags = p_glyph_key.font_custom_flags;
+		return key;
+	}
+
+	_FORCE_INLINE_ Glyph _decode_glyph(int p_offset) const;
+
+public:
+	Error load(const String &p_path);
+	void clear();
+
+	_FORCE_INLINE_ bool is_loaded() const { return !sets.empty(); }
+
+	int find_set(const GlyphCacheKey &p_glyph_key) const;
+	int get_page_count(int p_set) const;
+	int get_page_texture_size(int p_set, int p_page) const;
+	Image::Format get_page_format(int p_set, int p_page) const;
+	const uint8_t *get_page_data(int p_set, int p_page) const;
+	int get_glyph_count(int p_set) const;
+	Glyph get_glyph(int p_set, int p_glyph) const;
+
+	static Vector<uint8_t> encode(const Vector<Set> &p_sets);
+};
+
+#endif
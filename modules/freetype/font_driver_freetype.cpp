@@ -32,12 +32,15 @@
 
 #include "freetype_font.h"
 
+#include "core/engine.h"
 #include "core/error_macros.h"
 #include "core/hash_map.h"
 #include "core/map.h"
 #include "core/math/vector2.h"
 #include "core/os/file_access.h"
 #include "core/os/memory.h"
+#include "core/os/threaded_array_processor.h"
+#include "core/project_settings.h"
 #include "scene/resources/texture.h"
 #include "servers/visual_server.h"
 
@@ -64,71 +67,307 @@ static _FORCE_INLINE_ bool _is_sfnt_data(const PoolVector<uint8_t> &p_data) {
 	return false;
 }
 
-_FORCE_INLINE_ ShelfPackTexture::Position FontDriverFreeType::_find_texture_pos(const GlyphCacheKey &p_glyph_key, int p_width, int p_height, int p_color_size, Image::Format p_image_format, int p_rect_range) {
-	ShelfPackTexture::Position tex_pos{};
+static _FORCE_INLINE_ int _get_load_flags(FT_Face p_ft_face, const GlyphCacheKey &p_glyph_key) {
+	if (p_glyph_key.font_distance_field) {
+		// Distance fields are scaled freely, hinting for the base size would only distort them.
+		return FT_LOAD_DEFAULT | FT_LOAD_NO_HINTING | FT_LOAD_NO_BITMAP;
+	}
 
-	Vector<ShelfPackTexture> *textures = texture_map.getptr(p_glyph_key);
-	if (textures) {
-		ShelfPackTexture *glyph_texture = textures->ptrw();
-		for (int i = 0; i < textures->size(); i++) {
-			if (glyph_texture[i].image_format != p_image_format)
-				continue;
+	int load_flags = FT_HAS_COLOR(p_ft_face) ? FT_LOAD_COLOR : FT_LOAD_DEFAULT;
+	switch (p_glyph_key.font_custom_flags) {
+		case FreeTypeFont::HINTING_NONE:
+			load_flags |= FT_LOAD_NO_HINTING;
+			break;
+		case FreeTypeFont::HINTING_AUTO:
+			load_flags |= FT_LOAD_FORCE_AUTOHINT;
+			break;
+		case FreeTypeFont::HINTING_LIGHT:
+			load_flags |= FT_LOAD_TARGET_LIGHT;
+			break;
+		default:
+			load_flags |= FT_LOAD_TARGET_NORMAL;
+			break;
+	}
+	return load_flags;
+}
 
-			if (p_width > glyph_texture[i].texture_size || p_height > glyph_texture[i].texture_size)
-				continue;
+static _FORCE_INLINE_ FT_Render_Mode _get_render_mode(const GlyphCacheKey &p_glyph_key) {
+	return p_glyph_key.font_distance_field ? FT_RENDER_MODE_SDF : FT_RENDER_MODE_NORMAL;
+}
 
-			tex_pos = glyph_texture[i].pack_rect(i, p_width, p_height);
-			if (tex_pos.index != -1) {
-				break;
+_FORCE_INLINE_ GlyphCacheKey FontDriverFreeType::_get_distance_field_key(const GlyphCacheKey &p_glyph_key) {
+	GlyphCacheKey field_key = p_glyph_key;
+	field_key.font_size = DISTANCE_FIELD_SIZE;
+	field_key.font_oversampling = 1;
+	field_key.font_use_mipmaps = false;
+	field_key.font_use_filter = true;
+	return field_key;
+}
+
+_FORCE_INLINE_ GlyphInfo FontDriverFreeType::_scale_distance_field_glyph(const GlyphInfo &p_glyph_info, const GlyphCacheKey &p_glyph_key) {
+	GlyphInfo glyph_info = p_glyph_info;
+
+	// The texture rect keeps pointing at the shared field, only the metrics follow the requested size.
+	float scale = (float)p_glyph_key.font_size / DISTANCE_FIELD_SIZE;
+	glyph_info.texture_offset *= scale;
+	glyph_info.texture_size *= scale;
+	glyph_info.advance *= scale;
+	return glyph_info;
+}
+
+_FORCE_INLINE_ bool FontDriverFreeType::_get_cached_glyph_info(const GlyphCacheKey &p_glyph_key, uint32_t p_glyph_index, GlyphInfo &r_glyph_info) {
+	GlyphCacheShard &shard = _get_glyph_cache_shard(p_glyph_key, p_glyph_index);
+	RWLockRead read_lock(shard.lock);
+
+	const HashMap<uint32_t, GlyphInfo> *glyph_map = shard.glyph_info_map.getptr(p_glyph_key);
+	if (!glyph_map) {
+		return false;
+	}
+
+	const GlyphInfo *glyph_info = glyph_map->getptr(p_glyph_index);
+	if (!glyph_info) {
+		return false;
+	}
+
+	r_glyph_info = *glyph_info;
+	return true;
+}
+
+_FORCE_INLINE_ void FontDriverFreeType::_store_glyph_info(const GlyphCacheKey &p_glyph_key, uint32_t p_glyph_index, const GlyphInfo &p_glyph_info) {
+	GlyphCacheShard &shard = _get_glyph_cache_shard(p_glyph_key, p_glyph_index);
+	RWLockWrite write_lock(shard.lock);
+
+	shard.glyph_info_map[p_glyph_key][p_glyph_index] = p_glyph_info;
+}
+
+_FORCE_INLINE_ void FontDriverFreeType::_erase_glyph_info(const GlyphCacheKey &p_glyph_key, uint32_t p_glyph_index) {
+	GlyphCacheShard &shard = _get_glyph_cache_shard(p_glyph_key, p_glyph_index);
+	RWLockWrite write_lock(shard.lock);
+
+	HashMap<uint32_t, GlyphInfo> *glyph_map = shard.glyph_info_map.getptr(p_glyph_key);
+	if (glyph_map) {
+		glyph_map->erase(p_glyph_index);
+	}
+}
+
+_FORCE_INLINE_ void FontDriverFreeType::_move_glyph_info(const GlyphCacheKey &p_glyph_key, const ShelfPackTexture &p_texture, const ShelfPackTexture::Slot &p_slot) {
+	GlyphCacheShard &shard = _get_glyph_cache_shard(p_glyph_key, p_slot.glyph_index);
+	RWLockWrite write_lock(shard.lock);
+
+	HashMap<uint32_t, GlyphInfo> *glyph_map = shard.glyph_info_map.getptr(p_glyph_key);
+	if (glyph_map) {
+		GlyphInfo *glyph_info = glyph_map->getptr(p_slot.glyph_index);
+		if (glyph_info) {
+			glyph_info->texture_rect_uv.position = Vector2(p_slot.x + p_texture.rect_range, p_slot.y + p_texture.rect_range);
+		}
+	}
+}
+
+_FORCE_INLINE_ bool FontDriverFreeType::_evict_glyphs(const GlyphCacheKey &p_glyph_key, Vector<ShelfPackTexture> &p_textures, int p_width, int p_height, Image::Format p_image_format) {
+	uint64_t frame = Engine::get_singleton()->get_frames_drawn();
+
+	// Glyphs drawn during the current frame are never evicted or moved, their rects may already be queued.
+	LocalVector<EvictionCandidate> candidates;
+	for (int i = 0; i < p_textures.size(); i++) {
+		const ShelfPackTexture &tex = p_textures[i];
+		if (tex.image_format != p_image_format) {
+			continue;
+		}
+
+		for (int j = 0; j < (int)tex.slots.size(); j++) {
+			const ShelfPackTexture::Slot &slot = tex.slots[j];
+			if (slot.used && slot.last_used < frame) {
+				EvictionCandidate candidate;
+				candidate.last_used = slot.last_used;
+				candidate.texture_index = i;
+				candidate.slot = j;
+				candidates.push_back(candidate);
 			}
 		}
 	}
 
-	if (tex_pos.index == -1) {
-		int texture_size = MAX(p_glyph_key.font_size * p_glyph_key.font_oversampling * 8, ShelfPackTexture::MIN_TEXTURE_SIZE);
+	if (candidates.empty()) {
+		return false;
+	}
 
-		if (p_width > texture_size)
-			texture_size = p_width;
-		if (p_height > texture_size)
-			texture_size = p_height;
+	candidates.sort();
 
-		texture_size = next_power_of_2(texture_size);
-		texture_size = MIN(texture_size, ShelfPackTexture::MAX_TEXTURE_SIZE);
+	Vector<int> freed_area;
+	freed_area.resize(p_textures.size());
+	for (int i = 0; i < freed_area.size(); i++) {
+		freed_area.write[i] = 0;
+	}
 
-		ShelfPackTexture tex{};
-		tex.image_format = p_image_format;
-		tex.texture_size = texture_size;
-		tex.image_data.resize(texture_size * texture_size * p_color_size);
+	for (int i = 0; i < (int)candidates.size(); i++) {
+		ShelfPackTexture &tex = p_textures.write[candidates[i].texture_index];
+		const ShelfPackTexture::Slot &slot = tex.slots[candidates[i].slot];
 
-		{
-			PoolVector<uint8_t>::Write w = tex.image_data.write();
-			ERR_FAIL_COND_V(texture_size * texture_size * p_color_size > tex.image_data.size(), tex_pos);
+		_erase_glyph_info(p_glyph_key, slot.glyph_index);
+		freed_area.write[candidates[i].texture_index] += slot.w * slot.h;
+		tex.free_slot(candidates[i].slot);
 
-			if (p_color_size == 2) {
-				for (int i = 0; i < texture_size * texture_size * p_color_size; i += 2) {
-					w[i + 0] = 255;
-					w[i + 1] = 0;
-				}
-			} else {
-				for (int i = 0; i < texture_size * texture_size * p_color_size; i += 4) {
-					w[i + 0] = 255;
-					w[i + 1] = 255;
-					w[i + 2] = 255;
-					w[i + 3] = 0;
-				}
+		// Free a sizable chunk at once, so the next misses don't evict again right away.
+		int wanted_area = MAX(p_width * p_height * 2, tex.texture_size * tex.texture_size / 8);
+		if (freed_area[candidates[i].texture_index] >= wanted_area) {
+			break;
+		}
+	}
+
+	for (int i = 0; i < p_textures.size(); i++) {
+		if (freed_area[i] == 0) {
+			continue;
+		}
+
+		ShelfPackTexture &tex = p_textures.write[i];
+
+		Vector<uint32_t> dropped = tex.defragment(frame);
+		for (int j = 0; j < dropped.size(); j++) {
+			_erase_glyph_info(p_glyph_key, dropped[j]);
+		}
+
+		for (int j = 0; j < (int)tex.slots.size(); j++) {
+			if (tex.slots[j].used) {
+				_move_glyph_info(p_glyph_key, tex, tex.slots[j]);
 			}
 		}
+	}
 
-		Vector<ShelfPackTexture> &textures = texture_map[p_glyph_key];
-		textures.push_back(tex);
-		int texture_index = textures.size() - 1;
-		tex_pos = textures.write[texture_index].pack_rect(texture_index, p_width, p_height);
+	FontServer::get_singleton()->glyph_atlas_changed();
+
+	return true;
+}
+
+_FORCE_INLINE_ ShelfPackTexture::Position FontDriverFreeType::_pack_in_textures(Vector<ShelfPackTexture> &p_textures, int p_width, int p_height, Image::Format p_image_format) {
+	ShelfPackTexture::Position tex_pos{};
+
+	ShelfPackTexture *glyph_texture = p_textures.ptrw();
+	for (int i = 0; i < p_textures.size(); i++) {
+		if (glyph_texture[i].image_format != p_image_format)
+			continue;
+
+		if (p_width > glyph_texture[i].texture_size || p_height > glyph_texture[i].texture_size)
+			continue;
+
+		tex_pos = glyph_texture[i].pack_rect(i, p_width, p_height);
+		if (tex_pos.index != -1) {
+			break;
+		}
+	}
+
+	return tex_pos;
+}
+
+_FORCE_INLINE_ ShelfPackTexture::Position FontDriverFreeType::_find_texture_pos(const GlyphCacheKey &p_glyph_key, int p_width, int p_height, int p_color_size, Image::Format p_image_format, int p_rect_range) {
+	Vector<ShelfPackTexture> &textures = texture_map[p_glyph_key];
+
+	ShelfPackTexture::Position tex_pos = _pack_in_textures(textures, p_width, p_height, p_image_format);
+	if (tex_pos.index != -1) {
+		return tex_pos;
+	}
+
+	int texture_size = MAX(p_glyph_key.font_size * p_glyph_key.font_oversampling * 8, ShelfPackTexture::MIN_TEXTURE_SIZE);
+
+	if (p_width > texture_size)
+		texture_size = p_width;
+	if (p_height > texture_size)
+		texture_size = p_height;
+
+	texture_size = next_power_of_2(texture_size);
+	texture_size = MIN(texture_size, ShelfPackTexture::MAX_TEXTURE_SIZE);
+
+	int64_t memory_used = 0;
+	for (int i = 0; i < textures.size(); i++) {
+		memory_used += textures[i].get_memory_size();
+	}
+
+	if (memory_used + texture_size * texture_size * p_color_size > glyph_atlas_budget) {
+		for (int attempt = 0; attempt < 4 && tex_pos.index == -1; attempt++) {
+			if (!_evict_glyphs(p_glyph_key, textures, p_width, p_height, p_image_format)) {
+				break;
+			}
+			tex_pos = _pack_in_textures(textures, p_width, p_height, p_image_format);
+		}
+
+		if (tex_pos.index != -1) {
+			return tex_pos;
+		}
 	}
 
+	ShelfPackTexture tex{};
+	tex.setup(texture_size, p_color_size, p_image_format, p_rect_range);
+
+	textures.push_back(tex);
+	int texture_index = textures.size() - 1;
+	tex_pos = textures.write[texture_index].pack_rect(texture_index, p_width, p_height);
+
 	return tex_pos;
 }
 
-_FORCE_INLINE_ GlyphInfo FontDriverFreeType::_rasterize_bitmap(const GlyphCacheKey &p_glyph_key, const FT_Bitmap &p_bitmap, int p_rect_range) {
+static _FORCE_INLINE_ void _get_bitmap_format(const FT_Bitmap &p_bitmap, int &r_color_size, Image::Format &r_image_format) {
+	switch (p_bitmap.pixel_mode) {
+		case FT_PIXEL_MODE_BGRA: {
+			r_color_size = 4;
+			r_image_format = Image::FORMAT_RGBA8;
+		} break;
+		default: {
+			r_color_size = 2;
+			r_image_format = Image::FORMAT_LA8;
+		} break;
+	}
+}
+
+// Copies the bitmap into the page with its top left corner at (p_x, p_y).
+static _FORCE_INLINE_ bool _write_bitmap(ShelfPackTexture &p_texture, int p_x, int p_y, const FT_Bitmap &p_bitmap) {
+	int w = p_bitmap.width;
+	int h = p_bitmap.rows;
+	int color_size = p_texture.color_size;
+
+	PoolVector<uint8_t>::Write wr = p_texture.image_data.write();
+
+	for (int i = 0; i < h; i++) {
+		for (int j = 0; j < w; j++) {
+			int ofs = ((i + p_y) * p_texture.texture_size + j + p_x) * color_size;
+			ERR_FAIL_COND_V(ofs >= p_texture.image_data.size(), false);
+			switch (p_bitmap.pixel_mode) {
+				case FT_PIXEL_MODE_MONO: {
+					int byte = i * p_bitmap.pitch + (j >> 3);
+					int bit = 1 << (7 - (j % 8));
+					wr[ofs + 0] = 255;
+					wr[ofs + 1] = (p_bitmap.buffer[byte] & bit) ? 255 : 0;
+				} break;
+				case FT_PIXEL_MODE_GRAY:
+					wr[ofs + 0] = 255;
+					wr[ofs + 1] = p_bitmap.buffer[i * p_bitmap.pitch + j];
+					break;
+				case FT_PIXEL_MODE_BGRA: {
+					int ofs_color = i * p_bitmap.pitch + (j << 2);
+					wr[ofs + 2] = p_bitmap.buffer[ofs_color + 0];
+					wr[ofs + 1] = p_bitmap.buffer[ofs_color + 1];
+					wr[ofs + 0] = p_bitmap.buffer[ofs_color + 2];
+					wr[ofs + 3] = p_bitmap.buffer[ofs_color + 3];
+				} break;
+				default:
+					ERR_FAIL_V_MSG(false, "Font uses unsupported pixel format: " + itos(p_bitmap.pixel_mode) + ".");
+					break;
+			}
+		}
+	}
+
+	return true;
+}
+
+static _FORCE_INLINE_ uint32_t _get_texture_flags(const GlyphCacheKey &p_glyph_key) {
+	uint32_t texture_flags = 0;
+	if (p_glyph_key.font_use_mipmaps) {
+		texture_flags |= Texture::FLAG_MIPMAPS;
+	}
+	if (p_glyph_key.font_use_filter) {
+		texture_flags |= Texture::FLAG_FILTER;
+	}
+	return texture_flags;
+}
+
+_FORCE_INLINE_ GlyphInfo FontDriverFreeType::_rasterize_bitmap(const GlyphCacheKey &p_glyph_key, uint32_t p_glyph_index, const FT_Bitmap &p_bitmap, int p_rect_range) {
 	GlyphInfo glyph_info{};
 
 	int rect_range = p_rect_range;
@@ -139,18 +378,7 @@ _FORCE_INLINE_ GlyphInfo FontDriverFreeType::_rasterize_bitmap(const GlyphCacheK
 
 	int color_size = 2;
 	Image::Format image_format = Image::FORMAT_LA8;
-
-	switch (p_bitmap.pixel_mode) {
-		case FT_PIXEL_MODE_MONO:
-		case FT_PIXEL_MODE_GRAY: {
-			color_size = 2;
-			image_format = Image::FORMAT_LA8;
-		} break;
-		case FT_PIXEL_MODE_BGRA: {
-			color_size = 4;
-			image_format = Image::FORMAT_RGBA8;
-		} break;
-	}
+	_get_bitmap_format(p_bitmap, color_size, image_format);
 
 	ERR_FAIL_COND_V(mw > ShelfPackTexture::MAX_TEXTURE_SIZE, glyph_info);
 	ERR_FAIL_COND_V(mh > ShelfPackTexture::MAX_TEXTURE_SIZE, glyph_info);
@@ -162,53 +390,81 @@ _FORCE_INLINE_ GlyphInfo FontDriverFreeType::_rasterize_bitmap(const GlyphCacheK
 	Vector<ShelfPackTexture> *textures = texture_map.getptr(p_glyph_key);
 	ERR_FAIL_COND_V(!textures, glyph_info);
 	ShelfPackTexture &tex = textures->write[tex_pos.index];
-	tex.dirty = true;
+	tex.mark_dirty_rect(tex_pos.x, tex_pos.y, mw, mh);
 
-	{
-		PoolVector<uint8_t>::Write wr = tex.image_data.write();
-
-		for (int i = 0; i < h; i++) {
-			for (int j = 0; j < w; j++) {
-				int ofs = ((i + tex_pos.y + rect_range) * tex.texture_size + j + tex_pos.x + rect_range) * color_size;
-				ERR_FAIL_COND_V(ofs >= tex.image_data.size(), glyph_info);
-				switch (p_bitmap.pixel_mode) {
-					case FT_PIXEL_MODE_MONO: {
-						int byte = i * p_bitmap.pitch + (j >> 3);
-						int bit = 1 << (7 - (j % 8));
-						wr[ofs + 0] = 255;
-						wr[ofs + 1] = (p_bitmap.buffer[byte] & bit) ? 255 : 0;
-					} break;
-					case FT_PIXEL_MODE_GRAY:
-						wr[ofs + 0] = 255;
-						wr[ofs + 1] = p_bitmap.buffer[i * p_bitmap.pitch + j];
-						break;
-					case FT_PIXEL_MODE_BGRA: {
-						int ofs_color = i * p_bitmap.pitch + (j << 2);
-						wr[ofs + 2] = p_bitmap.buffer[ofs_color + 0];
-						wr[ofs + 1] = p_bitmap.buffer[ofs_color + 1];
-						wr[ofs + 0] = p_bitmap.buffer[ofs_color + 2];
-						wr[ofs + 3] = p_bitmap.buffer[ofs_color + 3];
-					} break;
-					default:
-						ERR_FAIL_V_MSG(glyph_info, "Font uses unsupported pixel format: " + itos(p_bitmap.pixel_mode) + ".");
-						break;
-				}
-			}
-		}
+	glyph_info.texture_slot = tex.add_slot(p_glyph_index, tex_pos, mw, mh, Engine::get_singleton()->get_frames_drawn());
+
+	if (!_write_bitmap(tex, tex_pos.x + rect_range, tex_pos.y + rect_range, p_bitmap)) {
+		return glyph_info;
 	}
 
 	glyph_info.found = true;
 	glyph_info.texture_format = image_format;
 	glyph_info.texture_rect_uv = Rect2(tex_pos.x + rect_range, tex_pos.y + rect_range, w, h);
 	glyph_info.texture_size = glyph_info.texture_rect_uv.size / p_glyph_key.font_oversampling;
-	if (p_glyph_key.font_use_mipmaps) {
-		glyph_info.texture_flags |= Texture::FLAG_MIPMAPS;
+	glyph_info.texture_flags = _get_texture_flags(p_glyph_key);
+
+	return glyph_info;
+}
+
+_FORCE_INLINE_ bool FontDriverFreeType::_import_baked_glyphs(const GlyphCacheKey &p_glyph_key) {
+	// Baked pages only hold coverage bitmaps.
+	if (!baked_atlas.is_loaded() || p_glyph_key.font_distance_field) {
+		return false;
 	}
-	if (p_glyph_key.font_use_filter) {
-		glyph_info.texture_flags |= Texture::FLAG_FILTER;
+
+	MutexLock texture_lock(texture_mutex);
+
+	if (baked_glyph_keys.has(p_glyph_key)) {
+		return false;
 	}
+	baked_glyph_keys[p_glyph_key] = true;
 
-	return glyph_info;
+	int set = baked_atlas.find_set(p_glyph_key);
+	if (set == -1) {
+		return false;
+	}
+
+	// Baked pages are added full, live glyphs go to new pages until eviction repacks them.
+	Vector<ShelfPackTexture> &textures = texture_map[p_glyph_key];
+	int first_texture = textures.size();
+	for (int i = 0; i < baked_atlas.get_page_count(set); i++) {
+		Image::Format image_format = baked_atlas.get_page_format(set, i);
+
+		ShelfPackTexture tex{};
+		tex.setup_from_data(baked_atlas.get_page_texture_size(set, i), image_format == Image::FORMAT_RGBA8 ? 4 : 2, image_format, BakedGlyphAtlas::RECT_RANGE, baked_atlas.get_page_data(set, i));
+		textures.push_back(tex);
+	}
+
+	uint64_t frame = Engine::get_singleton()->get_frames_drawn();
+	uint32_t texture_flags = _get_texture_flags(p_glyph_key);
+	int rect_range = BakedGlyphAtlas::RECT_RANGE;
+
+	for (int i = 0; i < baked_atlas.get_glyph_count(set); i++) {
+		BakedGlyphAtlas::Glyph glyph = baked_atlas.get_glyph(set, i);
+		ShelfPackTexture &tex = textures.write[first_texture + glyph.page];
+
+		ShelfPackTexture::Position pos;
+		pos.index = first_texture + glyph.page;
+		pos.x = glyph.x - rect_range;
+		pos.y = glyph.y - rect_range;
+
+		GlyphInfo glyph_info{};
+		glyph_info.found = true;
+		glyph_info.cache_key = p_glyph_key;
+		glyph_info.texture_index = pos.index;
+		glyph_info.texture_slot = tex.add_slot(glyph.glyph_index, pos, glyph.w + rect_range * 2, glyph.h + rect_range * 2, frame);
+		glyph_info.texture_format = tex.image_format;
+		glyph_info.texture_rect_uv = Rect2(glyph.x, glyph.y, glyph.w, glyph.h);
+		glyph_info.texture_size = glyph_info.texture_rect_uv.size / p_glyph_key.font_oversampling;
+		glyph_info.texture_flags = texture_flags;
+		glyph_info.texture_offset = glyph.offset / p_glyph_key.font_oversampling;
+		glyph_info.advance = glyph.advance / p_glyph_key.font_oversampling;
+
+		_store_glyph_info(p_glyph_key, glyph.glyph_index, glyph_info);
+	}
+
+	return true;
 }
 
 _FORCE_INLINE_ void _ft_face_finalizer(void *p_ft_face) {
@@ -375,6 +631,20 @@ Error FontDriverFreeType::init() {
 		ERR_PRINT("[FreeType] Failed to initialize: '" + String(FT_Error_String(error)) + "'.");
 	}
 
+	int budget_mb = GLOBAL_DEF("gui/text/glyph_atlas_budget_mb", 16);
+	ProjectSettings::get_singleton()->set_custom_property_info("gui/text/glyph_atlas_budget_mb", PropertyInfo(Variant::INT, "gui/text/glyph_atlas_budget_mb", PROPERTY_HINT_RANGE, "1,256,1,or_greater"));
+	glyph_atlas_budget = (int64_t)MAX(budget_mb, 1) * 1024 * 1024;
+
+	// Filled in at export time, see EditorExportBakedGlyphAtlas.
+	String baked_atlas_path = GLOBAL_DEF("gui/text/baked_glyph_atlas_path", "");
+	ProjectSettings::get_singleton()->set_custom_property_info("gui/text/baked_glyph_atlas_path", PropertyInfo(Variant::STRING, "gui/text/baked_glyph_atlas_path", PROPERTY_HINT_FILE, "*.gga"));
+	GLOBAL_DEF("gui/text/baked_glyph_atlas_fonts", PoolStringArray());
+	GLOBAL_DEF("gui/text/baked_glyph_atlas_chars", "");
+
+	if (!baked_atlas_path.empty() && FileAccess::exists(baked_atlas_path)) {
+		baked_atlas.load(baked_atlas_path);
+	}
+
 	_setup_builtin_fonts();
 
 	return OK;
@@ -390,6 +660,8 @@ Error FontDriverFreeType::load_font_data(FontID &r_font_id, const PoolVector<uin
 
 	r_font_id.font_hash = XXH32(p_font_data.read().ptr(), p_font_data.size(), 0);
 
+	MutexLock lock(ft_mutex);
+
 	FontInfo **font_info = font_id_to_info.getptr(r_font_id);
 	if (!font_info) {
 		FontInfo *new_font_info = memnew(FontInfo);
@@ -429,6 +701,8 @@ Error FontDriverFreeType::load_font_file(FontID &r_font_id, const String &p_font
 
 	r_font_id.font_hash = XXH32(font_data.read().ptr(), font_data.size(), 0);
 
+	MutexLock lock(ft_mutex);
+
 	FontInfo **font_info = font_id_to_info.getptr(r_font_id);
 	if (!font_info) {
 		FontInfo *new_font_info = memnew(FontInfo);
@@ -447,9 +721,21 @@ Error FontDriverFreeType::load_font_file(FontID &r_font_id, const String &p_font
 	return OK;
 }
 
+FontDriverFreeType::ScopedFace::ScopedFace(const FontDriverFreeType *p_driver, const FontID &p_font_id, int p_size, int p_oversampling) :
+		lock(p_driver->ft_mutex),
+		face(NULL) {
+	FT_Face ft_face = p_driver->get_ft_face(p_font_id);
+	// Looking up the size makes it the active one on the face.
+	if (ft_face && p_driver->get_ft_size(p_font_id, p_size, p_oversampling)) {
+		face = ft_face;
+	}
+}
+
 FT_Face FontDriverFreeType::get_ft_face(const FontID &p_font_id) const {
 	ERR_FAIL_COND_V(!p_font_id.is_valid(), NULL);
 
+	MutexLock lock(ft_mutex);
+
 	FontInfo **font_info = font_id_to_info.getptr(p_font_id);
 	ERR_FAIL_COND_V(!font_info || !*font_info, NULL);
 
@@ -463,6 +749,8 @@ FT_Face FontDriverFreeType::get_ft_face(const FontID &p_font_id) const {
 FT_Size FontDriverFreeType::get_ft_size(const FontID &p_font_id, int p_size, int p_oversampling) const {
 	ERR_FAIL_COND_V(!p_font_id.is_valid(), NULL);
 
+	MutexLock lock(ft_mutex);
+
 	FontInfo **font_info = font_id_to_info.getptr(p_font_id);
 	ERR_FAIL_COND_V(!font_info || !*font_info, NULL);
 
@@ -481,12 +769,27 @@ FT_Size FontDriverFreeType::get_ft_size(const FontID &p_font_id, int p_size, int
 	return ft_size;
 }
 
+PoolVector<uint8_t> FontDriverFreeType::get_font_data(const FontID &p_font_id) const {
+	ERR_FAIL_COND_V(!p_font_id.is_valid(), PoolVector<uint8_t>());
+
+	// Make sure the face data is resident, the copy keeps it alive while other threads read it.
+	MutexLock lock(ft_mutex);
+	ERR_FAIL_COND_V(!get_ft_face(p_font_id), PoolVector<uint8_t>());
+
+	FontInfo **font_info = font_id_to_info.getptr(p_font_id);
+	ERR_FAIL_COND_V(!font_info || !*font_info, PoolVector<uint8_t>());
+
+	return (*font_info)->get_owner()->data;
+}
+
 Vector<FontID> FontDriverFreeType::get_builtin_font_ids() const {
 	return builtin_font_ids;
 }
 
 Ref<FontDriver::FontInfo> FontDriverFreeType::get_font_info(const FontID &p_font_id) const {
 	ERR_FAIL_COND_V(!p_font_id.is_valid(), Ref<FontInfo>());
+
+	MutexLock lock(ft_mutex);
 	ERR_FAIL_COND_V(!font_id_to_info.has(p_font_id), Ref<FontInfo>());
 
 	FontInfo *info = font_id_to_info[p_font_id];
@@ -494,6 +797,8 @@ Ref<FontDriver::FontInfo> FontDriverFreeType::get_font_info(const FontID &p_font
 }
 
 Ref<FontDriver::FontInfo> FontDriverFreeType::get_font_info(const FT_Face &p_ft_face) const {
+	MutexLock lock(ft_mutex);
+
 	ERR_FAIL_COND_V(!face_to_info.has(p_ft_face), Ref<FontInfo>());
 
 	FontInfo *info = face_to_info[p_ft_face];
@@ -501,6 +806,8 @@ Ref<FontDriver::FontInfo> FontDriverFreeType::get_font_info(const FT_Face &p_ft_
 }
 
 void FontDriverFreeType::finalize_font(const FontID &p_font_id) {
+	MutexLock lock(ft_mutex);
+
 	FontInfo **p_info = font_id_to_info.getptr(p_font_id);
 	if (!p_info || !*p_info) {
 		return;
@@ -516,18 +823,52 @@ void FontDriverFreeType::finalize_font(const FontID &p_font_id) {
 }
 
 void FontDriverFreeType::clear_glyph_cache(const GlyphCacheKey &p_glyph_key) {
-	if (glyph_info_map.has(p_glyph_key)) {
-		glyph_info_map.erase(p_glyph_key);
+	for (int i = 0; i < GLYPH_CACHE_SHARDS; i++) {
+		RWLockWrite write_lock(glyph_cache_shards[i].lock);
+		glyph_cache_shards[i].glyph_info_map.erase(p_glyph_key);
 	}
 
-	if (texture_map.has(p_glyph_key)) {
+	MutexLock texture_lock(texture_mutex);
+
+	Vector<ShelfPackTexture> *textures = texture_map.getptr(p_glyph_key);
+	if (textures) {
+		for (int i = 0; i < textures->size(); i++) {
+			if ((*textures)[i].texture_rid.is_valid()) {
+				VisualServer::get_singleton()->free((*textures)[i].texture_rid);
+			}
+		}
 		texture_map.erase(p_glyph_key);
 	}
+	baked_glyph_keys.erase(p_glyph_key);
 }
 
 GlyphInfo FontDriverFreeType::get_glyph_info(const GlyphCacheKey &p_glyph_key, uint32_t p_glyph_index) {
+	if (p_glyph_key.font_distance_field) {
+		// Every size shares the glyphs of the base size field.
+		GlyphCacheKey field_key = _get_distance_field_key(p_glyph_key);
+		if (field_key != p_glyph_key) {
+			return _scale_distance_field_glyph(get_glyph_info(field_key, p_glyph_index), p_glyph_key);
+		}
+	}
+
 	GlyphInfo glyph_info{};
 
+	if (_get_cached_glyph_info(p_glyph_key, p_glyph_index, glyph_info)) {
+		return glyph_info;
+	}
+
+	// The first miss of a baked size brings in all of its glyphs at once.
+	if (_import_baked_glyphs(p_glyph_key) && _get_cached_glyph_info(p_glyph_key, p_glyph_index, glyph_info)) {
+		return glyph_info;
+	}
+
+	MutexLock ft_lock(ft_mutex);
+
+	// Another thread may have rasterized the glyph while we were waiting.
+	if (_get_cached_glyph_info(p_glyph_key, p_glyph_index, glyph_info)) {
+		return glyph_info;
+	}
+
 	FontID font_id = p_glyph_key.get_font_id();
 
 	FT_Face ft_face = get_ft_face(font_id);
@@ -536,70 +877,285 @@ GlyphInfo FontDriverFreeType::get_glyph_info(const GlyphCacheKey &p_glyph_key, u
 	FT_Size ft_size = get_ft_size(font_id, p_glyph_key.font_size, p_glyph_key.font_oversampling);
 	ERR_FAIL_COND_V(!ft_size, glyph_info);
 
-	HashMap<uint32_t, GlyphInfo> *glyph_map = glyph_info_map.getptr(p_glyph_key);
-	if (glyph_map && glyph_map->has(p_glyph_index)) {
-		return (*glyph_map)[p_glyph_index];
-	}
-
-	int load_flags = FT_HAS_COLOR(ft_face) ? FT_LOAD_COLOR : FT_LOAD_DEFAULT;
-	switch (p_glyph_key.font_custom_flags) {
-		case FreeTypeFont::HINTING_NONE:
-			load_flags |= FT_LOAD_NO_HINTING;
-			break;
-		case FreeTypeFont::HINTING_AUTO:
-			load_flags |= FT_LOAD_FORCE_AUTOHINT;
-			break;
-		case FreeTypeFont::HINTING_LIGHT:
-			load_flags |= FT_LOAD_TARGET_LIGHT;
-			break;
-		default:
-			load_flags |= FT_LOAD_TARGET_NORMAL;
-			break;
-	}
-
-	int error = FT_Load_Glyph(ft_face, p_glyph_index, load_flags);
+	int error = FT_Load_Glyph(ft_face, p_glyph_index, _get_load_flags(ft_face, p_glyph_key));
 
 	FT_GlyphSlot ft_glyph_slot = ft_face->glyph;
 	if (!error) {
-		error = FT_Render_Glyph(ft_glyph_slot, FT_RENDER_MODE_NORMAL);
+		error = FT_Render_Glyph(ft_glyph_slot, _get_render_mode(p_glyph_key));
 	}
 	if (!error) {
-		glyph_info = _rasterize_bitmap(p_glyph_key, ft_glyph_slot->bitmap);
+		MutexLock texture_lock(texture_mutex);
+
+		glyph_info = _rasterize_bitmap(p_glyph_key, p_glyph_index, ft_glyph_slot->bitmap);
 		glyph_info.cache_key = p_glyph_key;
 		glyph_info.texture_offset = Vector2(ft_glyph_slot->bitmap_left, -ft_glyph_slot->bitmap_top) / p_glyph_key.font_oversampling;
 		glyph_info.advance = Vector2(ft_glyph_slot->advance.x / 64.0, ft_glyph_slot->advance.y / 64.0) / p_glyph_key.font_oversampling;
 	}
 
 	if (glyph_info.found) {
-		HashMap<uint32_t, GlyphInfo> &glyph_map = glyph_info_map[p_glyph_key];
-		glyph_map[p_glyph_index] = glyph_info;
+		_store_glyph_info(p_glyph_key, p_glyph_index, glyph_info);
 	}
 
 	return glyph_info;
 }
 
 RID FontDriverFreeType::get_glyph_texture_rid(const GlyphInfo &p_glyph_info) {
+	MutexLock texture_lock(texture_mutex);
+
 	Vector<ShelfPackTexture> *textures = texture_map.getptr(p_glyph_info.cache_key);
 	ERR_FAIL_COND_V(!textures, RID());
 	ERR_FAIL_INDEX_V(p_glyph_info.texture_index, textures->size(), RID());
 
-	if ((*textures)[p_glyph_info.texture_index].dirty) {
-		ShelfPackTexture &tex = textures->write[p_glyph_info.texture_index];
+	ShelfPackTexture &tex = textures->write[p_glyph_info.texture_index];
+	tex.touch(p_glyph_info.texture_slot, p_glyph_info.texture_rect_uv.position, Engine::get_singleton()->get_frames_drawn());
+
+	if (tex.dirty || !tex.texture_rid.is_valid()) {
 		tex.dirty = false;
+		tex.dirty_rects.clear();
 		Ref<Image> img = memnew(Image(tex.texture_size, tex.texture_size, 0, tex.image_format, tex.image_data));
 		if (!tex.texture_rid.is_valid()) {
 			tex.texture_rid = VisualServer::get_singleton()->texture_create_from_image(img, Texture::FLAG_VIDEO_SURFACE | p_glyph_info.texture_flags);
 		} else {
 			VisualServer::get_singleton()->texture_set_data(tex.texture_rid, img);
 		}
+	} else if (tex.dirty_rects.size()) {
+		// Only the regions touched since the last upload are sent, as copies so image_data stays unshared.
+		for (int i = 0; i < (int)tex.dirty_rects.size(); i++) {
+			const Rect2i &rect = tex.dirty_rects[i];
+			Ref<Image> img = tex.get_rect_image(rect);
+			VisualServer::get_singleton()->texture_set_data_partial(tex.texture_rid, img, 0, 0, rect.size.width, rect.size.height, rect.position.x, rect.position.y, 0, 0);
+		}
+		tex.dirty_rects.clear();
 	}
 
-	return (*textures)[p_glyph_info.texture_index].texture_rid;
+	return tex.texture_rid;
+}
+
+void FontDriverFreeType::_prewarm_chunk(uint32_t p_chunk, PrewarmJob *p_job) {
+	// Every chunk renders with its own library and face, no shared FreeType state is touched.
+	FT_Library library = NULL;
+	if (FT_Init_FreeType(&library)) {
+		return;
+	}
+
+	PoolVector<uint8_t>::Read r = p_job->font_data.read();
+
+	FT_Face face = NULL;
+	FT_Error error = FT_New_Memory_Face(library, r.ptr(), p_job->font_data.size(), p_job->glyph_key.font_id.font_index, &face);
+	if (!error) {
+		FT_F26Dot6 char_size = p_job->glyph_key.font_size * 64 * p_job->glyph_key.font_oversampling;
+		error = FT_Set_Char_Size(face, char_size, char_size, 0, 0);
+	}
+
+	if (!error) {
+		int load_flags = _get_load_flags(face, p_job->glyph_key);
+
+		for (int i = p_chunk; i < p_job->glyph_count; i += p_job->chunk_count) {
+			PrewarmGlyph &glyph = p_job->glyphs[i];
+
+			if (FT_Load_Glyph(face, glyph.glyph_index, load_flags) || FT_Render_Glyph(face->glyph, _get_render_mode(p_job->glyph_key))) {
+				continue;
+			}
+
+			const FT_Bitmap &bitmap = face->glyph->bitmap;
+			if (bitmap.pitch < 0) {
+				continue;
+			}
+
+			glyph.bitmap_width = bitmap.width;
+			glyph.bitmap_rows = bitmap.rows;
+			glyph.bitmap_pitch = bitmap.pitch;
+			glyph.bitmap_pixel_mode = bitmap.pixel_mode;
+			glyph.bitmap_buffer.resize(bitmap.rows * bitmap.pitch);
+			if (glyph.bitmap_buffer.size() > 0) {
+				copymem(glyph.bitmap_buffer.ptrw(), bitmap.buffer, glyph.bitmap_buffer.size());
+			}
+
+			glyph.bitmap_offset = Vector2(face->glyph->bitmap_left, -face->glyph->bitmap_top);
+			glyph.advance = Vector2(face->glyph->advance.x / 64.0, face->glyph->advance.y / 64.0);
+			glyph.rendered = true;
+		}
+	}
+
+	if (face) {
+		FT_Done_Face(face);
+	}
+	FT_Done_FreeType(library);
+}
+
+void FontDriverFreeType::_render_glyphs(const GlyphCacheKey &p_glyph_key, Vector<PrewarmGlyph> &r_glyphs) {
+	PrewarmJob job;
+	job.glyph_key = p_glyph_key;
+	job.font_data = get_font_data(p_glyph_key.get_font_id());
+
+	if (job.font_data.empty() || r_glyphs.empty()) {
+		return;
+	}
+
+	job.glyphs = r_glyphs.ptrw();
+	job.glyph_count = r_glyphs.size();
+	job.chunk_count = CLAMP(OS::get_singleton()->get_processor_count(), 1, job.glyph_count);
+
+	thread_process_array(job.chunk_count, this, &FontDriverFreeType::_prewarm_chunk, &job);
+}
+
+void FontDriverFreeType::prewarm_glyphs(const GlyphCacheKey &p_glyph_key, const Vector<uint32_t> &p_glyph_indices) {
+	if (p_glyph_key.font_distance_field) {
+		GlyphCacheKey field_key = _get_distance_field_key(p_glyph_key);
+		if (field_key != p_glyph_key) {
+			prewarm_glyphs(field_key, p_glyph_indices);
+			return;
+		}
+	}
+
+	_import_baked_glyphs(p_glyph_key);
+
+	Vector<PrewarmGlyph> glyphs;
+	{
+		HashMap<uint32_t, bool> seen;
+		GlyphInfo glyph_info;
+		for (int i = 0; i < p_glyph_indices.size(); i++) {
+			uint32_t glyph_index = p_glyph_indices[i];
+			if (seen.has(glyph_index) || _get_cached_glyph_info(p_glyph_key, glyph_index, glyph_info)) {
+				continue;
+			}
+			seen[glyph_index] = true;
+
+			PrewarmGlyph glyph;
+			glyph.glyph_index = glyph_index;
+			glyphs.push_back(glyph);
+		}
+	}
+
+	if (glyphs.empty()) {
+		return;
+	}
+
+	_render_glyphs(p_glyph_key, glyphs);
+
+	for (int i = 0; i < glyphs.size(); i++) {
+		const PrewarmGlyph &glyph = glyphs[i];
+
+		if (!glyph.rendered) {
+			get_glyph_info(p_glyph_key, glyph.glyph_index);
+			continue;
+		}
+
+		GlyphInfo glyph_info;
+		if (_get_cached_glyph_info(p_glyph_key, glyph.glyph_index, glyph_info)) {
+			continue;
+		}
+
+		FT_Bitmap bitmap = glyph.get_bitmap();
+
+		{
+			MutexLock texture_lock(texture_mutex);
+
+			glyph_info = _rasterize_bitmap(p_glyph_key, glyph.glyph_index, bitmap);
+			glyph_info.cache_key = p_glyph_key;
+			glyph_info.texture_offset = glyph.bitmap_offset / p_glyph_key.font_oversampling;
+			glyph_info.advance = glyph.advance / p_glyph_key.font_oversampling;
+		}
+
+		if (glyph_info.found) {
+			_store_glyph_info(p_glyph_key, glyph.glyph_index, glyph_info);
+		}
+	}
+}
+
+Error FontDriverFreeType::bake_glyph_atlas(const Vector<GlyphCacheKey> &p_glyph_keys, const String &p_chars, Vector<uint8_t> &r_data) {
+	Vector<BakedGlyphAtlas::Set> sets;
+	int rect_range = BakedGlyphAtlas::RECT_RANGE;
+
+	for (int i = 0; i < p_glyph_keys.size(); i++) {
+		const GlyphCacheKey &glyph_key = p_glyph_keys[i];
+		ERR_FAIL_COND_V(!validate_font(glyph_key.font_id), ERR_INVALID_PARAMETER);
+
+		Vector<PrewarmGlyph> glyphs;
+		{
+			HashMap<uint32_t, bool> seen;
+			for (int j = 0; j < p_chars.length(); j++) {
+				uint32_t glyph_index = get_glyph_index(glyph_key.font_id, p_chars[j]);
+				if (glyph_index == 0 || seen.has(glyph_index)) {
+					continue;
+				}
+				seen[glyph_index] = true;
+
+				PrewarmGlyph glyph;
+				glyph.glyph_index = glyph_index;
+				glyphs.push_back(glyph);
+			}
+		}
+
+		_render_glyphs(glyph_key, glyphs);
+
+		int page_size = MAX(glyph_key.font_size * glyph_key.font_oversampling * 32, ShelfPackTexture::MIN_TEXTURE_SIZE);
+		page_size = MIN(next_power_of_2(page_size), ShelfPackTexture::MAX_TEXTURE_SIZE);
+
+		BakedGlyphAtlas::Set set;
+		set.glyph_key = glyph_key;
+
+		Vector<ShelfPackTexture> pages;
+		for (int j = 0; j < glyphs.size(); j++) {
+			const PrewarmGlyph &glyph = glyphs[j];
+			if (!glyph.rendered) {
+				continue;
+			}
+
+			FT_Bitmap bitmap = glyph.get_bitmap();
+
+			int color_size = 2;
+			Image::Format image_format = Image::FORMAT_LA8;
+			_get_bitmap_format(bitmap, color_size, image_format);
+
+			int mw = bitmap.width + rect_range * 2;
+			int mh = bitmap.rows + rect_range * 2;
+			ERR_CONTINUE(mw > page_size || mh > page_size);
+
+			ShelfPackTexture::Position pos = _pack_in_textures(pages, mw, mh, image_format);
+			if (pos.index == -1) {
+				ShelfPackTexture page{};
+				page.setup(page_size, color_size, image_format, rect_range);
+				pages.push_back(page);
+				pos = pages.write[pages.size() - 1].pack_rect(pages.size() - 1, mw, mh);
+				ERR_CONTINUE(pos.index == -1);
+			}
+
+			ERR_CONTINUE(!_write_bitmap(pages.write[pos.index], pos.x + rect_range, pos.y + rect_range, bitmap));
+
+			BakedGlyphAtlas::Glyph baked_glyph;
+			baked_glyph.glyph_index = glyph.glyph_index;
+			baked_glyph.page = pos.index;
+			baked_glyph.x = pos.x + rect_range;
+			baked_glyph.y = pos.y + rect_range;
+			baked_glyph.w = bitmap.width;
+			baked_glyph.h = bitmap.rows;
+			baked_glyph.offset = glyph.bitmap_offset;
+			baked_glyph.advance = glyph.advance;
+			set.glyphs.push_back(baked_glyph);
+		}
+
+		for (int j = 0; j < pages.size(); j++) {
+			BakedGlyphAtlas::Page page;
+			page.texture_size = pages[j].texture_size;
+			page.format = pages[j].image_format;
+			page.data = pages[j].image_data;
+			set.pages.push_back(page);
+		}
+
+		sets.push_back(set);
+	}
+
+	r_data = BakedGlyphAtlas::encode(sets);
+
+	return OK;
 }
 
 bool FontDriverFreeType::owns_font(const FontID &p_font_id) const {
 	ERR_FAIL_COND_V(!p_font_id.is_valid(), false);
 
+	MutexLock lock(ft_mutex);
+
 	return font_id_to_info.has(p_font_id);
 }
 
@@ -612,6 +1168,8 @@ static _FORCE_INLINE_ FontID _get_base_font_id(const FontID &p_font_id) {
 bool FontDriverFreeType::validate_font(const FontID &p_font_id) {
 	ERR_FAIL_COND_V(!p_font_id.is_valid(), false);
 
+	MutexLock lock(ft_mutex);
+
 	if (!font_id_to_info.has(p_font_id)) {
 		FontID base_id = _get_base_font_id(p_font_id);
 		FontInfo **base_font_info = font_id_to_info.getptr(base_id);
@@ -638,6 +1196,8 @@ bool FontDriverFreeType::validate_font(const FontID &p_font_id) {
 uint32_t FontDriverFreeType::get_glyph_index(const FontID &p_font_id, char32_t p_char) const {
 	ERR_FAIL_COND_V(!p_font_id.is_valid(), 0);
 
+	MutexLock lock(ft_mutex);
+
 	FT_Face ft_face = get_ft_face(p_font_id);
 	ERR_FAIL_COND_V(!ft_face, false);
 
@@ -647,6 +1207,8 @@ uint32_t FontDriverFreeType::get_glyph_index(const FontID &p_font_id, char32_t p
 bool FontDriverFreeType::get_font_metrics(float &r_ascent, float &r_descent, const FontID &p_font_id, int p_size, int p_oversampling) const {
 	ERR_FAIL_COND_V(!p_font_id.is_valid(), false);
 
+	MutexLock lock(ft_mutex);
+
 	FT_Size ft_size = get_ft_size(p_font_id, p_size, p_oversampling);
 	ERR_FAIL_COND_V(!ft_size, false);
 
@@ -658,6 +1220,8 @@ bool FontDriverFreeType::get_font_metrics(float &r_ascent, float &r_descent, con
 Vector2 FontDriverFreeType::get_font_kerning(const FontID &p_font_id, char32_t p_char, char32_t p_next_char, int p_size, int p_oversampling) const {
 	ERR_FAIL_COND_V(!p_font_id.is_valid(), Vector2());
 
+	MutexLock lock(ft_mutex);
+
 	FT_Face ft_face = get_ft_face(p_font_id);
 	ERR_FAIL_COND_V(!ft_face, Vector2());
 
@@ -677,6 +1241,7 @@ Vector2 FontDriverFreeType::get_font_kerning(const FontID &p_font_id, char32_t p
 FontDriverFreeType::FontDriverFreeType() {
 	ft_library = NULL;
 	ftc_manager = NULL;
+	glyph_atlas_budget = 16 * 1024 * 1024;
 }
 
 FontDriverFreeType::~FontDriverFreeType() {
@@ -33,10 +33,13 @@
 
 #include "core/hash_map.h"
 #include "core/map.h"
+#include "core/os/mutex.h"
+#include "core/os/rw_lock.h"
 #include "core/pool_vector.h"
 #include "core/reference.h"
 #include "servers/font_server.h"
 
+#include "baked_glyph_atlas.h"
 #include "shelf_pack_texture.h"
 
 #include <ft2build.h>
@@ -52,18 +55,122 @@ class FontDriverFreeType : public FontDriver {
 	mutable HashMap<FontID, FontInfo *, FontIDHasher> font_id_to_info;
 	Map<FT_Face, FontInfo *> face_to_info;
 
-	HashMap<GlyphCacheKey, Vector<ShelfPackTexture>, GlyphCacheKeyHasher> texture_map;
-	HashMap<GlyphCacheKey, HashMap<uint32_t, GlyphInfo>, GlyphCacheKeyHasher> glyph_info_map;
+	enum {
+		GLYPH_CACHE_SHARDS = 16,
+		// Pixel size distance field glyphs are rendered at, whatever size they are drawn at.
+		DISTANCE_FIELD_SIZE = 48,
+	};
+
+	// Glyph infos are spread over shards by cache key and glyph index, so
+	// concurrent readers rarely touch the same lock.
+	struct GlyphCacheShard {
+		RWLock lock;
+		HashMap<GlyphCacheKey, HashMap<uint32_t, GlyphInfo>, GlyphCacheKeyHasher> glyph_info_map;
+	};
 
+	GlyphCacheShard glyph_cache_shards[GLYPH_CACHE_SHARDS];
+
+	// Atlas pages, guarded by texture_mutex. Once the pages of a cache key
+	// reach glyph_atlas_budget, least recently drawn glyphs are evicted
+	// instead of allocating new pages.
+	HashMap<GlyphCacheKey, Vector<ShelfPackTexture>, GlyphCacheKeyHasher> texture_map;
+	Mutex texture_mutex;
+	int64_t glyph_atlas_budget;
+
+	struct EvictionCandidate {
+		uint64_t last_used = 0;
+		int texture_index = 0;
+		int slot = 0;
+
+		_FORCE_INLINE_ bool operator<(const EvictionCandidate &p_other) const {
+			return last_used < p_other.last_used;
+		}
+	};
+
+	// Glyphs baked at export time, imported a whole size at a time on the
+	// first miss. baked_glyph_keys is guarded by texture_mutex.
+	BakedGlyphAtlas baked_atlas;
+	HashMap<GlyphCacheKey, bool, GlyphCacheKeyHasher> baked_glyph_keys;
+
+	// FT_Library, FTC_Manager and the faces it hands out are not thread safe.
+	Mutex ft_mutex;
+
+	struct PrewarmGlyph {
+		uint32_t glyph_index = 0;
+		bool rendered = false;
+
+		int bitmap_width = 0;
+		int bitmap_rows = 0;
+		int bitmap_pitch = 0;
+		unsigned char bitmap_pixel_mode = 0;
+		Vector<uint8_t> bitmap_buffer;
+
+		Vector2 bitmap_offset;
+		Vector2 advance;
+
+		_FORCE_INLINE_ FT_Bitmap get_bitmap() const {
+			FT_Bitmap bitmap;
+			zeromem(&bitmap, sizeof(FT_Bitmap));
+			bitmap.width = bitmap_width;
+			bitmap.rows = bitmap_rows;
+			bitmap.pitch = bitmap_pitch;
+			bitmap.pixel_mode = bitmap_pixel_mode;
+			bitmap.buffer = (unsigned char *)bitmap_buffer.ptr();
+			return bitmap;
+		}
+	};
+
+	struct PrewarmJob {
+		GlyphCacheKey glyph_key;
+		PoolVector<uint8_t> font_data;
+		PrewarmGlyph *glyphs = NULL;
+		int glyph_count = 0;
+		int chunk_count = 1;
+	};
+
+	_FORCE_INLINE_ GlyphCacheShard &_get_glyph_cache_shard(const GlyphCacheKey &p_glyph_key, uint32_t p_glyph_index) {
+		return glyph_cache_shards[(GlyphCacheKeyHasher::hash(p_glyph_key) ^ (p_glyph_index * 2654435761u)) % GLYPH_CACHE_SHARDS];
+	}
+
+	static _FORCE_INLINE_ GlyphCacheKey _get_distance_field_key(const GlyphCacheKey &p_glyph_key);
+	static _FORCE_INLINE_ GlyphInfo _scale_distance_field_glyph(const GlyphInfo &p_glyph_info, const GlyphCacheKey &p_glyph_key);
+
+	_FORCE_INLINE_ bool _get_cached_glyph_info(const GlyphCacheKey &p_glyph_key, uint32_t p_glyph_index, GlyphInfo &r_glyph_info);
+	_FORCE_INLINE_ void _store_glyph_info(const GlyphCacheKey &p_glyph_key, uint32_t p_glyph_index, const GlyphInfo &p_glyph_info);
+
+	void _prewarm_chunk(uint32_t p_chunk, PrewarmJob *p_job);
+	void _render_glyphs(const GlyphCacheKey &p_glyph_key, Vector<PrewarmGlyph> &r_glyphs);
+	_FORCE_INLINE_ bool _import_baked_glyphs(const GlyphCacheKey &p_glyph_key);
+
+	_FORCE_INLINE_ void _erase_glyph_info(const GlyphCacheKey &p_glyph_key, uint32_t p_glyph_index);
+	_FORCE_INLINE_ void _move_glyph_info(const GlyphCacheKey &p_glyph_key, const ShelfPackTexture &p_texture, const ShelfPackTexture::Slot &p_slot);
+	_FORCE_INLINE_ bool _evict_glyphs(const GlyphCacheKey &p_glyph_key, Vector<ShelfPackTexture> &p_textures, int p_width, int p_height, Image::Format p_image_format);
+	_FORCE_INLINE_ ShelfPackTexture::Position _pack_in_textures(Vector<ShelfPackTexture> &p_textures, int p_width, int p_height, Image::Format p_image_format);
 	_FORCE_INLINE_ ShelfPackTexture::Position _find_texture_pos(const GlyphCacheKey &p_glyph_key, int p_width, int p_height, int p_color_size, Image::Format p_image_format, int p_rect_range);
-	_FORCE_INLINE_ GlyphInfo _rasterize_bitmap(const GlyphCacheKey &p_glyph_key, const FT_Bitmap &p_bitmap, int p_rect_range = 1);
+	_FORCE_INLINE_ GlyphInfo _rasterize_bitmap(const GlyphCacheKey &p_glyph_key, uint32_t p_glyph_index, const FT_Bitmap &p_bitmap, int p_rect_range = 1);
 
 	friend _FORCE_INLINE_ FT_Error _ftc_manager_requester(FTC_FaceID p_font_info_ptr, FT_Library p_library, FT_Pointer p_request_data, FT_Face *r_face);
 	friend _FORCE_INLINE_ void _ft_face_finalizer(void *p_ft_face);
 
 	_FORCE_INLINE_ void _setup_builtin_fonts();
 
+	// The returned objects belong to the cache, callers must hold ft_mutex while they use them.
+	FT_Face get_ft_face(const FontID &p_font_id) const;
+	FT_Size get_ft_size(const FontID &p_font_id, int p_size, int p_oversampling) const;
+
 public:
+	// A face with the requested size active. ft_mutex stays locked for the lifetime of the
+	// accessor, so the cache can't flush or resize the face while it is used.
+	class ScopedFace {
+		MutexLock lock;
+		FT_Face face;
+
+	public:
+		_FORCE_INLINE_ FT_Face get() const { return face; }
+
+		ScopedFace(const FontDriverFreeType *p_driver, const FontID &p_font_id, int p_size, int p_oversampling);
+	};
+
 	virtual Error init();
 
 	virtual const char *get_name() const { return "FreeType"; }
@@ -71,8 +178,8 @@ public:
 	virtual Error load_font_data(FontID &r_font_id, const PoolVector<uint8_t> &p_font_data);
 	virtual Error load_font_file(FontID &r_font_id, const String &p_font_path);
 
-	FT_Face get_ft_face(const FontID &p_font_id) const;
-	FT_Size get_ft_size(const FontID &p_font_id, int p_size, int p_oversampling) const;
+	// Face data, loaded if needed, for threads that open their own faces.
+	PoolVector<uint8_t> get_font_data(const FontID &p_font_id) const;
 
 	virtual Vector<FontID> get_builtin_font_ids() const;
 	virtual Ref<FontInfo> get_font_info(const FontID &p_font_id) const;
@@ -89,6 +196,10 @@ public:
 	virtual void clear_glyph_cache(const GlyphCacheKey &p_glyph_key);
 	virtual GlyphInfo get_glyph_info(const GlyphCacheKey &p_glyph_key, uint32_t p_glyph_index);
 	virtual RID get_glyph_texture_rid(const GlyphInfo &p_glyph_info);
+	virtual void prewarm_glyphs(const GlyphCacheKey &p_glyph_key, const Vector<uint32_t> &p_glyph_indices);
+
+	// Rasterizes p_chars for every key into a BakedGlyphAtlas file image.
+	Error bake_glyph_atlas(const Vector<GlyphCacheKey> &p_glyph_keys, const String &p_chars, Vector<uint8_t> &r_data);
 
 	FontDriverFreeType();
 	virtual ~FontDriverFreeType();
@@ -46,12 +46,16 @@ void FreeTypeFont::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_hinting", "mode"), &FreeTypeFont::set_hinting);
 	ClassDB::bind_method(D_METHOD("get_hinting"), &FreeTypeFont::get_hinting);
 
+	ClassDB::bind_method(D_METHOD("set_distance_field", "enable"), &FreeTypeFont::set_distance_field);
+	ClassDB::bind_method(D_METHOD("is_distance_field"), &FreeTypeFont::is_distance_field);
+
 	ADD_PROPERTY(PropertyInfo(Variant::STRING, "load_path", PROPERTY_HINT_FILE, "*.ttf,*.ttc,*.otf,*.otc"), "load", "get_load_path");
 
 	ADD_GROUP("Settings", "");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "face_index", PROPERTY_HINT_RANGE, "0,1024,1"), "set_face_index", "get_face_index");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "face_size", PROPERTY_HINT_RANGE, "1,1024,1"), "set_face_size", "get_face_size");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "hinting", PROPERTY_HINT_ENUM, "None,Auto,Light,Normal"), "set_hinting", "get_hinting");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "distance_field"), "set_distance_field", "is_distance_field");
 
 	BIND_ENUM_CONSTANT(HINTING_NONE);
 	BIND_ENUM_CONSTANT(HINTING_AUTO);
@@ -213,12 +217,33 @@ void FreeTypeFont::set_hinting(Hinting p_hinting) {
 	_change_notify();
 }
 
+bool FreeTypeFont::is_distance_field() const {
+	return distance_field;
+}
+
+void FreeTypeFont::set_distance_field(bool p_enable) {
+	if (distance_field == p_enable) {
+		return;
+	}
+	distance_field = p_enable;
+
+	FontServer::get_singleton()->font_set_distance_field(font, distance_field);
+
+	emit_changed();
+	_change_notify();
+}
+
+bool FreeTypeFont::is_distance_field_hint() const {
+	return distance_field;
+}
+
 FreeTypeFont::FreeTypeFont() {
 	use_mipmaps = true;
 	use_filter = true;
 	face_index = 0;
 	face_size = 16;
 	hinting = FreeTypeFont::HINTING_NORMAL;
+	distance_field = false;
 
 	font = FontServer::get_singleton()->font_create(face_size, use_mipmaps, use_filter, hinting);
 }
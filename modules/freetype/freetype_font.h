@@ -55,6 +55,7 @@ private:
 	int face_index;
 	int face_size;
 	Hinting hinting;
+	bool distance_field;
 
 protected:
 	static void _bind_methods();
@@ -78,6 +79,10 @@ public:
 	Hinting get_hinting() const;
 	void set_hinting(Hinting p_hinting);
 
+	bool is_distance_field() const;
+	void set_distance_field(bool p_enable);
+	virtual bool is_distance_field_hint() const;
+
 	virtual Size2 get_char_size(char32_t p_char) const;
 	virtual Size2 get_string_size(const String &p_string) const;
 
@@ -36,6 +36,67 @@
 static FontDriverFreeType *freetype_driver = NULL;
 static Ref<ResourceFormatLoaderFreeTypeFont> resource_loader_freetype;
 
+#ifdef TOOLS_ENABLED
+
+#include "core/project_settings.h"
+#include "editor/editor_export.h"
+#include "editor/editor_node.h"
+
+// Rasterizes gui/text/baked_glyph_atlas_chars for every "path:size" entry of
+// gui/text/baked_glyph_atlas_fonts and ships the result as the baked atlas.
+class EditorExportBakedGlyphAtlas : public EditorExportPlugin {
+	GDCLASS(EditorExportBakedGlyphAtlas, EditorExportPlugin);
+
+public:
+	virtual void _export_begin(const Set<String> &p_features, bool p_debug, const String &p_path, int p_flags) {
+		String atlas_path = ProjectSettings::get_singleton()->get("gui/text/baked_glyph_atlas_path");
+		PoolStringArray fonts = ProjectSettings::get_singleton()->get("gui/text/baked_glyph_atlas_fonts");
+		String chars = ProjectSettings::get_singleton()->get("gui/text/baked_glyph_atlas_chars");
+
+		if (atlas_path.empty() || fonts.size() == 0 || chars.empty()) {
+			return;
+		}
+
+		Vector<GlyphCacheKey> glyph_keys;
+		// Keeps the faces loaded until baking is done.
+		Vector<Ref<FontDriver::FontInfo> > font_infos;
+
+		for (int i = 0; i < fonts.size(); i++) {
+			String entry = fonts[i];
+			int separator = entry.rfind(":");
+			int size = separator > 0 ? entry.substr(separator + 1, entry.length()).to_int() : 0;
+			ERR_CONTINUE_MSG(size <= 0, "Expected 'path:size' in gui/text/baked_glyph_atlas_fonts, got '" + entry + "'.");
+
+			String font_path = entry.substr(0, separator);
+
+			FontID font_id;
+			Error err = freetype_driver->load_font_file(font_id, font_path);
+			ERR_CONTINUE_MSG(err != OK, "Cannot load font '" + font_path + "' for the baked glyph atlas.");
+			font_infos.push_back(freetype_driver->get_font_info(font_id));
+
+			GlyphCacheKey glyph_key;
+			glyph_key.font_id = font_id;
+			glyph_key.font_size = size;
+			glyph_key.font_oversampling = FontServer::FONT_OVERSAMPLING;
+			glyph_key.font_custom_flags = FreeTypeFont::HINTING_NORMAL;
+			glyph_keys.push_back(glyph_key);
+		}
+
+		Vector<uint8_t> data;
+		if (freetype_driver->bake_glyph_atlas(glyph_keys, chars, data) == OK) {
+			add_file(atlas_path, data, false);
+		}
+	}
+};
+
+static void _editor_init() {
+	Ref<EditorExportBakedGlyphAtlas> baked_glyph_atlas_export;
+	baked_glyph_atlas_export.instance();
+	EditorExport::get_singleton()->add_export_plugin(baked_glyph_atlas_export);
+}
+
+#endif // TOOLS_ENABLED
+
 void register_freetype_types(ModuleLevel p_level) {
 	if (p_level == MODULE_LEVEL_SERVERS) {
 		freetype_driver = memnew(FontDriverFreeType);
@@ -48,6 +109,12 @@ void register_freetype_types(ModuleLevel p_level) {
 		resource_loader_freetype.instance();
 		ResourceLoader::add_resource_format_loader(resource_loader_freetype);
 	}
+
+#ifdef TOOLS_ENABLED
+	if (p_level == MODULE_LEVEL_EDITOR) {
+		EditorNode::add_init_callback(_editor_init);
+	}
+#endif // TOOLS_ENABLED
 }
 
 void unregister_freetype_types(ModuleLevel p_level) {
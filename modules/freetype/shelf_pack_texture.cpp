@@ -30,47 +30,346 @@
 
 #include "shelf_pack_texture.h"
 
-ShelfPackTexture::Position ShelfPackTexture::Shelf::alloc_shelf(int p_index, int p_w, int p_h) {
-	if (p_w > w || p_h > h) {
-		return ShelfPackTexture::Position{};
+void ShelfPackTexture::setup(int p_texture_size, int p_color_size, Image::Format p_image_format, int p_rect_range) {
+	texture_size = p_texture_size;
+	color_size = p_color_size;
+	image_format = p_image_format;
+	rect_range = p_rect_range;
+
+	image_data.resize(texture_size * texture_size * color_size);
+	clear_image();
+	reset_skyline();
+
+	slots.clear();
+	free_slots.clear();
+	used_area = 0;
+	dirty = true;
+	dirty_rects.clear();
+}
+
+void ShelfPackTexture::setup_from_data(int p_texture_size, int p_color_size, Image::Format p_image_format, int p_rect_range, const uint8_t *p_data) {
+	texture_size = p_texture_size;
+	color_size = p_color_size;
+	image_format = p_image_format;
+	rect_range = p_rect_range;
+
+	image_data.resize(texture_size * texture_size * color_size);
+	{
+		PoolVector<uint8_t>::Write w = image_data.write();
+		copymem(w.ptr(), p_data, image_data.size());
 	}
-	int xx = x;
-	x += p_w;
-	w -= p_w;
-	return ShelfPackTexture::Position{ p_index, xx, y };
+
+	skyline.clear();
+	SkylineNode node;
+	node.w = texture_size;
+	node.y = texture_size;
+	skyline.push_back(node);
+
+	slots.clear();
+	free_slots.clear();
+	used_area = 0;
+	dirty = true;
+	dirty_rects.clear();
 }
 
-ShelfPackTexture::Position ShelfPackTexture::pack_rect(int p_index, int p_w, int p_h) {
-	int y = 0;
-	int waste = 0;
-	List<Shelf>::Element *best_shelf = nullptr;
-	int best_waste = INT_MAX;
-
-	for (List<Shelf>::Element *E = shelves.front(); E; E = E->next()) {
-		y += E->get().h;
-		if (p_w > E->get().w) {
+void ShelfPackTexture::mark_dirty_rect(int p_x, int p_y, int p_w, int p_h) {
+	if (dirty) {
+		return;
+	}
+
+	Rect2i rect(p_x, p_y, p_w, p_h);
+
+	// Glyphs packed next to each other usually touch, grow an existing rect when that doesn't waste much.
+	for (int i = 0; i < (int)dirty_rects.size(); i++) {
+		Rect2i merged = dirty_rects[i].merge(rect);
+		if (merged.get_area() <= (dirty_rects[i].get_area() + rect.get_area()) * 2) {
+			dirty_rects[i] = merged;
+			return;
+		}
+	}
+
+	if (dirty_rects.size() < MAX_DIRTY_RECTS) {
+		dirty_rects.push_back(rect);
+		return;
+	}
+
+	Rect2i bounds = rect;
+	for (int i = 0; i < (int)dirty_rects.size(); i++) {
+		bounds = bounds.merge(dirty_rects[i]);
+	}
+	dirty_rects.clear();
+	dirty_rects.push_back(bounds);
+}
+
+Ref<Image> ShelfPackTexture::get_rect_image(const Rect2i &p_rect) const {
+	PoolVector<uint8_t> data;
+	data.resize(p_rect.size.width * p_rect.size.height * color_size);
+
+	{
+		PoolVector<uint8_t>::Read r = image_data.read();
+		PoolVector<uint8_t>::Write w = data.write();
+
+		int row_size = p_rect.size.width * color_size;
+		for (int i = 0; i < p_rect.size.height; i++) {
+			copymem(&w[i * row_size], &r[((p_rect.position.y + i) * texture_size + p_rect.position.x) * color_size], row_size);
+		}
+	}
+
+	return memnew(Image(p_rect.size.width, p_rect.size.height, 0, image_format, data));
+}
+
+void ShelfPackTexture::clear_image() {
+	PoolVector<uint8_t>::Write w = image_data.write();
+	int size = image_data.size();
+
+	if (color_size == 2) {
+		for (int i = 0; i < size; i += 2) {
+			w[i + 0] = 255;
+			w[i + 1] = 0;
+		}
+	} else {
+		for (int i = 0; i < size; i += 4) {
+			w[i + 0] = 255;
+			w[i + 1] = 255;
+			w[i + 2] = 255;
+			w[i + 3] = 0;
+		}
+	}
+}
+
+void ShelfPackTexture::reset_skyline() {
+	skyline.clear();
+
+	SkylineNode node;
+	node.w = texture_size;
+	skyline.push_back(node);
+}
+
+void ShelfPackTexture::_raise_skyline(int p_x, int p_w, int p_y) {
+	int end = p_x + p_w;
+
+	LocalVector<SkylineNode> raised;
+	for (uint32_t i = 0; i < skyline.size(); i++) {
+		const SkylineNode &node = skyline[i];
+		int node_end = node.x + node.w;
+		if (node_end <= p_x || node.x >= end) {
+			raised.push_back(node);
 			continue;
 		}
-		if (p_h == E->get().h) {
-			return E->get().alloc_shelf(p_index, p_w, p_h);
+
+		SkylineNode part = node;
+		if (node.x < p_x) {
+			part.w = p_x - node.x;
+			raised.push_back(part);
+		}
+
+		part.x = MAX(node.x, p_x);
+		part.y = MAX(node.y, p_y);
+		part.w = MIN(node_end, end) - part.x;
+		raised.push_back(part);
+
+		if (node_end > end) {
+			part.x = end;
+			part.y = node.y;
+			part.w = node_end - end;
+			raised.push_back(part);
+		}
+	}
+
+	skyline.clear();
+	for (uint32_t i = 0; i < raised.size(); i++) {
+		if (!skyline.empty() && skyline[skyline.size() - 1].y == raised[i].y) {
+			skyline[skyline.size() - 1].w += raised[i].w;
+		} else {
+			skyline.push_back(raised[i]);
 		}
-		if (p_h > E->get().h) {
+	}
+}
+
+int ShelfPackTexture::_fit(int p_node, int p_w, int p_h) const {
+	int x = skyline[p_node].x;
+	if (x + p_w > texture_size) {
+		return -1;
+	}
+
+	int y = skyline[p_node].y;
+	int width_left = p_w;
+	for (int i = p_node; width_left > 0; i++) {
+		y = MAX(y, skyline[i].y);
+		if (y + p_h > texture_size) {
+			return -1;
+		}
+		width_left -= skyline[i].w;
+	}
+
+	return y;
+}
+
+ShelfPackTexture::Position ShelfPackTexture::pack_rect(int p_index, int p_w, int p_h) {
+	int best_node = -1;
+	int best_top = INT_MAX;
+	int best_width = INT_MAX;
+	int best_y = 0;
+
+	for (int i = 0; i < (int)skyline.size(); i++) {
+		int y = _fit(i, p_w, p_h);
+		if (y < 0) {
 			continue;
 		}
-		if (p_h < E->get().h) {
-			waste = (E->get().h - p_h) * p_w;
-			if (waste < best_waste) {
-				best_waste = waste;
-				best_shelf = E;
-			}
+		if (y + p_h < best_top || (y + p_h == best_top && skyline[i].w < best_width)) {
+			best_node = i;
+			best_top = y + p_h;
+			best_width = skyline[i].w;
+			best_y = y;
+		}
+	}
+
+	if (best_node == -1) {
+		return ShelfPackTexture::Position{};
+	}
+
+	SkylineNode node;
+	node.x = skyline[best_node].x;
+	node.y = best_y + p_h;
+	node.w = p_w;
+	skyline.insert(best_node, node);
+
+	// Shrink or drop the segments now covered by the new one.
+	for (int i = best_node + 1; i < (int)skyline.size(); i++) {
+		SkylineNode &prev = skyline[i - 1];
+		SkylineNode &cur = skyline[i];
+		if (cur.x >= prev.x + prev.w) {
+			break;
+		}
+
+		int shrink = prev.x + prev.w - cur.x;
+		cur.x += shrink;
+		cur.w -= shrink;
+		if (cur.w > 0) {
+			break;
 		}
+		skyline.remove(i);
+		i--;
+	}
+
+	for (int i = 0; i < (int)skyline.size() - 1; i++) {
+		if (skyline[i].y == skyline[i + 1].y) {
+			skyline[i].w += skyline[i + 1].w;
+			skyline.remove(i + 1);
+			i--;
+		}
+	}
+
+	return ShelfPackTexture::Position{ p_index, node.x, best_y };
+}
+
+int ShelfPackTexture::add_slot(uint32_t p_glyph_index, const Position &p_pos, int p_w, int p_h, uint64_t p_frame) {
+	int slot_idx;
+	if (free_slots.size() > 0) {
+		slot_idx = free_slots[free_slots.size() - 1];
+		free_slots.resize(free_slots.size() - 1);
+	} else {
+		slot_idx = slots.size();
+		slots.push_back(Slot());
+	}
+
+	Slot &slot = slots[slot_idx];
+	slot.glyph_index = p_glyph_index;
+	slot.used = true;
+	slot.x = p_pos.x;
+	slot.y = p_pos.y;
+	slot.w = p_w;
+	slot.h = p_h;
+	slot.last_used = p_frame;
+
+	used_area += p_w * p_h;
+
+	return slot_idx;
+}
+
+void ShelfPackTexture::free_slot(int p_slot) {
+	ERR_FAIL_INDEX(p_slot, (int)slots.size());
+	Slot &slot = slots[p_slot];
+	if (!slot.used) {
+		return;
 	}
-	if (best_shelf) {
-		return best_shelf->get().alloc_shelf(p_index, p_w, p_h);
+
+	slot.used = false;
+	used_area -= slot.w * slot.h;
+	free_slots.push_back(p_slot);
+}
+
+struct _SlotHeightComparator {
+	const LocalVector<ShelfPackTexture::Slot> *slots;
+
+	_FORCE_INLINE_ bool operator()(int p_a, int p_b) const {
+		return (*slots)[p_a].h > (*slots)[p_b].h;
 	}
-	if (p_h <= (texture_size - y) && p_w <= texture_size) {
-		List<Shelf>::Element *E = shelves.push_back(Shelf{ 0, y, texture_size, p_h });
-		return E->get().alloc_shelf(p_index, p_w, p_h);
+};
+
+Vector<uint32_t> ShelfPackTexture::defragment(uint64_t p_pinned_frame) {
+	Vector<uint32_t> dropped;
+
+	Vector<int> order;
+	Vector<int> pinned;
+	for (int i = 0; i < (int)slots.size(); i++) {
+		if (!slots[i].used) {
+			continue;
+		}
+		if (slots[i].last_used >= p_pinned_frame) {
+			pinned.push_back(i);
+		} else {
+			order.push_back(i);
+		}
+	}
+
+	SortArray<int, _SlotHeightComparator> sorter;
+	sorter.compare.slots = &slots;
+	sorter.sort(order.ptrw(), order.size());
+
+	PoolVector<uint8_t> old_data = image_data;
+	image_data = PoolVector<uint8_t>();
+	image_data.resize(old_data.size());
+	clear_image();
+	reset_skyline();
+
+	{
+		PoolVector<uint8_t>::Read r = old_data.read();
+		PoolVector<uint8_t>::Write w = image_data.write();
+
+		for (int i = 0; i < pinned.size(); i++) {
+			const Slot &slot = slots[pinned[i]];
+			_raise_skyline(slot.x, slot.w, slot.y + slot.h);
+
+			for (int row = 0; row < slot.h; row++) {
+				int ofs = ((slot.y + row) * texture_size + slot.x) * color_size;
+				copymem(&w[ofs], &r[ofs], slot.w * color_size);
+			}
+		}
+
+		for (int i = 0; i < order.size(); i++) {
+			Slot &slot = slots[order[i]];
+
+			Position pos = pack_rect(0, slot.w, slot.h);
+			if (pos.index == -1) {
+				dropped.push_back(slot.glyph_index);
+				free_slot(order[i]);
+				continue;
+			}
+
+			for (int row = 0; row < slot.h; row++) {
+				int src = ((slot.y + row) * texture_size + slot.x) * color_size;
+				int dst = ((pos.y + row) * texture_size + pos.x) * color_size;
+				copymem(&w[dst], &r[src], slot.w * color_size);
+			}
+
+			slot.x = pos.x;
+			slot.y = pos.y;
+		}
 	}
-	return ShelfPackTexture::Position{};
+
+	dirty = true;
+	dirty_rects.clear();
+
+	return dropped;
 }
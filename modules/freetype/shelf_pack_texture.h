@@ -31,14 +31,18 @@
 #ifndef SHELF_PACK_TEXTURE_H
 #define SHELF_PACK_TEXTURE_H
 
+#include "core/local_vector.h"
 #include "scene/resources/texture.h"
 
 #include <limits.h>
 
+// Glyph atlas page. Rects are packed bottom-left along a skyline, every
+// packed glyph owns a slot so it can be evicted and the page compacted.
 struct ShelfPackTexture {
 	enum {
 		MIN_TEXTURE_SIZE = 256,
 		MAX_TEXTURE_SIZE = 4096,
+		MAX_DIRTY_RECTS = 16,
 	};
 
 	struct Position {
@@ -47,24 +51,75 @@ struct ShelfPackTexture {
 		int y = 0;
 	};
 
-	struct Shelf {
+	struct SkylineNode {
+		int x = 0;
+		int y = 0;
+		int w = 0;
+	};
+
+	struct Slot {
+		uint32_t glyph_index = 0;
+		bool used = false;
+
 		int x = 0;
 		int y = 0;
 		int w = 0;
 		int h = 0;
 
-		Position alloc_shelf(int p_index, int p_w, int p_h);
+		uint64_t last_used = 0;
 	};
 
-	List<Shelf> shelves;
+	LocalVector<SkylineNode> skyline;
+	LocalVector<Slot> slots;
+	LocalVector<int> free_slots;
+	int used_area = 0;
+
+	// Whole page needs uploading, otherwise only dirty_rects are sent.
 	bool dirty = true;
+	LocalVector<Rect2i> dirty_rects;
 
 	int texture_size = MIN_TEXTURE_SIZE;
+	int color_size = 2;
+	int rect_range = 1;
 	PoolVector<uint8_t> image_data;
 	RID texture_rid;
 	Image::Format image_format;
 
+	_FORCE_INLINE_ int get_memory_size() const { return texture_size * texture_size * color_size; }
+
+	// Callers may hold a GlyphInfo copied before its slot was moved, freed or reused,
+	// only touch the slot while it still sits where the glyph's UV rect points.
+	_FORCE_INLINE_ void touch(int p_slot, const Point2 &p_uv_position, uint64_t p_frame) {
+		if (p_slot < 0 || p_slot >= (int)slots.size()) {
+			return;
+		}
+		Slot &slot = slots[p_slot];
+		if (slot.used && slot.x + rect_range == (int)p_uv_position.x && slot.y + rect_range == (int)p_uv_position.y) {
+			slot.last_used = p_frame;
+		}
+	}
+
+	void mark_dirty_rect(int p_x, int p_y, int p_w, int p_h);
+	Ref<Image> get_rect_image(const Rect2i &p_rect) const;
+
+	void setup(int p_texture_size, int p_color_size, Image::Format p_image_format, int p_rect_range);
+	// Takes over pre-rendered pixels, the page is treated as full until it is defragmented.
+	void setup_from_data(int p_texture_size, int p_color_size, Image::Format p_image_format, int p_rect_range, const uint8_t *p_data);
+	void clear_image();
+	void reset_skyline();
+
 	Position pack_rect(int p_index, int p_w, int p_h);
+
+	int add_slot(uint32_t p_glyph_index, const Position &p_pos, int p_w, int p_h, uint64_t p_frame);
+	void free_slot(int p_slot);
+
+	// Repacks the live slots from scratch, glyphs that no longer fit are freed and returned.
+	// Slots used on or after p_pinned_frame keep their position, their rects may already be queued for drawing.
+	Vector<uint32_t> defragment(uint64_t p_pinned_frame);
+
+private:
+	int _fit(int p_node, int p_w, int p_h) const;
+	void _raise_skyline(int p_x, int p_w, int p_y);
 };
 
 #endif
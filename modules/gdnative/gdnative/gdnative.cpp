@@ -56,7 +56,7 @@ godot_object GDAPI *godot_global_get_singleton(char *p_name) {
 // MethodBind API
 
 godot_method_bind GDAPI *godot_method_bind_get_method(const char *p_classname, const char *p_methodname) {
-	MethodBind *mb = ClassDB::get_method(StringName(p_classname), StringName(p_methodname));
+	MethodBind *mb = ClassDB::get_method(StringName::search(Utf8Range(p_classname)), Utf8Range(p_methodname));
 	// MethodBind *mb = ClassDB::get_method("Node", "get_name");
 	return (godot_method_bind *)mb;
 }
@@ -37,7 +37,10 @@
 #include "core/os/file_access.h"
 #include "core/os/os.h"
 #include "core/project_settings.h"
+#include "gdscript_bytecode.h"
 #include "gdscript_compiler.h"
+#include "gdscript_sampler.h"
+#include "gdscript_vm_stack.h"
 
 ///////////////////////////
 
@@ -714,6 +717,22 @@ Error GDScript::load_byte_code(const String &p_path) {
 	ERR_FAIL_COND_V(bytecode.size() == 0, ERR_PARSE_ERROR);
 	path = p_path;
 
+	if (GDScriptBytecode::is_image(bytecode)) {
+		valid = false;
+		if (GDScriptBytecode::load(this, bytecode) == OK) {
+			valid = true;
+			for (Map<StringName, Ref<GDScript>>::Element *E = subclasses.front(); E; E = E->next()) {
+				_set_subclass_path(E->get(), path);
+			}
+			return OK;
+		}
+
+		// Stale or foreign image, compile the tokens shipped along with it.
+		print_verbose("GDScript: Compiled image of '" + path + "' can't be used, compiling its tokens instead.");
+		bytecode = GDScriptBytecode::get_tokens(bytecode);
+		ERR_FAIL_COND_V(bytecode.size() == 0, ERR_PARSE_ERROR);
+	}
+
 	String basedir = path;
 
 	if (basedir == "")
@@ -891,6 +910,8 @@ GDScript::~GDScript() {
 	}
 	GDScriptLanguage::get_singleton()->lock.unlock();
 
+	// Caches may still be keyed on this script.
+	GDScriptFunction::clear_inline_caches();
 	for (Map<StringName, GDScriptFunction *>::Element *E = member_functions.front(); E; E = E->next()) {
 		memdelete(E->get());
 	}
@@ -1354,6 +1375,21 @@ void GDScriptLanguage::init() {
 	for (List<Engine::Singleton>::Element *E = singletons.front(); E; E = E->next()) {
 		_add_global(E->get().name, E->get().ptr);
 	}
+
+	// Sampling profiler, available in release builds so it can run on exported, headless games.
+	int sample_rate = 1000;
+	List<String> args = OS::get_singleton()->get_cmdline_args();
+	for (List<String>::Element *E = args.front(); E; E = E->next()) {
+		if (E->get() == "--gdscript-sample-profile" && E->next()) {
+			sample_profile_path = E->next()->get();
+		} else if (E->get() == "--gdscript-sample-rate" && E->next()) {
+			sample_rate = E->next()->get().to_int();
+		}
+	}
+
+	if (sample_profile_path != String()) {
+		GDScriptSampler::start(sample_rate);
+	}
 }
 
 String GDScriptLanguage::get_type() const {
@@ -1367,6 +1403,19 @@ Error GDScriptLanguage::execute_file(const String &p_path) {
 	return OK;
 }
 void GDScriptLanguage::finish() {
+	if (sample_profile_path != String()) {
+		GDScriptSampler::stop();
+		if (GDScriptSampler::save(sample_profile_path) == OK) {
+			print_line("GDScript sample profile: " + itos(GDScriptSampler::get_sample_count()) + " samples written to " + sample_profile_path + ".");
+		}
+		sample_profile_path = String();
+	}
+
+	GDScriptVMStack::release_thread();
+}
+
+void GDScriptLanguage::thread_exit() {
+	GDScriptVMStack::release_thread();
 }
 
 void GDScriptLanguage::profiling_start() {
@@ -68,6 +68,7 @@ class GDScript : public Script {
 	friend class GDScriptInstance;
 	friend class GDScriptFunction;
 	friend class GDScriptCompiler;
+	friend class GDScriptBytecode;
 	friend class GDScriptFunctions;
 	friend class GDScriptLanguage;
 
@@ -358,6 +359,8 @@ class GDScriptLanguage : public ScriptLanguage {
 	bool profiling;
 	uint64_t script_frame_time;
 
+	String sample_profile_path;
+
 	Map<String, ObjectID> orphan_subclasses;
 
 public:
@@ -445,6 +448,7 @@ public:
 	virtual String get_extension() const;
 	virtual Error execute_file(const String &p_path);
 	virtual void finish();
+	virtual void thread_exit();
 
 	/* EDITOR FUNCTIONS */
 	virtual void get_reserved_words(List<String> *p_words) const;
@@ -0,0 +1,1572 @@
+/*************************************************************************/
+/*  gdscript_bytecode.cpp                                                */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-present Godot Engine contributors (cf. AUTHORS.md).*/
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "gdscript_bytecode.h"
+
+#include "core/io/marshalls.h"
+#include "core/io/resource_loader.h"
+#include "core/local_vector.h"
+#include "core/version.h"
+#include "gdscript.h"
+#include "gdscript_functions.h"
+
+enum {
+	HEADER_MAGIC = 0,
+	HEADER_FORMAT_VERSION = 4,
+	HEADER_ENGINE_VERSION = 8,
+	HEADER_OPCODE_COUNT = 12,
+	HEADER_FUNCTION_COUNT = 16,
+	HEADER_TYPE_COUNT = 20,
+	HEADER_OPERATOR_COUNT = 24,
+	HEADER_TOKENS_OFFSET = 28,
+	HEADER_TOKENS_LENGTH = 32,
+	HEADER_SIZE = 36,
+};
+
+enum {
+	SCRIPT_REF_SELF,
+	SCRIPT_REF_PATH,
+};
+
+enum {
+	CONSTANT_VALUE,
+	CONSTANT_ARRAY,
+	CONSTANT_DICTIONARY,
+	CONSTANT_NULL_OBJECT,
+	CONSTANT_NATIVE_CLASS,
+	CONSTANT_SCRIPT,
+	CONSTANT_RESOURCE,
+};
+
+enum {
+	FUNCTION_STATIC = 1,
+	FUNCTION_INITIALIZER = 2,
+	FUNCTION_COROUTINE = 4,
+};
+
+enum {
+	MAX_DEPTH = 64,
+};
+
+enum Operand {
+	OPERAND_ADDRESS,
+	OPERAND_JUMP,
+	OPERAND_NAME,
+	OPERAND_TYPE,
+	OPERAND_OPERATOR,
+	OPERAND_VALIDATED_OPERATOR,
+	OPERAND_VALIDATED_GETTER,
+	OPERAND_VALIDATED_SETTER,
+	OPERAND_VALIDATED_CALL,
+	OPERAND_INLINE_CACHE,
+	OPERAND_BUILT_IN_FUNCTION,
+	OPERAND_CALL_ARGUMENT_COUNT,
+	OPERAND_ELEMENT_COUNT,
+	OPERAND_LINE,
+};
+
+// Decodes instruction boundaries and operand kinds the same way the VM reads them.
+template <class V>
+static bool _walk_code(const int *p_code, int p_size, V &p_visitor) {
+	int ip = 0;
+	while (ip < p_size) {
+		int opcode = p_code[ip];
+		if (!p_visitor.instruction(ip, opcode)) {
+			return false;
+		}
+
+		Operand fixed[5];
+		int fixed_count = 0;
+		int trailing = 0; // Addresses after the variable arguments.
+		int arg_scale = 1;
+
+#define FIXED(m_kind) fixed[fixed_count++] = m_kind
+
+		switch (opcode) {
+			case GDScriptFunction::OPCODE_OPERATOR:
+			case GDScriptFunction::OPCODE_OPERATOR_VALIDATED: {
+				FIXED(opcode == GDScriptFunction::OPCODE_OPERATOR ? OPERAND_OPERATOR : OPERAND_VALIDATED_OPERATOR);
+				FIXED(OPERAND_ADDRESS);
+				FIXED(OPERAND_ADDRESS);
+				FIXED(OPERAND_ADDRESS);
+			} break;
+			case GDScriptFunction::OPCODE_EXTENDS_TEST:
+			case GDScriptFunction::OPCODE_SET:
+			case GDScriptFunction::OPCODE_GET:
+			case GDScriptFunction::OPCODE_ASSIGN_TYPED_NATIVE:
+			case GDScriptFunction::OPCODE_ASSIGN_TYPED_SCRIPT:
+			case GDScriptFunction::OPCODE_CAST_TO_NATIVE:
+			case GDScriptFunction::OPCODE_CAST_TO_SCRIPT: {
+				FIXED(OPERAND_ADDRESS);
+				FIXED(OPERAND_ADDRESS);
+				FIXED(OPERAND_ADDRESS);
+			} break;
+			case GDScriptFunction::OPCODE_IS_BUILTIN: {
+				FIXED(OPERAND_ADDRESS);
+				FIXED(OPERAND_TYPE);
+				FIXED(OPERAND_ADDRESS);
+			} break;
+			case GDScriptFunction::OPCODE_SET_NAMED:
+			case GDScriptFunction::OPCODE_SET_NAMED_VALIDATED: {
+				FIXED(OPERAND_ADDRESS);
+				FIXED(opcode == GDScriptFunction::OPCODE_SET_NAMED ? OPERAND_NAME : OPERAND_VALIDATED_SETTER);
+				FIXED(OPERAND_ADDRESS);
+			} break;
+			case GDScriptFunction::OPCODE_GET_NAMED:
+			case GDScriptFunction::OPCODE_GET_NAMED_VALIDATED: {
+				FIXED(OPERAND_ADDRESS);
+				FIXED(opcode == GDScriptFunction::OPCODE_GET_NAMED ? OPERAND_INLINE_CACHE : OPERAND_VALIDATED_GETTER);
+				FIXED(OPERAND_ADDRESS);
+			} break;
+			case GDScriptFunction::OPCODE_SET_MEMBER:
+			case GDScriptFunction::OPCODE_GET_MEMBER: {
+				FIXED(OPERAND_NAME);
+				FIXED(OPERAND_ADDRESS);
+			} break;
+			case GDScriptFunction::OPCODE_ASSIGN: {
+				FIXED(OPERAND_ADDRESS);
+				FIXED(OPERAND_ADDRESS);
+			} break;
+			case GDScriptFunction::OPCODE_ASSIGN_TRUE:
+			case GDScriptFunction::OPCODE_ASSIGN_FALSE:
+			case GDScriptFunction::OPCODE_YIELD_RESUME:
+			case GDScriptFunction::OPCODE_RETURN: {
+				FIXED(OPERAND_ADDRESS);
+			} break;
+			case GDScriptFunction::OPCODE_ASSIGN_TYPED_BUILTIN:
+			case GDScriptFunction::OPCODE_CAST_TO_BUILTIN: {
+				FIXED(OPERAND_TYPE);
+				FIXED(OPERAND_ADDRESS);
+				FIXED(OPERAND_ADDRESS);
+			} break;
+			case GDScriptFunction::OPCODE_CONSTRUCT: {
+				FIXED(OPERAND_TYPE);
+				FIXED(OPERAND_CALL_ARGUMENT_COUNT);
+				trailing = 1;
+			} break;
+			case GDScriptFunction::OPCODE_CONSTRUCT_ARRAY: {
+				FIXED(OPERAND_ELEMENT_COUNT);
+				trailing = 1;
+			} break;
+			case GDScriptFunction::OPCODE_CONSTRUCT_DICTIONARY: {
+				FIXED(OPERAND_ELEMENT_COUNT);
+				arg_scale = 2;
+				trailing = 1;
+			} break;
+			case GDScriptFunction::OPCODE_CALL:
+			case GDScriptFunction::OPCODE_CALL_RETURN:
+			case GDScriptFunction::OPCODE_CALL_VALIDATED:
+			case GDScriptFunction::OPCODE_CALL_RETURN_VALIDATED: {
+				bool validated = opcode == GDScriptFunction::OPCODE_CALL_VALIDATED || opcode == GDScriptFunction::OPCODE_CALL_RETURN_VALIDATED;
+				FIXED(OPERAND_CALL_ARGUMENT_COUNT);
+				FIXED(OPERAND_ADDRESS);
+				FIXED(validated ? OPERAND_VALIDATED_CALL : OPERAND_INLINE_CACHE);
+				trailing = 1;
+			} break;
+			case GDScriptFunction::OPCODE_CALL_BUILT_IN: {
+				FIXED(OPERAND_BUILT_IN_FUNCTION);
+				FIXED(OPERAND_CALL_ARGUMENT_COUNT);
+				trailing = 1;
+			} break;
+			case GDScriptFunction::OPCODE_CALL_SELF_BASE: {
+				FIXED(OPERAND_NAME);
+				FIXED(OPERAND_CALL_ARGUMENT_COUNT);
+				trailing = 1;
+			} break;
+			case GDScriptFunction::OPCODE_YIELD_SIGNAL: {
+				FIXED(OPERAND_ADDRESS);
+				FIXED(OPERAND_ADDRESS);
+			} break;
+			case GDScriptFunction::OPCODE_JUMP: {
+				FIXED(OPERAND_JUMP);
+			} break;
+			case GDScriptFunction::OPCODE_JUMP_IF:
+			case GDScriptFunction::OPCODE_JUMP_IF_NOT: {
+				FIXED(OPERAND_ADDRESS);
+				FIXED(OPERAND_JUMP);
+			} break;
+			case GDScriptFunction::OPCODE_ITERATE_BEGIN:
+			case GDScriptFunction::OPCODE_ITERATE: {
+				FIXED(OPERAND_ADDRESS);
+				FIXED(OPERAND_ADDRESS);
+				FIXED(OPERAND_JUMP);
+				FIXED(OPERAND_ADDRESS);
+			} break;
+			case GDScriptFunction::OPCODE_ASSERT: {
+				FIXED(OPERAND_ADDRESS);
+				FIXED(OPERAND_ADDRESS);
+			} break;
+			case GDScriptFunction::OPCODE_LINE: {
+				FIXED(OPERAND_LINE);
+			} break;
+			case GDScriptFunction::OPCODE_YIELD:
+			case GDScriptFunction::OPCODE_JUMP_TO_DEF_ARGUMENT:
+			case GDScriptFunction::OPCODE_BREAKPOINT:
+			case GDScriptFunction::OPCODE_END: {
+			} break;
+			default: {
+				return false;
+			}
+		}
+
+#undef FIXED
+
+		if (fixed_count >= p_size - ip) {
+			return false;
+		}
+
+		int argc = 0;
+		for (int i = 0; i < fixed_count; i++) {
+			int pos = ip + 1 + i;
+			if (!p_visitor.operand(pos, fixed[i], p_code[pos])) {
+				return false;
+			}
+			if (fixed[i] == OPERAND_CALL_ARGUMENT_COUNT || fixed[i] == OPERAND_ELEMENT_COUNT) {
+				argc = p_code[pos];
+			}
+		}
+
+		if (argc < 0 || argc > p_size) {
+			return false;
+		}
+
+		int variable = argc * arg_scale + trailing;
+		int next = ip + 1 + fixed_count;
+		if (variable > p_size - next) {
+			return false;
+		}
+
+		for (int i = 0; i < variable; i++) {
+			if (!p_visitor.operand(next + i, OPERAND_ADDRESS, p_code[next + i])) {
+				return false;
+			}
+		}
+
+		ip = next + variable;
+	}
+
+	return true;
+}
+
+static bool _is_global_address(int p_address) {
+	uint32_t type = uint32_t(p_address) >> GDScriptFunction::ADDR_BITS;
+	return type == GDScriptFunction::ADDR_TYPE_GLOBAL || type == GDScriptFunction::ADDR_TYPE_NAMED_GLOBAL;
+}
+
+struct GDScriptGlobalCollector {
+	Vector<int> positions;
+
+	bool instruction(int p_pos, int p_opcode) {
+		return true;
+	}
+
+	bool operand(int p_pos, Operand p_kind, int p_value) {
+		if (p_kind == OPERAND_ADDRESS && _is_global_address(p_value)) {
+			positions.push_back(p_pos);
+		}
+		return true;
+	}
+};
+
+struct GDScriptCodeValidator {
+	int code_size;
+	int member_count;
+	int constant_count;
+	int global_name_count;
+	int global_count;
+	int named_global_count;
+	int stack_size;
+	int call_size;
+	int validated_operator_count;
+	int validated_call_count;
+	int inline_cache_count;
+	const GDScriptFunction::ValidatedMember *validated_members;
+	int validated_member_count;
+	bool has_default_arguments;
+	bool coroutine;
+
+	LocalVector<uint8_t> starts;
+	Vector<int> jumps;
+	int last_opcode;
+	bool expect_iterate;
+
+	bool instruction(int p_pos, int p_opcode) {
+		if (expect_iterate && p_opcode != GDScriptFunction::OPCODE_ITERATE) {
+			return false; // ITERATE_BEGIN skips over the ITERATE that follows it.
+		}
+		if (p_opcode == GDScriptFunction::OPCODE_JUMP_TO_DEF_ARGUMENT && !has_default_arguments) {
+			return false;
+		}
+		if ((p_opcode == GDScriptFunction::OPCODE_YIELD || p_opcode == GDScriptFunction::OPCODE_YIELD_SIGNAL) && !coroutine) {
+			return false; // Only coroutine frames can outlive the call.
+		}
+		expect_iterate = p_opcode == GDScriptFunction::OPCODE_ITERATE_BEGIN;
+		last_opcode = p_opcode;
+		starts[p_pos] = 1;
+		return true;
+	}
+
+	bool operand(int p_pos, Operand p_kind, int p_value) {
+		switch (p_kind) {
+			case OPERAND_ADDRESS: {
+				int index = p_value & GDScriptFunction::ADDR_MASK;
+				switch (uint32_t(p_value) >> GDScriptFunction::ADDR_BITS) {
+					case GDScriptFunction::ADDR_TYPE_SELF:
+					case GDScriptFunction::ADDR_TYPE_CLASS:
+					case GDScriptFunction::ADDR_TYPE_NIL:
+						return true;
+					case GDScriptFunction::ADDR_TYPE_MEMBER:
+						return index < member_count;
+					case GDScriptFunction::ADDR_TYPE_CLASS_CONSTANT:
+						return index < global_name_count;
+					case GDScriptFunction::ADDR_TYPE_LOCAL_CONSTANT:
+						return index < constant_count;
+					case GDScriptFunction::ADDR_TYPE_STACK:
+					case GDScriptFunction::ADDR_TYPE_STACK_VARIABLE:
+						return index < stack_size;
+					case GDScriptFunction::ADDR_TYPE_GLOBAL:
+						return index < global_count;
+#ifdef TOOLS_ENABLED
+					case GDScriptFunction::ADDR_TYPE_NAMED_GLOBAL:
+						return index < named_global_count;
+#endif
+				}
+				return false;
+			}
+			case OPERAND_JUMP: {
+				jumps.push_back(p_value);
+				return true;
+			}
+			case OPERAND_NAME:
+				return p_value >= 0 && p_value < global_name_count;
+			case OPERAND_TYPE:
+				return p_value >= 0 && p_value < Variant::VARIANT_MAX;
+			case OPERAND_OPERATOR:
+				return p_value >= 0 && p_value < Variant::OP_MAX;
+			case OPERAND_VALIDATED_OPERATOR:
+				return p_value >= 0 && p_value < validated_operator_count;
+			case OPERAND_VALIDATED_GETTER:
+				return p_value >= 0 && p_value < validated_member_count && validated_members[p_value].getter;
+			case OPERAND_VALIDATED_SETTER:
+				return p_value >= 0 && p_value < validated_member_count && validated_members[p_value].setter;
+			case OPERAND_VALIDATED_CALL:
+				return p_value >= 0 && p_value < validated_call_count;
+			case OPERAND_INLINE_CACHE:
+				return p_value >= 0 && p_value < inline_cache_count;
+			case OPERAND_BUILT_IN_FUNCTION:
+				return p_value >= 0 && p_value < GDScriptFunctions::FUNC_MAX;
+			case OPERAND_CALL_ARGUMENT_COUNT:
+				return p_value >= 0 && p_value <= call_size;
+			case OPERAND_ELEMENT_COUNT:
+			case OPERAND_LINE:
+				return true;
+		}
+		return false;
+	}
+
+	bool is_start(int p_pos) const {
+		return p_pos >= 0 && p_pos < code_size && starts[p_pos];
+	}
+};
+
+class GDScriptBytecode::Writer {
+public:
+	LocalVector<uint8_t> data;
+	const GDScript *root;
+	Map<int, StringName> globals;
+	int depth;
+
+	void put_32(uint32_t p_value) {
+		uint32_t pos = data.size();
+		data.resize(pos + 4);
+		encode_uint32(p_value, &data[pos]);
+	}
+
+	void put_buffer(const uint8_t *p_buffer, int p_len) {
+		uint32_t pos = data.size();
+		data.resize(pos + p_len);
+		if (p_len) {
+			copymem(&data[pos], p_buffer, p_len);
+		}
+	}
+
+	void put_string(const String &p_string) {
+		CharString utf8 = p_string.utf8();
+		put_32(utf8.length());
+		put_buffer((const uint8_t *)utf8.get_data(), utf8.length());
+	}
+
+	bool put_script(const Script *p_script) {
+		Vector<StringName> chain;
+		const Script *top = p_script;
+		const GDScript *gds = Object::cast_to<GDScript>(p_script);
+		while (gds && gds->_owner) {
+			const Map<StringName, Ref<GDScript>>::Element *E = gds->_owner->subclasses.find(gds->name);
+			if (!E || E->get().ptr() != gds) {
+				return false;
+			}
+			chain.push_back(gds->name);
+			gds = gds->_owner;
+			top = gds;
+		}
+
+		if (top == root || (root->path != String() && top->get_path() == root->path)) {
+			put_32(SCRIPT_REF_SELF);
+		} else {
+			String path = top->get_path();
+			if (!path.is_resource_file()) {
+				return false; // Built-in scripts can't be loaded on their own.
+			}
+			put_32(SCRIPT_REF_PATH);
+			put_string(path);
+		}
+
+		put_32(chain.size());
+		for (int i = chain.size() - 1; i >= 0; i--) {
+			put_string(chain[i]);
+		}
+		return true;
+	}
+
+	bool put_constant(const Variant &p_value) {
+		if (depth > MAX_DEPTH) {
+			return false;
+		}
+
+		switch (p_value.get_type()) {
+			case Variant::ARRAY: {
+				Array array = p_value;
+				put_32(CONSTANT_ARRAY);
+				put_32(array.size());
+				depth++;
+				for (int i = 0; i < array.size(); i++) {
+					if (!put_constant(array[i])) {
+						return false;
+					}
+				}
+				depth--;
+			} break;
+			case Variant::DICTIONARY: {
+				Dictionary dict = p_value;
+				put_32(CONSTANT_DICTIONARY);
+				put_32(dict.size());
+				depth++;
+				const Variant *K = NULL;
+				while ((K = dict.next(K))) {
+					if (!put_constant(*K) || !put_constant(dict[*K])) {
+						return false;
+					}
+				}
+				depth--;
+			} break;
+			case Variant::OBJECT: {
+				Object *obj = p_value;
+				if (!obj) {
+					put_32(CONSTANT_NULL_OBJECT);
+					break;
+				}
+
+				GDScriptNativeClass *native = Object::cast_to<GDScriptNativeClass>(obj);
+				Script *script = Object::cast_to<Script>(obj);
+				Resource *res = Object::cast_to<Resource>(obj);
+				if (native) {
+					put_32(CONSTANT_NATIVE_CLASS);
+					put_string(native->get_name());
+				} else if (script) {
+					put_32(CONSTANT_SCRIPT);
+					return put_script(script);
+				} else if (res && res->get_path().is_resource_file()) {
+					put_32(CONSTANT_RESOURCE);
+					put_string(res->get_path());
+					put_string(res->get_class());
+				} else {
+					return false;
+				}
+			} break;
+			default: {
+				int len;
+				if (encode_variant(p_value, NULL, len) != OK) {
+					return false;
+				}
+				put_32(CONSTANT_VALUE);
+				put_32(len);
+				uint32_t pos = data.size();
+				data.resize(pos + len);
+				encode_variant(p_value, &data[pos], len);
+			} break;
+		}
+		return true;
+	}
+
+	bool put_data_type(const GDScriptDataType &p_type) {
+		put_32(p_type.has_type);
+		put_32(p_type.kind);
+		put_32(p_type.builtin_type);
+		put_string(p_type.native_type);
+		put_32(p_type.script_type != NULL);
+		if (!p_type.script_type) {
+			return true;
+		}
+		put_32(p_type.script_type_ref.is_valid());
+		return put_script(p_type.script_type);
+	}
+
+	void put_property_info(const PropertyInfo &p_info) {
+		put_32(p_info.type);
+		put_string(p_info.name);
+		put_string(p_info.class_name);
+		put_32(p_info.hint);
+		put_string(p_info.hint_string);
+		put_32(p_info.usage);
+	}
+};
+
+class GDScriptBytecode::Reader {
+public:
+	const uint8_t *data;
+	uint32_t size;
+	uint32_t pos;
+	bool failed;
+	GDScript *root;
+	int depth;
+
+	bool fail() {
+		failed = true;
+		return false;
+	}
+
+	uint32_t get_32() {
+		if (failed || size - pos < 4) {
+			failed = true;
+			return 0;
+		}
+		uint32_t value = decode_uint32(&data[pos]);
+		pos += 4;
+		return value;
+	}
+
+	int get_int() {
+		return int32_t(get_32());
+	}
+
+	// Counts are checked against what's left, so a bad count can't trigger a huge allocation.
+	int get_count(uint32_t p_item_size) {
+		uint32_t count = get_32();
+		if (failed || count > (size - pos) / p_item_size) {
+			failed = true;
+			return 0;
+		}
+		return count;
+	}
+
+	String get_string() {
+		uint32_t len = get_32();
+		if (failed || len > size - pos) {
+			failed = true;
+			return String();
+		}
+		String str;
+		if (len) {
+			str.parse_utf8((const char *)&data[pos], len);
+			pos += len;
+		}
+		return str;
+	}
+
+	bool get_script(Ref<Script> &r_script, bool &r_in_image) {
+		uint32_t kind = get_32();
+		if (kind == SCRIPT_REF_SELF) {
+			r_script = Ref<Script>(root);
+			r_in_image = true;
+		} else if (kind == SCRIPT_REF_PATH) {
+			String path = get_string();
+			if (failed || !path.is_resource_file()) {
+				return fail();
+			}
+			r_script = ResourceLoader::load(path);
+			r_in_image = false;
+		} else {
+			return fail();
+		}
+
+		int count = get_count(4);
+		for (int i = 0; i < count; i++) {
+			StringName name = get_string();
+			Ref<GDScript> gds = r_script;
+			if (failed || gds.is_null()) {
+				return fail();
+			}
+			const Map<StringName, Ref<GDScript>>::Element *E = gds->subclasses.find(name);
+			if (!E) {
+				return fail();
+			}
+			r_script = E->get();
+		}
+		if (failed || r_script.is_null()) {
+			return fail();
+		}
+		return true;
+	}
+
+	bool get_constant(Variant &r_value) {
+		if (depth > MAX_DEPTH) {
+			return fail();
+		}
+
+		switch (get_32()) {
+			case CONSTANT_VALUE: {
+				uint32_t len = get_32();
+				if (failed || len > size - pos) {
+					return fail();
+				}
+				int used = 0;
+				if (decode_variant(r_value, &data[pos], len, &used) != OK || uint32_t(used) != len || r_value.get_type() == Variant::OBJECT) {
+					return fail();
+				}
+				pos += len;
+			} break;
+			case CONSTANT_ARRAY: {
+				Array array;
+				array.resize(get_count(4));
+				depth++;
+				for (int i = 0; i < array.size(); i++) {
+					if (!get_constant(array[i])) {
+						return false;
+					}
+				}
+				depth--;
+				r_value = array;
+			} break;
+			case CONSTANT_DICTIONARY: {
+				Dictionary dict;
+				int count = get_count(8);
+				depth++;
+				for (int i = 0; i < count; i++) {
+					Variant key;
+					Variant value;
+					if (!get_constant(key) || !get_constant(value)) {
+						return false;
+					}
+					dict[key] = value;
+				}
+				depth--;
+				r_value = dict;
+			} break;
+			case CONSTANT_NULL_OBJECT: {
+				r_value = (Object *)NULL;
+			} break;
+			case CONSTANT_NATIVE_CLASS: {
+				StringName name = get_string();
+				const Map<StringName, int>::Element *E = GDScriptLanguage::get_singleton()->get_global_map().find(name);
+				if (failed || !E) {
+					return fail();
+				}
+				Ref<GDScriptNativeClass> native = GDScriptLanguage::get_singleton()->get_global_array()[E->get()];
+				if (native.is_null()) {
+					return fail();
+				}
+				r_value = native;
+			} break;
+			case CONSTANT_SCRIPT: {
+				Ref<Script> script;
+				bool in_image;
+				if (!get_script(script, in_image)) {
+					return false;
+				}
+				r_value = script;
+			} break;
+			case CONSTANT_RESOURCE: {
+				String path = get_string();
+				String type_hint = get_string();
+				if (failed || !path.is_resource_file()) {
+					return fail();
+				}
+				Ref<Resource> res = ResourceLoader::load(path, type_hint);
+				if (res.is_null()) {
+					return fail();
+				}
+				r_value = res;
+			} break;
+			default: {
+				return fail();
+			}
+		}
+		return !failed;
+	}
+
+	bool get_data_type(GDScriptDataType &r_type) {
+		r_type.has_type = get_32();
+		uint32_t kind = get_32();
+		uint32_t builtin_type = get_32();
+		if (kind > GDScriptDataType::GDSCRIPT || builtin_type >= Variant::VARIANT_MAX) {
+			return fail();
+		}
+		r_type.kind = decltype(r_type.kind)(kind);
+		r_type.builtin_type = Variant::Type(builtin_type);
+		r_type.native_type = get_string();
+
+		if (get_32()) {
+			Ref<Script> script;
+			bool strong = get_32();
+			bool in_image;
+			if (!get_script(script, in_image)) {
+				return false;
+			}
+			r_type.script_type = script.ptr();
+			// Scripts from other files are always held, weak references only make sense inside the image.
+			if (strong || !in_image) {
+				r_type.script_type_ref = script;
+			}
+		}
+		return !failed;
+	}
+
+	bool get_property_info(PropertyInfo &r_info) {
+		uint32_t type = get_32();
+		if (type >= Variant::VARIANT_MAX) {
+			return fail();
+		}
+		r_info.type = Variant::Type(type);
+		r_info.name = get_string();
+		r_info.class_name = get_string();
+		r_info.hint = PropertyHint(get_32());
+		r_info.hint_string = get_string();
+		r_info.usage = get_32();
+		return !failed;
+	}
+};
+
+bool GDScriptBytecode::is_image(const Vector<uint8_t> &p_buffer) {
+	if (p_buffer.size() < HEADER_SIZE) {
+		return false;
+	}
+	const uint8_t *buf = p_buffer.ptr();
+	return buf[0] == 'G' && buf[1] == 'D' && buf[2] == 'S' && buf[3] == 'B';
+}
+
+Vector<uint8_t> GDScriptBytecode::get_tokens(const Vector<uint8_t> &p_buffer) {
+	if (!is_image(p_buffer)) {
+		return p_buffer;
+	}
+
+	const uint8_t *buf = p_buffer.ptr();
+	uint32_t ofs = decode_uint32(&buf[HEADER_TOKENS_OFFSET]);
+	uint32_t len = decode_uint32(&buf[HEADER_TOKENS_LENGTH]);
+	ERR_FAIL_COND_V(ofs < HEADER_SIZE || ofs > uint32_t(p_buffer.size()) || len > p_buffer.size() - ofs, Vector<uint8_t>());
+
+	Vector<uint8_t> tokens;
+	tokens.resize(len);
+	if (len) {
+		copymem(tokens.ptrw(), &buf[ofs], len);
+	}
+	return tokens;
+}
+
+void GDScriptBytecode::_save_tree(Writer &w, const GDScript *p_script, Vector<const GDScript *> &r_classes) {
+	r_classes.push_back(p_script);
+	w.put_32(p_script->subclasses.size());
+	for (const Map<StringName, Ref<GDScript>>::Element *E = p_script->subclasses.front(); E; E = E->next()) {
+		w.put_string(E->key());
+		_save_tree(w, E->get().ptr(), r_classes);
+	}
+}
+
+bool GDScriptBytecode::_save_class(Writer &w, const GDScript *p_script) {
+	w.put_32(p_script->tool);
+	w.put_string(p_script->name);
+
+	if (p_script->base.is_valid()) {
+		w.put_32(1);
+		if (!w.put_script(p_script->base.ptr())) {
+			return false;
+		}
+	} else {
+		ERR_FAIL_COND_V(p_script->native.is_null(), false);
+		w.put_32(0);
+		w.put_string(p_script->native->get_name());
+	}
+
+	w.put_32(p_script->members.size());
+	for (const Set<StringName>::Element *E = p_script->members.front(); E; E = E->next()) {
+		w.put_string(E->get());
+	}
+
+	w.put_32(p_script->member_indices.size());
+	for (const Map<StringName, GDScript::MemberInfo>::Element *E = p_script->member_indices.front(); E; E = E->next()) {
+		const GDScript::MemberInfo &info = E->get();
+		w.put_string(E->key());
+		w.put_32(info.index);
+		w.put_string(info.setter);
+		w.put_string(info.getter);
+		w.put_32(info.rpc_mode);
+		if (!w.put_data_type(info.data_type)) {
+			return false;
+		}
+	}
+
+	w.put_32(p_script->member_info.size());
+	for (const Map<StringName, PropertyInfo>::Element *E = p_script->member_info.front(); E; E = E->next()) {
+		w.put_string(E->key());
+		w.put_property_info(E->get());
+	}
+
+	w.put_32(p_script->constants.size());
+	for (const Map<StringName, Variant>::Element *E = p_script->constants.front(); E; E = E->next()) {
+		w.put_string(E->key());
+		if (!w.put_constant(E->get())) {
+			return false;
+		}
+	}
+
+	w.put_32(p_script->_signals.size());
+	for (const Map<StringName, Vector<StringName>>::Element *E = p_script->_signals.front(); E; E = E->next()) {
+		w.put_string(E->key());
+		w.put_32(E->get().size());
+		for (int i = 0; i < E->get().size(); i++) {
+			w.put_string(E->get()[i]);
+		}
+	}
+
+#ifdef TOOLS_ENABLED
+	w.put_32(p_script->member_lines.size());
+	for (const Map<StringName, int>::Element *E = p_script->member_lines.front(); E; E = E->next()) {
+		w.put_string(E->key());
+		w.put_32(E->get());
+	}
+
+	w.put_32(p_script->member_default_values.size());
+	for (const Map<StringName, Variant>::Element *E = p_script->member_default_values.front(); E; E = E->next()) {
+		w.put_string(E->key());
+		if (!w.put_constant(E->get())) {
+			return false;
+		}
+	}
+#else
+	w.put_32(0);
+	w.put_32(0);
+#endif
+
+	w.put_32(p_script->member_functions.size());
+	for (const Map<StringName, GDScriptFunction *>::Element *E = p_script->member_functions.front(); E; E = E->next()) {
+		if (!_save_function(w, p_script, E->get())) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool GDScriptBytecode::_save_function(Writer &w, const GDScript *p_script, const GDScriptFunction *p_function) {
+	const GDScriptFunction *f = p_function;
+
+	GDScriptGlobalCollector globals;
+	if (!_walk_code(f->_code_ptr, f->_code_size, globals)) {
+		return false;
+	}
+
+	w.put_string(f->name);
+	w.put_32((f->_static ? FUNCTION_STATIC : 0) | (p_script->initializer == f ? FUNCTION_INITIALIZER : 0) | (f->_coroutine ? FUNCTION_COROUTINE : 0));
+	w.put_32(f->rpc_mode);
+	w.put_32(f->_argument_count);
+	w.put_32(f->_stack_size);
+	w.put_32(f->_call_size);
+	w.put_32(f->_initial_line);
+
+	w.put_32(f->argument_types.size());
+	for (int i = 0; i < f->argument_types.size(); i++) {
+		if (!w.put_data_type(f->argument_types[i])) {
+			return false;
+		}
+	}
+	if (!w.put_data_type(f->return_type)) {
+		return false;
+	}
+
+#ifdef TOOLS_ENABLED
+	w.put_32(f->arg_names.size());
+	for (int i = 0; i < f->arg_names.size(); i++) {
+		w.put_string(f->arg_names[i]);
+	}
+#else
+	w.put_32(0);
+#endif
+
+	w.put_32(f->constants.size());
+	for (int i = 0; i < f->constants.size(); i++) {
+		if (!w.put_constant(f->constants[i])) {
+			return false;
+		}
+	}
+
+	w.put_32(f->global_names.size());
+	for (int i = 0; i < f->global_names.size(); i++) {
+		w.put_string(f->global_names[i]);
+	}
+
+	w.put_32(f->validated_operators.size());
+	for (int i = 0; i < f->validated_operators.size(); i++) {
+		const GDScriptFunction::ValidatedOperator &validated = f->validated_operators[i];
+		w.put_32(validated.op);
+		w.put_32(validated.left_type);
+		w.put_32(validated.right_type);
+	}
+
+	w.put_32(f->validated_members.size());
+	for (int i = 0; i < f->validated_members.size(); i++) {
+		const GDScriptFunction::ValidatedMember &validated = f->validated_members[i];
+		w.put_32(validated.name);
+		w.put_32(validated.base_type);
+		w.put_32(validated.setter != NULL);
+	}
+
+	w.put_32(f->validated_calls.size());
+	for (int i = 0; i < f->validated_calls.size(); i++) {
+		w.put_32(f->validated_calls[i].name);
+		w.put_32(f->validated_calls[i].base_type);
+	}
+
+	w.put_32(f->_inline_cache_count);
+	for (int i = 0; i < f->_inline_cache_count; i++) {
+		w.put_32(f->_inline_caches[i].name);
+	}
+
+	w.put_32(f->default_arguments.size());
+	for (int i = 0; i < f->default_arguments.size(); i++) {
+		w.put_32(f->default_arguments[i]);
+	}
+
+	w.put_32(f->_code_size);
+	for (int i = 0; i < f->_code_size; i++) {
+		w.put_32(f->_code_ptr[i]);
+	}
+
+	// Global indices depend on what the running engine registered, so they are stored by name.
+	w.put_32(globals.positions.size());
+	for (int i = 0; i < globals.positions.size(); i++) {
+		int address = f->_code_ptr[globals.positions[i]];
+		int index = address & GDScriptFunction::ADDR_MASK;
+		StringName name;
+		if ((address >> GDScriptFunction::ADDR_BITS) == GDScriptFunction::ADDR_TYPE_GLOBAL) {
+			const Map<int, StringName>::Element *E = w.globals.find(index);
+			ERR_FAIL_COND_V(!E, false);
+			name = E->get();
+		} else {
+#ifdef TOOLS_ENABLED
+			ERR_FAIL_INDEX_V(index, f->named_globals.size(), false);
+			name = f->named_globals[index];
+#else
+			return false;
+#endif
+		}
+		w.put_32(globals.positions[i]);
+		w.put_string(name);
+	}
+
+	w.put_32(f->stack_debug.size());
+	for (const List<GDScriptFunction::StackDebug>::Element *E = f->stack_debug.front(); E; E = E->next()) {
+		w.put_32(E->get().line);
+		w.put_32(E->get().pos);
+		w.put_32(E->get().added);
+		w.put_string(E->get().identifier);
+	}
+
+	w.put_32(f->line_table.size());
+	for (int i = 0; i < f->line_table.size(); i++) {
+		w.put_32(f->line_table[i].ip);
+		w.put_32(f->line_table[i].line);
+	}
+
+	return true;
+}
+
+Error GDScriptBytecode::save(const GDScript *p_script, const Vector<uint8_t> &p_tokens, Vector<uint8_t> &r_buffer) {
+	ERR_FAIL_NULL_V(p_script, ERR_INVALID_PARAMETER);
+	ERR_FAIL_COND_V(!p_script->valid, ERR_INVALID_PARAMETER);
+
+	Writer w;
+	w.root = p_script;
+	w.depth = 0;
+
+	const Map<StringName, int> &global_map = GDScriptLanguage::get_singleton()->get_global_map();
+	for (const Map<StringName, int>::Element *E = global_map.front(); E; E = E->next()) {
+		w.globals[E->get()] = E->key();
+	}
+
+	w.put_buffer((const uint8_t *)"GDSB", 4);
+	w.put_32(FORMAT_VERSION);
+	w.put_32(VERSION_HEX);
+	w.put_32(GDScriptFunction::OPCODE_END);
+	w.put_32(GDScriptFunctions::FUNC_MAX);
+	w.put_32(Variant::VARIANT_MAX);
+	w.put_32(Variant::OP_MAX);
+	w.put_32(0); // Tokens offset.
+	w.put_32(0); // Tokens length.
+
+	Vector<const GDScript *> classes;
+	_save_tree(w, p_script, classes);
+	for (int i = 0; i < classes.size(); i++) {
+		if (!_save_class(w, classes[i])) {
+			return ERR_UNAVAILABLE;
+		}
+	}
+
+	encode_uint32(w.data.size(), &w.data[HEADER_TOKENS_OFFSET]);
+	encode_uint32(p_tokens.size(), &w.data[HEADER_TOKENS_LENGTH]);
+	w.put_buffer(p_tokens.ptr(), p_tokens.size());
+
+	r_buffer = w.data;
+	return OK;
+}
+
+void GDScriptBytecode::_clear_class(GDScript *p_script) {
+	p_script->native = Ref<GDScriptNativeClass>();
+	p_script->base = Ref<GDScript>();
+	p_script->_base = NULL;
+	p_script->members.clear();
+	p_script->constants.clear();
+	GDScriptFunction::clear_inline_caches();
+	for (Map<StringName, GDScriptFunction *>::Element *E = p_script->member_functions.front(); E; E = E->next()) {
+		memdelete(E->get());
+	}
+	p_script->member_functions.clear();
+	p_script->member_indices.clear();
+	p_script->member_info.clear();
+	p_script->_signals.clear();
+	p_script->initializer = NULL;
+#ifdef TOOLS_ENABLED
+	p_script->member_lines.clear();
+	p_script->member_default_values.clear();
+#endif
+}
+
+bool GDScriptBytecode::_load_tree(Reader &r, GDScript *p_script, Vector<GDScript *> &r_classes) {
+	r_classes.push_back(p_script);
+	if (r.depth > MAX_DEPTH) {
+		return r.fail();
+	}
+
+	int count = r.get_count(8);
+	r.depth++;
+	for (int i = 0; i < count; i++) {
+		StringName name = r.get_string();
+		if (r.failed || name == StringName() || p_script->subclasses.has(name)) {
+			return r.fail();
+		}
+
+		String fully_qualified_name = p_script->fully_qualified_name + "::" + name;
+		Ref<GDScript> subclass = GDScriptLanguage::get_singleton()->get_orphan_subclass(fully_qualified_name);
+		if (subclass.is_null()) {
+			subclass.instance();
+		}
+
+		subclass->_owner = p_script;
+		subclass->fully_qualified_name = fully_qualified_name;
+		p_script->subclasses.insert(name, subclass);
+
+		if (!_load_tree(r, subclass.ptr(), r_classes)) {
+			return false;
+		}
+	}
+	r.depth--;
+
+	return !r.failed;
+}
+
+bool GDScriptBytecode::_load_class(Reader &r, GDScript *p_script) {
+	_clear_class(p_script);
+
+	p_script->tool = r.get_32();
+	p_script->name = r.get_string();
+
+	if (r.get_32()) {
+		Ref<Script> script;
+		bool in_image;
+		if (!r.get_script(script, in_image)) {
+			return false;
+		}
+		Ref<GDScript> base = script;
+		if (base.is_null() || base.ptr() == p_script) {
+			return r.fail();
+		}
+		p_script->base = base;
+		p_script->_base = base.ptr();
+	} else {
+		StringName native_name = r.get_string();
+		const Map<StringName, int>::Element *E = GDScriptLanguage::get_singleton()->get_global_map().find(native_name);
+		if (r.failed || !E) {
+			return r.fail();
+		}
+		Ref<GDScriptNativeClass> native = GDScriptLanguage::get_singleton()->get_global_array()[E->get()];
+		if (native.is_null()) {
+			return r.fail();
+		}
+		p_script->native = native;
+	}
+
+	int count = r.get_count(4);
+	for (int i = 0; i < count; i++) {
+		p_script->members.insert(r.get_string());
+	}
+
+	count = r.get_count(4);
+	LocalVector<uint8_t> used_indices;
+	used_indices.resize(count);
+	for (int i = 0; i < count; i++) {
+		used_indices[i] = 0;
+	}
+	for (int i = 0; i < count; i++) {
+		StringName name = r.get_string();
+		GDScript::MemberInfo info;
+		info.index = r.get_int();
+		info.setter = r.get_string();
+		info.getter = r.get_string();
+		uint32_t rpc_mode = r.get_32();
+		if (info.index < 0 || info.index >= count || used_indices[info.index] || rpc_mode > MultiplayerAPI::RPC_MODE_PUPPETSYNC) {
+			return r.fail();
+		}
+		used_indices[info.index] = 1;
+		info.rpc_mode = MultiplayerAPI::RPCMode(rpc_mode);
+		if (!r.get_data_type(info.data_type)) {
+			return false;
+		}
+		p_script->member_indices[name] = info;
+	}
+	if (p_script->member_indices.size() != count) {
+		return r.fail();
+	}
+
+	count = r.get_count(4);
+	for (int i = 0; i < count; i++) {
+		StringName name = r.get_string();
+		PropertyInfo info;
+		if (!r.get_property_info(info)) {
+			return false;
+		}
+		p_script->member_info[name] = info;
+	}
+
+	count = r.get_count(4);
+	for (int i = 0; i < count; i++) {
+		StringName name = r.get_string();
+		Variant value;
+		if (!r.get_constant(value)) {
+			return false;
+		}
+		p_script->constants[name] = value;
+	}
+
+	count = r.get_count(4);
+	for (int i = 0; i < count; i++) {
+		StringName name = r.get_string();
+		Vector<StringName> arguments;
+		arguments.resize(r.get_count(4));
+		for (int j = 0; j < arguments.size(); j++) {
+			arguments.write[j] = r.get_string();
+		}
+		p_script->_signals[name] = arguments;
+	}
+
+	count = r.get_count(4);
+	for (int i = 0; i < count; i++) {
+		StringName name = r.get_string();
+		int line = r.get_int();
+#ifdef TOOLS_ENABLED
+		p_script->member_lines[name] = line;
+#else
+		(void)line;
+#endif
+	}
+
+	count = r.get_count(4);
+	for (int i = 0; i < count; i++) {
+		StringName name = r.get_string();
+		Variant value;
+		if (!r.get_constant(value)) {
+			return false;
+		}
+#ifdef TOOLS_ENABLED
+		p_script->member_default_values[name] = value;
+#endif
+	}
+
+	count = r.get_count(4);
+	for (int i = 0; i < count && !r.failed; i++) {
+		GDScriptFunction *function = memnew(GDScriptFunction);
+		bool initializer = false;
+		if (!_load_function(r, p_script, function, initializer) || p_script->member_functions.has(function->name)) {
+			memdelete(function);
+			return r.fail();
+		}
+
+		p_script->member_functions[function->name] = function;
+		if (initializer) {
+			p_script->initializer = function;
+		}
+	}
+
+	return !r.failed;
+}
+
+bool GDScriptBytecode::_load_function(Reader &r, GDScript *p_script, GDScriptFunction *p_function, bool &r_initializer) {
+	GDScriptFunction *f = p_function;
+
+	f->name = r.get_string();
+	uint32_t flags = r.get_32();
+	f->_static = flags & FUNCTION_STATIC;
+	f->_coroutine = flags & FUNCTION_COROUTINE;
+	r_initializer = flags & FUNCTION_INITIALIZER;
+	uint32_t rpc_mode = r.get_32();
+	if (rpc_mode > MultiplayerAPI::RPC_MODE_PUPPETSYNC) {
+		return r.fail();
+	}
+	f->rpc_mode = MultiplayerAPI::RPCMode(rpc_mode);
+	f->_argument_count = r.get_int();
+	f->_stack_size = r.get_int();
+	f->_call_size = r.get_int();
+	f->_initial_line = r.get_int();
+	if (f->_argument_count < 0 || f->_stack_size < f->_argument_count || f->_stack_size > GDScriptFunction::ADDR_MASK || f->_call_size < 0 || f->_call_size > GDScriptFunction::ADDR_MASK) {
+		return r.fail();
+	}
+
+	f->argument_types.resize(r.get_count(4));
+	for (int i = 0; i < f->argument_types.size(); i++) {
+		if (!r.get_data_type(f->argument_types.write[i])) {
+			return false;
+		}
+	}
+	if (f->argument_types.size() < f->_argument_count || !r.get_data_type(f->return_type)) {
+		return r.fail();
+	}
+
+	int count = r.get_count(4);
+	for (int i = 0; i < count; i++) {
+		StringName arg_name = r.get_string();
+#ifdef TOOLS_ENABLED
+		f->arg_names.push_back(arg_name);
+#endif
+	}
+
+	f->constants.resize(r.get_count(4));
+	for (int i = 0; i < f->constants.size(); i++) {
+		if (!r.get_constant(f->constants.write[i])) {
+			return false;
+		}
+	}
+	f->_constant_count = f->constants.size();
+	f->_constants_ptr = f->_constant_count ? f->constants.ptrw() : NULL;
+
+	f->global_names.resize(r.get_count(4));
+	for (int i = 0; i < f->global_names.size(); i++) {
+		f->global_names.write[i] = r.get_string();
+	}
+	f->_global_names_count = f->global_names.size();
+	f->_global_names_ptr = f->_global_names_count ? f->global_names.ptr() : NULL;
+
+	// Validated entries point into this engine's function tables, so they are resolved again.
+	f->validated_operators.resize(r.get_count(12));
+	for (int i = 0; i < f->validated_operators.size(); i++) {
+		GDScriptFunction::ValidatedOperator &validated = f->validated_operators.write[i];
+		uint32_t op = r.get_32();
+		uint32_t left_type = r.get_32();
+		uint32_t right_type = r.get_32();
+		if (op >= Variant::OP_MAX || left_type >= Variant::VARIANT_MAX || right_type >= Variant::VARIANT_MAX) {
+			return r.fail();
+		}
+		validated.op = Variant::Operator(op);
+		validated.left_type = Variant::Type(left_type);
+		validated.right_type = Variant::Type(right_type);
+		validated.evaluator = Variant::get_validated_operator_evaluator(validated.op, validated.left_type, validated.right_type);
+		if (!validated.evaluator) {
+			return r.fail();
+		}
+	}
+
+	f->validated_members.resize(r.get_count(12));
+	for (int i = 0; i < f->validated_members.size(); i++) {
+		GDScriptFunction::ValidatedMember &validated = f->validated_members.write[i];
+		validated.name = r.get_int();
+		uint32_t base_type = r.get_32();
+		bool setter = r.get_32();
+		if (validated.name < 0 || validated.name >= f->_global_names_count || base_type >= Variant::VARIANT_MAX) {
+			return r.fail();
+		}
+		validated.base_type = Variant::Type(base_type);
+		const StringName &member = f->global_names[validated.name];
+		validated.getter = setter ? NULL : Variant::get_validated_getter(validated.base_type, member);
+		validated.setter = setter ? Variant::get_validated_setter(validated.base_type, member) : NULL;
+		if (!validated.getter && !validated.setter) {
+			return r.fail();
+		}
+	}
+
+	f->validated_calls.resize(r.get_count(8));
+	for (int i = 0; i < f->validated_calls.size(); i++) {
+		GDScriptFunction::ValidatedCall &validated = f->validated_calls.write[i];
+		validated.name = r.get_int();
+		uint32_t base_type = r.get_32();
+		if (validated.name < 0 || validated.name >= f->_global_names_count || base_type >= Variant::VARIANT_MAX) {
+			return r.fail();
+		}
+		validated.base_type = Variant::Type(base_type);
+		if (!Variant::resolve_call_site(validated.base_type, f->global_names[validated.name], validated.cache)) {
+			return r.fail();
+		}
+	}
+
+	f->_validated_operators_ptr = f->validated_operators.ptr();
+	f->_validated_operators_count = f->validated_operators.size();
+	f->_validated_members_ptr = f->validated_members.ptr();
+	f->_validated_members_count = f->validated_members.size();
+	f->_validated_calls_ptr = f->validated_calls.ptrw();
+	f->_validated_calls_count = f->validated_calls.size();
+
+	count = r.get_count(4);
+	if (count) {
+		f->_inline_caches = memnew_arr(GDScriptFunction::InlineCache, count);
+		f->_inline_cache_count = count;
+		for (int i = 0; i < count; i++) {
+			f->_inline_caches[i].name = r.get_int();
+			if (f->_inline_caches[i].name < 0 || f->_inline_caches[i].name >= f->_global_names_count) {
+				return r.fail();
+			}
+		}
+	}
+
+	f->default_arguments.resize(r.get_count(4));
+	for (int i = 0; i < f->default_arguments.size(); i++) {
+		f->default_arguments.write[i] = r.get_int();
+	}
+	f->_default_arg_count = f->default_arguments.size() ? f->default_arguments.size() - 1 : 0;
+	f->_default_arg_ptr = f->default_arguments.size() ? f->default_arguments.ptr() : NULL;
+
+	f->code.resize(r.get_count(4));
+	for (int i = 0; i < f->code.size(); i++) {
+		f->code.write[i] = r.get_int();
+	}
+	f->_code_size = f->code.size();
+
+	const Map<StringName, int> &global_map = GDScriptLanguage::get_singleton()->get_global_map();
+	count = r.get_count(8);
+	for (int i = 0; i < count; i++) {
+		int pos = r.get_int();
+		StringName name = r.get_string();
+		if (r.failed || pos < 0 || pos >= f->_code_size || !_is_global_address(f->code[pos])) {
+			return r.fail();
+		}
+
+		const Map<StringName, int>::Element *E = global_map.find(name);
+		if (E) {
+			f->code.write[pos] = E->get() | (GDScriptFunction::ADDR_TYPE_GLOBAL << GDScriptFunction::ADDR_BITS);
+			continue;
+		}
+#ifdef TOOLS_ENABLED
+		if (GDScriptLanguage::get_singleton()->get_named_globals_map().has(name)) {
+			int idx = f->named_globals.find(name);
+			if (idx == -1) {
+				idx = f->named_globals.size();
+				f->named_globals.push_back(name);
+			}
+			f->code.write[pos] = idx | (GDScriptFunction::ADDR_TYPE_NAMED_GLOBAL << GDScriptFunction::ADDR_BITS);
+			continue;
+		}
+#endif
+		return r.fail();
+	}
+#ifdef TOOLS_ENABLED
+	f->_named_globals_ptr = f->named_globals.ptr();
+	f->_named_globals_count = f->named_globals.size();
+#endif
+	f->_code_ptr = f->_code_size ? f->code.ptr() : NULL;
+
+	count = r.get_count(16);
+	for (int i = 0; i < count; i++) {
+		GDScriptFunction::StackDebug sd;
+		sd.line = r.get_int();
+		sd.pos = r.get_int();
+		sd.added = r.get_32();
+		sd.identifier = r.get_string();
+		if (sd.pos < 0 || sd.pos >= f->_stack_size) {
+			return r.fail();
+		}
+		f->stack_debug.push_back(sd);
+	}
+
+	count = r.get_count(8);
+	f->line_table.resize(count);
+	for (int i = 0; i < count; i++) {
+		GDScriptFunction::LineEntry &entry = f->line_table.write[i];
+		entry.ip = r.get_int();
+		entry.line = r.get_int();
+		if (entry.ip < 0 || entry.ip > f->_code_size || (i > 0 && entry.ip <= f->line_table[i - 1].ip)) {
+			return r.fail();
+		}
+	}
+
+	if (r.failed || !_validate_code(p_script, f)) {
+		return r.fail();
+	}
+
+	f->_script = p_script;
+	f->source = r.root->get_path();
+
+#ifdef DEBUG_ENABLED
+	if (ScriptDebugger::get_singleton()) {
+		String signature = r.root->get_path() + "::" + itos(f->_initial_line) + "::";
+		if (p_script->name != String()) {
+			signature += p_script->name + ".";
+		}
+		f->profile.signature = signature + String(f->name);
+	}
+
+	f->func_cname = (String(f->source) + " - " + String(f->name)).utf8();
+	f->_func_cname = f->func_cname.get_data();
+#endif
+
+	return true;
+}
+
+bool GDScriptBytecode::_validate_code(const GDScript *p_script, const GDScriptFunction *p_function) {
+	const GDScriptFunction *f = p_function;
+
+	GDScriptCodeValidator validator;
+	validator.code_size = f->_code_size;
+	validator.member_count = p_script->member_indices.size();
+	validator.constant_count = f->_constant_count;
+	validator.global_name_count = f->_global_names_count;
+	validator.global_count = GDScriptLanguage::get_singleton()->get_global_array_size();
+#ifdef TOOLS_ENABLED
+	validator.named_global_count = f->_named_globals_count;
+#else
+	validator.named_global_count = 0;
+#endif
+	validator.stack_size = f->_stack_size;
+	validator.call_size = f->_call_size;
+	validator.validated_operator_count = f->_validated_operators_count;
+	validator.validated_call_count = f->_validated_calls_count;
+	validator.inline_cache_count = f->_inline_cache_count;
+	validator.validated_members = f->_validated_members_ptr;
+	validator.validated_member_count = f->_validated_members_count;
+	validator.has_default_arguments = f->_default_arg_count > 0;
+	validator.coroutine = f->_coroutine;
+	validator.last_opcode = -1;
+	validator.expect_iterate = false;
+	validator.starts.resize(f->_code_size);
+	for (int i = 0; i < f->_code_size; i++) {
+		validator.starts[i] = 0;
+	}
+
+	if (!_walk_code(f->_code_ptr, f->_code_size, validator) || validator.last_opcode != GDScriptFunction::OPCODE_END) {
+		return false;
+	}
+
+	for (int i = 0; i < validator.jumps.size(); i++) {
+		if (!validator.is_start(validator.jumps[i])) {
+			return false;
+		}
+	}
+	for (int i = 0; i < f->default_arguments.size(); i++) {
+		if (!validator.is_start(f->default_arguments[i])) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+Error GDScriptBytecode::load(GDScript *p_script, const Vector<uint8_t> &p_buffer) {
+	ERR_FAIL_NULL_V(p_script, ERR_INVALID_PARAMETER);
+	ERR_FAIL_COND_V(!is_image(p_buffer), ERR_FILE_UNRECOGNIZED);
+
+	const uint8_t *buf = p_buffer.ptr();
+	if (decode_uint32(&buf[HEADER_FORMAT_VERSION]) != FORMAT_VERSION ||
+			decode_uint32(&buf[HEADER_ENGINE_VERSION]) != VERSION_HEX ||
+			decode_uint32(&buf[HEADER_OPCODE_COUNT]) != GDScriptFunction::OPCODE_END ||
+			decode_uint32(&buf[HEADER_FUNCTION_COUNT]) != GDScriptFunctions::FUNC_MAX ||
+			decode_uint32(&buf[HEADER_TYPE_COUNT]) != Variant::VARIANT_MAX ||
+			decode_uint32(&buf[HEADER_OPERATOR_COUNT]) != Variant::OP_MAX) {
+		return ERR_FILE_UNRECOGNIZED; // Built by another engine, the tokens are still usable.
+	}
+
+	uint32_t tokens_ofs = decode_uint32(&buf[HEADER_TOKENS_OFFSET]);
+	ERR_FAIL_COND_V(tokens_ofs < HEADER_SIZE || tokens_ofs > uint32_t(p_buffer.size()), ERR_FILE_CORRUPT);
+
+	Reader r;
+	r.data = buf;
+	r.size = tokens_ofs;
+	r.pos = HEADER_SIZE;
+	r.failed = false;
+	r.root = p_script;
+	r.depth = 0;
+
+	p_script->valid = false;
+	p_script->_owner = NULL;
+	p_script->fully_qualified_name = p_script->path;
+	p_script->subclasses.clear();
+
+	Vector<GDScript *> classes;
+	bool ok = _load_tree(r, p_script, classes);
+	r.depth = 0;
+	for (int i = 0; ok && i < classes.size(); i++) {
+		ok = _load_class(r, classes[i]);
+	}
+	ok = ok && !r.failed && r.pos == r.size;
+
+	for (int i = 0; ok && i < classes.size(); i++) {
+		const GDScript *script = classes[i];
+
+		// Bases inside the image can form a cycle only if it was tampered with.
+		int steps = 0;
+		for (const GDScript *base = script->_base; base && ok; base = base->_base) {
+			if (classes.find(const_cast<GDScript *>(base)) != -1 && ++steps > classes.size()) {
+				ok = false;
+			}
+		}
+
+		// Inherited members must still be where this class expects them.
+		for (const Map<StringName, GDScript::MemberInfo>::Element *E = script->_base ? script->_base->member_indices.front() : NULL; ok && E; E = E->next()) {
+			const Map<StringName, GDScript::MemberInfo>::Element *F = script->member_indices.find(E->key());
+			ok = F && F->get().index == E->get().index;
+		}
+	}
+
+	if (!ok) {
+		for (int i = 0; i < classes.size(); i++) {
+			_clear_class(classes[i]);
+		}
+		p_script->subclasses.clear();
+		return ERR_FILE_CORRUPT;
+	}
+
+	for (int i = 0; i < classes.size(); i++) {
+		classes[i]->valid = true;
+	}
+
+	return OK;
+}
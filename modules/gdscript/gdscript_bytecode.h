@@ -0,0 +1,70 @@
+/*************************************************************************/
+/*  gdscript_bytecode.h                                                  */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-present Godot Engine contributors (cf. AUTHORS.md).*/
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef GDSCRIPT_BYTECODE_H
+#define GDSCRIPT_BYTECODE_H
+
+#include "core/error_list.h"
+#include "core/vector.h"
+
+class GDScript;
+class GDScriptFunction;
+
+// Compiled class images, so exported scripts load without being parsed and compiled.
+// An image also carries the tokenized source, used when it can't be loaded as is.
+class GDScriptBytecode {
+public:
+	enum {
+		FORMAT_VERSION = 3, // Bump whenever opcodes or the image layout change.
+	};
+
+	static bool is_image(const Vector<uint8_t> &p_buffer);
+	static Vector<uint8_t> get_tokens(const Vector<uint8_t> &p_buffer);
+
+private:
+	class Writer;
+	class Reader;
+
+	static void _save_tree(Writer &w, const GDScript *p_script, Vector<const GDScript *> &r_classes);
+	static bool _save_class(Writer &w, const GDScript *p_script);
+	static bool _save_function(Writer &w, const GDScript *p_script, const GDScriptFunction *p_function);
+
+	static bool _load_tree(Reader &r, GDScript *p_script, Vector<GDScript *> &r_classes);
+	static bool _load_class(Reader &r, GDScript *p_script);
+	static bool _load_function(Reader &r, GDScript *p_script, GDScriptFunction *p_function, bool &r_initializer);
+	static bool _validate_code(const GDScript *p_script, const GDScriptFunction *p_function);
+	static void _clear_class(GDScript *p_script);
+
+public:
+	static Error save(const GDScript *p_script, const Vector<uint8_t> &p_tokens, Vector<uint8_t> &r_buffer);
+	static Error load(GDScript *p_script, const Vector<uint8_t> &p_buffer);
+};
+
+#endif // GDSCRIPT_BYTECODE_H
@@ -70,6 +70,15 @@ void GDScriptCompiler::_set_error(const String &p_error, const GDScriptParser::N
 	}
 }
 
+// Static builtin type of an expression, or VARIANT_MAX when it is not known.
+static Variant::Type _get_builtin_type(const GDScriptParser::Node *p_node) {
+	GDScriptParser::DataType datatype = p_node->get_datatype();
+	if (!datatype.has_type || datatype.kind != GDScriptParser::DataType::BUILTIN) {
+		return Variant::VARIANT_MAX;
+	}
+	return datatype.builtin_type;
+}
+
 bool GDScriptCompiler::_create_unary_operator(CodeGen &codegen, const GDScriptParser::OperatorNode *on, Variant::Operator op, int p_stack_level) {
 	ERR_FAIL_COND_V(on->arguments.size() != 1, false);
 
@@ -77,8 +86,15 @@ bool GDScriptCompiler::_create_unary_operator(CodeGen &codegen, const GDScriptPa
 	if (src_address_a < 0)
 		return false;
 
-	codegen.opcodes.push_back(GDScriptFunction::OPCODE_OPERATOR); // perform operator
-	codegen.opcodes.push_back(op); //which operator
+	Variant::Type type_a = _get_builtin_type(on->arguments[0]);
+	int validated = codegen.get_validated_operator_pos(op, type_a, type_a);
+	if (validated >= 0) {
+		codegen.opcodes.push_back(GDScriptFunction::OPCODE_OPERATOR_VALIDATED); // perform operator on known types
+		codegen.opcodes.push_back(validated); // which specialization
+	} else {
+		codegen.opcodes.push_back(GDScriptFunction::OPCODE_OPERATOR); // perform operator
+		codegen.opcodes.push_back(op); //which operator
+	}
 	codegen.opcodes.push_back(src_address_a); // argument 1
 	codegen.opcodes.push_back(src_address_a); // argument 2 (repeated)
 	//codegen.opcodes.push_back(GDScriptFunction::ADDR_TYPE_NIL); // argument 2 (unary only takes one parameter)
@@ -98,8 +114,14 @@ bool GDScriptCompiler::_create_binary_operator(CodeGen &codegen, const GDScriptP
 	if (src_address_b < 0)
 		return false;
 
-	codegen.opcodes.push_back(GDScriptFunction::OPCODE_OPERATOR); // perform operator
-	codegen.opcodes.push_back(op); //which operator
+	int validated = codegen.get_validated_operator_pos(op, _get_builtin_type(on->arguments[0]), _get_builtin_type(on->arguments[1]));
+	if (validated >= 0) {
+		codegen.opcodes.push_back(GDScriptFunction::OPCODE_OPERATOR_VALIDATED); // perform operator on known types
+		codegen.opcodes.push_back(validated); // which specialization
+	} else {
+		codegen.opcodes.push_back(GDScriptFunction::OPCODE_OPERATOR); // perform operator
+		codegen.opcodes.push_back(op); //which operator
+	}
 	codegen.opcodes.push_back(src_address_a); // argument 1
 	codegen.opcodes.push_back(src_address_b); // argument 2 (unary only takes one parameter)
 	return true;
@@ -645,7 +667,19 @@ int GDScriptCompiler::_parse_expression(CodeGen &codegen, const GDScriptParser::
 							arguments.push_back(ret);
 						}
 
-						codegen.opcodes.push_back(p_root ? GDScriptFunction::OPCODE_CALL : GDScriptFunction::OPCODE_CALL_RETURN); // perform operator
+						Variant::Type base_type = _get_builtin_type(instance);
+						int validated = -1;
+						if (base_type != Variant::VARIANT_MAX && base_type != Variant::NIL && base_type != Variant::OBJECT) {
+							validated = codegen.get_validated_call_pos(base_type, static_cast<GDScriptParser::IdentifierNode *>(on->arguments[1])->name);
+						}
+
+						if (validated >= 0) {
+							arguments.write[1] = validated;
+							codegen.opcodes.push_back(p_root ? GDScriptFunction::OPCODE_CALL_VALIDATED : GDScriptFunction::OPCODE_CALL_RETURN_VALIDATED); // call on known builtin type
+						} else {
+							arguments.write[1] = codegen.get_inline_cache_pos(arguments[1]);
+							codegen.opcodes.push_back(p_root ? GDScriptFunction::OPCODE_CALL : GDScriptFunction::OPCODE_CALL_RETURN); // perform operator
+						}
 						codegen.opcodes.push_back(on->arguments.size() - 2);
 						codegen.alloc_call(on->arguments.size() - 2);
 						for (int i = 0; i < arguments.size(); i++)
@@ -669,6 +703,7 @@ int GDScriptCompiler::_parse_expression(CodeGen &codegen, const GDScriptParser::
 					}
 
 					//push call bytecode
+					codegen.coroutine = true;
 					codegen.opcodes.push_back(arguments.size() == 0 ? GDScriptFunction::OPCODE_YIELD : GDScriptFunction::OPCODE_YIELD_SIGNAL); // basic type constructor
 					for (int i = 0; i < arguments.size(); i++)
 						codegen.opcodes.push_back(arguments[i]); //arguments
@@ -690,6 +725,7 @@ int GDScriptCompiler::_parse_expression(CodeGen &codegen, const GDScriptParser::
 						return from;
 
 					int index;
+					StringName index_name;
 					if (p_index_addr != 0) {
 						index = p_index_addr;
 					} else if (named) {
@@ -711,13 +747,14 @@ int GDScriptCompiler::_parse_expression(CodeGen &codegen, const GDScriptParser::
 							}
 						}
 
-						index = codegen.get_name_map_pos(static_cast<GDScriptParser::IdentifierNode *>(on->arguments[1])->name);
+						index_name = static_cast<GDScriptParser::IdentifierNode *>(on->arguments[1])->name;
+						index = codegen.get_name_map_pos(index_name);
 
 					} else {
 						if (on->arguments[1]->type == GDScriptParser::Node::TYPE_CONSTANT && static_cast<const GDScriptParser::ConstantNode *>(on->arguments[1])->value.get_type() == Variant::STRING) {
 							//also, somehow, named (speed up anyway)
-							StringName name = static_cast<const GDScriptParser::ConstantNode *>(on->arguments[1])->value;
-							index = codegen.get_name_map_pos(name);
+							index_name = static_cast<const GDScriptParser::ConstantNode *>(on->arguments[1])->value;
+							index = codegen.get_name_map_pos(index_name);
 							named = true;
 
 						} else {
@@ -733,9 +770,20 @@ int GDScriptCompiler::_parse_expression(CodeGen &codegen, const GDScriptParser::
 						}
 					}
 
-					codegen.opcodes.push_back(named ? GDScriptFunction::OPCODE_GET_NAMED : GDScriptFunction::OPCODE_GET); // perform operator
-					codegen.opcodes.push_back(from); // argument 1
-					codegen.opcodes.push_back(index); // argument 2 (unary only takes one parameter)
+					int validated = -1;
+					if (named && index_name != StringName()) {
+						validated = codegen.get_validated_member_pos(_get_builtin_type(on->arguments[0]), index_name, false);
+					}
+
+					if (validated >= 0) {
+						codegen.opcodes.push_back(GDScriptFunction::OPCODE_GET_NAMED_VALIDATED); // get member of known builtin type
+						codegen.opcodes.push_back(from); // argument 1
+						codegen.opcodes.push_back(validated); // which specialization
+					} else {
+						codegen.opcodes.push_back(named ? GDScriptFunction::OPCODE_GET_NAMED : GDScriptFunction::OPCODE_GET); // perform operator
+						codegen.opcodes.push_back(from); // argument 1
+						codegen.opcodes.push_back(named ? codegen.get_inline_cache_pos(index) : index); // argument 2 (unary only takes one parameter)
+					}
 
 				} break;
 				case GDScriptParser::OperatorNode::OP_AND: {
@@ -1045,7 +1093,7 @@ int GDScriptCompiler::_parse_expression(CodeGen &codegen, const GDScriptParser::
 
 							codegen.opcodes.push_back(named ? GDScriptFunction::OPCODE_GET_NAMED : GDScriptFunction::OPCODE_GET);
 							codegen.opcodes.push_back(prev_pos);
-							codegen.opcodes.push_back(key_idx);
+							codegen.opcodes.push_back(named ? codegen.get_inline_cache_pos(key_idx) : key_idx);
 							slevel++;
 							codegen.alloc_stack(slevel);
 							int dst_pos = (GDScriptFunction::ADDR_TYPE_STACK << GDScriptFunction::ADDR_BITS) | slevel;
@@ -1066,9 +1114,12 @@ int GDScriptCompiler::_parse_expression(CodeGen &codegen, const GDScriptParser::
 
 						int set_index;
 						bool named = false;
+						int validated = -1;
 
 						if (op->op == GDScriptParser::OperatorNode::OP_INDEX_NAMED) {
-							set_index = codegen.get_name_map_pos(static_cast<const GDScriptParser::IdentifierNode *>(op->arguments[1])->name);
+							StringName set_name = static_cast<const GDScriptParser::IdentifierNode *>(op->arguments[1])->name;
+							set_index = codegen.get_name_map_pos(set_name);
+							validated = codegen.get_validated_member_pos(_get_builtin_type(op->arguments[0]), set_name, true);
 							named = true;
 						} else {
 							set_index = _parse_expression(codegen, op->arguments[1], slevel + 1);
@@ -1087,9 +1138,15 @@ int GDScriptCompiler::_parse_expression(CodeGen &codegen, const GDScriptParser::
 						if (set_value < 0) //error
 							return set_value;
 
-						codegen.opcodes.push_back(named ? GDScriptFunction::OPCODE_SET_NAMED : GDScriptFunction::OPCODE_SET);
-						codegen.opcodes.push_back(prev_pos);
-						codegen.opcodes.push_back(set_index);
+						if (validated >= 0) {
+							codegen.opcodes.push_back(GDScriptFunction::OPCODE_SET_NAMED_VALIDATED);
+							codegen.opcodes.push_back(prev_pos);
+							codegen.opcodes.push_back(validated);
+						} else {
+							codegen.opcodes.push_back(named ? GDScriptFunction::OPCODE_SET_NAMED : GDScriptFunction::OPCODE_SET);
+							codegen.opcodes.push_back(prev_pos);
+							codegen.opcodes.push_back(set_index);
+						}
 						codegen.opcodes.push_back(set_value);
 
 						for (int i = 0; i < setchain.size(); i++) {
@@ -1255,11 +1312,14 @@ Error GDScriptCompiler::_parse_block(CodeGen &codegen, const GDScriptParser::Blo
 
 		switch (s->type) {
 			case GDScriptParser::Node::TYPE_NEWLINE: {
-#ifdef DEBUG_ENABLED
 				const GDScriptParser::NewLineNode *nl = static_cast<const GDScriptParser::NewLineNode *>(s);
-				codegen.opcodes.push_back(GDScriptFunction::OPCODE_LINE);
-				codegen.opcodes.push_back(nl->line);
-				codegen.current_line = nl->line;
+				codegen.add_line(nl->line);
+#ifdef DEBUG_ENABLED
+				if (debug_info != DEBUG_INFO_NONE) {
+					codegen.opcodes.push_back(GDScriptFunction::OPCODE_LINE);
+					codegen.opcodes.push_back(nl->line);
+					codegen.current_line = nl->line;
+				}
 #endif
 			} break;
 			case GDScriptParser::Node::TYPE_CONTROL_FLOW: {
@@ -1488,6 +1548,10 @@ Error GDScriptCompiler::_parse_block(CodeGen &codegen, const GDScriptParser::Blo
 			} break;
 			case GDScriptParser::Node::TYPE_ASSERT: {
 #ifdef DEBUG_ENABLED
+				if (debug_info == DEBUG_INFO_NONE) {
+					break;
+				}
+
 				// try subblocks
 
 				const GDScriptParser::AssertNode *as = static_cast<const GDScriptParser::AssertNode *>(s);
@@ -1510,8 +1574,9 @@ Error GDScriptCompiler::_parse_block(CodeGen &codegen, const GDScriptParser::Blo
 			} break;
 			case GDScriptParser::Node::TYPE_BREAKPOINT: {
 #ifdef DEBUG_ENABLED
-				// try subblocks
-				codegen.opcodes.push_back(GDScriptFunction::OPCODE_BREAKPOINT);
+				if (debug_info != DEBUG_INFO_NONE) {
+					codegen.opcodes.push_back(GDScriptFunction::OPCODE_BREAKPOINT);
+				}
 #endif
 			} break;
 			case GDScriptParser::Node::TYPE_LOCAL_VAR: {
@@ -1551,7 +1616,8 @@ Error GDScriptCompiler::_parse_function(GDScript *p_script, const GDScriptParser
 	codegen.stack_max = 0;
 	codegen.current_line = 0;
 	codegen.call_max = 0;
-	codegen.debug_stack = ScriptDebugger::get_singleton() != NULL;
+	codegen.coroutine = false;
+	codegen.debug_stack = debug_info == DEBUG_INFO_FULL || (debug_info == DEBUG_INFO_DEFAULT && ScriptDebugger::get_singleton() != NULL);
 	Vector<StringName> argnames;
 
 	int stack_level = 0;
@@ -1703,6 +1769,24 @@ Error GDScriptCompiler::_parse_function(GDScript *p_script, const GDScriptParser
 	}
 #endif
 
+	gdfunc->validated_operators = codegen.validated_operators;
+	gdfunc->_validated_operators_ptr = gdfunc->validated_operators.ptr();
+	gdfunc->_validated_operators_count = gdfunc->validated_operators.size();
+	gdfunc->validated_members = codegen.validated_members;
+	gdfunc->_validated_members_ptr = gdfunc->validated_members.ptr();
+	gdfunc->_validated_members_count = gdfunc->validated_members.size();
+	gdfunc->validated_calls = codegen.validated_calls;
+	gdfunc->_validated_calls_ptr = gdfunc->validated_calls.ptrw();
+	gdfunc->_validated_calls_count = gdfunc->validated_calls.size();
+
+	if (codegen.inline_caches.size()) {
+		gdfunc->_inline_caches = memnew_arr(GDScriptFunction::InlineCache, codegen.inline_caches.size());
+		for (int i = 0; i < codegen.inline_caches.size(); i++) {
+			gdfunc->_inline_caches[i].name = codegen.inline_caches[i];
+		}
+		gdfunc->_inline_cache_count = codegen.inline_caches.size();
+	}
+
 	if (codegen.opcodes.size()) {
 		gdfunc->code = codegen.opcodes;
 		gdfunc->_code_ptr = &gdfunc->code[0];
@@ -1725,6 +1809,7 @@ Error GDScriptCompiler::_parse_function(GDScript *p_script, const GDScriptParser
 	gdfunc->_argument_count = p_func ? p_func->arguments.size() : 0;
 	gdfunc->_stack_size = codegen.stack_max;
 	gdfunc->_call_size = codegen.call_max;
+	gdfunc->_coroutine = codegen.coroutine;
 	gdfunc->name = func_name;
 #ifdef DEBUG_ENABLED
 	if (ScriptDebugger::get_singleton()) {
@@ -1771,6 +1856,8 @@ Error GDScriptCompiler::_parse_function(GDScript *p_script, const GDScriptParser
 		gdfunc->_initial_line = 0;
 	}
 
+	gdfunc->line_table = codegen.line_table;
+
 	if (codegen.debug_stack)
 		gdfunc->stack_debug = codegen.stack_debug;
 
@@ -1802,6 +1889,7 @@ Error GDScriptCompiler::_parse_class_level(GDScript *p_script, const GDScriptPar
 	p_script->_base = NULL;
 	p_script->members.clear();
 	p_script->constants.clear();
+	GDScriptFunction::clear_inline_caches();
 	for (Map<StringName, GDScriptFunction *>::Element *E = p_script->member_functions.front(); E; E = E->next()) {
 		memdelete(E->get());
 	}
@@ -2137,4 +2225,5 @@ int GDScriptCompiler::get_error_column() const {
 }
 
 GDScriptCompiler::GDScriptCompiler() {
+	debug_info = DEBUG_INFO_DEFAULT;
 }
@@ -45,11 +45,13 @@ class GDScriptCompiler {
 		const GDScriptParser::ClassNode *class_node;
 		const GDScriptParser::FunctionNode *function_node;
 		bool debug_stack;
+		bool coroutine; // Contains a yield, so its frame is allocated apart from the VM stack.
 
 		List<Map<StringName, int>> stack_id_stack;
 		Map<StringName, int> stack_identifiers;
 
 		List<GDScriptFunction::StackDebug> stack_debug;
+		Vector<GDScriptFunction::LineEntry> line_table;
 		List<Map<StringName, int>> block_identifier_stack;
 		Map<StringName, int> block_identifiers;
 
@@ -66,6 +68,18 @@ class GDScriptCompiler {
 			}
 		}
 
+		void add_line(int p_line) {
+			int ip = opcodes.size();
+			if (line_table.size() && line_table[line_table.size() - 1].ip == ip) {
+				line_table.write[line_table.size() - 1].line = p_line;
+				return;
+			}
+			GDScriptFunction::LineEntry entry;
+			entry.ip = ip;
+			entry.line = p_line;
+			line_table.push_back(entry);
+		}
+
 		void push_stack_identifiers() {
 			stack_id_stack.push_back(stack_identifiers);
 			if (debug_stack) {
@@ -117,6 +131,68 @@ class GDScriptCompiler {
 			return pos;
 		}
 
+		Vector<GDScriptFunction::ValidatedOperator> validated_operators;
+		Vector<GDScriptFunction::ValidatedMember> validated_members;
+		Vector<GDScriptFunction::ValidatedCall> validated_calls;
+
+		int get_validated_operator_pos(Variant::Operator p_op, Variant::Type p_left, Variant::Type p_right) {
+			for (int i = 0; i < validated_operators.size(); i++) {
+				if (validated_operators[i].op == p_op && validated_operators[i].left_type == p_left && validated_operators[i].right_type == p_right)
+					return i;
+			}
+			Variant::ValidatedOperatorEvaluator evaluator = Variant::get_validated_operator_evaluator(p_op, p_left, p_right);
+			if (!evaluator)
+				return -1;
+			GDScriptFunction::ValidatedOperator validated;
+			validated.op = p_op;
+			validated.left_type = p_left;
+			validated.right_type = p_right;
+			validated.evaluator = evaluator;
+			validated_operators.push_back(validated);
+			return validated_operators.size() - 1;
+		}
+
+		int get_validated_member_pos(Variant::Type p_type, const StringName &p_member, bool p_set) {
+			const Map<StringName, int>::Element *N = name_map.find(p_member);
+			for (int i = 0; N && i < validated_members.size(); i++) {
+				if (validated_members[i].base_type == p_type && validated_members[i].name == N->get() && (validated_members[i].setter != NULL) == p_set)
+					return i;
+			}
+			Variant::ValidatedGetter getter = p_set ? NULL : Variant::get_validated_getter(p_type, p_member);
+			Variant::ValidatedSetter setter = p_set ? Variant::get_validated_setter(p_type, p_member) : NULL;
+			if (!getter && !setter)
+				return -1;
+			GDScriptFunction::ValidatedMember validated;
+			validated.name = get_name_map_pos(p_member);
+			validated.base_type = p_type;
+			validated.getter = getter;
+			validated.setter = setter;
+			validated_members.push_back(validated);
+			return validated_members.size() - 1;
+		}
+
+		int get_validated_call_pos(Variant::Type p_type, const StringName &p_method) {
+			const Map<StringName, int>::Element *N = name_map.find(p_method);
+			for (int i = 0; N && i < validated_calls.size(); i++) {
+				if (validated_calls[i].base_type == p_type && validated_calls[i].name == N->get())
+					return i;
+			}
+			GDScriptFunction::ValidatedCall validated;
+			if (!Variant::resolve_call_site(p_type, p_method, validated.cache))
+				return -1;
+			validated.name = get_name_map_pos(p_method);
+			validated.base_type = p_type;
+			validated_calls.push_back(validated);
+			return validated_calls.size() - 1;
+		}
+
+		Vector<int> inline_caches;
+
+		int get_inline_cache_pos(int p_name) {
+			inline_caches.push_back(p_name);
+			return inline_caches.size() - 1;
+		}
+
 		Vector<int> opcodes;
 		void alloc_stack(int p_level) {
 			if (p_level >= stack_max)
@@ -155,6 +231,18 @@ class GDScriptCompiler {
 	String error;
 
 public:
+	enum DebugInfo {
+		DEBUG_INFO_DEFAULT, // Follows the build and whether a debugger is attached.
+		DEBUG_INFO_FULL, // Lines, asserts and stack info, as a debug build running under a debugger.
+		DEBUG_INFO_NONE, // What a release build compiles.
+	};
+
+private:
+	DebugInfo debug_info;
+
+public:
+	void set_debug_info(DebugInfo p_debug_info) { debug_info = p_debug_info; }
+
 	Error compile(const GDScriptParser *p_parser, GDScript *p_script, bool p_keep_state = false);
 
 	String get_error() const;
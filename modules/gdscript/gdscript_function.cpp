@@ -30,9 +30,12 @@
 
 #include "gdscript_function.h"
 
+#include "core/core_string_names.h"
 #include "core/os/os.h"
 #include "gdscript.h"
 #include "gdscript_functions.h"
+#include "gdscript_sampler.h"
+#include "gdscript_vm_stack.h"
 
 Variant *GDScriptFunction::_get_variant(int p_address, GDScriptInstance *p_instance, GDScript *p_script, Variant &self, Variant &static_ref, Variant *p_stack, String &r_error) const {
 	int address = p_address & ADDR_MASK;
@@ -182,16 +185,146 @@ String GDScriptFunction::_get_call_error(const Variant::CallError &p_err, const
 	return err_text;
 }
 
+SafeNumeric<uint32_t> GDScriptFunction::inline_cache_epoch(1);
+
+bool GDScriptFunction::_inline_cache_key(Object *p_object, uintptr_t &r_class_key, GDScriptInstance *&r_instance) {
+	ScriptInstance *si = p_object->get_script_instance();
+	if (si) {
+		// Other languages and placeholders resolve members in ways the caches can't follow.
+		if (si->get_language() != GDScriptLanguage::get_singleton() || si->is_placeholder()) {
+			return false;
+		}
+		r_instance = static_cast<GDScriptInstance *>(si);
+	} else {
+		r_instance = NULL;
+	}
+	r_class_key = (uintptr_t)p_object->get_class_name().data_unique_pointer();
+	return true;
+}
+
+GDScriptFunction::InlineCacheResult GDScriptFunction::_inline_cache_lookup(const InlineCache &p_cache, uintptr_t p_class_key, uintptr_t p_script, InlineCache::Kind &r_kind, uintptr_t &r_target) const {
+	uint32_t version = p_cache.version.get();
+	if (version & 1) {
+		return INLINE_CACHE_SKIP; // Being written.
+	}
+	if (p_cache.epoch.get() != inline_cache_epoch.get()) {
+		return INLINE_CACHE_MISS;
+	}
+
+	uint32_t used = p_cache.used.get();
+	for (uint32_t i = 0; i < used; i++) {
+		const InlineCache::Entry &entry = p_cache.entries[i];
+		if (entry.class_key.get() == p_class_key && entry.script.get() == p_script) {
+			r_kind = (InlineCache::Kind)entry.kind.get();
+			r_target = entry.target.get();
+			if (p_cache.version.get() != version || r_kind == InlineCache::KIND_NONE) {
+				return INLINE_CACHE_SKIP;
+			}
+			return INLINE_CACHE_HIT;
+		}
+	}
+
+	// Once every entry is taken the site is megamorphic and stops resolving.
+	return used < InlineCache::MAX_ENTRIES && p_cache.version.get() == version ? INLINE_CACHE_MISS : INLINE_CACHE_SKIP;
+}
+
+void GDScriptFunction::_inline_cache_store(InlineCache &p_cache, uint32_t p_epoch, uintptr_t p_class_key, uintptr_t p_script, InlineCache::Kind p_kind, uintptr_t p_target) {
+	MutexLock lock(GDScriptLanguage::get_singleton()->lock);
+
+	if (inline_cache_epoch.get() != p_epoch) {
+		return; // A script changed while resolving.
+	}
+
+	p_cache.version.increment();
+
+	if (p_cache.epoch.get() != p_epoch) {
+		p_cache.used.set(0);
+		p_cache.epoch.set(p_epoch);
+	}
+
+	uint32_t used = p_cache.used.get();
+	bool found = false;
+	for (uint32_t i = 0; i < used; i++) {
+		if (p_cache.entries[i].class_key.get() == p_class_key && p_cache.entries[i].script.get() == p_script) {
+			found = true;
+			break;
+		}
+	}
+
+	if (!found && used < InlineCache::MAX_ENTRIES) {
+		InlineCache::Entry &entry = p_cache.entries[used];
+		entry.class_key.set(p_class_key);
+		entry.script.set(p_script);
+		entry.target.set(p_target);
+		entry.kind.set(p_kind);
+		p_cache.used.set(used + 1);
+	}
+
+	p_cache.version.increment();
+}
+
+void GDScriptFunction::_inline_cache_resolve_call(InlineCache &p_cache, Object *p_object, uintptr_t p_class_key, GDScriptInstance *p_instance) {
+	uint32_t epoch = inline_cache_epoch.get();
+	const StringName &method = _global_names_ptr[p_cache.name];
+	GDScript *script = p_instance ? p_instance->script.ptr() : NULL;
+
+	// Object::call() handles free before anything else, and GDScript overrides it for static calls.
+	if (method == CoreStringNames::get_singleton()->_free || Object::cast_to<GDScript>(p_object)) {
+		_inline_cache_store(p_cache, epoch, p_class_key, (uintptr_t)script, InlineCache::KIND_NONE, 0);
+		return;
+	}
+
+	for (GDScript *sptr = script; sptr; sptr = sptr->_base) {
+		Map<StringName, GDScriptFunction *>::Element *E = sptr->member_functions.find(method);
+		if (E) {
+			_inline_cache_store(p_cache, epoch, p_class_key, (uintptr_t)script, InlineCache::KIND_FUNCTION, (uintptr_t)E->get());
+			return;
+		}
+	}
+
+	MethodBind *bind = ClassDB::get_method(p_object->get_class_name(), method);
+	_inline_cache_store(p_cache, epoch, p_class_key, (uintptr_t)script, bind ? InlineCache::KIND_METHOD_BIND : InlineCache::KIND_NONE, (uintptr_t)bind);
+}
+
+void GDScriptFunction::_inline_cache_resolve_get(InlineCache &p_cache, Object *p_object, uintptr_t p_class_key, GDScriptInstance *p_instance) {
+	uint32_t epoch = inline_cache_epoch.get();
+	const StringName &property = _global_names_ptr[p_cache.name];
+	GDScript *script = p_instance ? p_instance->script.ptr() : NULL;
+
+	// Follows GDScriptInstance::get() and then ClassDB::get_property().
+	if (script) {
+		const Map<StringName, GDScript::MemberInfo>::Element *E = script->member_indices.find(property);
+		if (E) {
+			bool plain = !E->get().getter && E->get().index >= 0;
+			_inline_cache_store(p_cache, epoch, p_class_key, (uintptr_t)script, plain ? InlineCache::KIND_MEMBER : InlineCache::KIND_NONE, plain ? E->get().index : 0);
+			return;
+		}
+
+		for (GDScript *sptr = script; sptr; sptr = sptr->_base) {
+			if (sptr->constants.has(property) || sptr->member_functions.has(GDScriptLanguage::get_singleton()->strings._get)) {
+				_inline_cache_store(p_cache, epoch, p_class_key, (uintptr_t)script, InlineCache::KIND_NONE, 0);
+				return;
+			}
+		}
+	}
+
+	MethodBind *getter = ClassDB::get_property_getter_bind(p_object->get_class_name(), property);
+	_inline_cache_store(p_cache, epoch, p_class_key, (uintptr_t)script, getter ? InlineCache::KIND_GETTER : InlineCache::KIND_NONE, (uintptr_t)getter);
+}
+
 #if defined(__GNUC__)
 #define OPCODES_TABLE                         \
 	static const void *switch_table_ops[] = { \
 		&&OPCODE_OPERATOR,                    \
+		&&OPCODE_OPERATOR_VALIDATED,          \
 		&&OPCODE_EXTENDS_TEST,                \
 		&&OPCODE_IS_BUILTIN,                  \
 		&&OPCODE_SET,                         \
 		&&OPCODE_GET,                         \
 		&&OPCODE_SET_NAMED,                   \
+		&&OPCODE_SET_NAMED_VALIDATED,         \
 		&&OPCODE_GET_NAMED,                   \
+		&&OPCODE_GET_NAMED_VALIDATED,         \
 		&&OPCODE_SET_MEMBER,                  \
 		&&OPCODE_GET_MEMBER,                  \
 		&&OPCODE_ASSIGN,                      \
@@ -208,6 +341,8 @@ String GDScriptFunction::_get_call_error(const Variant::CallError &p_err, const
 		&&OPCODE_CONSTRUCT_DICTIONARY,        \
 		&&OPCODE_CALL,                        \
 		&&OPCODE_CALL_RETURN,                 \
+		&&OPCODE_CALL_VALIDATED,              \
+		&&OPCODE_CALL_RETURN_VALIDATED,       \
 		&&OPCODE_CALL_BUILT_IN,               \
 		&&OPCODE_CALL_SELF,                   \
 		&&OPCODE_CALL_SELF_BASE,              \
@@ -234,7 +369,11 @@ String GDScriptFunction::_get_call_error(const Variant::CallError &p_err, const
 	OPSEXIT:
 #define OPCODES_OUT \
 	OPSOUT:
-#define DISPATCH_OPCODE goto *switch_table_ops[_code_ptr[ip]]
+#define DISPATCH_OPCODE                        \
+	do {                                       \
+		SAMPLE_STEP                            \
+		goto *switch_table_ops[_code_ptr[ip]]; \
+	} while (0)
 #define OPCODE_SWITCH(m_test) DISPATCH_OPCODE;
 #define OPCODE_BREAK goto OPSEXIT
 #define OPCODE_OUT goto OPSOUT
@@ -245,7 +384,9 @@ String GDScriptFunction::_get_call_error(const Variant::CallError &p_err, const
 #define OPCODES_END
 #define OPCODES_OUT
 #define DISPATCH_OPCODE continue
-#define OPCODE_SWITCH(m_test) switch (m_test)
+#define OPCODE_SWITCH(m_test) \
+	SAMPLE_STEP               \
+	switch (m_test)
 #define OPCODE_BREAK break
 #define OPCODE_OUT break
 #endif
@@ -272,18 +413,19 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 
 #endif
 
-	uint32_t alloca_size = 0;
+	uint32_t frame_slots = 0;
+	bool frame_suspended = false;
 	GDScript *script;
 	int ip = 0;
 	int line = _initial_line;
 
 	if (p_state) {
 		//use existing (supplied) state (yielded)
-		stack = (Variant *)p_state->stack.ptr();
-		call_args = (Variant **)&p_state->stack.ptr()[sizeof(Variant) * p_state->stack_size]; //ptr() to avoid bounds check
+		stack = p_state->stack;
+		frame_slots = p_state->frame_slots;
+		call_args = _call_size ? (Variant **)&stack[_stack_size] : NULL;
 		line = p_state->line;
 		ip = p_state->ip;
-		alloca_size = p_state->stack.size();
 		script = p_state->script;
 		p_instance = p_state->instance;
 		defarg = p_state->defarg;
@@ -306,50 +448,45 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			}
 		}
 
-		alloca_size = sizeof(Variant *) * _call_size + sizeof(Variant) * _stack_size;
+		// Frame slots are NIL until written, see GDScriptVMStack.
+		frame_slots = GDScriptVMStack::get_frame_slots(_stack_size, _call_size);
 
-		if (alloca_size) {
-			uint8_t *aptr = (uint8_t *)alloca(alloca_size);
+		if (frame_slots) {
+			if (_coroutine) {
+				stack = GDScriptVMStack::alloc_detached(frame_slots);
+			} else {
+				stack = GDScriptVMStack::push(frame_slots);
+			}
 
-			if (_stack_size) {
-				stack = (Variant *)aptr;
-				for (int i = 0; i < p_argcount; i++) {
-					if (!argument_types[i].has_type) {
-						memnew_placement(&stack[i], Variant(*p_args[i]));
-						continue;
-					}
+			for (int i = 0; i < p_argcount; i++) {
+				if (!argument_types[i].has_type) {
+					stack[i] = *p_args[i];
+					continue;
+				}
 
-					if (!argument_types[i].is_type(*p_args[i], true)) {
-						if (argument_types[i].is_type(Variant(), true)) {
-							memnew_placement(&stack[i], Variant);
-							continue;
+				if (!argument_types[i].is_type(*p_args[i], true)) {
+					if (argument_types[i].is_type(Variant(), true)) {
+						continue;
+					} else {
+						r_err.error = Variant::CallError::CALL_ERROR_INVALID_ARGUMENT;
+						r_err.argument = i;
+						r_err.expected = argument_types[i].kind == GDScriptDataType::BUILTIN ? argument_types[i].builtin_type : Variant::OBJECT;
+						if (_coroutine) {
+							GDScriptVMStack::free_detached(stack, _stack_size, frame_slots);
 						} else {
-							r_err.error = Variant::CallError::CALL_ERROR_INVALID_ARGUMENT;
-							r_err.argument = i;
-							r_err.expected = argument_types[i].kind == GDScriptDataType::BUILTIN ? argument_types[i].builtin_type : Variant::OBJECT;
-							return Variant();
+							GDScriptVMStack::pop(stack, _stack_size, frame_slots);
 						}
-					}
-					if (argument_types[i].kind == GDScriptDataType::BUILTIN) {
-						Variant arg = Variant::construct(argument_types[i].builtin_type, &p_args[i], 1, r_err);
-						memnew_placement(&stack[i], Variant(arg));
-					} else {
-						memnew_placement(&stack[i], Variant(*p_args[i]));
+						return Variant();
 					}
 				}
-				for (int i = p_argcount; i < _stack_size; i++) {
-					memnew_placement(&stack[i], Variant);
+				if (argument_types[i].kind == GDScriptDataType::BUILTIN) {
+					stack[i] = Variant::construct(argument_types[i].builtin_type, &p_args[i], 1, r_err);
+				} else {
+					stack[i] = *p_args[i];
 				}
-			} else {
-				stack = NULL;
-			}
-
-			if (_call_size) {
-				call_args = (Variant **)&aptr[sizeof(Variant) * _stack_size];
-			} else {
-				call_args = NULL;
 			}
 
+			call_args = _call_size ? (Variant **)&stack[_stack_size] : NULL;
 		} else {
 			stack = NULL;
 			call_args = NULL;
@@ -413,6 +550,17 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 	bool yielded = false;
 #endif
 
+	GDScriptSampler::Frame sample_frame;
+	GDScriptSampler::ThreadState *sample_state = NULL;
+	if (unlikely(GDScriptSampler::is_running())) {
+		sample_state = GDScriptSampler::enter(sample_frame, this);
+	}
+
+#define SAMPLE_STEP                                             \
+	if (unlikely(sample_state)) {                               \
+		GDScriptSampler::step(*sample_state, sample_frame, ip); \
+	}
+
 #ifdef DEBUG_ENABLED
 	OPCODE_WHILE(ip < _code_size) {
 		int last_opcode = _code_ptr[ip];
@@ -421,17 +569,33 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 #endif
 
 		OPCODE_SWITCH(_code_ptr[ip]) {
+			OPCODE(OPCODE_OPERATOR_VALIDATED)
 			OPCODE(OPCODE_OPERATOR) {
 				CHECK_SPACE(5);
 
-				bool valid;
-				Variant::Operator op = (Variant::Operator)_code_ptr[ip + 1];
-				GD_ERR_BREAK(op >= Variant::OP_MAX);
-
 				GET_VARIANT_PTR(a, 2);
 				GET_VARIANT_PTR(b, 3);
 				GET_VARIANT_PTR(dst, 4);
 
+				Variant::Operator op;
+				if (_code_ptr[ip] == OPCODE_OPERATOR_VALIDATED) {
+					int validated_idx = _code_ptr[ip + 1];
+					GD_ERR_BREAK(validated_idx < 0 || validated_idx >= _validated_operators_count);
+					const ValidatedOperator &validated = _validated_operators_ptr[validated_idx];
+
+					if (likely(a->get_type() == validated.left_type && b->get_type() == validated.right_type)) {
+						validated.evaluator(*a, *b, *dst);
+						ip += 5;
+						DISPATCH_OPCODE;
+					}
+					op = validated.op;
+				} else {
+					op = (Variant::Operator)_code_ptr[ip + 1];
+				}
+
+				bool valid;
+				GD_ERR_BREAK(op >= Variant::OP_MAX);
+
 #ifdef DEBUG_ENABLED
 
 				Variant ret;
@@ -592,6 +756,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			}
 			DISPATCH_OPCODE;
 
+			OPCODE(OPCODE_SET_NAMED_VALIDATED)
 			OPCODE(OPCODE_SET_NAMED) {
 				CHECK_SPACE(3);
 
@@ -600,6 +765,17 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 
 				int indexname = _code_ptr[ip + 2];
 
+				if (_code_ptr[ip] == OPCODE_SET_NAMED_VALIDATED) {
+					GD_ERR_BREAK(indexname < 0 || indexname >= _validated_members_count);
+					const ValidatedMember &validated = _validated_members_ptr[indexname];
+
+					if (likely(dst->get_type() == validated.base_type) && validated.setter(*dst, *value)) {
+						ip += 4;
+						DISPATCH_OPCODE;
+					}
+					indexname = validated.name;
+				}
+
 				GD_ERR_BREAK(indexname < 0 || indexname >= _global_names_count);
 				const StringName *index = &_global_names_ptr[indexname];
 
@@ -617,6 +793,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			}
 			DISPATCH_OPCODE;
 
+			OPCODE(OPCODE_GET_NAMED_VALIDATED)
 			OPCODE(OPCODE_GET_NAMED) {
 				CHECK_SPACE(4);
 
@@ -625,6 +802,47 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 
 				int indexname = _code_ptr[ip + 2];
 
+				if (_code_ptr[ip] == OPCODE_GET_NAMED_VALIDATED) {
+					GD_ERR_BREAK(indexname < 0 || indexname >= _validated_members_count);
+					const ValidatedMember &validated = _validated_members_ptr[indexname];
+
+					if (likely(src->get_type() == validated.base_type)) {
+						validated.getter(*src, *dst);
+						ip += 4;
+						DISPATCH_OPCODE;
+					}
+					indexname = validated.name;
+				} else {
+					GD_ERR_BREAK(indexname < 0 || indexname >= _inline_cache_count);
+					InlineCache &cache = _inline_caches[indexname];
+					indexname = cache.name;
+
+					Object *obj = src->get_type() == Variant::OBJECT ? src->operator Object *() : NULL;
+					uintptr_t class_key;
+					GDScriptInstance *receiver;
+					if (obj && _inline_cache_key(obj, class_key, receiver)) {
+						GDScript *receiver_script = receiver ? receiver->script.ptr() : NULL;
+						InlineCache::Kind kind;
+						uintptr_t target;
+						InlineCacheResult result = _inline_cache_lookup(cache, class_key, (uintptr_t)receiver_script, kind, target);
+						if (result == INLINE_CACHE_HIT && (kind != InlineCache::KIND_MEMBER || target < (uintptr_t)receiver->members.size())) {
+							// Copy first, the receiver may only be referenced by dst.
+							Variant value;
+							if (kind == InlineCache::KIND_MEMBER) {
+								value = receiver->members[target];
+							} else {
+								Variant::CallError ce;
+								value = ((MethodBind *)target)->call(obj, NULL, 0, ce);
+							}
+							*dst = value;
+							ip += 4;
+							DISPATCH_OPCODE;
+						} else if (result == INLINE_CACHE_MISS) {
+							_inline_cache_resolve_get(cache, obj, class_key, receiver);
+						}
+					}
+				}
+
 				GD_ERR_BREAK(indexname < 0 || indexname >= _global_names_count);
 				const StringName *index = &_global_names_ptr[indexname];
 
@@ -994,15 +1212,32 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			}
 			DISPATCH_OPCODE;
 
+			OPCODE(OPCODE_CALL_RETURN_VALIDATED)
+			OPCODE(OPCODE_CALL_VALIDATED)
 			OPCODE(OPCODE_CALL_RETURN)
 			OPCODE(OPCODE_CALL) {
 				CHECK_SPACE(4);
-				bool call_ret = _code_ptr[ip] == OPCODE_CALL_RETURN;
+				bool call_ret = _code_ptr[ip] == OPCODE_CALL_RETURN || _code_ptr[ip] == OPCODE_CALL_RETURN_VALIDATED;
 
 				int argc = _code_ptr[ip + 1];
 				GET_VARIANT_PTR(base, 2);
 				int nameg = _code_ptr[ip + 3];
 
+				ValidatedCall *validated = NULL;
+				InlineCache *cache = NULL;
+				if (_code_ptr[ip] == OPCODE_CALL_VALIDATED || _code_ptr[ip] == OPCODE_CALL_RETURN_VALIDATED) {
+					GD_ERR_BREAK(nameg < 0 || nameg >= _validated_calls_count);
+					ValidatedCall &validated_call = _validated_calls_ptr[nameg];
+					if (likely(base->get_type() == validated_call.base_type)) {
+						validated = &validated_call;
+					}
+					nameg = validated_call.name;
+				} else {
+					GD_ERR_BREAK(nameg < 0 || nameg >= _inline_cache_count);
+					cache = &_inline_caches[nameg];
+					nameg = cache->name;
+				}
+
 				GD_ERR_BREAK(nameg < 0 || nameg >= _global_names_count);
 				const StringName *methodname = &_global_names_ptr[nameg];
 
@@ -1025,11 +1260,46 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 
 #endif
 				Variant::CallError err;
+				Variant *ret = NULL;
 				if (call_ret) {
-					GET_VARIANT_PTR(ret, argc);
+					GET_VARIANT_PTR(v, argc);
+					ret = v;
+				}
+				bool called = false;
+				if (validated) {
+					// The base type matches, so the cache is only read.
+					base->call_cached(*methodname, validated->cache, (const Variant **)argptrs, argc, ret, err);
+					called = true;
+				} else if (cache && base->get_type() == Variant::OBJECT) {
+					Object *obj = base->operator Object *();
+					uintptr_t class_key;
+					GDScriptInstance *receiver;
+					if (obj && _inline_cache_key(obj, class_key, receiver)) {
+						InlineCache::Kind kind;
+						uintptr_t target;
+						InlineCacheResult result = _inline_cache_lookup(*cache, class_key, (uintptr_t)(receiver ? receiver->script.ptr() : NULL), kind, target);
+						if (result == INLINE_CACHE_HIT) {
+#ifdef DEBUG_ENABLED
+							_ObjectDebugLock debug_lock(obj);
+#endif
+							err.error = Variant::CallError::CALL_OK;
+							Variant call_ret;
+							if (kind == InlineCache::KIND_FUNCTION) {
+								call_ret = ((GDScriptFunction *)target)->call(receiver, (const Variant **)argptrs, argc, err);
+							} else {
+								call_ret = ((MethodBind *)target)->call(obj, (const Variant **)argptrs, argc, err);
+							}
+							if (err.error == Variant::CallError::CALL_OK && ret) {
+								*ret = call_ret;
+							}
+							called = true;
+						} else if (result == INLINE_CACHE_MISS) {
+							_inline_cache_resolve_call(*cache, obj, class_key, receiver);
+						}
+					}
+				}
+				if (!called) {
 					base->call_ptr(*methodname, (const Variant **)argptrs, argc, ret, err);
-				} else {
-					base->call_ptr(*methodname, (const Variant **)argptrs, argc, NULL, err);
 				}
 #ifdef DEBUG_ENABLED
 				if (GDScriptLanguage::get_singleton()->profiling) {
@@ -1195,18 +1465,21 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				} else {
 					CHECK_SPACE(2);
 				}
+				GD_ERR_BREAK(!_coroutine);
 
 				Ref<GDScriptFunctionState> gdfs = memnew(GDScriptFunctionState);
 				gdfs->function = this;
 
-				gdfs->state.stack.resize(alloca_size);
-				//copy variant stack
-				for (int i = 0; i < _stack_size; i++) {
-					memnew_placement(&gdfs->state.stack.write[sizeof(Variant) * i], Variant(stack[i]));
-				}
+				// The frame is detached from the VM stack, hand it over as is.
+				gdfs->state.stack = stack;
 				gdfs->state.stack_size = _stack_size;
+				gdfs->state.frame_slots = frame_slots;
+				if (p_state) {
+					p_state->stack = NULL;
+					p_state->stack_size = 0;
+				}
+				frame_suspended = true;
 				gdfs->state.self = self;
-				gdfs->state.alloca_size = alloca_size;
 				gdfs->state.ip = ip + ipofs;
 				gdfs->state.line = line;
 				gdfs->state.script = _script;
@@ -1531,6 +1804,10 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 	}
 
 	OPCODES_OUT
+	if (unlikely(sample_state)) {
+		GDScriptSampler::leave(*sample_state, sample_frame);
+	}
+
 #ifdef DEBUG_ENABLED
 	if (GDScriptLanguage::get_singleton()->profiling) {
 		uint64_t time_taken = OS::get_singleton()->get_ticks_usec() - function_start_time;
@@ -1550,10 +1827,17 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			GDScriptLanguage::get_singleton()->exit_function();
 #endif
 
-		if (_stack_size) {
-			//free stack
-			for (int i = 0; i < _stack_size; i++)
-				stack[i].~Variant();
+		//free stack
+		if (!_coroutine) {
+			if (frame_slots) {
+				GDScriptVMStack::pop(stack, _stack_size, frame_slots);
+			}
+		} else if (!frame_suspended) {
+			GDScriptVMStack::free_detached(stack, _stack_size, frame_slots);
+			if (p_state) {
+				p_state->stack = NULL;
+				p_state->stack_size = 0;
+			}
 		}
 
 #ifdef DEBUG_ENABLED
@@ -1580,6 +1864,26 @@ StringName GDScriptFunction::get_global_name(int p_idx) const {
 	return global_names[p_idx];
 }
 
+Variant::Operator GDScriptFunction::get_validated_operator(int p_idx) const {
+	ERR_FAIL_INDEX_V(p_idx, validated_operators.size(), Variant::OP_MAX);
+	return validated_operators[p_idx].op;
+}
+
+StringName GDScriptFunction::get_validated_member_name(int p_idx) const {
+	ERR_FAIL_INDEX_V(p_idx, validated_members.size(), "<errgname>");
+	return get_global_name(validated_members[p_idx].name);
+}
+
+StringName GDScriptFunction::get_validated_call_name(int p_idx) const {
+	ERR_FAIL_INDEX_V(p_idx, validated_calls.size(), "<errgname>");
+	return get_global_name(validated_calls[p_idx].name);
+}
+
+StringName GDScriptFunction::get_inline_cache_name(int p_idx) const {
+	ERR_FAIL_INDEX_V(p_idx, _inline_cache_count, "<errgname>");
+	return get_global_name(_inline_caches[p_idx].name);
+}
+
 int GDScriptFunction::get_default_argument_count() const {
 	return _default_arg_count;
 }
@@ -1601,6 +1905,22 @@ StringName GDScriptFunction::get_name() const {
 	return name;
 }
 
+int GDScriptFunction::get_line(int p_ip) const {
+	int line = _initial_line;
+	int low = 0;
+	int high = line_table.size() - 1;
+	while (low <= high) {
+		int mid = (low + high) / 2;
+		if (line_table[mid].ip <= p_ip) {
+			line = line_table[mid].line;
+			low = mid + 1;
+		} else {
+			high = mid - 1;
+		}
+	}
+	return line;
+}
+
 int GDScriptFunction::get_max_stack_size() const {
 	return _stack_size;
 }
@@ -1670,6 +1990,15 @@ GDScriptFunction::GDScriptFunction() :
 		function_list(this) {
 	_stack_size = 0;
 	_call_size = 0;
+	_coroutine = false;
+	_validated_operators_ptr = NULL;
+	_validated_operators_count = 0;
+	_validated_members_ptr = NULL;
+	_validated_members_count = 0;
+	_validated_calls_ptr = NULL;
+	_validated_calls_count = 0;
+	_inline_caches = NULL;
+	_inline_cache_count = 0;
 	rpc_mode = MultiplayerAPI::RPC_MODE_DISABLED;
 	name = "<anonymous>";
 #ifdef DEBUG_ENABLED
@@ -1693,6 +2022,9 @@ GDScriptFunction::GDScriptFunction() :
 }
 
 GDScriptFunction::~GDScriptFunction() {
+	if (_inline_caches) {
+		memdelete_arr(_inline_caches);
+	}
 #ifdef DEBUG_ENABLED
 	GDScriptLanguage::get_singleton()->lock.lock();
 	GDScriptLanguage::get_singleton()->function_list.remove(&function_list);
@@ -1816,11 +2148,13 @@ Variant GDScriptFunctionState::resume(const Variant &p_arg) {
 }
 
 void GDScriptFunctionState::_clear_stack() {
-	if (state.stack_size) {
-		Variant *stack = (Variant *)state.stack.ptr();
-		for (int i = 0; i < state.stack_size; i++)
-			stack[i].~Variant();
+	if (state.stack) {
+		// Clearing may release the last reference to this state, so detach the frame first.
+		Variant *stack = state.stack;
+		int stack_size = state.stack_size;
+		state.stack = NULL;
 		state.stack_size = 0;
+		GDScriptVMStack::free_detached(stack, stack_size, state.frame_slots);
 	}
 }
 
@@ -1836,6 +2170,9 @@ GDScriptFunctionState::GDScriptFunctionState() :
 		scripts_list(this),
 		instances_list(this) {
 	function = NULL;
+	state.stack = NULL;
+	state.stack_size = 0;
+	state.frame_slots = 0;
 }
 
 GDScriptFunctionState::~GDScriptFunctionState() {
@@ -34,6 +34,7 @@
 #include "core/os/thread.h"
 #include "core/pair.h"
 #include "core/reference.h"
+#include "core/safe_refcount.h"
 #include "core/script_language.h"
 #include "core/self_list.h"
 #include "core/string_name.h"
@@ -159,12 +160,15 @@ class GDScriptFunction {
 public:
 	enum Opcode {
 		OPCODE_OPERATOR,
+		OPCODE_OPERATOR_VALIDATED,
 		OPCODE_EXTENDS_TEST,
 		OPCODE_IS_BUILTIN,
 		OPCODE_SET,
 		OPCODE_GET,
 		OPCODE_SET_NAMED,
+		OPCODE_SET_NAMED_VALIDATED,
 		OPCODE_GET_NAMED,
+		OPCODE_GET_NAMED_VALIDATED,
 		OPCODE_SET_MEMBER,
 		OPCODE_GET_MEMBER,
 		OPCODE_ASSIGN,
@@ -181,6 +185,8 @@ public:
 		OPCODE_CONSTRUCT_DICTIONARY,
 		OPCODE_CALL,
 		OPCODE_CALL_RETURN,
+		OPCODE_CALL_VALIDATED,
+		OPCODE_CALL_RETURN_VALIDATED,
 		OPCODE_CALL_BUILT_IN,
 		OPCODE_CALL_SELF,
 		OPCODE_CALL_SELF_BASE,
@@ -216,6 +222,67 @@ public:
 		ADDR_TYPE_NIL = 9
 	};
 
+	// Specializations picked by the compiler from static types. The VM checks the
+	// operand types before taking them and falls back to the generic path otherwise.
+	struct ValidatedOperator {
+		Variant::Operator op;
+		Variant::Type left_type;
+		Variant::Type right_type;
+		Variant::ValidatedOperatorEvaluator evaluator;
+	};
+
+	struct ValidatedMember {
+		int name;
+		Variant::Type base_type;
+		Variant::ValidatedGetter getter;
+		Variant::ValidatedSetter setter;
+	};
+
+	struct ValidatedCall {
+		int name;
+		Variant::Type base_type;
+		Variant::CallSiteCache cache;
+	};
+
+	// Receiver types seen by an object call or named get, keyed on the native class
+	// and the GDScript of the receiver. Entries are published under a seqlock and
+	// dropped whenever a script is recompiled or freed.
+	struct InlineCache {
+		enum {
+			MAX_ENTRIES = 4,
+		};
+
+		enum Kind {
+			KIND_NONE, // Resolved, but needs the generic path.
+			KIND_METHOD_BIND,
+			KIND_FUNCTION,
+			KIND_MEMBER,
+			KIND_GETTER,
+		};
+
+		struct Entry {
+			SafeNumeric<uintptr_t> class_key;
+			SafeNumeric<uintptr_t> script;
+			SafeNumeric<uintptr_t> target;
+			SafeNumeric<uint32_t> kind;
+		};
+
+		int name;
+		SafeNumeric<uint32_t> version;
+		SafeNumeric<uint32_t> epoch;
+		SafeNumeric<uint32_t> used;
+		Entry entries[MAX_ENTRIES];
+
+		InlineCache() { name = -1; }
+	};
+
+	// Maps the first ip of each source line, kept in any build so the sampler can
+	// attribute opcodes to lines without OPCODE_LINE.
+	struct LineEntry {
+		int ip;
+		int line;
+	};
+
 	struct StackDebug {
 		int line;
 		int pos;
@@ -225,6 +292,7 @@ public:
 
 private:
 	friend class GDScriptCompiler;
+	friend class GDScriptBytecode;
 
 	StringName source;
 
@@ -237,6 +305,14 @@ private:
 	const StringName *_named_globals_ptr;
 	int _named_globals_count;
 #endif
+	const ValidatedOperator *_validated_operators_ptr;
+	int _validated_operators_count;
+	const ValidatedMember *_validated_members_ptr;
+	int _validated_members_count;
+	ValidatedCall *_validated_calls_ptr;
+	int _validated_calls_count;
+	InlineCache *_inline_caches;
+	int _inline_cache_count;
 	const int *_default_arg_ptr;
 	int _default_arg_count;
 	const int *_code_ptr;
@@ -246,6 +322,7 @@ private:
 	int _call_size;
 	int _initial_line;
 	bool _static;
+	bool _coroutine;
 	MultiplayerAPI::RPCMode rpc_mode;
 
 	GDScript *_script;
@@ -256,6 +333,9 @@ private:
 #ifdef TOOLS_ENABLED
 	Vector<StringName> named_globals;
 #endif
+	Vector<ValidatedOperator> validated_operators;
+	Vector<ValidatedMember> validated_members;
+	Vector<ValidatedCall> validated_calls;
 	Vector<int> default_arguments;
 	Vector<int> code;
 	Vector<GDScriptDataType> argument_types;
@@ -265,9 +345,23 @@ private:
 	Vector<StringName> arg_names;
 #endif
 
+	Vector<LineEntry> line_table;
 	List<StackDebug> stack_debug;
 
 	_FORCE_INLINE_ Variant *_get_variant(int p_address, GDScriptInstance *p_instance, GDScript *p_script, Variant &self, Variant &static_ref, Variant *p_stack, String &r_error) const;
+	enum InlineCacheResult {
+		INLINE_CACHE_HIT,
+		INLINE_CACHE_MISS,
+		INLINE_CACHE_SKIP,
+	};
+
+	static SafeNumeric<uint32_t> inline_cache_epoch;
+
+	_FORCE_INLINE_ static bool _inline_cache_key(Object *p_object, uintptr_t &r_class_key, GDScriptInstance *&r_instance);
+	_FORCE_INLINE_ InlineCacheResult _inline_cache_lookup(const InlineCache &p_cache, uintptr_t p_class_key, uintptr_t p_script, InlineCache::Kind &r_kind, uintptr_t &r_target) const;
+	void _inline_cache_store(InlineCache &p_cache, uint32_t p_epoch, uintptr_t p_class_key, uintptr_t p_script, InlineCache::Kind p_kind, uintptr_t p_target);
+	void _inline_cache_resolve_call(InlineCache &p_cache, Object *p_object, uintptr_t p_class_key, GDScriptInstance *p_instance);
+	void _inline_cache_resolve_get(InlineCache &p_cache, Object *p_object, uintptr_t p_class_key, GDScriptInstance *p_instance);
 	_FORCE_INLINE_ String _get_call_error(const Variant::CallError &p_err, const String &p_where, const Variant **argptrs) const;
 
 	friend class GDScriptLanguage;
@@ -300,10 +394,10 @@ public:
 		StringName function_name;
 		String script_path;
 #endif
-		Vector<uint8_t> stack;
+		Variant *stack; // Detached frame, see GDScriptVMStack.
 		int stack_size;
+		uint32_t frame_slots;
 		Variant self;
-		uint32_t alloca_size;
 		int ip;
 		int line;
 		int defarg;
@@ -316,7 +410,14 @@ public:
 	int get_code_size() const;
 	Variant get_constant(int p_idx) const;
 	StringName get_global_name(int p_idx) const;
+	Variant::Operator get_validated_operator(int p_idx) const;
+	StringName get_validated_member_name(int p_idx) const;
+	StringName get_validated_call_name(int p_idx) const;
+	_FORCE_INLINE_ int get_validated_operator_count() const { return _validated_operators_count; }
+	_FORCE_INLINE_ int get_validated_member_count() const { return _validated_members_count; }
+	StringName get_inline_cache_name(int p_idx) const;
 	StringName get_name() const;
+	int get_line(int p_ip) const;
 	int get_max_stack_size() const;
 	int get_default_argument_count() const;
 	int get_default_argument_addr(int p_idx) const;
@@ -346,6 +447,9 @@ public:
 	Variant call(GDScriptInstance *p_instance, const Variant **p_args, int p_argcount, Variant::CallError &r_err, CallState *p_state = NULL);
 
 	_FORCE_INLINE_ MultiplayerAPI::RPCMode get_rpc_mode() const { return rpc_mode; }
+
+	// Invalidates every inline cache, called when script methods or members go away.
+	static void clear_inline_caches() { inline_cache_epoch.increment(); }
 	GDScriptFunction();
 	~GDScriptFunction();
 };
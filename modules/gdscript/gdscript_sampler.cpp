@@ -0,0 +1,215 @@
+/*************************************************************************/
+/*  gdscript_sampler.cpp                                                 */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-present Godot Engine contributors (cf. AUTHORS.md).*/
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "gdscript_sampler.h"
+
+#include "core/os/file_access.h"
+#include "core/os/os.h"
+#include "gdscript.h"
+
+static const char *opcode_names[] = {
+	"operator",
+	"operator_validated",
+	"extends_test",
+	"is_builtin",
+	"set",
+	"get",
+	"set_named",
+	"set_named_validated",
+	"get_named",
+	"get_named_validated",
+	"set_member",
+	"get_member",
+	"assign",
+	"assign_true",
+	"assign_false",
+	"assign_typed_builtin",
+	"assign_typed_native",
+	"assign_typed_script",
+	"cast_to_builtin",
+	"cast_to_native",
+	"cast_to_script",
+	"construct",
+	"construct_array",
+	"construct_dictionary",
+	"call",
+	"call_return",
+	"call_validated",
+	"call_return_validated",
+	"call_built_in",
+	"call_self",
+	"call_self_base",
+	"yield",
+	"yield_signal",
+	"yield_resume",
+	"jump",
+	"jump_if",
+	"jump_if_not",
+	"jump_to_def_argument",
+	"return",
+	"iterate_begin",
+	"iterate",
+	"assert",
+	"breakpoint",
+	"line",
+	"end",
+};
+
+static_assert(sizeof(opcode_names) / sizeof(opcode_names[0]) == GDScriptFunction::OPCODE_END + 1, "Opcode names are out of sync with GDScriptFunction::Opcode.");
+
+SafeFlag GDScriptSampler::running;
+SafeFlag GDScriptSampler::thread_exit;
+SafeNumeric<uint32_t> GDScriptSampler::tick;
+uint32_t GDScriptSampler::interval_usec = 1000;
+Thread GDScriptSampler::thread;
+Mutex GDScriptSampler::mutex;
+HashMap<String, uint64_t> GDScriptSampler::stacks;
+uint64_t GDScriptSampler::sample_count = 0;
+thread_local GDScriptSampler::ThreadState GDScriptSampler::thread_state = { NULL, 0 };
+
+void GDScriptSampler::_thread_func(void *p_userdata) {
+	while (!thread_exit.is_set()) {
+		OS::get_singleton()->delay_usec(interval_usec);
+		tick.increment();
+	}
+}
+
+static String _frame_label(const GDScriptFunction *p_function, int p_ip) {
+	String source = p_function->get_source();
+	String label = source.empty() ? String("<built-in>") : source;
+	label += ":";
+
+	GDScript *script = p_function->get_script();
+	if (script && script->get_script_class_name() != StringName()) {
+		label += String(script->get_script_class_name()) + ".";
+	}
+	label += String(p_function->get_name());
+
+	return label + ":" + itos(p_function->get_line(p_ip));
+}
+
+void GDScriptSampler::_sample(ThreadState &p_state, const Frame &p_frame) {
+	uint32_t now = tick.get();
+	uint32_t weight = now - p_state.seen_tick;
+	p_state.seen_tick = now;
+
+	// Ticks before the first dispatch were spent calling into this function.
+	const Frame *leaf = p_frame.ip < 0 ? p_frame.parent : &p_frame;
+	if (!leaf) {
+		return;
+	}
+
+	String key = opcode_names[CLAMP(leaf->function->get_code()[leaf->ip], 0, (int)GDScriptFunction::OPCODE_END)];
+	for (const Frame *f = leaf; f; f = f->parent) {
+		key = _frame_label(f->function, MAX(f->ip, 0)) + ";" + key;
+	}
+
+	MutexLock lock(mutex);
+	uint64_t *count = stacks.getptr(key);
+	if (count) {
+		*count += weight;
+	} else {
+		stacks.set(key, weight);
+	}
+	sample_count += weight;
+}
+
+GDScriptSampler::ThreadState *GDScriptSampler::enter(Frame &r_frame, const GDScriptFunction *p_function) {
+	ThreadState *state = &thread_state;
+	if (!state->top) {
+		// Don't charge the time spent outside the VM to the first opcode.
+		state->seen_tick = tick.get();
+	}
+
+	r_frame.function = p_function;
+	r_frame.ip = -1;
+	r_frame.parent = state->top;
+	state->top = &r_frame;
+	return state;
+}
+
+const char *GDScriptSampler::get_opcode_name(int p_opcode) {
+	ERR_FAIL_INDEX_V(p_opcode, GDScriptFunction::OPCODE_END + 1, "");
+	return opcode_names[p_opcode];
+}
+
+void GDScriptSampler::start(int p_frequency) {
+	ERR_FAIL_COND(running.is_set());
+	ERR_FAIL_COND(p_frequency <= 0);
+
+	interval_usec = MAX(1000000 / p_frequency, 1);
+	thread_exit.clear();
+	thread.start(_thread_func, NULL);
+	running.set();
+}
+
+void GDScriptSampler::stop() {
+	if (!running.is_set()) {
+		return;
+	}
+
+	running.clear();
+	thread_exit.set();
+	thread.wait_to_finish();
+}
+
+void GDScriptSampler::clear() {
+	MutexLock lock(mutex);
+	stacks.clear();
+	sample_count = 0;
+}
+
+uint64_t GDScriptSampler::get_sample_count() {
+	MutexLock lock(mutex);
+	return sample_count;
+}
+
+Error GDScriptSampler::save(const String &p_path) {
+	Error err;
+	FileAccess *f = FileAccess::open(p_path, FileAccess::WRITE, &err);
+	ERR_FAIL_COND_V_MSG(!f, err, "Can't open GDScript sample profile for writing: " + p_path + ".");
+
+	MutexLock lock(mutex);
+
+	Vector<String> keys;
+	const String *k = NULL;
+	while ((k = stacks.next(k))) {
+		keys.push_back(*k);
+	}
+	keys.sort();
+
+	for (int i = 0; i < keys.size(); i++) {
+		f->store_string(keys[i] + " " + uitos(stacks[keys[i]]) + "\n");
+	}
+
+	f->close();
+	memdelete(f);
+	return OK;
+}
@@ -0,0 +1,100 @@
+/*************************************************************************/
+/*  gdscript_sampler.h                                                   */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-present Godot Engine contributors (cf. AUTHORS.md).*/
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef GDSCRIPT_SAMPLER_H
+#define GDSCRIPT_SAMPLER_H
+
+#include "core/hash_map.h"
+#include "core/os/mutex.h"
+#include "core/os/thread.h"
+#include "core/safe_refcount.h"
+#include "core/ustring.h"
+
+class GDScriptFunction;
+
+// Statistical profiler for the GDScript VM. A timer thread advances a tick counter,
+// and the interpreter charges each elapsed tick to the opcode it is about to dispatch,
+// so the only cost per opcode while running is comparing two counters.
+// Stacks are written in the folded "frame;frame;... count" format used by flame graph tools.
+class GDScriptSampler {
+public:
+	struct Frame {
+		const GDScriptFunction *function;
+		int ip; // -1 until the first opcode is dispatched.
+		Frame *parent;
+	};
+
+	struct ThreadState {
+		Frame *top;
+		uint32_t seen_tick;
+	};
+
+private:
+	static SafeFlag running;
+	static SafeFlag thread_exit;
+	static SafeNumeric<uint32_t> tick;
+	static uint32_t interval_usec;
+	static Thread thread;
+
+	static Mutex mutex;
+	static HashMap<String, uint64_t> stacks;
+	static uint64_t sample_count;
+
+	static thread_local ThreadState thread_state;
+
+	static void _thread_func(void *p_userdata);
+	static void _sample(ThreadState &p_state, const Frame &p_frame);
+
+public:
+	_FORCE_INLINE_ static bool is_running() { return running.is_set(); }
+
+	static ThreadState *enter(Frame &r_frame, const GDScriptFunction *p_function);
+
+	_FORCE_INLINE_ static void step(ThreadState &p_state, Frame &p_frame, int p_ip) {
+		if (unlikely(tick.get() != p_state.seen_tick)) {
+			_sample(p_state, p_frame);
+		}
+		p_frame.ip = p_ip;
+	}
+
+	_FORCE_INLINE_ static void leave(ThreadState &p_state, Frame &p_frame) {
+		p_state.top = p_frame.parent;
+	}
+
+	static const char *get_opcode_name(int p_opcode);
+
+	static void start(int p_frequency);
+	static void stop();
+	static void clear();
+	static uint64_t get_sample_count();
+	static Error save(const String &p_path);
+};
+
+#endif // GDSCRIPT_SAMPLER_H
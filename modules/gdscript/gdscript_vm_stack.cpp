@@ -0,0 +1,169 @@
+/*************************************************************************/
+/*  gdscript_vm_stack.cpp                                                */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-present Godot Engine contributors (cf. AUTHORS.md).*/
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "gdscript_vm_stack.h"
+
+#include "core/os/memory.h"
+
+thread_local GDScriptVMStack GDScriptVMStack::thread_stack;
+
+GDScriptVMStack::Block *GDScriptVMStack::_alloc_block(uint32_t p_capacity) {
+	static_assert(sizeof(Block) % alignof(Variant) == 0, "Slots must be aligned after the block header.");
+
+	Block *b = (Block *)memalloc(sizeof(Block) + sizeof(Variant) * p_capacity);
+	CRASH_COND_MSG(!b, "Out of memory for the GDScript VM stack.");
+	b->prev = NULL;
+	b->next = NULL;
+	b->capacity = p_capacity;
+	b->used = 0;
+
+	Variant *slots = _get_slots(b);
+	for (uint32_t i = 0; i < p_capacity; i++) {
+		memnew_placement(&slots[i], Variant);
+	}
+	return b;
+}
+
+void GDScriptVMStack::_free_block(Block *p_block) {
+	Variant *slots = _get_slots(p_block);
+	for (uint32_t i = 0; i < p_block->capacity; i++) {
+		slots[i].~Variant();
+	}
+	memfree(p_block);
+}
+
+void GDScriptVMStack::_clear_slots(Variant *p_frame, uint32_t p_variants, uint32_t p_slots) {
+	for (uint32_t i = 0; i < p_variants; i++) {
+		if (p_frame[i].get_type() != Variant::NIL) {
+			p_frame[i].~Variant();
+			memnew_placement(&p_frame[i], Variant);
+		}
+	}
+	for (uint32_t i = p_variants; i < p_slots; i++) {
+		memnew_placement(&p_frame[i], Variant);
+	}
+}
+
+Variant *GDScriptVMStack::_push_segment(uint32_t p_slots) {
+	GDScriptVMStack &s = thread_stack;
+
+	// Segments after the top one are empty, keep the next one if the frame fits.
+	Block *next = s.top ? s.top->next : NULL;
+	if (next && next->capacity < p_slots) {
+		s.top->next = NULL;
+		while (next) {
+			Block *after = next->next;
+			_free_block(next);
+			next = after;
+		}
+	}
+
+	if (!next) {
+		next = _alloc_block(MAX((uint32_t)SEGMENT_SLOTS, p_slots));
+		next->prev = s.top;
+		if (s.top) {
+			s.top->next = next;
+		}
+	}
+
+	s.top = next;
+	next->used = p_slots;
+	return _get_slots(next);
+}
+
+void GDScriptVMStack::pop(Variant *p_frame, uint32_t p_variants, uint32_t p_slots) {
+	// Clearing can run destructors that call into scripts, so keep the frame
+	// reserved until it is done.
+	_clear_slots(p_frame, p_variants, p_slots);
+
+	Block *b = thread_stack.top;
+	CRASH_COND(!b || _get_slots(b) + b->used - p_slots != p_frame);
+	b->used -= p_slots;
+	if (b->used == 0 && b->prev) {
+		thread_stack.top = b->prev;
+	}
+}
+
+Variant *GDScriptVMStack::alloc_detached(uint32_t p_slots) {
+	if (!p_slots) {
+		return NULL;
+	}
+
+	GDScriptVMStack &s = thread_stack;
+	for (int i = 0; i < s.detached_cached; i++) {
+		Block *b = s.detached_cache[i];
+		if (b->capacity >= p_slots) {
+			s.detached_cache[i] = s.detached_cache[--s.detached_cached];
+			return _get_slots(b);
+		}
+	}
+
+	uint32_t capacity = (p_slots + DETACHED_GRANULARITY - 1) & ~uint32_t(DETACHED_GRANULARITY - 1);
+	return _get_slots(_alloc_block(capacity));
+}
+
+void GDScriptVMStack::free_detached(Variant *p_frame, uint32_t p_variants, uint32_t p_slots) {
+	if (!p_frame) {
+		return;
+	}
+
+	_clear_slots(p_frame, p_variants, p_slots);
+
+	// Frames may be resumed and freed on a different thread than the one that
+	// allocated them, they simply move to this thread's cache.
+	GDScriptVMStack &s = thread_stack;
+	Block *b = _get_block(p_frame);
+	if (s.detached_cached < DETACHED_CACHE_SIZE) {
+		s.detached_cache[s.detached_cached++] = b;
+	} else {
+		_free_block(b);
+	}
+}
+
+void GDScriptVMStack::release_thread() {
+	GDScriptVMStack &s = thread_stack;
+	ERR_FAIL_COND_MSG(s.top && s.top->used, "Releasing the GDScript VM stack while a function is running.");
+
+	Block *b = s.top;
+	while (b && b->prev) {
+		b = b->prev;
+	}
+	while (b) {
+		Block *next = b->next;
+		_free_block(b);
+		b = next;
+	}
+	s.top = NULL;
+
+	for (int i = 0; i < s.detached_cached; i++) {
+		_free_block(s.detached_cache[i]);
+	}
+	s.detached_cached = 0;
+}
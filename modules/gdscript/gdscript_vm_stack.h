@@ -0,0 +1,96 @@
+/*************************************************************************/
+/*  gdscript_vm_stack.h                                                  */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-present Godot Engine contributors (cf. AUTHORS.md).*/
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef GDSCRIPT_VM_STACK_H
+#define GDSCRIPT_VM_STACK_H
+
+#include "core/variant.h"
+
+// Per-thread stack that GDScript function frames are pushed onto. Free slots are
+// always NIL Variants, so pushing a frame constructs nothing, and popping it only
+// clears the slots that were written. Frames of functions that yield are allocated
+// apart, so a yield hands the frame over to its GDScriptFunctionState as is.
+class GDScriptVMStack {
+	struct Block {
+		Block *prev;
+		Block *next;
+		uint32_t capacity;
+		uint32_t used;
+	};
+
+	enum {
+		SEGMENT_SLOTS = 2048,
+		DETACHED_GRANULARITY = 8,
+		DETACHED_CACHE_SIZE = 16,
+	};
+
+	// Zero initialized per thread, freed by release_thread().
+	Block *top;
+	Block *detached_cache[DETACHED_CACHE_SIZE];
+	int detached_cached;
+
+	static thread_local GDScriptVMStack thread_stack;
+
+	_FORCE_INLINE_ static Variant *_get_slots(Block *p_block) { return reinterpret_cast<Variant *>(p_block + 1); }
+	_FORCE_INLINE_ static Block *_get_block(Variant *p_slots) { return reinterpret_cast<Block *>(p_slots) - 1; }
+
+	static Block *_alloc_block(uint32_t p_capacity);
+	static void _free_block(Block *p_block);
+	static void _clear_slots(Variant *p_frame, uint32_t p_variants, uint32_t p_slots);
+	static Variant *_push_segment(uint32_t p_slots);
+
+public:
+	// Slots for the Variant stack plus the call argument pointers that follow it.
+	_FORCE_INLINE_ static uint32_t get_frame_slots(int p_stack_size, int p_call_size) {
+		return p_stack_size + (p_call_size * sizeof(Variant *) + sizeof(Variant) - 1) / sizeof(Variant);
+	}
+
+	_FORCE_INLINE_ static Variant *push(uint32_t p_slots) {
+		Block *b = thread_stack.top;
+		if (likely(b && b->used + p_slots <= b->capacity)) {
+			Variant *frame = _get_slots(b) + b->used;
+			b->used += p_slots;
+			return frame;
+		}
+		return _push_segment(p_slots);
+	}
+
+	// Frames must be popped in reverse order of pushing. The first p_variants slots
+	// are cleared, the rest held call arguments and are reset to NIL.
+	static void pop(Variant *p_frame, uint32_t p_variants, uint32_t p_slots);
+
+	static Variant *alloc_detached(uint32_t p_slots);
+	static void free_detached(Variant *p_frame, uint32_t p_variants, uint32_t p_slots);
+
+	// Frees the memory cached by the calling thread. No frame may be active on it.
+	static void release_thread();
+};
+
+#endif // GDSCRIPT_VM_STACK_H
@@ -47,6 +47,8 @@ Ref<ResourceFormatSaverGDScript> resource_saver_gd;
 #include "editor/editor_node.h"
 #include "editor/editor_settings.h"
 #include "editor/gdscript_highlighter.h"
+#include "gdscript_bytecode.h"
+#include "gdscript_compiler.h"
 
 #ifndef GDSCRIPT_NO_LSP
 #include "core/engine.h"
@@ -56,7 +58,39 @@ Ref<ResourceFormatSaverGDScript> resource_saver_gd;
 class EditorExportGDScript : public EditorExportPlugin {
 	GDCLASS(EditorExportGDScript, EditorExportPlugin);
 
+	bool debug;
+
+	// Compiles the script ahead of time, keeping only the tokens if it can't be stored as an image.
+	Vector<uint8_t> _compile(const String &p_path, const String &p_code, const Vector<uint8_t> &p_tokens) {
+		Ref<GDScript> script;
+		script.instance();
+
+		GDScriptParser parser;
+		if (parser.parse(p_code, p_path.get_base_dir(), false, p_path) != OK) {
+			return p_tokens;
+		}
+
+		GDScriptCompiler compiler;
+		compiler.set_debug_info(debug ? GDScriptCompiler::DEBUG_INFO_FULL : GDScriptCompiler::DEBUG_INFO_NONE);
+		if (compiler.compile(&parser, script.ptr()) != OK) {
+			return p_tokens;
+		}
+
+		// Set after compiling so the throwaway subclasses don't take the names of the edited ones.
+		script->set_script_path(p_path);
+
+		Vector<uint8_t> image;
+		if (GDScriptBytecode::save(script.ptr(), p_tokens, image) != OK) {
+			return p_tokens;
+		}
+		return image;
+	}
+
 public:
+	virtual void _export_begin(const Set<String> &p_features, bool p_debug, const String &p_path, int p_flags) {
+		debug = p_debug;
+	}
+
 	virtual void _export_file(const String &p_path, const String &p_type, const Set<String> &p_features) {
 		int script_mode = EditorExportPreset::MODE_SCRIPT_COMPILED;
 		String script_key;
@@ -80,6 +114,8 @@ public:
 		file = GDScriptTokenizerBuffer::parse_code_string(txt);
 
 		if (!file.empty()) {
+			file = _compile(p_path, txt, file);
+
 			if (script_mode == EditorExportPreset::MODE_SCRIPT_ENCRYPTED) {
 				String tmp_path = EditorSettings::get_singleton()->get_cache_dir().plus_file("script.gde");
 				FileAccess *fa = FileAccess::open(tmp_path, FileAccess::WRITE);
@@ -127,6 +163,10 @@ public:
 			}
 		}
 	}
+
+	EditorExportGDScript() {
+		debug = false;
+	}
 };
 
 static void _editor_init() {
@@ -30,7 +30,10 @@
 
 #include "text_shaper_raqm.h"
 
+#include "core/local_vector.h"
 #include "core/os/memory.h"
+#include "core/os/os.h"
+#include "core/os/threaded_array_processor.h"
 #include "servers/font_server.h"
 
 #include "configs/modules_enabled.gen.h"
@@ -49,6 +52,10 @@ static _FORCE_INLINE_ bool _have_glyph(char32_t p_char_code) {
 	return (p_char_code != 0x200Cu && p_char_code != 0x200Du);
 }
 
+static _FORCE_INLINE_ bool _is_invisible_glyph(const raqm_glyph_t &p_glyph) {
+	return (p_glyph.x_offset == 0 && p_glyph.y_offset == 0 && p_glyph.x_advance == 0 && p_glyph.y_advance == 0);
+}
+
 static _FORCE_INLINE_ bool _font_covers_all(const FontID &p_font, const char32_t *p_text, int p_len) {
 	FontDriver *driver = FontDriverManager::get_driver_for_font(p_font);
 	if (!driver) {
@@ -78,45 +85,43 @@ static _FORCE_INLINE_ FontID _select_font_for_text(const FontID &p_primary, cons
 	return p_primary;
 }
 
-static _FORCE_INLINE_ void _shape_run(FontDriverFreeType *p_driver, const char32_t *p_text_ptr, int p_start, int p_end, const FontID &p_run_font, int p_font_size, int p_font_oversampling, CharInfo *r_char_infos) {
-	const int run_len = p_end - p_start;
-	if (run_len <= 0) {
-		return;
-	}
-
-	FT_Face face = p_driver->get_ft_face(p_run_font);
-	ERR_FAIL_COND(!face);
+static _FORCE_INLINE_ int _face_for_text(const FT_Face *p_faces, int p_face_count, const char32_t *p_text, int p_len) {
+	for (int i = 0; i < p_face_count; i++) {
+		if (!p_faces[i]) {
+			continue;
+		}
 
-	FT_Size size = p_driver->get_ft_size(p_run_font, p_font_size, p_font_oversampling);
-	ERR_FAIL_COND(!size);
+		bool covers = true;
+		for (int j = 0; j < p_len && covers; j++) {
+			covers = FT_Get_Char_Index(p_faces[i], p_text[j]) != 0;
+		}
+		if (covers) {
+			return i;
+		}
+	}
 
-	raqm_t *rq = raqm_create();
-	ERR_FAIL_COND(!rq);
+	return 0;
+}
 
-	if (!raqm_set_text(rq, (const uint32_t *)(p_text_ptr + p_start), (size_t)run_len)) {
-		raqm_destroy(rq);
-		ERR_FAIL();
+// Shapes with a face whose size is already active. The raqm state is owned by the caller.
+static _FORCE_INLINE_ void _shape_run(raqm_t *p_rq, FT_Face p_face, const char32_t *p_text_ptr, int p_start, int p_end, const FontID &p_run_font, int p_font_oversampling, CharInfo *r_char_infos, ShapedGlyphBuffer &r_glyphs) {
+	const int run_len = p_end - p_start;
+	if (run_len <= 0) {
+		return;
 	}
 
-	if (!raqm_set_freetype_face(rq, face)) {
-		raqm_destroy(rq);
-		ERR_FAIL();
-	}
+	ERR_FAIL_COND(!p_face);
 
-	if (!raqm_set_par_direction(rq, RAQM_DIRECTION_DEFAULT)) {
-		raqm_destroy(rq);
-		ERR_FAIL();
-	}
+	raqm_t *rq = p_rq;
 
-	if (!raqm_layout(rq)) {
-		raqm_destroy(rq);
-		ERR_FAIL();
-	}
+	ERR_FAIL_COND(!raqm_set_text(rq, (const uint32_t *)(p_text_ptr + p_start), (size_t)run_len));
+	ERR_FAIL_COND(!raqm_set_freetype_face(rq, p_face));
+	ERR_FAIL_COND(!raqm_set_par_direction(rq, RAQM_DIRECTION_DEFAULT));
+	ERR_FAIL_COND(!raqm_layout(rq));
 
 	size_t glyph_count = 0;
 	raqm_glyph_t *glyphs = raqm_get_glyphs(rq, &glyph_count);
 	if (!glyphs || glyph_count == 0) {
-		raqm_destroy(rq);
 		return;
 	}
 
@@ -138,34 +143,22 @@ static _FORCE_INLINE_ void _shape_run(FontDriverFreeType *p_driver, const char32
 
 		const int cluster_glyph_count = (j - i);
 
-		Vector<uint8_t> invisible_mask;
-		invisible_mask.resize(cluster_glyph_count);
-
-		for (int g = 0; g < cluster_glyph_count; g++) {
-			const raqm_glyph_t &glyph = glyphs[i + g];
-			if (glyph.x_offset == 0 && glyph.y_offset == 0 && glyph.x_advance == 0 && glyph.y_advance == 0) {
-				invisible_mask.write[g] = 1;
-			} else {
-				invisible_mask.write[g] = 0;
-			}
-		}
-
 		int cluster_glyph_index = 0;
 		for (int c = (int)cluster; c < (int)next_cluster; c++) {
 			const int out_idx = c - p_start;
 			if (cluster_glyph_index < cluster_glyph_count &&
-					(_have_glyph(p_text_ptr[p_start + c]) || (invisible_mask[cluster_glyph_index] != 0))) {
+					(_have_glyph(p_text_ptr[p_start + c]) || _is_invisible_glyph(glyphs[i + cluster_glyph_index]))) {
 				const raqm_glyph_t &glyph = glyphs[i + cluster_glyph_index];
 
-				ShapedData *sd = memnew(ShapedData);
-				sd->glyph_font_id = p_run_font;
-				sd->glyph_index = glyph.index;
-				sd->glyph_offset = Vector2((float)glyph.x_offset / 64.0, -(float)glyph.y_offset / 64.0) / p_font_oversampling;
-				sd->glyph_advance = Vector2((float)glyph.x_advance / 64.0, (float)glyph.y_advance / 64.0) / p_font_oversampling;
-				sd->cluster_glyph_count = cluster_glyph_count;
-				sd->cluster_glyph_index = cluster_glyph_index;
+				int glyph_idx = r_glyphs.push_back(
+						p_run_font,
+						glyph.index,
+						Vector2((float)glyph.x_offset / 64.0, -(float)glyph.y_offset / 64.0) / p_font_oversampling,
+						Vector2((float)glyph.x_advance / 64.0, (float)glyph.y_advance / 64.0) / p_font_oversampling,
+						cluster_glyph_count,
+						cluster_glyph_index);
 
-				r_char_infos[out_idx].set_shaped_data(sd);
+				r_char_infos[out_idx].set_glyph(glyph_idx);
 				r_char_infos[out_idx].set_char_code(p_text_ptr[p_start + c]);
 				cluster_glyph_index++;
 			} else {
@@ -176,11 +169,9 @@ static _FORCE_INLINE_ void _shape_run(FontDriverFreeType *p_driver, const char32
 
 		i = j;
 	}
-
-	raqm_destroy(rq);
 }
 
-bool TextShaperRaqm::shape_text(CharInfo *r_char_infos, const FontID &p_font_id, const Vector<FontID> &p_fallback_font_ids, const char32_t *p_text, int p_char_count, int p_font_size, int p_font_oversampling) {
+bool TextShaperRaqm::shape_text(CharInfo *r_char_infos, ShapedGlyphBuffer &r_glyphs, const FontID &p_font_id, const Vector<FontID> &p_fallback_font_ids, const char32_t *p_text, int p_char_count, int p_font_size, int p_font_oversampling) {
 	if (p_char_count <= 0) {
 		return false;
 	}
@@ -199,11 +190,124 @@ bool TextShaperRaqm::shape_text(CharInfo *r_char_infos, const FontID &p_font_id,
 
 	FontDriverFreeType *driver_ft = static_cast<FontDriverFreeType *>(driver);
 #endif
-	if (driver_ft && driver_ft->owns_font(run_font)) {
-		_shape_run(driver_ft, p_text, 0, p_char_count, run_font, p_font_size, p_font_oversampling, r_char_infos);
-	} else {
+	if (!driver_ft || !driver_ft->owns_font(run_font)) {
 		return false;
 	}
 
+	// HarfBuzz reads the face through FreeType, the driver stays locked until shaping is done.
+	FontDriverFreeType::ScopedFace face(driver_ft, run_font, p_font_size, p_font_oversampling);
+	ERR_FAIL_COND_V(!face.get(), false);
+
+	raqm_t *rq = raqm_create();
+	ERR_FAIL_COND_V(!rq, false);
+
+	_shape_run(rq, face.get(), p_text, 0, p_char_count, run_font, p_font_oversampling, r_char_infos, r_glyphs);
+
+	raqm_destroy(rq);
+
 	return true;
 }
+
+void TextShaperRaqm::_shape_chunk(uint32_t p_chunk, ShapeJob *p_job) {
+	// Every worker shapes with its own library, faces and raqm state, no shared FreeType or HarfBuzz state is touched.
+	FT_Library library = NULL;
+	if (FT_Init_FreeType(&library)) {
+		return;
+	}
+
+	int face_count = p_job->font_ids.size();
+	LocalVector<FT_Face> faces;
+	faces.resize(face_count);
+
+	LocalVector<PoolVector<uint8_t>::Read> reads;
+	reads.resize(face_count);
+
+	for (int i = 0; i < face_count; i++) {
+		faces[i] = NULL;
+		reads[i] = p_job->font_data[i].read();
+
+		FT_Face face = NULL;
+		if (FT_New_Memory_Face(library, reads[i].ptr(), p_job->font_data[i].size(), p_job->font_ids[i].font_index, &face)) {
+			continue;
+		}
+
+		FT_F26Dot6 char_size = p_job->font_size * 64 * p_job->font_oversampling;
+		if (FT_Set_Char_Size(face, char_size, char_size, 0, 0)) {
+			FT_Done_Face(face);
+			continue;
+		}
+
+		faces[i] = face;
+	}
+
+	raqm_t *rq = faces[0] ? raqm_create() : NULL;
+
+	if (rq) {
+		for (int i = p_chunk; i < p_job->request_count; i += p_job->chunk_count) {
+			ShapeRequest &request = p_job->requests[i];
+			if (request.char_count <= 0) {
+				continue;
+			}
+
+			int face_idx = _face_for_text(faces.ptr(), face_count, request.text, request.char_count);
+
+			request.glyphs.reserve(request.char_count);
+			_shape_run(rq, faces[face_idx], request.text, 0, request.char_count, p_job->font_ids[face_idx], p_job->font_oversampling, request.char_infos, request.glyphs);
+			request.shaped = true;
+
+			raqm_clear_contents(rq);
+		}
+
+		raqm_destroy(rq);
+	}
+
+	for (int i = 0; i < face_count; i++) {
+		if (faces[i]) {
+			FT_Done_Face(faces[i]);
+		}
+	}
+	FT_Done_FreeType(library);
+}
+
+void TextShaperRaqm::shape_texts(ShapeRequest *r_requests, int p_request_count, const FontID &p_font_id, const Vector<FontID> &p_fallback_font_ids, int p_font_size, int p_font_oversampling) {
+	int chunk_count = CLAMP(OS::get_singleton()->get_processor_count(), 1, p_request_count);
+	if (p_request_count < MIN_PARALLEL_REQUESTS || chunk_count < 2) {
+		TextShaper::shape_texts(r_requests, p_request_count, p_font_id, p_fallback_font_ids, p_font_size, p_font_oversampling);
+		return;
+	}
+
+	ShapeJob job;
+	job.font_ids.push_back(p_font_id);
+	job.font_ids.append_array(p_fallback_font_ids);
+
+	for (int i = 0; i < job.font_ids.size(); i++) {
+		FontDriver *driver = FontDriverManager::get_driver_for_font(job.font_ids[i]);
+		FontDriverFreeType *driver_ft = NULL;
+#ifndef NO_SAFE_CAST
+		driver_ft = dynamic_cast<FontDriverFreeType *>(driver);
+#else
+		if (driver && String(driver->get_name()) == "FreeType") {
+			driver_ft = static_cast<FontDriverFreeType *>(driver);
+		}
+#endif
+		PoolVector<uint8_t> data;
+		if (driver_ft && driver_ft->owns_font(job.font_ids[i])) {
+			data = driver_ft->get_font_data(job.font_ids[i]);
+		}
+
+		if (data.empty()) {
+			// Workers can only open FreeType faces, shape anything else on this thread.
+			TextShaper::shape_texts(r_requests, p_request_count, p_font_id, p_fallback_font_ids, p_font_size, p_font_oversampling);
+			return;
+		}
+		job.font_data.push_back(data);
+	}
+
+	job.font_size = p_font_size;
+	job.font_oversampling = p_font_oversampling;
+	job.requests = r_requests;
+	job.request_count = p_request_count;
+	job.chunk_count = chunk_count;
+
+	thread_process_array(job.chunk_count, this, &TextShaperRaqm::_shape_chunk, &job);
+}
@@ -34,11 +34,29 @@
 #include "servers/text/text_shaper.h"
 
 class TextShaperRaqm : public TextShaper {
+	enum {
+		// Below this many requests, spinning up workers costs more than it saves.
+		MIN_PARALLEL_REQUESTS = 64,
+	};
+
+	struct ShapeJob {
+		Vector<FontID> font_ids;
+		Vector<PoolVector<uint8_t>> font_data;
+		int font_size = 0;
+		int font_oversampling = 1;
+		ShapeRequest *requests = NULL;
+		int request_count = 0;
+		int chunk_count = 1;
+	};
+
+	void _shape_chunk(uint32_t p_chunk, ShapeJob *p_job);
+
 public:
 	virtual Error init() { return OK; }
 	virtual const char *get_name() const { return "Raqm"; }
 
-	virtual bool shape_text(CharInfo *r_char_infos, const FontID &p_font_id, const Vector<FontID> &p_fallback_font_ids, const char32_t *p_text, int p_char_count, int p_font_size, int p_font_oversampling);
+	virtual bool shape_text(CharInfo *r_char_infos, ShapedGlyphBuffer &r_glyphs, const FontID &p_font_id, const Vector<FontID> &p_fallback_font_ids, const char32_t *p_text, int p_char_count, int p_font_size, int p_font_oversampling);
+	virtual void shape_texts(ShapeRequest *r_requests, int p_request_count, const FontID &p_font_id, const Vector<FontID> &p_fallback_font_ids, int p_font_size, int p_font_oversampling);
 };
 
 #endif
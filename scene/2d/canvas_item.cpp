@@ -544,7 +544,7 @@ void CanvasItem::_notification(int p_what) {
 			}
 			_enter_canvas();
 			if (!block_transform_notify && !xform_change.in_list()) {
-				get_tree()->xform_change_list.add(&xform_change);
+				get_tree()->_xform_change_add(&xform_change);
 			}
 		} break;
 		case NOTIFICATION_MOVED_IN_PARENT: {
@@ -562,7 +562,7 @@ void CanvasItem::_notification(int p_what) {
 		} break;
 		case NOTIFICATION_EXIT_TREE: {
 			if (xform_change.in_list())
-				get_tree()->xform_change_list.remove(&xform_change);
+				get_tree()->_xform_change_remove(&xform_change);
 			_exit_canvas();
 			if (C) {
 				Object::cast_to<CanvasItem>(get_parent())->children_items.erase(C);
@@ -898,7 +898,7 @@ void CanvasItem::_notify_transform(CanvasItem *p_node) {
 	if (p_node->notify_transform && !p_node->xform_change.in_list()) {
 		if (!p_node->block_transform_notify) {
 			if (p_node->is_inside_tree())
-				get_tree()->xform_change_list.add(&p_node->xform_change);
+				get_tree()->_xform_change_add(&p_node->xform_change);
 		}
 	}
 
@@ -1031,7 +1031,7 @@ void CanvasItem::force_update_transform() {
 		return;
 	}
 
-	get_tree()->xform_change_list.remove(&xform_change);
+	get_tree()->_xform_change_remove(&xform_change);
 
 	notification(NOTIFICATION_TRANSFORM_CHANGED);
 }
@@ -80,7 +80,7 @@ void Spatial::_notify_dirty() {
 	if (data.notify_transform && !data.ignore_notification && !xform_change.in_list()) {
 
 #endif
-		get_tree()->xform_change_list.add(&xform_change);
+		get_tree()->_xform_change_add(&xform_change);
 	}
 }
 
@@ -111,7 +111,7 @@ void Spatial::_propagate_transform_changed(Spatial *p_origin) {
 #else
 	if (data.notify_transform && !data.ignore_notification && !xform_change.in_list()) {
 #endif
-		get_tree()->xform_change_list.add(&xform_change);
+		get_tree()->_xform_change_add(&xform_change);
 	}
 	data.dirty |= DIRTY_GLOBAL;
 
@@ -149,7 +149,7 @@ void Spatial::_notification(int p_what) {
 		case NOTIFICATION_EXIT_TREE: {
 			notification(NOTIFICATION_EXIT_WORLD, true);
 			if (xform_change.in_list())
-				get_tree()->xform_change_list.remove(&xform_change);
+				get_tree()->_xform_change_remove(&xform_change);
 			if (data.C)
 				data.parent->data.children.erase(data.C);
 			data.parent = NULL;
@@ -666,7 +666,7 @@ void Spatial::force_update_transform() {
 	if (!xform_change.in_list()) {
 		return; //nothing to update
 	}
-	get_tree()->xform_change_list.remove(&xform_change);
+	get_tree()->_xform_change_remove(&xform_change);
 
 	notification(NOTIFICATION_TRANSFORM_CHANGED);
 }
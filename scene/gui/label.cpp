@@ -97,8 +97,6 @@ void Label::_notification(int p_what) {
 
 		style->draw(ci, Rect2(Point2(0, 0), get_size()));
 
-		VisualServer::get_singleton()->canvas_item_set_distance_field_mode(get_canvas_item(), font.is_valid() && font->is_distance_field_hint());
-
 		int font_h = font->get_height() + line_spacing;
 
 		int lines_visible = (size.y + line_spacing) / font_h;
@@ -44,20 +44,21 @@
 #endif
 
 VARIANT_ENUM_CAST(Node::PauseMode);
+VARIANT_ENUM_CAST(Node::ProcessThreadGroup);
 
 int Node::orphan_node_count = 0;
 
 void Node::_notification(int p_notification) {
 	switch (p_notification) {
 		case NOTIFICATION_PROCESS: {
-			if (get_script_instance()) {
+			if (get_script_instance() && _has_script_callback(SCRIPT_CALLBACK_PROCESS)) {
 				Variant time = get_process_delta_time();
 				const Variant *ptr[1] = { &time };
 				get_script_instance()->call_multilevel(SceneStringNames::get_singleton()->_process, ptr, 1);
 			}
 		} break;
 		case NOTIFICATION_PHYSICS_PROCESS: {
-			if (get_script_instance()) {
+			if (get_script_instance() && _has_script_callback(SCRIPT_CALLBACK_PHYSICS_PROCESS)) {
 				Variant time = get_physics_process_delta_time();
 				const Variant *ptr[1] = { &time };
 				get_script_instance()->call_multilevel(SceneStringNames::get_singleton()->_physics_process, ptr, 1);
@@ -77,6 +78,15 @@ void Node::_notification(int p_notification) {
 				data.pause_owner = this;
 			}
 
+			if (data.process_thread_group == PROCESS_THREAD_GROUP_INHERIT) {
+				if (data.parent)
+					data.process_thread_group_owner = data.parent->data.process_thread_group_owner;
+				else
+					data.process_thread_group_owner = NULL;
+			} else {
+				data.process_thread_group_owner = this;
+			}
+
 			if (data.input)
 				add_to_group("_vp_input" + itos(get_viewport()->get_instance_id()));
 			if (data.unhandled_input)
@@ -103,6 +113,7 @@ void Node::_notification(int p_notification) {
 				remove_from_group("_vp_unhandled_key_input" + itos(get_viewport()->get_instance_id()));
 
 			data.pause_owner = NULL;
+			data.process_thread_group_owner = NULL;
 			if (data.path_cache) {
 				memdelete(data.path_cache);
 				data.path_cache = NULL;
@@ -202,6 +213,11 @@ void Node::_propagate_enter_tree() {
 		E->get().group = data.tree->add_to_group(E->key(), this);
 	}
 
+	_set_process_listed(SceneTree::PROCESS_LIST_IDLE, data.idle_process);
+	_set_process_listed(SceneTree::PROCESS_LIST_IDLE_INTERNAL, data.idle_process_internal);
+	_set_process_listed(SceneTree::PROCESS_LIST_PHYSICS, data.physics_process);
+	_set_process_listed(SceneTree::PROCESS_LIST_PHYSICS_INTERNAL, data.physics_process_internal);
+
 	notification(NOTIFICATION_ENTER_TREE);
 
 	if (get_script_instance()) {
@@ -289,6 +305,10 @@ void Node::_propagate_exit_tree() {
 		E->get().group = NULL;
 	}
 
+	for (int i = 0; i < SceneTree::PROCESS_LIST_MAX; i++) {
+		_set_process_listed(SceneTree::ProcessListType(i), false);
+	}
+
 	data.viewport = NULL;
 
 	if (data.tree)
@@ -338,6 +358,10 @@ void Node::move_child(Node *p_child, int p_pos) {
 		if (E->get().group)
 			E->get().group->changed = true;
 	}
+	for (int i = 0; i < SceneTree::PROCESS_LIST_MAX; i++) {
+		if (p_child->data.process_slots[i] != -1)
+			data.tree->process_list_changed(SceneTree::ProcessListType(i));
+	}
 
 	data.blocked--;
 }
@@ -365,12 +389,11 @@ void Node::set_physics_process(bool p_process) {
 	if (data.physics_process == p_process)
 		return;
 
+	ERR_FAIL_COND_MSG(data.tree && SceneTree::is_process_group_thread(), "Can't change processing from a process group thread. Consider using call_deferred(\"set_physics_process\", enable) instead.");
+
 	data.physics_process = p_process;
 
-	if (data.physics_process)
-		add_to_group("physics_process", false);
-	else
-		remove_from_group("physics_process");
+	_set_process_listed(SceneTree::PROCESS_LIST_PHYSICS, data.physics_process);
 
 	_change_notify("physics_process");
 }
@@ -383,12 +406,11 @@ void Node::set_physics_process_internal(bool p_process_internal) {
 	if (data.physics_process_internal == p_process_internal)
 		return;
 
+	ERR_FAIL_COND_MSG(data.tree && SceneTree::is_process_group_thread(), "Can't change processing from a process group thread. Consider using call_deferred(\"set_physics_process_internal\", enable) instead.");
+
 	data.physics_process_internal = p_process_internal;
 
-	if (data.physics_process_internal)
-		add_to_group("physics_process_internal", false);
-	else
-		remove_from_group("physics_process_internal");
+	_set_process_listed(SceneTree::PROCESS_LIST_PHYSICS_INTERNAL, data.physics_process_internal);
 
 	_change_notify("physics_process_internal");
 }
@@ -424,6 +446,37 @@ Node::PauseMode Node::get_pause_mode() const {
 	return data.pause_mode;
 }
 
+void Node::set_process_thread_group(ProcessThreadGroup p_group) {
+	ERR_FAIL_COND_MSG(data.tree && SceneTree::is_process_group_thread(), "Can't change the process thread group from a process group thread. Consider using call_deferred(\"set_process_thread_group\", group) instead.");
+
+	if (data.process_thread_group == p_group)
+		return;
+
+	data.process_thread_group = p_group;
+	if (!is_inside_tree())
+		return;
+
+	Node *owner = this;
+	if (data.process_thread_group == PROCESS_THREAD_GROUP_INHERIT) {
+		owner = data.parent ? data.parent->data.process_thread_group_owner : NULL;
+	}
+
+	_propagate_process_thread_group_owner(owner);
+}
+
+Node::ProcessThreadGroup Node::get_process_thread_group() const {
+	return data.process_thread_group;
+}
+
+void Node::_propagate_process_thread_group_owner(Node *p_owner) {
+	if (this != p_owner && data.process_thread_group != PROCESS_THREAD_GROUP_INHERIT)
+		return;
+	data.process_thread_group_owner = p_owner;
+	for (int i = 0; i < data.children.size(); i++) {
+		data.children[i]->_propagate_process_thread_group_owner(p_owner);
+	}
+}
+
 void Node::_propagate_pause_owner(Node *p_owner) {
 	if (this != p_owner && data.pause_mode != PAUSE_MODE_INHERIT)
 		return;
@@ -737,12 +790,11 @@ void Node::set_process(bool p_idle_process) {
 	if (data.idle_process == p_idle_process)
 		return;
 
+	ERR_FAIL_COND_MSG(data.tree && SceneTree::is_process_group_thread(), "Can't change processing from a process group thread. Consider using call_deferred(\"set_process\", enable) instead.");
+
 	data.idle_process = p_idle_process;
 
-	if (data.idle_process)
-		add_to_group("idle_process", false);
-	else
-		remove_from_group("idle_process");
+	_set_process_listed(SceneTree::PROCESS_LIST_IDLE, data.idle_process);
 
 	_change_notify("idle_process");
 }
@@ -755,12 +807,11 @@ void Node::set_process_internal(bool p_idle_process_internal) {
 	if (data.idle_process_internal == p_idle_process_internal)
 		return;
 
+	ERR_FAIL_COND_MSG(data.tree && SceneTree::is_process_group_thread(), "Can't change processing from a process group thread. Consider using call_deferred(\"set_process_internal\", enable) instead.");
+
 	data.idle_process_internal = p_idle_process_internal;
 
-	if (data.idle_process_internal)
-		add_to_group("idle_process_internal", false);
-	else
-		remove_from_group("idle_process_internal");
+	_set_process_listed(SceneTree::PROCESS_LIST_IDLE_INTERNAL, data.idle_process_internal);
 
 	_change_notify("idle_process_internal");
 }
@@ -777,21 +828,42 @@ void Node::set_process_priority(int p_priority) {
 		return;
 	}
 
-	if (is_processing()) {
-		data.tree->make_group_changed("idle_process");
+	for (int i = 0; i < SceneTree::PROCESS_LIST_MAX; i++) {
+		if (data.process_slots[i] != -1) {
+			data.tree->process_list_changed(SceneTree::ProcessListType(i));
+		}
 	}
+}
 
-	if (is_processing_internal()) {
-		data.tree->make_group_changed("idle_process_internal");
-	}
+void Node::_set_process_listed(SceneTree::ProcessListType p_type, bool p_listed) {
+	if (!data.tree || (data.process_slots[p_type] != -1) == p_listed)
+		return;
 
-	if (is_physics_processing()) {
-		data.tree->make_group_changed("physics_process");
-	}
+	if (p_listed)
+		data.tree->process_list_add(p_type, this);
+	else
+		data.tree->process_list_remove(p_type, this);
+}
 
-	if (is_physics_processing_internal()) {
-		data.tree->make_group_changed("physics_process_internal");
-	}
+bool Node::_has_script_callback(uint8_t p_callback) {
+#ifdef DEBUG_ENABLED
+	// Scripts can be reloaded in place while debugging, let the instance resolve the call.
+	return true;
+#else
+	if (!(data.script_callbacks & SCRIPT_CALLBACKS_CACHED)) {
+		ScriptInstance *si = get_script_instance();
+		data.script_callbacks = SCRIPT_CALLBACKS_CACHED;
+		if (si && si->has_method(SceneStringNames::get_singleton()->_process))
+			data.script_callbacks |= SCRIPT_CALLBACK_PROCESS;
+		if (si && si->has_method(SceneStringNames::get_singleton()->_physics_process))
+			data.script_callbacks |= SCRIPT_CALLBACK_PHYSICS_PROCESS;
+	}
+	return data.script_callbacks & p_callback;
+#endif
+}
+
+void Node::_script_instance_changed() {
+	data.script_callbacks = 0;
 }
 
 int Node::get_process_priority() const {
@@ -1079,6 +1151,7 @@ void Node::add_child(Node *p_child, bool p_legible_unique_name) {
 	ERR_FAIL_COND_MSG(p_child == this, "Can't add child '" + p_child->get_name() + "' to itself."); // adding to itself!
 	ERR_FAIL_COND_MSG(p_child->data.parent, "Can't add child '" + p_child->get_name() + "' to '" + get_name() + "', already has a parent '" + p_child->data.parent->get_name() + "'."); //Fail if node has a parent
 	ERR_FAIL_COND_MSG(data.blocked > 0, "Parent node is busy setting up children, add_node() failed. Consider using call_deferred(\"add_child\", child) instead.");
+	ERR_FAIL_COND_MSG(data.tree && SceneTree::is_process_group_thread(), "Can't add children to the tree from a process group thread. Consider using call_deferred(\"add_child\", child) instead.");
 
 	/* Validate name */
 	_validate_child_name(p_child, p_legible_unique_name);
@@ -1127,6 +1200,7 @@ void Node::_propagate_validate_owner() {
 void Node::remove_child(Node *p_child) {
 	ERR_FAIL_NULL(p_child);
 	ERR_FAIL_COND_MSG(data.blocked > 0, "Parent node is busy setting up children, remove_node() failed. Consider using call_deferred(\"remove_child\", child) instead.");
+	ERR_FAIL_COND_MSG(data.tree && SceneTree::is_process_group_thread(), "Can't remove children from the tree from a process group thread. Consider using call_deferred(\"remove_child\", child) instead.");
 
 	int child_count = data.children.size();
 	Node **children = data.children.ptrw();
@@ -2618,6 +2692,8 @@ void Node::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("is_processing_unhandled_key_input"), &Node::is_processing_unhandled_key_input);
 	ClassDB::bind_method(D_METHOD("set_pause_mode", "mode"), &Node::set_pause_mode);
 	ClassDB::bind_method(D_METHOD("get_pause_mode"), &Node::get_pause_mode);
+	ClassDB::bind_method(D_METHOD("set_process_thread_group", "group"), &Node::set_process_thread_group);
+	ClassDB::bind_method(D_METHOD("get_process_thread_group"), &Node::get_process_thread_group);
 	ClassDB::bind_method(D_METHOD("can_process"), &Node::can_process);
 	ClassDB::bind_method(D_METHOD("print_stray_nodes"), &Node::_print_stray_nodes);
 	ClassDB::bind_method(D_METHOD("get_position_in_parent"), &Node::get_position_in_parent);
@@ -2726,6 +2802,10 @@ void Node::_bind_methods() {
 	BIND_ENUM_CONSTANT(PAUSE_MODE_STOP);
 	BIND_ENUM_CONSTANT(PAUSE_MODE_PROCESS);
 
+	BIND_ENUM_CONSTANT(PROCESS_THREAD_GROUP_INHERIT);
+	BIND_ENUM_CONSTANT(PROCESS_THREAD_GROUP_MAIN_THREAD);
+	BIND_ENUM_CONSTANT(PROCESS_THREAD_GROUP_SUB_THREAD);
+
 	BIND_ENUM_CONSTANT(DUPLICATE_SIGNALS);
 	BIND_ENUM_CONSTANT(DUPLICATE_GROUPS);
 	BIND_ENUM_CONSTANT(DUPLICATE_SCRIPTS);
@@ -2738,6 +2818,7 @@ void Node::_bind_methods() {
 	ADD_SIGNAL(MethodInfo("tree_exited"));
 
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "pause_mode", PROPERTY_HINT_ENUM, "Inherit,Stop,Process"), "set_pause_mode", "get_pause_mode");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "process_thread_group", PROPERTY_HINT_ENUM, "Inherit,Main Thread,Sub Thread"), "set_process_thread_group", "get_process_thread_group");
 
 #ifdef ENABLE_DEPRECATED
 	//no longer exists, but remains for compatibility (keep previous scenes folded
@@ -2787,6 +2868,10 @@ Node::Node() {
 	data.process_priority = 0;
 	data.physics_process_internal = false;
 	data.idle_process_internal = false;
+	for (int i = 0; i < SceneTree::PROCESS_LIST_MAX; i++) {
+		data.process_slots[i] = -1;
+	}
+	data.script_callbacks = 0;
 	data.inside_tree = false;
 	data.ready_notified = false;
 
@@ -2797,6 +2882,10 @@ Node::Node() {
 	data.unhandled_key_input = false;
 	data.pause_mode = PAUSE_MODE_INHERIT;
 	data.pause_owner = NULL;
+	data.process_thread_group = PROCESS_THREAD_GROUP_INHERIT;
+	data.process_thread_group_owner = NULL;
+	data.process_group_pass = 0;
+	data.process_group_task = 0;
 	data.network_master = 1; //server by default
 	data.path_cache = NULL;
 	data.parent_owned = false;
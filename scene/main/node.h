@@ -53,6 +53,13 @@ public:
 		PAUSE_MODE_PROCESS
 	};
 
+	enum ProcessThreadGroup {
+
+		PROCESS_THREAD_GROUP_INHERIT,
+		PROCESS_THREAD_GROUP_MAIN_THREAD,
+		PROCESS_THREAD_GROUP_SUB_THREAD
+	};
+
 	enum DuplicateFlags {
 
 		DUPLICATE_SIGNALS = 1,
@@ -110,6 +117,11 @@ private:
 		PauseMode pause_mode;
 		Node *pause_owner;
 
+		ProcessThreadGroup process_thread_group;
+		Node *process_thread_group_owner;
+		uint64_t process_group_pass; // used by the tree while batching the group, see SceneTree::_dispatch_process_groups()
+		uint32_t process_group_task;
+
 		int network_master;
 		Map<StringName, MultiplayerAPI::RPCMode> rpc_methods;
 		Map<StringName, MultiplayerAPI::RPCMode> rpc_properties;
@@ -123,6 +135,9 @@ private:
 		bool physics_process_internal;
 		bool idle_process_internal;
 
+		int process_slots[SceneTree::PROCESS_LIST_MAX]; // position in the tree's process lists, -1 when not listed
+		uint8_t script_callbacks;
+
 		bool input;
 		bool unhandled_input;
 		bool unhandled_key_input;
@@ -165,6 +180,7 @@ private:
 	void _propagate_validate_owner();
 	void _print_stray_nodes();
 	void _propagate_pause_owner(Node *p_owner);
+	void _propagate_process_thread_group_owner(Node *p_owner);
 	Array _get_node_and_resource(const NodePath &p_path);
 
 	void _duplicate_signals(const Node *p_original, Node *p_copy) const;
@@ -183,11 +199,21 @@ private:
 
 	void _set_tree(SceneTree *p_tree);
 
+	enum {
+		SCRIPT_CALLBACK_PROCESS = 1,
+		SCRIPT_CALLBACK_PHYSICS_PROCESS = 2,
+		SCRIPT_CALLBACKS_CACHED = 128
+	};
+
+	bool _has_script_callback(uint8_t p_callback);
+	void _set_process_listed(SceneTree::ProcessListType p_type, bool p_listed);
+
 protected:
 	void _block() { data.blocked++; }
 	void _unblock() { data.blocked--; }
 
 	void _notification(int p_notification);
+	virtual void _script_instance_changed();
 
 	virtual void add_child_notify(Node *p_child);
 	virtual void remove_child_notify(Node *p_child);
@@ -374,6 +400,8 @@ public:
 
 	void set_pause_mode(PauseMode p_mode);
 	PauseMode get_pause_mode() const;
+	void set_process_thread_group(ProcessThreadGroup p_group);
+	ProcessThreadGroup get_process_thread_group() const;
 	bool can_process() const;
 	bool can_process_notification(int p_what) const;
 
@@ -40,6 +40,7 @@
 #include "core/project_settings.h"
 #include "main/input_default.h"
 #include "node.h"
+#include "scene/2d/canvas_item.h"
 #include "scene/debugger/script_debugger_remote.h"
 #include "scene/resources/material.h"
 #include "scene/resources/mesh.h"
@@ -143,6 +144,208 @@ void SceneTree::make_group_changed(const StringName &p_group) {
 		E->get().changed = true;
 }
 
+thread_local bool SceneTree::process_group_thread = false;
+
+void SceneTree::process_list_add(ProcessListType p_type, Node *p_node) {
+	ERR_FAIL_COND_MSG(process_group_thread, "Can't change processing from a process group thread. Consider using call_deferred() instead.");
+
+	ProcessList &list = process_lists[p_type];
+	p_node->data.process_slots[p_type] = -2 - int(list.added.size());
+	list.added.push_back(p_node);
+}
+
+void SceneTree::process_list_remove(ProcessListType p_type, Node *p_node) {
+	ERR_FAIL_COND_MSG(process_group_thread, "Can't change processing from a process group thread. Consider using call_deferred() instead.");
+
+	ProcessList &list = process_lists[p_type];
+	int slot = p_node->data.process_slots[p_type];
+	p_node->data.process_slots[p_type] = -1;
+
+	if (slot >= 0) {
+		list.nodes[slot] = NULL;
+		list.holes++;
+	} else {
+		uint32_t idx = -2 - slot;
+		uint32_t last_idx = list.added.size() - 1;
+		if (idx != last_idx) {
+			Node *last = list.added[last_idx];
+			list.added[idx] = last;
+			last->data.process_slots[p_type] = slot;
+		}
+		list.added.resize(last_idx);
+	}
+}
+
+void SceneTree::process_list_changed(ProcessListType p_type) {
+	process_lists[p_type].resort = true;
+}
+
+void SceneTree::_update_process_list(ProcessList &p_list, ProcessListType p_type) {
+	if (!p_list.holes && p_list.added.empty() && !p_list.resort)
+		return;
+
+	if (p_list.holes) {
+		uint32_t to = 0;
+		for (uint32_t i = 0; i < p_list.nodes.size(); i++) {
+			if (p_list.nodes[i]) {
+				p_list.nodes[to++] = p_list.nodes[i];
+			}
+		}
+		p_list.nodes.resize(to);
+		p_list.holes = 0;
+	}
+
+	if (!p_list.added.empty()) {
+		uint32_t old_count = p_list.nodes.size();
+		uint32_t added_count = p_list.added.size();
+		p_list.nodes.resize(old_count + added_count);
+
+		if (p_list.resort) {
+			memcpy(&p_list.nodes[old_count], &p_list.added[0], added_count * sizeof(Node *));
+		} else {
+			// Only the new nodes need sorting, then merge them in from the back.
+			p_list.added.sort_custom<Node::ComparatorWithPriority>();
+			Node::ComparatorWithPriority compare;
+			int64_t i = int64_t(old_count) - 1;
+			int64_t j = int64_t(added_count) - 1;
+			for (int64_t w = int64_t(old_count + added_count) - 1; j >= 0; w--) {
+				if (i >= 0 && compare(p_list.added[j], p_list.nodes[i])) {
+					p_list.nodes[w] = p_list.nodes[i--];
+				} else {
+					p_list.nodes[w] = p_list.added[j--];
+				}
+			}
+		}
+		p_list.added.clear();
+	}
+
+	if (p_list.resort) {
+		p_list.nodes.sort_custom<Node::ComparatorWithPriority>();
+		p_list.resort = false;
+	}
+
+	for (uint32_t i = 0; i < p_list.nodes.size(); i++) {
+		p_list.nodes[i]->data.process_slots[p_type] = i;
+	}
+}
+
+void SceneTree::_notify_process_list(ProcessListType p_type, int p_notification) {
+	ProcessList &list = process_lists[p_type];
+	ERR_FAIL_COND(list.dispatching);
+
+	_update_process_list(list, p_type);
+	if (list.nodes.empty())
+		return;
+
+	// Nodes added meanwhile are staged until the next frame and removed ones leave a NULL,
+	// so the array can be walked in place.
+	list.dispatching = true;
+	uint32_t node_count = list.nodes.size();
+	bool allow_groups = p_type == PROCESS_LIST_IDLE || p_type == PROCESS_LIST_PHYSICS;
+
+	for (uint32_t i = 0; i < node_count;) {
+		Node *n = list.nodes[i];
+		if (!n) {
+			i++;
+			continue;
+		}
+
+		Node *group = n->data.process_thread_group_owner;
+		if (allow_groups && group && group->data.process_thread_group == Node::PROCESS_THREAD_GROUP_SUB_THREAD) {
+			i = _dispatch_process_groups(list, i, p_notification);
+			continue;
+		}
+
+		if (n->can_process())
+			n->notification(p_notification);
+		i++;
+	}
+
+	list.dispatching = false;
+}
+
+uint32_t SceneTree::_dispatch_process_groups(ProcessList &p_list, uint32_t p_from, int p_notification) {
+	// Take the run of consecutive group nodes, a main thread node in between acts as a barrier
+	// so priorities keep ordering work across groups.
+	process_group_pass++;
+	uint32_t task_count = 0;
+	uint32_t to = p_from;
+
+	for (; to < p_list.nodes.size(); to++) {
+		Node *n = p_list.nodes[to];
+		if (!n)
+			continue;
+
+		Node *group = n->data.process_thread_group_owner;
+		if (!group || group->data.process_thread_group != Node::PROCESS_THREAD_GROUP_SUB_THREAD)
+			break;
+
+		if (group->data.process_group_pass != process_group_pass) {
+			group->data.process_group_pass = process_group_pass;
+			group->data.process_group_task = task_count;
+			if (task_count == process_group_tasks.size()) {
+				process_group_tasks.resize(task_count + 1);
+				process_group_tasks[task_count].deferred = memnew(MessageQueue(4096));
+			}
+			process_group_tasks[task_count].nodes.clear();
+			task_count++;
+		}
+
+		if (n->can_process())
+			process_group_tasks[group->data.process_group_task].nodes.push_back(n);
+	}
+
+	if (!process_group_pool.is_initialized())
+		process_group_pool.init();
+
+	process_group_pool.do_work(task_count, this, &SceneTree::_process_group_task, p_notification);
+
+	// Tasks were numbered in list order, so the merged deferred calls don't depend on scheduling.
+	for (uint32_t i = 0; i < task_count; i++) {
+		process_group_tasks[i].deferred->transfer_to(MessageQueue::get_singleton());
+	}
+
+	return to;
+}
+
+void SceneTree::_process_group_task(uint32_t p_index, int p_notification) {
+	ProcessGroupTask &task = process_group_tasks[p_index];
+
+	process_group_thread = true;
+	MessageQueue::set_thread_capture(task.deferred);
+
+	for (uint32_t i = 0; i < task.nodes.size(); i++) {
+		task.nodes[i]->notification(p_notification);
+	}
+
+	MessageQueue::set_thread_capture(NULL);
+	process_group_thread = false;
+}
+
+void SceneTree::_xform_change_add(SelfList<Node> *p_elem) {
+	if (process_group_thread) {
+		MutexLock lock(xform_change_mutex);
+		if (!p_elem->in_list())
+			xform_change_list.add(p_elem);
+		return;
+	}
+
+	if (!p_elem->in_list())
+		xform_change_list.add(p_elem);
+}
+
+void SceneTree::_xform_change_remove(SelfList<Node> *p_elem) {
+	if (process_group_thread) {
+		MutexLock lock(xform_change_mutex);
+		if (p_elem->in_list())
+			xform_change_list.remove(p_elem);
+		return;
+	}
+
+	if (p_elem->in_list())
+		xform_change_list.remove(p_elem);
+}
+
 void SceneTree::flush_transform_notifications() {
 	SelfList<Node> *n = xform_change_list.first();
 	while (n) {
@@ -172,7 +375,7 @@ void SceneTree::_flush_ugc() {
 	ugc_locked = false;
 }
 
-void SceneTree::_update_group_order(Group &g, bool p_use_priority) {
+void SceneTree::_update_group_order(Group &g) {
 	if (!g.changed)
 		return;
 	if (g.nodes.empty())
@@ -181,13 +384,8 @@ void SceneTree::_update_group_order(Group &g, bool p_use_priority) {
 	Node **nodes = g.nodes.ptrw();
 	int node_count = g.nodes.size();
 
-	if (p_use_priority) {
-		SortArray<Node *, Node::ComparatorWithPriority> node_sort;
-		node_sort.sort(nodes, node_count);
-	} else {
-		SortArray<Node *, Node::Comparator> node_sort;
-		node_sort.sort(nodes, node_count);
-	}
+	SortArray<Node *, Node::Comparator> node_sort;
+	node_sort.sort(nodes, node_count);
 	g.changed = false;
 }
 
@@ -449,11 +647,11 @@ bool SceneTree::iteration(float p_time) {
 
 	emit_signal("physics_frame");
 
-	_notify_group_pause("physics_process_internal", Node::NOTIFICATION_INTERNAL_PHYSICS_PROCESS);
+	_notify_process_list(PROCESS_LIST_PHYSICS_INTERNAL, Node::NOTIFICATION_INTERNAL_PHYSICS_PROCESS);
 	if (GLOBAL_GET("physics/common/enable_pause_aware_picking")) {
 		call_group_flags(GROUP_CALL_REALTIME, "_viewports", "_process_picking", true);
 	}
-	_notify_group_pause("physics_process", Node::NOTIFICATION_PHYSICS_PROCESS);
+	_notify_process_list(PROCESS_LIST_PHYSICS, Node::NOTIFICATION_PHYSICS_PROCESS);
 	_flush_ugc();
 	MessageQueue::get_singleton()->flush(); //small little hack
 	flush_transform_notifications();
@@ -472,6 +670,17 @@ void SceneTree::_update_font_oversampling(float p_ratio) {
 	}
 }
 
+void SceneTree::_redraw_canvas_items(Node *p_node) {
+	CanvasItem *ci = Object::cast_to<CanvasItem>(p_node);
+	if (ci) {
+		ci->update();
+	}
+
+	for (int i = 0; i < p_node->get_child_count(); i++) {
+		_redraw_canvas_items(p_node->get_child(i));
+	}
+}
+
 bool SceneTree::idle(float p_time) {
 	//print_line("ram: "+itos(OS::get_singleton()->get_static_memory_usage())+" sram: "+itos(OS::get_singleton()->get_dynamic_memory_usage()));
 	//print_line("node count: "+itos(get_node_count()));
@@ -493,8 +702,8 @@ bool SceneTree::idle(float p_time) {
 
 	flush_transform_notifications();
 
-	_notify_group_pause("idle_process_internal", Node::NOTIFICATION_INTERNAL_PROCESS);
-	_notify_group_pause("idle_process", Node::NOTIFICATION_PROCESS);
+	_notify_process_list(PROCESS_LIST_IDLE_INTERNAL, Node::NOTIFICATION_INTERNAL_PROCESS);
+	_notify_process_list(PROCESS_LIST_IDLE, Node::NOTIFICATION_PROCESS);
 
 	Size2 win_size = Size2(OS::get_singleton()->get_window_size().width, OS::get_singleton()->get_window_size().height);
 	bool custom_title_bar_visible = OS::get_singleton()->is_custom_title_bar_visible();
@@ -508,6 +717,14 @@ bool SceneTree::idle(float p_time) {
 
 	_flush_ugc();
 	MessageQueue::get_singleton()->flush(); //small little hack
+
+	// Glyphs not drawn this frame were evicted or moved, retained text still points at their old UVs.
+	uint64_t atlas_generation = FontServer::get_singleton()->get_glyph_atlas_generation();
+	if (atlas_generation != glyph_atlas_generation) {
+		glyph_atlas_generation = atlas_generation;
+		_redraw_canvas_items(root);
+	}
+
 	flush_transform_notifications(); //transforms after world update, to avoid unnecessary enter/exit notifications
 	call_group_flags(GROUP_CALL_REALTIME, "_viewports", "update_worlds");
 
@@ -938,44 +1155,6 @@ void SceneTree::_call_input_pause(const StringName &p_group, const StringName &p
 		call_skip.clear();
 }
 
-void SceneTree::_notify_group_pause(const StringName &p_group, int p_notification) {
-	Map<StringName, Group>::Element *E = group_map.find(p_group);
-	if (!E)
-		return;
-	Group &g = E->get();
-	if (g.nodes.empty())
-		return;
-
-	_update_group_order(g, p_notification == Node::NOTIFICATION_PROCESS || p_notification == Node::NOTIFICATION_INTERNAL_PROCESS || p_notification == Node::NOTIFICATION_PHYSICS_PROCESS || p_notification == Node::NOTIFICATION_INTERNAL_PHYSICS_PROCESS);
-
-	//copy, so copy on write happens in case something is removed from process while being called
-	//performance is not lost because only if something is added/removed the vector is copied.
-	Vector<Node *> nodes_copy = g.nodes;
-
-	int node_count = nodes_copy.size();
-	Node **nodes = nodes_copy.ptrw();
-
-	call_lock++;
-
-	for (int i = 0; i < node_count; i++) {
-		Node *n = nodes[i];
-		if (call_lock && call_skip.has(n))
-			continue;
-
-		if (!n->can_process())
-			continue;
-		if (!n->can_process_notification(p_notification))
-			continue;
-
-		n->notification(p_notification);
-		//ERR_FAIL_COND(node_count != g.nodes.size());
-	}
-
-	call_lock--;
-	if (call_lock == 0)
-		call_skip.clear();
-}
-
 /*
 void SceneMainLoop::_update_listener_2d() {
 
@@ -1969,6 +2148,7 @@ SceneTree::SceneTree() {
 	quit_on_go_back = true;
 	initialized = false;
 	use_font_oversampling = false;
+	glyph_atlas_generation = 0;
 #ifdef DEBUG_ENABLED
 	debug_collisions_hint = false;
 	debug_navigation_hint = false;
@@ -1983,6 +2163,7 @@ SceneTree::SceneTree() {
 	GLOBAL_DEF("debug/shapes/collision/draw_2d_outlines", true);
 
 	tree_version = 1;
+	process_group_pass = 0;
 	physics_process_time = 1;
 	idle_process_time = 1;
 
@@ -2122,6 +2303,11 @@ SceneTree::~SceneTree() {
 		memdelete(root);
 	}
 
+	process_group_pool.finish();
+	for (uint32_t i = 0; i < process_group_tasks.size(); i++) {
+		memdelete(process_group_tasks[i].deferred);
+	}
+
 	if (singleton == this)
 		singleton = NULL;
 }
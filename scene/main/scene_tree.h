@@ -32,7 +32,9 @@
 #define SCENE_MAIN_LOOP_H
 
 #include "core/io/multiplayer_api.h"
+#include "core/local_vector.h"
 #include "core/os/main_loop.h"
+#include "core/os/thread_work_pool.h"
 #include "core/os/thread_safe.h"
 #include "core/self_list.h"
 #include "scene/resources/mesh.h"
@@ -40,6 +42,7 @@
 #include "scene/resources/world_2d.h"
 
 class PackedScene;
+class MessageQueue;
 class Node;
 class Viewport;
 class Material;
@@ -98,6 +101,29 @@ private:
 		Group() { changed = false; };
 	};
 
+	enum ProcessListType {
+		PROCESS_LIST_IDLE,
+		PROCESS_LIST_IDLE_INTERNAL,
+		PROCESS_LIST_PHYSICS,
+		PROCESS_LIST_PHYSICS_INTERNAL,
+		PROCESS_LIST_MAX
+	};
+
+	// Nodes receiving a process notification, kept out of group_map so dispatch walks a dense array.
+	// Removals leave NULL holes and additions are staged, both are folded in before the next dispatch.
+	struct ProcessList {
+		LocalVector<Node *> nodes; // sorted by priority, then tree order
+		LocalVector<Node *> added;
+		uint32_t holes;
+		bool resort;
+		bool dispatching;
+		ProcessList() {
+			holes = 0;
+			resort = false;
+			dispatching = false;
+		}
+	};
+
 	Viewport *custom_title_bar_viewport;
 	Viewport *root;
 
@@ -115,6 +141,19 @@ private:
 	int root_lock;
 
 	Map<StringName, Group> group_map;
+	ProcessList process_lists[PROCESS_LIST_MAX];
+
+	// Nodes under a sub thread process group run on the pool, one task per group.
+	// Deferred calls made by a task are captured and merged in group order.
+	struct ProcessGroupTask {
+		LocalVector<Node *> nodes;
+		MessageQueue *deferred;
+	};
+
+	LocalVector<ProcessGroupTask> process_group_tasks;
+	uint64_t process_group_pass;
+	ThreadWorkPool process_group_pool;
+	static thread_local bool process_group_thread;
 	bool _quit;
 	bool initialized;
 	bool input_handled;
@@ -128,6 +167,7 @@ private:
 	bool last_custom_title_bar_visible;
 
 	bool use_font_oversampling;
+	uint64_t glyph_atlas_generation;
 	int64_t current_frame;
 	int64_t current_event;
 	int node_count;
@@ -152,6 +192,7 @@ private:
 	real_t stretch_shrink;
 
 	void _update_font_oversampling(float p_ratio);
+	void _redraw_canvas_items(Node *p_node);
 	void _update_root_rect();
 
 	List<ObjectID> delete_queue;
@@ -160,7 +201,7 @@ private:
 	bool ugc_locked;
 	void _flush_ugc();
 
-	_FORCE_INLINE_ void _update_group_order(Group &g, bool p_use_priority = false);
+	_FORCE_INLINE_ void _update_group_order(Group &g);
 	void _update_listener();
 
 	Array _get_nodes_in_group(const StringName &p_group);
@@ -206,7 +247,14 @@ private:
 	void remove_from_group(const StringName &p_group, Node *p_node);
 	void make_group_changed(const StringName &p_group);
 
-	void _notify_group_pause(const StringName &p_group, int p_notification);
+	void process_list_add(ProcessListType p_type, Node *p_node);
+	void process_list_remove(ProcessListType p_type, Node *p_node);
+	void process_list_changed(ProcessListType p_type);
+	void _update_process_list(ProcessList &p_list, ProcessListType p_type);
+	void _notify_process_list(ProcessListType p_type, int p_notification);
+	uint32_t _dispatch_process_groups(ProcessList &p_list, uint32_t p_from, int p_notification);
+	void _process_group_task(uint32_t p_index, int p_notification);
+
 	void _call_input_pause(const StringName &p_group, const StringName &p_method, const Ref<InputEvent> &p_input);
 	Variant _call_group_flags(const Variant **p_args, int p_argcount, Variant::CallError &r_error);
 	Variant _call_group(const Variant **p_args, int p_argcount, Variant::CallError &r_error);
@@ -218,6 +266,11 @@ private:
 	friend class Viewport;
 
 	SelfList<Node>::List xform_change_list;
+	BinaryMutex xform_change_mutex;
+
+	// Process group threads may move nodes, the list is only locked while they run.
+	void _xform_change_add(SelfList<Node> *p_elem);
+	void _xform_change_remove(SelfList<Node> *p_elem);
 
 	friend class ScriptDebuggerRemote;
 #ifdef DEBUG_ENABLED
@@ -310,6 +363,7 @@ public:
 	bool is_input_handled();
 	_FORCE_INLINE_ float get_physics_process_time() const { return physics_process_time; }
 	_FORCE_INLINE_ float get_idle_process_time() const { return idle_process_time; }
+	_FORCE_INLINE_ static bool is_process_group_thread() { return process_group_thread; }
 
 #ifdef TOOLS_ENABLED
 	void _next_frame();
@@ -44,6 +44,8 @@ void Font::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_char_size", "char"), &Font::get_char_size);
 	ClassDB::bind_method(D_METHOD("get_string_size", "string"), &Font::get_string_size);
 
+	ClassDB::bind_method(D_METHOD("prewarm_glyphs", "chars"), &Font::prewarm_glyphs);
+
 	ClassDB::bind_method(D_METHOD("set_use_mipmaps", "enable"), &Font::set_use_mipmaps);
 	ClassDB::bind_method(D_METHOD("get_use_mipmaps"), &Font::get_use_mipmaps);
 
@@ -63,3 +65,10 @@ void Font::_bind_methods() {
 	ADD_PROPERTYI(PropertyInfo(Variant::INT, "extra_spacing_glyph"), "set_spacing", "get_spacing", FontServer::SPACING_GLYPH);
 	ADD_PROPERTYI(PropertyInfo(Variant::INT, "extra_spacing_space_char"), "set_spacing", "get_spacing", FontServer::SPACING_SPACE_CHAR);
 }
+
+void Font::prewarm_glyphs(const String &p_chars) const {
+	RID font = get_rid();
+	ERR_FAIL_COND(!font.is_valid());
+
+	FontServer::get_singleton()->font_prewarm_glyphs(font, p_chars);
+}
@@ -61,6 +61,8 @@ public:
 	virtual float get_descent() const = 0;
 
 	virtual bool is_distance_field_hint() const { return false; };
+
+	void prewarm_glyphs(const String &p_chars) const;
 };
 
 #endif
@@ -42,6 +42,12 @@ void FontDriver::set_singleton() {
 	singleton = this;
 }
 
+void FontDriver::prewarm_glyphs(const GlyphCacheKey &p_glyph_key, const Vector<uint32_t> &p_glyph_indices) {
+	for (int i = 0; i < p_glyph_indices.size(); i++) {
+		get_glyph_info(p_glyph_key, p_glyph_indices[i]);
+	}
+}
+
 FontDriver *FontDriverManager::drivers[MAX_DRIVERS];
 int FontDriverManager::driver_count = 0;
 
@@ -139,12 +145,25 @@ _FORCE_INLINE_ void FontServer::_font_clear_caches(Font *p_font) {
 	ERR_FAIL_COND(!driver);
 
 	driver->clear_glyph_cache(p_font->glyph_key);
+
+	MutexLock lock(temp_glyph_keys_mutex);
 	for (int i = 0; i < p_font->temp_glyph_keys.size(); i++) {
 		driver->clear_glyph_cache(p_font->temp_glyph_keys[i]);
 	}
 	p_font->temp_glyph_keys.clear();
 }
 
+_FORCE_INLINE_ void FontServer::_font_add_temp_glyph_key(Font *p_font, const GlyphCacheKey &p_glyph_key) const {
+	if (p_font->glyph_key == p_glyph_key) {
+		return;
+	}
+
+	MutexLock lock(temp_glyph_keys_mutex);
+	if (p_font->temp_glyph_keys.find(p_glyph_key) == -1) {
+		p_font->temp_glyph_keys.push_back(p_glyph_key);
+	}
+}
+
 _FORCE_INLINE_ bool FontServer::_font_update_metrics(Font *p_font) {
 	ERR_FAIL_COND_V(!p_font->font_info.is_valid(), false);
 	FontDriver *driver = p_font->font_info->driver;
@@ -192,7 +211,7 @@ RID FontServer::font_create(int p_size, bool p_use_mipmaps, bool p_use_filter, i
 	Font *font = memnew(Font);
 
 	font->glyph_key.font_size = p_size;
-	font->glyph_key.font_oversampling = 2;
+	font->glyph_key.font_oversampling = FONT_OVERSAMPLING;
 	font->glyph_key.font_use_mipmaps = p_use_mipmaps;
 	font->glyph_key.font_use_filter = p_use_filter;
 	font->glyph_key.font_custom_flags = p_custom_flags;
@@ -256,6 +275,16 @@ void FontServer::font_set_custom_flags(RID p_font, int p_custom_flags) {
 	}
 }
 
+void FontServer::font_set_distance_field(RID p_font, bool p_distance_field) {
+	Font *font = font_owner.getornull(p_font);
+	ERR_FAIL_COND(!font);
+
+	if (font->glyph_key.font_distance_field != p_distance_field) {
+		_font_clear_caches(font);
+		font->glyph_key.font_distance_field = p_distance_field;
+	}
+}
+
 bool FontServer::font_set_data(RID p_font, const PoolVector<uint8_t> &p_font_data) {
 	Font *font = font_owner.getornull(p_font);
 	ERR_FAIL_COND_V(!font, false);
@@ -458,9 +487,7 @@ GlyphInfo FontServer::font_get_glyph_info(RID p_font, char32_t p_char) const {
 
 			if (glyph_index) {
 				GlyphCacheKey temp_glyph_key = font->glyph_key.create_temp_key(fallback_font_id);
-				if (font->temp_glyph_keys.find(temp_glyph_key) == -1) {
-					font->temp_glyph_keys.push_back(temp_glyph_key);
-				}
+				_font_add_temp_glyph_key(font, temp_glyph_key);
 
 				glyph_info = driver->get_glyph_info(temp_glyph_key, glyph_index);
 				break;
@@ -493,13 +520,62 @@ RID FontServer::font_get_glyph_texture_rid(RID p_font, const GlyphInfo &p_glyph_
 	FontDriver *driver = font->font_info->driver;
 	ERR_FAIL_COND_V(!driver, RID());
 
-	if (font->glyph_key != p_glyph_info.cache_key && font->temp_glyph_keys.find(p_glyph_info.cache_key) == -1) {
-		font->temp_glyph_keys.push_back(p_glyph_info.cache_key);
-	}
+	_font_add_temp_glyph_key(font, p_glyph_info.cache_key);
 
 	return driver->get_glyph_texture_rid(p_glyph_info);
 }
 
+void FontServer::font_prewarm_glyphs(RID p_font, const String &p_chars) const {
+	Font *font = font_owner.getornull(p_font);
+	ERR_FAIL_COND(!font);
+	ERR_FAIL_COND(!font->font_info.is_valid());
+
+	FontDriver *driver = font->font_info->driver;
+	ERR_FAIL_COND(!driver);
+
+	FontID font_id = font->glyph_key.get_font_id();
+	Vector<FontID> builtin_font_ids = driver->get_builtin_font_ids();
+
+	// Glyph indices grouped by the cache key they are rasterized with.
+	Vector<GlyphCacheKey> glyph_keys;
+	Vector<Vector<uint32_t>> glyph_indices;
+
+	for (int i = 0; i < p_chars.length(); i++) {
+		char32_t c = p_chars[i];
+
+		GlyphCacheKey glyph_key = font->glyph_key;
+		uint32_t glyph_index = driver->get_glyph_index(font_id, c);
+
+		for (int j = 0; !glyph_index && j < builtin_font_ids.size(); j++) {
+			if (builtin_font_ids[j] == font_id) {
+				continue;
+			}
+
+			glyph_index = driver->get_glyph_index(builtin_font_ids[j], c);
+			if (glyph_index) {
+				glyph_key = font->glyph_key.create_temp_key(builtin_font_ids[j]);
+			}
+		}
+
+		if (!glyph_index) {
+			continue;
+		}
+
+		int key_idx = glyph_keys.find(glyph_key);
+		if (key_idx == -1) {
+			key_idx = glyph_keys.size();
+			glyph_keys.push_back(glyph_key);
+			glyph_indices.push_back(Vector<uint32_t>());
+			_font_add_temp_glyph_key(font, glyph_key);
+		}
+		glyph_indices.write[key_idx].push_back(glyph_index);
+	}
+
+	for (int i = 0; i < glyph_keys.size(); i++) {
+		driver->prewarm_glyphs(glyph_keys[i], glyph_indices[i]);
+	}
+}
+
 FontServer::FontServer() {
 	singleton = this;
 }
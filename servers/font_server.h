@@ -34,9 +34,11 @@
 #include "core/image.h"
 #include "core/io/resource_loader.h"
 #include "core/math/vector2.h"
+#include "core/os/mutex.h"
 #include "core/pool_vector.h"
 #include "core/reference.h"
 #include "core/rid.h"
+#include "core/safe_refcount.h"
 
 struct FontID {
 	uint32_t font_hash = 0;
@@ -75,6 +77,7 @@ struct GlyphCacheKey {
 	uint32_t font_oversampling = 1;
 	bool font_use_mipmaps = false;
 	bool font_use_filter = false;
+	bool font_distance_field = false;
 	uint32_t font_custom_flags = 0;
 
 	_FORCE_INLINE_ bool operator==(const GlyphCacheKey &p_key) const {
@@ -82,6 +85,7 @@ struct GlyphCacheKey {
 				(font_size * font_oversampling) == (p_key.font_size * p_key.font_oversampling) &&
 				font_use_mipmaps == p_key.font_use_mipmaps &&
 				font_use_filter == p_key.font_use_filter &&
+				font_distance_field == p_key.font_distance_field &&
 				font_custom_flags == p_key.font_custom_flags);
 	}
 
@@ -90,6 +94,7 @@ struct GlyphCacheKey {
 				(font_size * font_oversampling) != (p_key.font_size * p_key.font_oversampling) ||
 				font_use_mipmaps != p_key.font_use_mipmaps ||
 				font_use_filter != p_key.font_use_filter ||
+				font_distance_field != p_key.font_distance_field ||
 				font_custom_flags != p_key.font_custom_flags);
 	}
 
@@ -98,6 +103,7 @@ struct GlyphCacheKey {
 		h = h * 31 + (font_size * font_oversampling);
 		h = h * 31 + (font_use_mipmaps ? 1 : 0);
 		h = h * 31 + (font_use_filter ? 1 : 0);
+		h = h * 31 + (font_distance_field ? 1 : 0);
 		h = h * 31 + font_custom_flags;
 		return h;
 	}
@@ -113,6 +119,7 @@ struct GlyphCacheKey {
 		temp_glyph_key.font_oversampling = font_oversampling;
 		temp_glyph_key.font_use_mipmaps = font_use_mipmaps;
 		temp_glyph_key.font_use_filter = font_use_filter;
+		temp_glyph_key.font_distance_field = font_distance_field;
 		temp_glyph_key.font_custom_flags = font_custom_flags;
 		return temp_glyph_key;
 	}
@@ -133,6 +140,7 @@ struct GlyphInfo {
 	Vector2 advance;
 
 	int texture_index = -1;
+	int texture_slot = -1;
 	Size2 texture_size;
 	Rect2 texture_rect_uv;
 	Image::Format texture_format;
@@ -209,6 +217,9 @@ public:
 	virtual GlyphInfo get_glyph_info(const GlyphCacheKey &p_glyph_key, uint32_t p_glyph_index) = 0;
 	virtual RID get_glyph_texture_rid(const GlyphInfo &p_glyph_info) = 0;
 
+	// Makes sure the given glyphs are cached, drivers may rasterize them in parallel.
+	virtual void prewarm_glyphs(const GlyphCacheKey &p_glyph_key, const Vector<uint32_t> &p_glyph_indices);
+
 	FontDriver() {}
 	virtual ~FontDriver() {}
 };
@@ -235,6 +246,11 @@ class FontServer : public Object {
 	GDCLASS(FontServer, Object);
 
 public:
+	enum {
+		// Fonts rasterize at this multiple of their size, baked atlases have to match it.
+		FONT_OVERSAMPLING = 2
+	};
+
 	enum SpacingType {
 		SPACING_TOP,
 		SPACING_BOTTOM,
@@ -274,7 +290,12 @@ private:
 
 	Ref<FontDriver::FontInfo> default_font_info;
 
+	Mutex temp_glyph_keys_mutex;
+
+	SafeNumeric<uint64_t> glyph_atlas_generation;
+
 	_FORCE_INLINE_ void _font_clear_caches(Font *p_font);
+	_FORCE_INLINE_ void _font_add_temp_glyph_key(Font *p_font, const GlyphCacheKey &p_glyph_key) const;
 	_FORCE_INLINE_ bool _font_update_metrics(Font *p_font);
 
 protected:
@@ -285,12 +306,17 @@ public:
 
 	void init();
 
+	// Drivers bump this when cached glyphs are evicted or moved, canvas items drawn with the old UVs have to be redrawn.
+	void glyph_atlas_changed() { glyph_atlas_generation.increment(); }
+	uint64_t get_glyph_atlas_generation() const { return glyph_atlas_generation.get(); }
+
 	RID font_create(int p_size = 16, bool p_use_mipmaps = true, bool p_use_filter = true, int p_custom_flags = -1);
 	void font_free(RID p_font);
 	void font_set_size(RID p_font, int p_size);
 	void font_set_use_mipmaps(RID p_font, bool p_use_mipmaps);
 	void font_set_use_filter(RID p_font, bool p_use_filter);
 	void font_set_custom_flags(RID p_font, int p_custom_flags);
+	void font_set_distance_field(RID p_font, bool p_distance_field);
 	bool font_set_data(RID p_font, const PoolVector<uint8_t> &p_font_data);
 	bool font_set_path(RID p_font, const String &p_font_path);
 	bool font_set_index(RID p_font, int p_font_index);
@@ -309,6 +335,7 @@ public:
 	GlyphInfo font_get_glyph_info(RID p_font, char32_t p_char) const;
 	GlyphInfo font_get_glyph_info(const GlyphCacheKey &p_glyph_key, uint32_t p_glyph_index) const;
 	RID font_get_glyph_texture_rid(RID p_font, const GlyphInfo &p_glyph_info) const;
+	void font_prewarm_glyphs(RID p_font, const String &p_chars) const;
 
 	FontServer();
 	~FontServer();
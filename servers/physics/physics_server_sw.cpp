@@ -425,7 +425,7 @@ void PhysicsServerSW::area_set_area_monitor_callback(RID p_area, Object *p_recei
 /* BODY API */
 
 RID PhysicsServerSW::body_create(BodyMode p_mode, bool p_init_sleeping) {
-	BodySW *body = memnew(BodySW);
+	BodySW *body = body_owner.alloc();
 	if (p_mode != BODY_MODE_RIGID)
 		body->set_mode(p_mode);
 	if (p_init_sleeping)
@@ -1215,7 +1215,6 @@ void PhysicsServerSW::free(RID p_rid) {
 		}
 
 		body_owner.free(p_rid);
-		memdelete(body);
 
 	} else if (area_owner.owns(p_rid)) {
 		AreaSW *area = area_owner.get(p_rid);
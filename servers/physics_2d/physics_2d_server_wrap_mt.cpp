@@ -68,6 +68,7 @@ void Physics2DServerWrapMT::thread_loop() {
 
 void Physics2DServerWrapMT::step(real_t p_step) {
 	if (create_thread) {
+		command_queue.commit_stagings();
 		command_queue.push(this, &Physics2DServerWrapMT::thread_step, p_step);
 	} else {
 		command_queue.flush_all(); //flush all pending from other threads
@@ -107,6 +108,9 @@ void Physics2DServerWrapMT::init() {
 }
 
 void Physics2DServerWrapMT::finish() {
+	CommandQueueMT::Stats stats = command_queue.get_stats();
+	print_verbose("Physics2DServerWrapMT: " + itos(stats.commands) + " commands queued, peak depth " + itos(stats.max_depth) + ", producers stalled " + itos(stats.stall_usec / 1000) + " msec.");
+
 	if (create_thread) {
 		command_queue.push(this, &Physics2DServerWrapMT::thread_exit);
 		thread.wait_to_finish();
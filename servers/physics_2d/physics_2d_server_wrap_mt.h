@@ -313,6 +313,8 @@ public:
 		return physics_2d_server->get_process_info(p_info);
 	}
 
+	CommandQueueMT::Stats get_command_queue_stats() { return command_queue.get_stats(); }
+
 	Physics2DServerWrapMT(Physics2DServer *p_contained, bool p_create_thread);
 	~Physics2DServerWrapMT();
 
@@ -30,6 +30,7 @@
 
 #include "physics_2d_server.h"
 
+#include "core/frame_allocator.h"
 #include "core/method_bind_ext.gen.inc"
 #include "core/print_string.h"
 #include "core/project_settings.h"
@@ -272,10 +273,11 @@ Dictionary Physics2DDirectSpaceState::_intersect_ray(const Vector2 &p_from, cons
 
 Array Physics2DDirectSpaceState::_intersect_shape(const Ref<Physics2DShapeQueryParameters> &p_shape_query, int p_max_results) {
 	ERR_FAIL_COND_V(!p_shape_query.is_valid(), Array());
+	ERR_FAIL_COND_V(p_max_results < 0, Array());
 
-	Vector<ShapeResult> sr;
+	FrameVector<ShapeResult> sr;
 	sr.resize(p_max_results);
-	int rc = intersect_shape(p_shape_query->shape, p_shape_query->transform, p_shape_query->motion, p_shape_query->margin, sr.ptrw(), sr.size(), p_shape_query->exclude, p_shape_query->collision_mask, p_shape_query->collide_with_bodies, p_shape_query->collide_with_areas);
+	int rc = intersect_shape(p_shape_query->shape, p_shape_query->transform, p_shape_query->motion, p_shape_query->margin, sr.ptr(), sr.size(), p_shape_query->exclude, p_shape_query->collision_mask, p_shape_query->collide_with_bodies, p_shape_query->collide_with_areas);
 	Array ret;
 	ret.resize(rc);
 	for (int i = 0; i < rc; i++) {
@@ -310,14 +312,15 @@ Array Physics2DDirectSpaceState::_intersect_point_impl(const Vector2 &p_point, i
 	for (int i = 0; i < p_exclude.size(); i++)
 		exclude.insert(p_exclude[i]);
 
-	Vector<ShapeResult> ret;
+	ERR_FAIL_COND_V(p_max_results < 0, Array());
+	FrameVector<ShapeResult> ret;
 	ret.resize(p_max_results);
 
 	int rc;
 	if (p_filter_by_canvas)
-		rc = intersect_point(p_point, ret.ptrw(), ret.size(), exclude, p_layers, p_collide_with_bodies, p_collide_with_areas);
+		rc = intersect_point(p_point, ret.ptr(), ret.size(), exclude, p_layers, p_collide_with_bodies, p_collide_with_areas);
 	else
-		rc = intersect_point_on_canvas(p_point, p_canvas_instance_id, ret.ptrw(), ret.size(), exclude, p_layers, p_collide_with_bodies, p_collide_with_areas);
+		rc = intersect_point_on_canvas(p_point, p_canvas_instance_id, ret.ptr(), ret.size(), exclude, p_layers, p_collide_with_bodies, p_collide_with_areas);
 
 	if (rc == 0)
 		return Array();
@@ -346,11 +349,12 @@ Array Physics2DDirectSpaceState::_intersect_point_on_canvas(const Vector2 &p_poi
 
 Array Physics2DDirectSpaceState::_collide_shape(const Ref<Physics2DShapeQueryParameters> &p_shape_query, int p_max_results) {
 	ERR_FAIL_COND_V(!p_shape_query.is_valid(), Array());
+	ERR_FAIL_COND_V(p_max_results < 0, Array());
 
-	Vector<Vector2> ret;
+	FrameVector<Vector2> ret;
 	ret.resize(p_max_results * 2);
 	int rc = 0;
-	bool res = collide_shape(p_shape_query->shape, p_shape_query->transform, p_shape_query->motion, p_shape_query->margin, ret.ptrw(), p_max_results, rc, p_shape_query->exclude, p_shape_query->collision_mask, p_shape_query->collide_with_bodies, p_shape_query->collide_with_areas);
+	bool res = collide_shape(p_shape_query->shape, p_shape_query->transform, p_shape_query->motion, p_shape_query->margin, ret.ptr(), p_max_results, rc, p_shape_query->exclude, p_shape_query->collision_mask, p_shape_query->collide_with_bodies, p_shape_query->collide_with_areas);
 	if (!res)
 		return Array();
 	Array r;
@@ -32,110 +32,311 @@
 #define LRU_CACHE_H
 
 #include "core/hash_map.h"
-#include "core/list.h"
+#include "core/os/memory.h"
 
+// Fixed-capacity LRU cache. Entries live in a slab allocated once per
+// capacity change and are chained in recency order through prev/next
+// indices; lookups go through an open-addressing index table with linear
+// probing. Inserting, hitting and evicting never allocate.
 template <typename TKey, typename TData, typename Hasher = HashMapHasherDefault, typename Comparator = HashMapComparatorDefault<TKey>>
 class LRUCache {
-public:
-	struct Pair {
+	enum {
+		INVALID = 0xFFFFFFFF,
+	};
+
+	struct Entry {
 		TKey key;
 		TData data;
+		uint32_t hash = 0;
+		uint32_t prev = INVALID;
+		uint32_t next = INVALID;
+	};
 
-		Pair() {}
-		Pair(const TKey &p_key, const TData &p_data) :
-				key(p_key),
-				data(p_data) {
+	Entry *entries = NULL;
+	uint32_t *table = NULL;
+	uint32_t capacity = 0;
+	uint32_t table_mask = 0;
+	uint32_t used = 0;
+	uint32_t elements = 0;
+
+	uint32_t head = INVALID;
+	uint32_t tail = INVALID;
+	uint32_t free_list = INVALID;
+
+	uint64_t hits = 0;
+	uint64_t misses = 0;
+	uint64_t evictions = 0;
+
+	_FORCE_INLINE_ uint32_t _find_pos(const TKey &p_key, uint32_t p_hash) const {
+		if (!table) {
+			return INVALID;
 		}
-	};
 
-	typedef typename List<Pair>::Element *Element;
+		uint32_t pos = p_hash & table_mask;
+		while (table[pos] != INVALID) {
+			const Entry &e = entries[table[pos]];
+			if (e.hash == p_hash && Comparator::compare(e.key, p_key)) {
+				return pos;
+			}
+			pos = (pos + 1) & table_mask;
+		}
+		return INVALID;
+	}
 
-private:
-	List<Pair> _list;
-	HashMap<TKey, Element, Hasher, Comparator> _map;
-	size_t capacity;
+	void _table_insert(uint32_t p_entry) {
+		uint32_t pos = entries[p_entry].hash & table_mask;
+		while (table[pos] != INVALID) {
+			pos = (pos + 1) & table_mask;
+		}
+		table[pos] = p_entry;
+	}
+
+	// Backward-shift deletion, keeps probe sequences intact without tombstones.
+	void _table_remove(uint32_t p_pos) {
+		uint32_t i = p_pos;
+		while (true) {
+			table[i] = INVALID;
+			uint32_t j = i;
+			while (true) {
+				j = (j + 1) & table_mask;
+				if (table[j] == INVALID) {
+					return;
+				}
+				uint32_t home = entries[table[j]].hash & table_mask;
+				bool in_range = (i <= j) ? (i < home && home <= j) : (i < home || home <= j);
+				if (!in_range) {
+					break;
+				}
+			}
+			table[i] = table[j];
+			i = j;
+		}
+	}
+
+	_FORCE_INLINE_ void _unlink(uint32_t p_entry) {
+		Entry &e = entries[p_entry];
+		if (e.prev != INVALID) {
+			entries[e.prev].next = e.next;
+		} else {
+			head = e.next;
+		}
+		if (e.next != INVALID) {
+			entries[e.next].prev = e.prev;
+		} else {
+			tail = e.prev;
+		}
+		e.prev = INVALID;
+		e.next = INVALID;
+	}
+
+	_FORCE_INLINE_ void _link_front(uint32_t p_entry) {
+		Entry &e = entries[p_entry];
+		e.prev = INVALID;
+		e.next = head;
+		if (head != INVALID) {
+			entries[head].prev = p_entry;
+		}
+		head = p_entry;
+		if (tail == INVALID) {
+			tail = p_entry;
+		}
+	}
+
+	_FORCE_INLINE_ void _move_to_front(uint32_t p_entry) {
+		if (head != p_entry) {
+			_unlink(p_entry);
+			_link_front(p_entry);
+		}
+	}
+
+	void _release(uint32_t p_entry) {
+		Entry &e = entries[p_entry];
+		e.key = TKey();
+		e.data = TData();
+		e.next = free_list;
+		free_list = p_entry;
+	}
+
+	void _evict_tail() {
+		uint32_t victim = tail;
+		uint32_t pos = _find_pos(entries[victim].key, entries[victim].hash);
+		CRASH_COND(pos == INVALID);
+		_table_remove(pos);
+		_unlink(victim);
+		_release(victim);
+		elements--;
+		evictions++;
+	}
+
+	void _allocate(uint32_t p_capacity) {
+		capacity = MAX(p_capacity, 1u);
+		uint32_t table_size = next_power_of_2(capacity * 2);
+		table_mask = table_size - 1;
+
+		entries = memnew_arr(Entry, capacity);
+		table = memnew_arr(uint32_t, table_size);
+		for (uint32_t i = 0; i < table_size; i++) {
+			table[i] = INVALID;
+		}
+
+		used = 0;
+		elements = 0;
+		head = INVALID;
+		tail = INVALID;
+		free_list = INVALID;
+	}
+
+	void _free() {
+		if (entries) {
+			memdelete_arr(entries);
+			entries = NULL;
+		}
+		if (table) {
+			memdelete_arr(table);
+			table = NULL;
+		}
+	}
 
 public:
-	const Pair *insert(const TKey &p_key, const TData &p_value) {
-		Element *e = _map.getptr(p_key);
-		Element n = _list.push_front(Pair(p_key, p_value));
+	const TData *insert(const TKey &p_key, const TData &p_value) {
+		uint32_t hash = Hasher::hash(p_key);
+		uint32_t pos = _find_pos(p_key, hash);
 
-		if (e) {
-			_list.erase(*e);
-			_map.erase(p_key);
+		if (pos != INVALID) {
+			uint32_t idx = table[pos];
+			entries[idx].data = p_value;
+			_move_to_front(idx);
+			return &entries[idx].data;
 		}
-		_map[p_key] = _list.front();
 
-		while (_map.size() > capacity) {
-			Element d = _list.back();
+		if (elements == capacity) {
+			_evict_tail();
+		}
 
-			_map.erase(d->get().key);
-			_list.pop_back();
+		uint32_t idx;
+		if (free_list != INVALID) {
+			idx = free_list;
+			free_list = entries[idx].next;
+		} else {
+			idx = used++;
 		}
 
-		return &n->get();
+		Entry &e = entries[idx];
+		e.key = p_key;
+		e.data = p_value;
+		e.hash = hash;
+		_table_insert(idx);
+		_link_front(idx);
+		elements++;
+
+		return &e.data;
 	}
 
 	void clear() {
-		_map.clear();
-		_list.clear();
+		uint32_t old_capacity = capacity;
+		_free();
+		_allocate(old_capacity);
 	}
 
 	bool has(const TKey &p_key) const {
-		return _map.has(p_key);
+		return _find_pos(p_key, Hasher::hash(p_key)) != INVALID;
 	}
 
 	bool erase(const TKey &p_key) {
-		Element *e = _map.getptr(p_key);
-		if (!e) {
+		uint32_t pos = _find_pos(p_key, Hasher::hash(p_key));
+		if (pos == INVALID) {
 			return false;
 		}
-		_list.move_to_front(*e);
-		_map.erase(p_key);
-		_list.pop_front();
+
+		uint32_t idx = table[pos];
+		_table_remove(pos);
+		_unlink(idx);
+		_release(idx);
+		elements--;
 		return true;
 	}
 
 	const TData &get(const TKey &p_key) {
-		Element *e = _map.getptr(p_key);
-		CRASH_COND(!e);
-		_list.move_to_front(*e);
-		return (*e)->get().data;
+		const TData *data = getptr(p_key);
+		CRASH_COND(!data);
+		return *data;
 	}
 
 	_FORCE_INLINE_ const TData *getptr(const TKey &p_key) {
-		Element *e = _map.getptr(p_key);
-		if (!e) {
+		uint32_t pos = _find_pos(p_key, Hasher::hash(p_key));
+		if (pos == INVALID) {
+			misses++;
 			return NULL;
-		} else {
-			_list.move_to_front(*e);
-			return &(*e)->get().data;
 		}
+
+		hits++;
+		uint32_t idx = table[pos];
+		_move_to_front(idx);
+		return &entries[idx].data;
 	}
 
 	_FORCE_INLINE_ size_t get_capacity() const { return capacity; }
-	_FORCE_INLINE_ size_t size() const { return _map.size(); }
-	_FORCE_INLINE_ bool empty() const { return _map.empty(); }
+	_FORCE_INLINE_ size_t size() const { return elements; }
+	_FORCE_INLINE_ bool empty() const { return elements == 0; }
+
+	_FORCE_INLINE_ uint64_t get_hits() const { return hits; }
+	_FORCE_INLINE_ uint64_t get_misses() const { return misses; }
+	_FORCE_INLINE_ uint64_t get_evictions() const { return evictions; }
 
+	void reset_stats() {
+		hits = 0;
+		misses = 0;
+		evictions = 0;
+	}
+
+	// Reallocates the slab, keeping the most recently used entries that still fit.
 	void set_capacity(size_t p_capacity) {
-		if (capacity > 0) {
-			capacity = p_capacity;
-			while (_map.size() > capacity) {
-				Element d = _list.back();
+		ERR_FAIL_COND(p_capacity == 0);
+		if (p_capacity == capacity) {
+			return;
+		}
+
+		Entry *old_entries = entries;
+		uint32_t *old_table = table;
+		uint32_t old_tail = tail;
+		uint32_t old_elements = elements;
 
-				_map.erase(d->get().key);
-				_list.pop_back();
+		_allocate(p_capacity);
+
+		// Walk from least to most recent so the order is preserved.
+		uint32_t skip = old_elements > capacity ? old_elements - capacity : 0;
+		uint32_t idx = old_tail;
+		while (idx != INVALID) {
+			if (skip > 0) {
+				skip--;
+			} else {
+				insert(old_entries[idx].key, old_entries[idx].data);
 			}
+			idx = old_entries[idx].prev;
+		}
+
+		if (old_entries) {
+			memdelete_arr(old_entries);
+		}
+		if (old_table) {
+			memdelete_arr(old_table);
 		}
 	}
 
 	LRUCache() {
-		capacity = 64;
+		_allocate(64);
 	}
 
 	LRUCache(int p_capacity) {
-		capacity = p_capacity;
+		_allocate(p_capacity);
 	}
+
+	~LRUCache() {
+		_free();
+	}
+
+	LRUCache(const LRUCache &) = delete;
+	LRUCache &operator=(const LRUCache &) = delete;
 };
 
 #endif
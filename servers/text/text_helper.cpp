@@ -30,6 +30,7 @@
 
 #include "text_helper.h"
 
+#include "core/project_settings.h"
 #include "servers/font_server.h"
 #include "servers/text/text_shaper.h"
 #include "servers/visual_server.h"
@@ -37,18 +38,34 @@
 #include <graphemebreak.h>
 #include <linebreak.h>
 
-LRUCache<CharInfoCacheKey, Vector<CharInfo>, CharInfoCacheKeyHasher> TextHelper::char_infos_cache(1024);
+LRUCache<CharInfoCacheKey, ShapedGrapheme, CharInfoCacheKeyHasher> TextHelper::char_infos_cache(1024);
 LRUCache<String, Vector<String>> TextHelper::graphemes_cache(1024);
+LRUCache<ShapedLineCacheKey, ShapedLine, ShapedLineCacheKeyHasher> TextHelper::shaped_lines_cache(256);
+ShapedLine TextHelper::last_shaped_line;
+
+// Characters that never form a grapheme cluster with their neighbours.
+static _FORCE_INLINE_ bool _is_standalone_grapheme_char(char32_t p_char) {
+	return (p_char >= 0x0020u && p_char < 0x0300u) || // Latin, before combining diacritics.
+			(p_char >= 0x0621u && p_char < 0x064Bu) || // Arabic letters, before harakat.
+			(p_char >= 0x4E00u && p_char < 0xA000u); // CJK unified ideographs.
+}
+
+static _FORCE_INLINE_ bool _is_safe_grapheme_boundary(const char32_t *p_text, int p_len, int p_pos) {
+	if (p_pos <= 0 || p_pos >= p_len) {
+		return true;
+	}
+	return _is_standalone_grapheme_char(p_text[p_pos - 1]) && _is_standalone_grapheme_char(p_text[p_pos]);
+}
 
 _FORCE_INLINE_ void TextHelper::_process_shapeless_grapheme(CharInfo *p_char_info, char32_t p_char) {
 	p_char_info->set_type(CharInfo::SHAPELESS);
 	p_char_info->set_char_code(p_char);
 }
 
-_FORCE_INLINE_ void TextHelper::_process_shaped_grapheme(CharInfo *p_char_infos, const char32_t *p_text_ptr, int p_start_idx, const String &p_grapheme, const FontID &p_font_id, const Vector<FontID> &p_fallback_font_ids, int p_font_size, int p_font_oversampling) {
+_FORCE_INLINE_ void TextHelper::_process_shaped_grapheme(CharInfo *p_char_infos, ShapedGlyphBuffer &r_glyphs, const char32_t *p_text_ptr, int p_start_idx, const String &p_grapheme, const FontID &p_font_id, const Vector<FontID> &p_fallback_font_ids, int p_font_size, int p_font_oversampling) {
 	int grapheme_len = p_grapheme.length();
 
-	bool shaped = TextShaper::get_singleton()->shape_text(p_char_infos, p_font_id, p_fallback_font_ids, p_text_ptr + p_start_idx, grapheme_len, p_font_size, p_font_oversampling);
+	bool shaped = TextShaper::get_singleton()->shape_text(p_char_infos, r_glyphs, p_font_id, p_fallback_font_ids, p_text_ptr + p_start_idx, grapheme_len, p_font_size, p_font_oversampling);
 	if (!shaped) {
 		for (int i = 0; i < grapheme_len; i++) {
 			p_char_infos[i].set_type(CharInfo::SHAPELESS);
@@ -57,7 +74,19 @@ _FORCE_INLINE_ void TextHelper::_process_shaped_grapheme(CharInfo *p_char_infos,
 	}
 }
 
-_FORCE_INLINE_ void TextHelper::_draw_glyph(RID p_canvas_item, RID p_font, const GlyphInfo &p_glyph_info, const Vector2 &p_pos, const Color &p_modulate, bool p_preserve_color) {
+// The distance field flag travels with each run, so other draws in the same canvas item keep the regular path.
+_FORCE_INLINE_ void TextHelper::_add_glyph_runs(RID p_canvas_item, RID p_font, const FrameVector<GlyphRun> &p_runs) {
+	if (p_runs.size() == 0) {
+		return;
+	}
+
+	bool distance_field = FontServer::get_singleton()->font_get_glyph_key(p_font).font_distance_field;
+	for (uint32_t i = 0; i < p_runs.size(); i++) {
+		VisualServer::get_singleton()->canvas_item_add_glyph_run(p_canvas_item, p_runs[i].texture, p_runs[i].rects, p_runs[i].sources, p_runs[i].colors, distance_field);
+	}
+}
+
+_FORCE_INLINE_ void TextHelper::_draw_glyph(RID p_canvas_item, RID p_font, const GlyphInfo &p_glyph_info, const Vector2 &p_pos, const Color &p_modulate, bool p_preserve_color, FrameVector<GlyphRun> &r_runs) {
 	if (!p_glyph_info.found) {
 		return;
 	}
@@ -75,7 +104,36 @@ _FORCE_INLINE_ void TextHelper::_draw_glyph(RID p_canvas_item, RID p_font, const
 	Vector2 texture_pos = p_pos + p_glyph_info.texture_offset;
 	Rect2 texture_rect(texture_pos, p_glyph_info.texture_size);
 
-	VisualServer::get_singleton()->canvas_item_add_texture_rect_region(p_canvas_item, texture_rect, texture_rid, p_glyph_info.texture_rect_uv, modulate, false, RID(), false);
+	// Glyphs are grouped by atlas page, a line normally fits in a single run.
+	GlyphRun *run = NULL;
+	for (uint32_t i = 0; i < r_runs.size(); i++) {
+		if (r_runs[i].texture == texture_rid) {
+			run = &r_runs[i];
+			break;
+		}
+	}
+	if (!run) {
+		r_runs.push_back(GlyphRun());
+		run = &r_runs[r_runs.size() - 1];
+		run->texture = texture_rid;
+	}
+
+	run->rects.push_back(texture_rect);
+	run->sources.push_back(p_glyph_info.texture_rect_uv);
+	run->colors.push_back(modulate);
+}
+
+void TextHelper::initialize() {
+	int graphemes_cache_size = GLOBAL_DEF("gui/text/graphemes_cache_size", 1024);
+	ProjectSettings::get_singleton()->set_custom_property_info("gui/text/graphemes_cache_size", PropertyInfo(Variant::INT, "gui/text/graphemes_cache_size", PROPERTY_HINT_RANGE, "16,65536,1,or_greater"));
+	int char_infos_cache_size = GLOBAL_DEF("gui/text/char_infos_cache_size", 1024);
+	ProjectSettings::get_singleton()->set_custom_property_info("gui/text/char_infos_cache_size", PropertyInfo(Variant::INT, "gui/text/char_infos_cache_size", PROPERTY_HINT_RANGE, "16,65536,1,or_greater"));
+	int shaped_lines_cache_size = GLOBAL_DEF("gui/text/shaped_lines_cache_size", 256);
+	ProjectSettings::get_singleton()->set_custom_property_info("gui/text/shaped_lines_cache_size", PropertyInfo(Variant::INT, "gui/text/shaped_lines_cache_size", PROPERTY_HINT_RANGE, "16,65536,1,or_greater"));
+
+	graphemes_cache.set_capacity(MAX(16, graphemes_cache_size));
+	char_infos_cache.set_capacity(MAX(16, char_infos_cache_size));
+	shaped_lines_cache.set_capacity(MAX(16, shaped_lines_cache_size));
 }
 
 Vector<String> TextHelper::get_graphemes(const String &p_text) {
@@ -128,22 +186,22 @@ Vector<String> TextHelper::get_graphemes(const String &p_text) {
 	return graphemes;
 }
 
-Vector<CharInfo> TextHelper::get_char_infos(const Ref<TextLine> &p_text_line) {
-	ERR_FAIL_COND_V(!p_text_line.is_valid(), Vector<CharInfo>());
+void TextHelper::_shape_span(const Ref<TextLine> &p_text_line, int p_from, int p_to, CharInfo *r_char_infos, ShapedGlyphBuffer &r_glyphs) {
+	if (p_from >= p_to) {
+		return;
+	}
 
-	Vector<CharInfo> char_infos;
-	int line_len = p_text_line->original_line.length();
+	const String &line = p_text_line->original_line;
+	const char32_t *line_ptr = line.ptr();
 
-	if (line_len == 0) {
-		return char_infos;
+	Vector<String> graphemes;
+	if (p_from == 0 && p_to == line.length()) {
+		graphemes = get_graphemes(line);
+	} else {
+		graphemes = get_graphemes(line.substr(p_from, p_to - p_from));
 	}
 
-	char_infos.resize(line_len);
-	CharInfo *char_infos_ptr = char_infos.ptrw();
-	const char32_t *line_ptr = p_text_line->original_line.ptr();
-
-	Vector<String> graphemes = get_graphemes(p_text_line->original_line);
-	int char_idx = 0;
+	int char_idx = p_from;
 
 	for (int i = 0; i < graphemes.size(); i++) {
 		const String &grapheme = graphemes[i];
@@ -153,44 +211,282 @@ Vector<CharInfo> TextHelper::get_char_infos(const Ref<TextLine> &p_text_line) {
 		char_info_key.header = p_text_line->cache_header;
 		char_info_key.grapheme = grapheme;
 
-		const Vector<CharInfo> *cached = char_infos_cache.getptr(char_info_key);
+		const ShapedGrapheme *cached = char_infos_cache.getptr(char_info_key);
 		if (cached) {
+			int glyph_base = r_glyphs.append(cached->glyphs);
 			for (int j = 0; j < grapheme_len; j++) {
-				char_infos_ptr[char_idx + j] = (*cached)[j];
+				const CharInfo &cached_info = cached->char_infos[j];
+				r_char_infos[char_idx + j] = cached_info;
+				if (cached_info.get_type() == CharInfo::SHAPED) {
+					r_char_infos[char_idx + j].set_glyph(glyph_base + cached_info.get_glyph());
+				}
 			}
 			char_idx += grapheme_len;
 		} else {
+			int glyph_start = r_glyphs.size();
+
 			if (grapheme_len == 1) {
-				_process_shapeless_grapheme(&char_infos_ptr[char_idx], line_ptr[char_idx]);
+				_process_shapeless_grapheme(&r_char_infos[char_idx], line_ptr[char_idx]);
 			} else if (TextShaper::get_singleton()) {
 				_process_shaped_grapheme(
-						&char_infos_ptr[char_idx], line_ptr, char_idx, grapheme,
+						&r_char_infos[char_idx], r_glyphs, line_ptr, char_idx, grapheme,
 						p_text_line->font_id, p_text_line->fallback_font_ids,
 						p_text_line->font_size, p_text_line->font_oversampling);
 			} else {
 				for (int j = 0; j < grapheme_len; j++) {
-					_process_shapeless_grapheme(&char_infos_ptr[char_idx + j], line_ptr[char_idx + j]);
+					_process_shapeless_grapheme(&r_char_infos[char_idx + j], line_ptr[char_idx + j]);
 				}
 			}
-			char_idx += grapheme_len;
 
-			Vector<CharInfo> sub_char_infos;
-			sub_char_infos.resize(grapheme_len);
+			ShapedGrapheme shaped_grapheme;
+			shaped_grapheme.char_infos.resize(grapheme_len);
+			shaped_grapheme.glyphs.append(r_glyphs, glyph_start, r_glyphs.size() - glyph_start);
 
 			for (int j = 0; j < grapheme_len; j++) {
-				sub_char_infos.write[j] = char_infos_ptr[char_idx - grapheme_len + j];
+				CharInfo &sub_info = shaped_grapheme.char_infos.write[j];
+				sub_info = r_char_infos[char_idx + j];
+				if (sub_info.get_type() == CharInfo::SHAPED) {
+					sub_info.set_glyph(sub_info.get_glyph() - glyph_start);
+				}
 			}
+			char_idx += grapheme_len;
 
-			char_infos_cache.insert(char_info_key, sub_char_infos);
+			char_infos_cache.insert(char_info_key, shaped_grapheme);
 		}
 	}
+}
+
+bool TextHelper::_reshape_changed_span(const Ref<TextLine> &p_text_line, const ShapedLine &p_previous, Vector<CharInfo> &r_char_infos, ShapedGlyphBuffer &r_glyphs) {
+	if (p_previous.header != p_text_line->cache_header) {
+		return false;
+	}
 
-	return char_infos;
+	const String &line = p_text_line->original_line;
+	int line_len = line.length();
+	int prev_len = p_previous.line.length();
+
+	if (line_len == 0 || prev_len == 0) {
+		return false;
+	}
+
+	const char32_t *line_ptr = line.ptr();
+	const char32_t *prev_ptr = p_previous.line.ptr();
+
+	int max_common = MIN(line_len, prev_len);
+
+	int prefix = 0;
+	while (prefix < max_common && line_ptr[prefix] == prev_ptr[prefix]) {
+		prefix++;
+	}
+
+	int suffix = 0;
+	while (suffix < max_common - prefix && line_ptr[line_len - 1 - suffix] == prev_ptr[prev_len - 1 - suffix]) {
+		suffix++;
+	}
+
+	// Only reuse spans whose ends are grapheme breaks in both lines.
+	while (prefix > 0 && !(_is_safe_grapheme_boundary(line_ptr, line_len, prefix) && _is_safe_grapheme_boundary(prev_ptr, prev_len, prefix))) {
+		prefix--;
+	}
+	while (suffix > 0 && !(_is_safe_grapheme_boundary(line_ptr, line_len, line_len - suffix) && _is_safe_grapheme_boundary(prev_ptr, prev_len, prev_len - suffix))) {
+		suffix--;
+	}
+
+	if ((prefix + suffix) * 2 < line_len) {
+		return false;
+	}
+
+	int span_end = line_len - suffix;
+	int prev_suffix_start = prev_len - suffix;
+
+	const CharInfo *prev_infos = p_previous.char_infos.ptr();
+	const ShapedGlyphBuffer &prev_glyphs = p_previous.glyphs;
+
+	// Glyphs are stored in character order, so the reused prefix and suffix
+	// each map to a contiguous range of the previous glyph buffer.
+	int prefix_glyph_end = prev_glyphs.size();
+	for (int i = prefix; i < prev_len; i++) {
+		if (prev_infos[i].get_type() == CharInfo::SHAPED) {
+			prefix_glyph_end = prev_infos[i].get_glyph();
+			break;
+		}
+	}
+
+	int suffix_glyph_start = prev_glyphs.size();
+	for (int i = prev_suffix_start; i < prev_len; i++) {
+		if (prev_infos[i].get_type() == CharInfo::SHAPED) {
+			suffix_glyph_start = prev_infos[i].get_glyph();
+			break;
+		}
+	}
+
+	r_char_infos.resize(line_len);
+	r_glyphs.clear();
+	r_glyphs.reserve(line_len);
+
+	CharInfo *char_infos_ptr = r_char_infos.ptrw();
+
+	for (int i = 0; i < prefix; i++) {
+		char_infos_ptr[i] = prev_infos[i];
+	}
+	r_glyphs.append(prev_glyphs, 0, prefix_glyph_end);
+
+	_shape_span(p_text_line, prefix, span_end, char_infos_ptr, r_glyphs);
+
+	int glyph_base = r_glyphs.append(prev_glyphs, suffix_glyph_start, prev_glyphs.size() - suffix_glyph_start);
+	for (int i = 0; i < suffix; i++) {
+		const CharInfo &prev_info = prev_infos[prev_suffix_start + i];
+		char_infos_ptr[span_end + i] = prev_info;
+		if (prev_info.get_type() == CharInfo::SHAPED) {
+			char_infos_ptr[span_end + i].set_glyph(prev_info.get_glyph() - suffix_glyph_start + glyph_base);
+		}
+	}
+
+	return true;
 }
 
-Ref<TextLine> TextHelper::create_text_line(RID p_font, const String &p_line) {
-	ERR_FAIL_COND_V(!p_font.is_valid(), Ref<TextLine>());
+void TextHelper::get_char_infos(const Ref<TextLine> &p_text_line, Vector<CharInfo> &r_char_infos, ShapedGlyphBuffer &r_glyphs) {
+	ERR_FAIL_COND(!p_text_line.is_valid());
+
+	const String &line = p_text_line->original_line;
+	int line_len = line.length();
+
+	if (line_len == 0) {
+		r_char_infos.clear();
+		r_glyphs.clear();
+		return;
+	}
+
+	ShapedLineCacheKey line_key;
+	line_key.header = p_text_line->cache_header;
+	line_key.line_hash = line.hash64();
+
+	const ShapedLine *cached = shaped_lines_cache.getptr(line_key);
+	if (cached && cached->line == line) {
+		r_char_infos = cached->char_infos;
+		r_glyphs = cached->glyphs;
+		return;
+	}
+
+	if (!_reshape_changed_span(p_text_line, last_shaped_line, r_char_infos, r_glyphs)) {
+		r_char_infos.resize(line_len);
+		r_glyphs.clear();
+
+		// A character maps to at most one glyph, so this is the only allocation for the line.
+		r_glyphs.reserve(line_len);
+
+		_shape_span(p_text_line, 0, line_len, r_char_infos.ptrw(), r_glyphs);
+	}
+
+	ShapedLine shaped_line;
+	shaped_line.header = p_text_line->cache_header;
+	shaped_line.line = line;
+	shaped_line.char_infos = r_char_infos;
+	shaped_line.glyphs = r_glyphs;
+
+	shaped_lines_cache.insert(line_key, shaped_line);
+	last_shaped_line = shaped_line;
+}
+
+void TextHelper::_shape_text_lines(const Vector<Ref<TextLine>> &p_text_lines) {
+	int line_count = p_text_lines.size();
+	if (line_count == 0) {
+		return;
+	}
+
+	const Ref<TextLine> &first_line = p_text_lines[0];
+
+	// Graphemes missing from the cache are gathered from every line first and
+	// shaped as one batch, which the shaper may spread over worker threads.
+	// Graphemes first seen in line i are texts [line_text_end[i - 1], line_text_end[i]).
+	Vector<String> texts;
+	FrameVector<int> line_text_end;
+	line_text_end.resize(line_count);
+
+	HashMap<String, bool> pending;
+	bool batch = TextShaper::get_singleton() && line_count > 1;
+
+	for (int i = 0; i < line_count; i++) {
+		const String &line = p_text_lines[i]->original_line;
+
+		if (batch && line.length() > 1) {
+			ShapedLineCacheKey line_key;
+			line_key.header = first_line->cache_header;
+			line_key.line_hash = line.hash64();
+
+			const ShapedLine *cached = shaped_lines_cache.getptr(line_key);
+			if (!cached || cached->line != line) {
+				Vector<String> graphemes = get_graphemes(line);
+				for (int j = 0; j < graphemes.size(); j++) {
+					const String &grapheme = graphemes[j];
+					if (grapheme.length() < 2 || pending.has(grapheme)) {
+						continue;
+					}
+
+					CharInfoCacheKey char_info_key;
+					char_info_key.header = first_line->cache_header;
+					char_info_key.grapheme = grapheme;
+					if (char_infos_cache.getptr(char_info_key)) {
+						continue;
+					}
+
+					pending[grapheme] = true;
+					texts.push_back(grapheme);
+				}
+			}
+		}
+
+		line_text_end[i] = texts.size();
+	}
+
+	int text_count = texts.size();
+
+	FrameVector<ShapeRequest> requests;
+	requests.resize(text_count);
+
+	Vector<ShapedGrapheme> shaped_graphemes;
+	shaped_graphemes.resize(text_count);
+	ShapedGrapheme *shaped_ptr = shaped_graphemes.ptrw();
+
+	for (int i = 0; i < text_count; i++) {
+		shaped_ptr[i].char_infos.resize(texts[i].length());
+
+		requests[i].text = texts[i].ptr();
+		requests[i].char_count = texts[i].length();
+		requests[i].char_infos = shaped_ptr[i].char_infos.ptrw();
+	}
+
+	if (text_count > 0) {
+		TextShaper::get_singleton()->shape_texts(requests.ptr(), text_count, first_line->font_id, first_line->fallback_font_ids, first_line->font_size, first_line->font_oversampling);
+	}
+
+	int text_idx = 0;
+	for (int i = 0; i < line_count; i++) {
+		// Results are cached right before the line needing them, so a small cache cannot evict them early.
+		for (; text_idx < line_text_end[i]; text_idx++) {
+			ShapedGrapheme &shaped_grapheme = shaped_ptr[text_idx];
+			const String &text = texts[text_idx];
+
+			if (requests[text_idx].shaped) {
+				shaped_grapheme.glyphs = requests[text_idx].glyphs;
+			} else {
+				for (int j = 0; j < text.length(); j++) {
+					_process_shapeless_grapheme(&shaped_grapheme.char_infos.write[j], text[j]);
+				}
+			}
 
+			CharInfoCacheKey char_info_key;
+			char_info_key.header = first_line->cache_header;
+			char_info_key.grapheme = text;
+			char_infos_cache.insert(char_info_key, shaped_grapheme);
+		}
+
+		Ref<TextLine> text_line = p_text_lines[i];
+		get_char_infos(text_line, text_line->char_infos, text_line->glyphs);
+	}
+}
+
+Ref<TextLine> TextHelper::_setup_text_line(RID p_font, const String &p_line) {
 	Ref<TextLine> text_line;
 	text_line.instance();
 
@@ -217,7 +513,14 @@ Ref<TextLine> TextHelper::create_text_line(RID p_font, const String &p_line) {
 
 	text_line->cache_header = h;
 
-	text_line->char_infos = get_char_infos(text_line);
+	return text_line;
+}
+
+Ref<TextLine> TextHelper::create_text_line(RID p_font, const String &p_line) {
+	ERR_FAIL_COND_V(!p_font.is_valid(), Ref<TextLine>());
+
+	Ref<TextLine> text_line = _setup_text_line(p_font, p_line);
+	get_char_infos(text_line, text_line->char_infos, text_line->glyphs);
 
 	return text_line;
 }
@@ -257,14 +560,15 @@ Vector<Ref<TextLine>> TextHelper::create_text_lines(RID p_font, const String &p_
 
 		String line(text_ptr + line_start, line_len);
 
-		Ref<TextLine> text_line = create_text_line(p_font, line);
-		text_lines.push_back(text_line);
+		text_lines.push_back(_setup_text_line(p_font, line));
 	}
 
+	_shape_text_lines(text_lines);
+
 	return text_lines;
 }
 
-Vector2 TextHelper::draw_char_in_text_line(const Ref<TextLine> &p_text_line, int p_char_index, RID p_canvas_item, const Vector2 &p_pos, const Color &p_modulate, bool p_preserve_color) {
+Vector2 TextHelper::_draw_char_in_text_line(const Ref<TextLine> &p_text_line, int p_char_index, RID p_canvas_item, const Vector2 &p_pos, const Color &p_modulate, bool p_preserve_color, FrameVector<GlyphRun> &r_runs) {
 	Vector2 ofs;
 
 	ERR_FAIL_COND_V(!p_text_line.is_valid(), ofs);
@@ -275,7 +579,7 @@ Vector2 TextHelper::draw_char_in_text_line(const Ref<TextLine> &p_text_line, int
 
 	if (char_info.get_type() == CharInfo::SHAPELESS) {
 		const GlyphInfo &glyph_info = FontServer::get_singleton()->font_get_glyph_info(p_text_line->font, char_info.get_char_code());
-		_draw_glyph(p_canvas_item, p_text_line->font, glyph_info, p_pos + ofs, p_modulate, p_preserve_color);
+		_draw_glyph(p_canvas_item, p_text_line->font, glyph_info, p_pos + ofs, p_modulate, p_preserve_color, r_runs);
 
 		ofs += glyph_info.advance;
 
@@ -285,16 +589,19 @@ Vector2 TextHelper::draw_char_in_text_line(const Ref<TextLine> &p_text_line, int
 		}
 	} else if (char_info.get_type() == CharInfo::SHAPED) {
 		GlyphCacheKey glyph_key = FontServer::get_singleton()->font_get_glyph_key(p_text_line->font);
-		GlyphCacheKey temp_glyph_key = glyph_key.create_temp_key(char_info.get_glyph_font_id());
+		const ShapedGlyphBuffer &glyphs = p_text_line->glyphs;
+		int glyph = char_info.get_glyph();
+
+		GlyphCacheKey temp_glyph_key = glyph_key.create_temp_key(glyphs.get_font_id(glyph));
 
-		const GlyphInfo &glyph_info = FontServer::get_singleton()->font_get_glyph_info(temp_glyph_key, char_info.get_glyph_index());
-		_draw_glyph(p_canvas_item, p_text_line->font, glyph_info, p_pos + ofs + char_info.get_glyph_offset(), p_modulate, p_preserve_color);
+		const GlyphInfo &glyph_info = FontServer::get_singleton()->font_get_glyph_info(temp_glyph_key, glyphs.get_index(glyph));
+		_draw_glyph(p_canvas_item, p_text_line->font, glyph_info, p_pos + ofs + glyphs.get_offset(glyph), p_modulate, p_preserve_color, r_runs);
 
-		ofs += char_info.get_glyph_advance();
+		ofs += glyphs.get_advance(glyph);
 		if (char_info.get_char_code() == 0x0020u) {
 			ofs.width += p_text_line->spacing_space_char;
 		}
-		if (char_info.is_cluster_end()) {
+		if (glyphs.is_cluster_end(glyph)) {
 			ofs.width += p_text_line->spacing_glyph;
 		}
 	}
@@ -302,6 +609,17 @@ Vector2 TextHelper::draw_char_in_text_line(const Ref<TextLine> &p_text_line, int
 	return ofs;
 }
 
+Vector2 TextHelper::draw_char_in_text_line(const Ref<TextLine> &p_text_line, int p_char_index, RID p_canvas_item, const Vector2 &p_pos, const Color &p_modulate, bool p_preserve_color) {
+	ERR_FAIL_COND_V(!p_text_line.is_valid(), Vector2());
+	ERR_FAIL_COND_V(!p_text_line->font.is_valid(), Vector2());
+
+	FrameVector<GlyphRun> runs;
+	Vector2 advance = _draw_char_in_text_line(p_text_line, p_char_index, p_canvas_item, p_pos, p_modulate, p_preserve_color, runs);
+	_add_glyph_runs(p_canvas_item, p_text_line->font, runs);
+
+	return advance;
+}
+
 Vector2 TextHelper::get_char_size_in_text_line(const Ref<TextLine> &p_text_line, int p_char_index) {
 	Vector2 size(0, p_text_line->height);
 
@@ -320,12 +638,13 @@ Vector2 TextHelper::get_char_size_in_text_line(const Ref<TextLine> &p_text_line,
 			size += FontServer::get_singleton()->font_get_kerning(p_text_line->font, char_info.get_char_code(), next_info.get_char_code());
 		}
 	} else if (char_info.get_type() == CharInfo::SHAPED) {
-		size.x += char_info.get_glyph_advance().x;
+		int glyph = char_info.get_glyph();
+		size.x += p_text_line->glyphs.get_advance(glyph).x;
 
 		if (char_info.get_char_code() == 0x0020u) {
 			size.x += p_text_line->spacing_space_char;
 		}
-		if (char_info.is_cluster_end()) {
+		if (p_text_line->glyphs.is_cluster_end(glyph)) {
 			size.x += p_text_line->spacing_glyph;
 		}
 	}
@@ -337,17 +656,21 @@ Vector2 TextHelper::draw_text_line(const Ref<TextLine> &p_text_line, RID p_canva
 	ERR_FAIL_COND_V(!p_text_line.is_valid(), Vector2());
 	ERR_FAIL_COND_V(!p_text_line->font.is_valid(), Vector2());
 
+	FrameVector<GlyphRun> runs;
+
 	Vector2 ofs;
 	for (int i = 0; i < p_text_line->char_infos.size(); i++) {
 		if (p_clip_w > 0.0 && ofs.x > p_clip_w) {
 			const CharInfo &char_info = p_text_line->char_infos[i];
-			if (i == 0 || char_info.get_type() != CharInfo::SHAPED || char_info.is_cluster_end()) {
+			if (i == 0 || char_info.get_type() != CharInfo::SHAPED || p_text_line->glyphs.is_cluster_end(char_info.get_glyph())) {
 				break;
 			}
 		}
-		ofs += draw_char_in_text_line(p_text_line, i, p_canvas_item, p_pos + ofs, p_modulate, p_preserve_color);
+		ofs += _draw_char_in_text_line(p_text_line, i, p_canvas_item, p_pos + ofs, p_modulate, p_preserve_color, runs);
 	}
 
+	_add_glyph_runs(p_canvas_item, p_text_line->font, runs);
+
 	return ofs;
 }
 
@@ -408,8 +731,10 @@ Vector2 TextHelper::get_char_size(RID p_font, char32_t p_char) {
 Vector2 TextHelper::draw_char(RID p_canvas_item, RID p_font, const Vector2 &p_pos, char32_t p_char, const Color &p_modulate, bool p_preserve_color) {
 	ERR_FAIL_COND_V(!p_font.is_valid(), Vector2());
 
+	FrameVector<GlyphRun> runs;
 	const GlyphInfo &glyph_info = FontServer::get_singleton()->font_get_glyph_info(p_font, p_char);
-	_draw_glyph(p_canvas_item, p_font, glyph_info, p_pos, p_modulate, p_preserve_color);
+	_draw_glyph(p_canvas_item, p_font, glyph_info, p_pos, p_modulate, p_preserve_color, runs);
+	_add_glyph_runs(p_canvas_item, p_font, runs);
 
 	return glyph_info.advance;
 }
@@ -31,6 +31,7 @@
 #ifndef TEXT_HELPER_H
 #define TEXT_HELPER_H
 
+#include "core/frame_allocator.h"
 #include "core/hash_map.h"
 #include "core/hashfuncs.h"
 #include "core/math/vector2.h"
@@ -69,20 +70,77 @@ struct CharInfoCacheKeyHasher {
 	}
 };
 
+struct ShapedGrapheme {
+	Vector<CharInfo> char_infos;
+	ShapedGlyphBuffer glyphs;
+};
+
+struct ShapedLineCacheKey {
+	uint64_t header = 0;
+	uint64_t line_hash = 0;
+
+	_FORCE_INLINE_ bool operator==(const ShapedLineCacheKey &p_key) const {
+		return (header == p_key.header &&
+				line_hash == p_key.line_hash);
+	}
+
+	_FORCE_INLINE_ bool operator!=(const ShapedLineCacheKey &p_key) const {
+		return (header != p_key.header ||
+				line_hash != p_key.line_hash);
+	}
+
+	_FORCE_INLINE_ uint64_t hash() const {
+		uint64_t h = header;
+		h = h * 31 + line_hash;
+		return h;
+	}
+};
+
+struct ShapedLineCacheKeyHasher {
+	static _FORCE_INLINE_ uint32_t hash(const ShapedLineCacheKey &p_key) {
+		return HashMapHasherDefault::hash(p_key.hash());
+	}
+};
+
+struct ShapedLine {
+	uint64_t header = 0;
+	String line;
+	Vector<CharInfo> char_infos;
+	ShapedGlyphBuffer glyphs;
+};
+
+struct GlyphRun {
+	RID texture;
+	Vector<Rect2> rects;
+	Vector<Rect2> sources;
+	Vector<Color> colors;
+};
+
 /*************************************************************************/
 
 class TextHelper {
-	static LRUCache<CharInfoCacheKey, Vector<CharInfo>, CharInfoCacheKeyHasher> char_infos_cache;
+	static LRUCache<CharInfoCacheKey, ShapedGrapheme, CharInfoCacheKeyHasher> char_infos_cache;
 	static LRUCache<String, Vector<String>> graphemes_cache;
+	static LRUCache<ShapedLineCacheKey, ShapedLine, ShapedLineCacheKeyHasher> shaped_lines_cache;
+	static ShapedLine last_shaped_line;
 
 	static _FORCE_INLINE_ void _process_shapeless_grapheme(CharInfo *p_char_info, char32_t p_char);
-	static _FORCE_INLINE_ void _process_shaped_grapheme(CharInfo *p_char_infos, const char32_t *p_text_ptr, int p_start_idx, const String &p_grapheme, const FontID &p_font_id, const Vector<FontID> &p_fallback_font_ids, int p_font_size, int p_font_oversampling);
+	static _FORCE_INLINE_ void _process_shaped_grapheme(CharInfo *p_char_infos, ShapedGlyphBuffer &r_glyphs, const char32_t *p_text_ptr, int p_start_idx, const String &p_grapheme, const FontID &p_font_id, const Vector<FontID> &p_fallback_font_ids, int p_font_size, int p_font_oversampling);
+
+	static void _shape_span(const Ref<TextLine> &p_text_line, int p_from, int p_to, CharInfo *r_char_infos, ShapedGlyphBuffer &r_glyphs);
+	static bool _reshape_changed_span(const Ref<TextLine> &p_text_line, const ShapedLine &p_previous, Vector<CharInfo> &r_char_infos, ShapedGlyphBuffer &r_glyphs);
+	static void _shape_text_lines(const Vector<Ref<TextLine>> &p_text_lines);
+	static Ref<TextLine> _setup_text_line(RID p_font, const String &p_line);
 
-	static _FORCE_INLINE_ void _draw_glyph(RID p_canvas_item, RID p_font, const GlyphInfo &p_glyph_info, const Vector2 &p_pos, const Color &p_modulate, bool p_preserve_color = true);
+	static _FORCE_INLINE_ void _add_glyph_runs(RID p_canvas_item, RID p_font, const FrameVector<GlyphRun> &p_runs);
+	static _FORCE_INLINE_ void _draw_glyph(RID p_canvas_item, RID p_font, const GlyphInfo &p_glyph_info, const Vector2 &p_pos, const Color &p_modulate, bool p_preserve_color, FrameVector<GlyphRun> &r_runs);
+	static Vector2 _draw_char_in_text_line(const Ref<TextLine> &p_text_line, int p_char_index, RID p_canvas_item, const Vector2 &p_pos, const Color &p_modulate, bool p_preserve_color, FrameVector<GlyphRun> &r_runs);
 
 public:
+	static void initialize();
+
 	static Vector<String> get_graphemes(const String &p_text);
-	static Vector<CharInfo> get_char_infos(const Ref<TextLine> &p_text_line);
+	static void get_char_infos(const Ref<TextLine> &p_text_line, Vector<CharInfo> &r_char_infos, ShapedGlyphBuffer &r_glyphs);
 
 	static Vector<Ref<TextLine>> create_text_lines(RID p_font, const String &p_text);
 	static Ref<TextLine> create_text_line(RID p_font, const String &p_line);
@@ -42,6 +42,14 @@ void TextShaper::set_singleton() {
 	singleton = this;
 }
 
+void TextShaper::shape_texts(ShapeRequest *r_requests, int p_request_count, const FontID &p_font_id, const Vector<FontID> &p_fallback_font_ids, int p_font_size, int p_font_oversampling) {
+	for (int i = 0; i < p_request_count; i++) {
+		ShapeRequest &request = r_requests[i];
+		request.glyphs.reserve(request.char_count);
+		request.shaped = shape_text(request.char_infos, request.glyphs, p_font_id, p_fallback_font_ids, request.text, request.char_count, p_font_size, p_font_oversampling);
+	}
+}
+
 TextShaper *TextShaperManager::shapers[MAX_SHAPERS];
 int TextShaperManager::shaper_count = 0;
 
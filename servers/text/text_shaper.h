@@ -38,6 +38,15 @@
 
 #include "text_types.h"
 
+// One independent text to shape, see TextShaper::shape_texts.
+struct ShapeRequest {
+	const char32_t *text = NULL;
+	int char_count = 0;
+	CharInfo *char_infos = NULL;
+	ShapedGlyphBuffer glyphs;
+	bool shaped = false;
+};
+
 class TextShaper {
 	static TextShaper *singleton;
 
@@ -49,7 +58,11 @@ public:
 
 	virtual const char *get_name() const = 0;
 
-	virtual bool shape_text(CharInfo *r_char_infos, const FontID &p_font_id, const Vector<FontID> &p_fallback_font_ids, const char32_t *p_text, int p_char_count, int p_font_size, int p_font_oversampling) = 0;
+	virtual bool shape_text(CharInfo *r_char_infos, ShapedGlyphBuffer &r_glyphs, const FontID &p_font_id, const Vector<FontID> &p_fallback_font_ids, const char32_t *p_text, int p_char_count, int p_font_size, int p_font_oversampling) = 0;
+
+	// Shapes many texts with the same font setup. Shapers may spread the
+	// requests over worker threads, the default shapes them one by one.
+	virtual void shape_texts(ShapeRequest *r_requests, int p_request_count, const FontID &p_font_id, const Vector<FontID> &p_fallback_font_ids, int p_font_size, int p_font_oversampling);
 
 	TextShaper() {}
 	virtual ~TextShaper() {}
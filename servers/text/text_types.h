@@ -40,22 +40,131 @@
 #include "core/vector.h"
 #include "servers/font_server.h"
 
-struct ShapedData {
-	FontID glyph_font_id;
-
-	uint32_t glyph_index;
-	Vector2 glyph_offset;
-	Vector2 glyph_advance;
-
-	int cluster_glyph_count;
-	int cluster_glyph_index;
-
-	ShapedData() :
-			glyph_index(0),
-			glyph_offset(0, 0),
-			glyph_advance(0, 0),
-			cluster_glyph_count(0),
-			cluster_glyph_index(-1) {}
+// Shaped glyphs of a whole line, stored as parallel arrays inside a single
+// copy-on-write block. CharInfo only keeps an index into it, so copying
+// char infos or text lines never allocates per glyph.
+class ShapedGlyphBuffer {
+	Vector<uint8_t> data;
+	int count = 0;
+	int capacity = 0;
+
+	// Arrays are laid out by decreasing alignment, each one `capacity` long.
+	_FORCE_INLINE_ static int _offsets_ofs(int p_capacity) { return 0; }
+	_FORCE_INLINE_ static int _advances_ofs(int p_capacity) { return p_capacity * sizeof(Vector2); }
+	_FORCE_INLINE_ static int _font_ids_ofs(int p_capacity) { return p_capacity * sizeof(Vector2) * 2; }
+	_FORCE_INLINE_ static int _indices_ofs(int p_capacity) { return _font_ids_ofs(p_capacity) + p_capacity * sizeof(FontID); }
+	_FORCE_INLINE_ static int _cluster_counts_ofs(int p_capacity) { return _indices_ofs(p_capacity) + p_capacity * sizeof(uint32_t); }
+	_FORCE_INLINE_ static int _cluster_indices_ofs(int p_capacity) { return _cluster_counts_ofs(p_capacity) + p_capacity * sizeof(uint16_t); }
+	_FORCE_INLINE_ static int _block_size(int p_capacity) { return _cluster_indices_ofs(p_capacity) + p_capacity * sizeof(uint16_t); }
+
+	template <class T>
+	_FORCE_INLINE_ const T *_array(int p_ofs) const { return reinterpret_cast<const T *>(data.ptr() + p_ofs); }
+	template <class T>
+	_FORCE_INLINE_ T *_array_w(int p_ofs) { return reinterpret_cast<T *>(data.ptrw() + p_ofs); }
+
+public:
+	_FORCE_INLINE_ int size() const { return count; }
+	_FORCE_INLINE_ bool empty() const { return count == 0; }
+	_FORCE_INLINE_ int get_capacity() const { return capacity; }
+
+	void reserve(int p_capacity) {
+		if (p_capacity <= capacity) {
+			return;
+		}
+
+		Vector<uint8_t> new_data;
+		new_data.resize(_block_size(p_capacity));
+
+		if (count > 0) {
+			const uint8_t *src = data.ptr();
+			uint8_t *dst = new_data.ptrw();
+
+			copymem(dst + _offsets_ofs(p_capacity), src + _offsets_ofs(capacity), count * sizeof(Vector2));
+			copymem(dst + _advances_ofs(p_capacity), src + _advances_ofs(capacity), count * sizeof(Vector2));
+			copymem(dst + _font_ids_ofs(p_capacity), src + _font_ids_ofs(capacity), count * sizeof(FontID));
+			copymem(dst + _indices_ofs(p_capacity), src + _indices_ofs(capacity), count * sizeof(uint32_t));
+			copymem(dst + _cluster_counts_ofs(p_capacity), src + _cluster_counts_ofs(capacity), count * sizeof(uint16_t));
+			copymem(dst + _cluster_indices_ofs(p_capacity), src + _cluster_indices_ofs(capacity), count * sizeof(uint16_t));
+		}
+
+		data = new_data;
+		capacity = p_capacity;
+	}
+
+	_FORCE_INLINE_ void clear() {
+		count = 0;
+	}
+
+	int push_back(const FontID &p_font_id, uint32_t p_index, const Vector2 &p_offset, const Vector2 &p_advance, int p_cluster_glyph_count, int p_cluster_glyph_index) {
+		if (count == capacity) {
+			reserve(capacity > 0 ? capacity * 2 : 8);
+		}
+
+		_array_w<Vector2>(_offsets_ofs(capacity))[count] = p_offset;
+		_array_w<Vector2>(_advances_ofs(capacity))[count] = p_advance;
+		_array_w<FontID>(_font_ids_ofs(capacity))[count] = p_font_id;
+		_array_w<uint32_t>(_indices_ofs(capacity))[count] = p_index;
+		_array_w<uint16_t>(_cluster_counts_ofs(capacity))[count] = p_cluster_glyph_count;
+		_array_w<uint16_t>(_cluster_indices_ofs(capacity))[count] = p_cluster_glyph_index;
+
+		return count++;
+	}
+
+	// Appends `p_count` glyphs of `p_other` starting at `p_from`, returns the index of the first one.
+	int append(const ShapedGlyphBuffer &p_other, int p_from, int p_count) {
+		ERR_FAIL_COND_V(p_from < 0 || p_count < 0 || p_from + p_count > p_other.count, count);
+
+		int base = count;
+		if (p_count == 0) {
+			return base;
+		}
+
+		if (count + p_count > capacity) {
+			reserve(MAX(count + p_count, capacity * 2));
+		}
+
+		const uint8_t *src = p_other.data.ptr();
+		uint8_t *dst = data.ptrw();
+
+		copymem(dst + _offsets_ofs(capacity) + base * sizeof(Vector2), src + _offsets_ofs(p_other.capacity) + p_from * sizeof(Vector2), p_count * sizeof(Vector2));
+		copymem(dst + _advances_ofs(capacity) + base * sizeof(Vector2), src + _advances_ofs(p_other.capacity) + p_from * sizeof(Vector2), p_count * sizeof(Vector2));
+		copymem(dst + _font_ids_ofs(capacity) + base * sizeof(FontID), src + _font_ids_ofs(p_other.capacity) + p_from * sizeof(FontID), p_count * sizeof(FontID));
+		copymem(dst + _indices_ofs(capacity) + base * sizeof(uint32_t), src + _indices_ofs(p_other.capacity) + p_from * sizeof(uint32_t), p_count * sizeof(uint32_t));
+		copymem(dst + _cluster_counts_ofs(capacity) + base * sizeof(uint16_t), src + _cluster_counts_ofs(p_other.capacity) + p_from * sizeof(uint16_t), p_count * sizeof(uint16_t));
+		copymem(dst + _cluster_indices_ofs(capacity) + base * sizeof(uint16_t), src + _cluster_indices_ofs(p_other.capacity) + p_from * sizeof(uint16_t), p_count * sizeof(uint16_t));
+
+		count += p_count;
+		return base;
+	}
+
+	_FORCE_INLINE_ int append(const ShapedGlyphBuffer &p_other) {
+		return append(p_other, 0, p_other.count);
+	}
+
+	_FORCE_INLINE_ Vector2 get_offset(int p_glyph) const {
+		ERR_FAIL_INDEX_V(p_glyph, count, Vector2());
+		return _array<Vector2>(_offsets_ofs(capacity))[p_glyph];
+	}
+
+	_FORCE_INLINE_ Vector2 get_advance(int p_glyph) const {
+		ERR_FAIL_INDEX_V(p_glyph, count, Vector2());
+		return _array<Vector2>(_advances_ofs(capacity))[p_glyph];
+	}
+
+	_FORCE_INLINE_ FontID get_font_id(int p_glyph) const {
+		ERR_FAIL_INDEX_V(p_glyph, count, FontID());
+		return _array<FontID>(_font_ids_ofs(capacity))[p_glyph];
+	}
+
+	_FORCE_INLINE_ uint32_t get_index(int p_glyph) const {
+		ERR_FAIL_INDEX_V(p_glyph, count, 0);
+		return _array<uint32_t>(_indices_ofs(capacity))[p_glyph];
+	}
+
+	_FORCE_INLINE_ bool is_cluster_end(int p_glyph) const {
+		ERR_FAIL_INDEX_V(p_glyph, count, true);
+		return (_array<uint16_t>(_cluster_indices_ofs(capacity))[p_glyph] + 1 == _array<uint16_t>(_cluster_counts_ofs(capacity))[p_glyph]);
+	}
 };
 
 struct CharInfo {
@@ -68,7 +177,7 @@ struct CharInfo {
 private:
 	Type type;
 	char32_t char_code;
-	ShapedData *shaped;
+	int glyph;
 
 public:
 	_FORCE_INLINE_ Type get_type() const {
@@ -87,66 +196,20 @@ public:
 		char_code = p_char_code;
 	}
 
-	_FORCE_INLINE_ bool is_cluster_end() const {
-		return (shaped->cluster_glyph_index + 1 == shaped->cluster_glyph_count);
-	}
-
-	_FORCE_INLINE_ FontID get_glyph_font_id() const {
-		ERR_FAIL_COND_V(!shaped, FontID());
-		return shaped->glyph_font_id;
-	}
-
-	_FORCE_INLINE_ uint32_t get_glyph_index() const {
-		ERR_FAIL_COND_V(!shaped, 0);
-		return shaped->glyph_index;
-	}
-
-	_FORCE_INLINE_ Vector2 get_glyph_offset() const {
-		ERR_FAIL_COND_V(!shaped, Vector2());
-		return shaped->glyph_offset;
+	// Index into the ShapedGlyphBuffer of the owning line, -1 if not shaped.
+	_FORCE_INLINE_ int get_glyph() const {
+		return glyph;
 	}
 
-	_FORCE_INLINE_ Vector2 get_glyph_advance() const {
-		ERR_FAIL_COND_V(!shaped, Vector2());
-		return shaped->glyph_advance;
-	}
-
-	_FORCE_INLINE_ void set_shaped_data(ShapedData *p_shaped_data) {
-		if (shaped) {
-			memdelete(shaped);
-		}
+	_FORCE_INLINE_ void set_glyph(int p_glyph) {
 		type = SHAPED;
-		shaped = p_shaped_data;
+		glyph = p_glyph;
 	}
 
 	CharInfo() :
 			type(INVISIBLE),
 			char_code(0),
-			shaped(NULL) {}
-
-	CharInfo &operator=(const CharInfo &p_other) {
-		if (this == &p_other) {
-			return *this;
-		}
-
-		type = p_other.type;
-		char_code = p_other.char_code;
-
-		if (shaped) {
-			memdelete(shaped);
-		}
-		if (p_other.shaped) {
-			shaped = memnew(ShapedData(*p_other.shaped));
-		}
-
-		return *this;
-	}
-
-	~CharInfo() {
-		if (shaped) {
-			memdelete(shaped);
-		}
-	}
+			glyph(-1) {}
 };
 
 struct TextLine : Reference {
@@ -165,6 +228,7 @@ struct TextLine : Reference {
 	uint64_t cache_header = 0;
 
 	Vector<CharInfo> char_infos;
+	ShapedGlyphBuffer glyphs;
 };
 
 #endif
@@ -690,6 +690,7 @@ public:
 				TYPE_CIRCLE,
 				TYPE_TRANSFORM,
 				TYPE_CLIP_IGNORE,
+				TYPE_GLYPH_RUN,
 			};
 
 			Type type;
@@ -823,6 +824,18 @@ public:
 			}
 		};
 
+		struct CommandGlyphRun : public Command {
+			RID texture;
+			Vector<Rect2> rects;
+			Vector<Rect2> sources;
+			Vector<Color> colors;
+			bool distance_field;
+			CommandGlyphRun() {
+				type = TYPE_GLYPH_RUN;
+				distance_field = false;
+			}
+		};
+
 		struct ViewportRender {
 			VisualServer *owner;
 			void *udata;
@@ -1021,6 +1034,15 @@ public:
 
 					case Item::Command::TYPE_CLIP_IGNORE: {
 					} break;
+					case Item::Command::TYPE_GLYPH_RUN: {
+						const Item::CommandGlyphRun *run = static_cast<const Item::CommandGlyphRun *>(c);
+						int l = run->rects.size();
+						const Rect2 *rp = run->rects.ptr();
+						r = rp[0];
+						for (int j = 1; j < l; j++) {
+							r = r.merge(rp[j]);
+						}
+					} break;
 				}
 
 				if (found_xform) {
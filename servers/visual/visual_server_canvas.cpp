@@ -663,6 +663,25 @@ void VisualServerCanvas::canvas_item_add_texture_rect_region(RID p_item, const R
 	canvas_item->commands.push_back(rect);
 }
 
+void VisualServerCanvas::canvas_item_add_glyph_run(RID p_item, RID p_texture, const Vector<Rect2> &p_rects, const Vector<Rect2> &p_src_rects, const Vector<Color> &p_colors, bool p_distance_field) {
+	Item *canvas_item = canvas_item_owner.getornull(p_item);
+	ERR_FAIL_COND(!canvas_item);
+	ERR_FAIL_COND(p_rects.empty());
+	ERR_FAIL_COND(p_src_rects.size() != p_rects.size());
+	ERR_FAIL_COND(p_colors.size() != p_rects.size());
+
+	Item::CommandGlyphRun *run = memnew(Item::CommandGlyphRun);
+	ERR_FAIL_COND(!run);
+	run->texture = p_texture;
+	run->rects = p_rects;
+	run->sources = p_src_rects;
+	run->colors = p_colors;
+	run->distance_field = p_distance_field;
+	canvas_item->rect_dirty = true;
+
+	canvas_item->commands.push_back(run);
+}
+
 void VisualServerCanvas::canvas_item_add_nine_patch(RID p_item, const Rect2 &p_rect, const Rect2 &p_source, RID p_texture, const Vector2 &p_topleft, const Vector2 &p_bottomright, VS::NinePatchAxisMode p_x_axis_mode, VS::NinePatchAxisMode p_y_axis_mode, bool p_draw_center, const Color &p_modulate, RID p_normal_map) {
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
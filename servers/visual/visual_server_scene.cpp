@@ -415,9 +415,7 @@ void VisualServerScene::_instance_queue_update(Instance *p_instance, bool p_upda
 }
 
 RID VisualServerScene::instance_create() {
-	Instance *instance = memnew(Instance);
-	ERR_FAIL_COND_V(!instance, RID());
-
+	Instance *instance = instance_owner.alloc();
 	RID instance_rid = instance_owner.make_rid(instance);
 	instance->self = instance_rid;
 
@@ -3362,8 +3360,6 @@ bool VisualServerScene::free(RID p_rid) {
 
 		update_dirty_instances();
 
-		Instance *instance = instance_owner.get(p_rid);
-
 		instance_set_use_lightmap(p_rid, RID(), RID(), -1, Rect2(0, 0, 1, 1));
 		instance_set_scenario(p_rid, RID());
 		instance_set_base(p_rid, RID());
@@ -3373,7 +3369,6 @@ bool VisualServerScene::free(RID p_rid) {
 		update_dirty_instances(); //in case something changed this
 
 		instance_owner.free(p_rid);
-		memdelete(instance);
 	} else {
 		return false;
 	}
@@ -491,7 +491,7 @@ public:
 	RID reflection_probe_instance_cull_result[MAX_REFLECTION_PROBES_CULLED];
 	int reflection_probe_cull_count;
 
-	RID_Owner<Instance> instance_owner;
+	RID_Alloc<Instance> instance_owner;
 
 	virtual RID instance_create();
 
@@ -85,6 +85,7 @@ void VisualServerWrapMT::sync() {
 void VisualServerWrapMT::draw(bool p_swap_buffers, double frame_step) {
 	if (create_thread) {
 		draw_pending.increment();
+		command_queue.commit_stagings();
 		command_queue.push(this, &VisualServerWrapMT::thread_draw, p_swap_buffers, frame_step);
 	} else {
 		visual_server->draw(p_swap_buffers, frame_step);
@@ -109,6 +110,9 @@ void VisualServerWrapMT::init() {
 }
 
 void VisualServerWrapMT::finish() {
+	CommandQueueMT::Stats stats = command_queue.get_stats();
+	print_verbose("VisualServerWrapMT: " + itos(stats.commands) + " commands queued, peak depth " + itos(stats.max_depth) + ", producers stalled " + itos(stats.stall_usec / 1000) + " msec.");
+
 	if (create_thread) {
 		command_queue.push(this, &VisualServerWrapMT::thread_exit);
 		thread.wait_to_finish();
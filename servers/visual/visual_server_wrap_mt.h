@@ -508,6 +508,7 @@ public:
 	FUNC4(canvas_item_add_circle, RID, const Point2 &, float, const Color &)
 	FUNC7(canvas_item_add_texture_rect, RID, const Rect2 &, RID, bool, const Color &, bool, RID)
 	FUNC8(canvas_item_add_texture_rect_region, RID, const Rect2 &, RID, const Rect2 &, const Color &, bool, RID, bool)
+	FUNC6(canvas_item_add_glyph_run, RID, RID, const Vector<Rect2> &, const Vector<Rect2> &, const Vector<Color> &, bool)
 	FUNC11(canvas_item_add_nine_patch, RID, const Rect2 &, const Rect2 &, RID, const Vector2 &, const Vector2 &, NinePatchAxisMode, NinePatchAxisMode, bool, const Color &, RID)
 	FUNC7(canvas_item_add_primitive, RID, const Vector<Point2> &, const Vector<Color> &, const Vector<Point2> &, RID, float, RID)
 	FUNC7(canvas_item_add_polygon, RID, const Vector<Point2> &, const Vector<Color> &, const Vector<Point2> &, RID, RID, bool)
@@ -597,6 +598,8 @@ public:
 		return visual_server->get_render_info(p_info);
 	}
 
+	CommandQueueMT::Stats get_command_queue_stats() { return command_queue.get_stats(); }
+
 	virtual String get_video_adapter_name() const {
 		return visual_server->get_video_adapter_name();
 	}
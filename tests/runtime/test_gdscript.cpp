@@ -38,6 +38,7 @@
 #ifdef MODULE_GDSCRIPT_ENABLED
 
 #include "modules/gdscript/gdscript.h"
+#include "modules/gdscript/gdscript_bytecode.h"
 #include "modules/gdscript/gdscript_compiler.h"
 #include "modules/gdscript/gdscript_parser.h"
 #include "modules/gdscript/gdscript_tokenizer.h"
@@ -514,9 +515,11 @@ static void _disassemble_class(const Ref<GDScript> &p_class, const Vector<String
 			String txt = itos(ip) + " ";
 
 			switch (code[ip]) {
-				case GDScriptFunction::OPCODE_OPERATOR: {
-					int op = code[ip + 1];
-					txt += " op ";
+				case GDScriptFunction::OPCODE_OPERATOR:
+				case GDScriptFunction::OPCODE_OPERATOR_VALIDATED: {
+					bool validated = code[ip] == GDScriptFunction::OPCODE_OPERATOR_VALIDATED;
+					int op = validated ? func.get_validated_operator(code[ip + 1]) : code[ip + 1];
+					txt += validated ? " op-validated " : " op ";
 
 					String opname = Variant::get_operator_name(Variant::Operator(op));
 
@@ -549,23 +552,27 @@ static void _disassemble_class(const Ref<GDScript> &p_class, const Vector<String
 					incr += 4;
 
 				} break;
-				case GDScriptFunction::OPCODE_SET_NAMED: {
-					txt += " set_named ";
+				case GDScriptFunction::OPCODE_SET_NAMED:
+				case GDScriptFunction::OPCODE_SET_NAMED_VALIDATED: {
+					bool validated = code[ip] == GDScriptFunction::OPCODE_SET_NAMED_VALIDATED;
+					txt += validated ? " set_named-validated " : " set_named ";
 					txt += DADDR(1);
 					txt += "[\"";
-					txt += func.get_global_name(code[ip + 2]);
+					txt += validated ? func.get_validated_member_name(code[ip + 2]) : func.get_global_name(code[ip + 2]);
 					txt += "\"]=";
 					txt += DADDR(3);
 					incr += 4;
 
 				} break;
-				case GDScriptFunction::OPCODE_GET_NAMED: {
-					txt += " get_named ";
+				case GDScriptFunction::OPCODE_GET_NAMED:
+				case GDScriptFunction::OPCODE_GET_NAMED_VALIDATED: {
+					bool validated = code[ip] == GDScriptFunction::OPCODE_GET_NAMED_VALIDATED;
+					txt += validated ? " get_named-validated " : " get_named ";
 					txt += DADDR(3);
 					txt += "=";
 					txt += DADDR(1);
 					txt += "[\"";
-					txt += func.get_global_name(code[ip + 2]);
+					txt += validated ? func.get_validated_member_name(code[ip + 2]) : func.get_inline_cache_name(code[ip + 2]);
 					txt += "\"]";
 					incr += 4;
 
@@ -701,13 +708,18 @@ static void _disassemble_class(const Ref<GDScript> &p_class, const Vector<String
 				} break;
 
 				case GDScriptFunction::OPCODE_CALL:
-				case GDScriptFunction::OPCODE_CALL_RETURN: {
-					bool ret = code[ip] == GDScriptFunction::OPCODE_CALL_RETURN;
+				case GDScriptFunction::OPCODE_CALL_RETURN:
+				case GDScriptFunction::OPCODE_CALL_VALIDATED:
+				case GDScriptFunction::OPCODE_CALL_RETURN_VALIDATED: {
+					bool ret = code[ip] == GDScriptFunction::OPCODE_CALL_RETURN || code[ip] == GDScriptFunction::OPCODE_CALL_RETURN_VALIDATED;
+					bool validated = code[ip] == GDScriptFunction::OPCODE_CALL_VALIDATED || code[ip] == GDScriptFunction::OPCODE_CALL_RETURN_VALIDATED;
 
 					if (ret)
 						txt += " call-ret ";
 					else
 						txt += " call ";
+					if (validated)
+						txt += "validated ";
 
 					int argc = code[ip + 1];
 					if (ret) {
@@ -715,7 +727,7 @@ static void _disassemble_class(const Ref<GDScript> &p_class, const Vector<String
 					}
 
 					txt += DADDR(2) + ".";
-					txt += String(func.get_global_name(code[ip + 3]));
+					txt += String(validated ? func.get_validated_call_name(code[ip + 3]) : func.get_inline_cache_name(code[ip + 3]));
 					txt += "(";
 
 					for (int i = 0; i < argc; i++) {
@@ -858,7 +870,196 @@ static void _disassemble_class(const Ref<GDScript> &p_class, const Vector<String
 	}
 }
 
+// Every *_typed function is compiled with specialized opcodes, its *_generic twin only with the generic ones.
+// fallback_typed relies on max() being inferred as float while it returns int for int arguments.
+static const char *_validated_code =
+		"static func int_real_typed(a: int, b: float):\n"
+		"\treturn [a + b, a - b, a * b, b + a, b - a, b * a, a < b, a <= b, b > a, b >= a, a == b, a != b, -a, -b, a & 6, ~a]\n"
+		"\n"
+		"static func int_real_generic(a, b):\n"
+		"\treturn [a + b, a - b, a * b, b + a, b - a, b * a, a < b, a <= b, b > a, b >= a, a == b, a != b, -a, -b, a & 6, ~a]\n"
+		"\n"
+		"static func in_place_typed(a: int, b: float):\n"
+		"\tvar i: int = 0\n"
+		"\tvar total: float = 0.0\n"
+		"\tvar count: int = 0\n"
+		"\tvar slot = \"text\"\n"
+		"\twhile i < a:\n"
+		"\t\ttotal = total + b * i\n"
+		"\t\tcount = count + i\n"
+		"\t\ti += 1\n"
+		"\tslot = count * 2\n"
+		"\tvar first = slot\n"
+		"\tslot = total * 0.5\n"
+		"\tvar v := Vector2(b, a)\n"
+		"\tv = v * 2\n"
+		"\tv = v + v\n"
+		"\tv = -v\n"
+		"\treturn [total, count, i, first, slot, v]\n"
+		"\n"
+		"static func in_place_generic(a, b):\n"
+		"\tvar i = 0\n"
+		"\tvar total = 0.0\n"
+		"\tvar count = 0\n"
+		"\tvar slot = \"text\"\n"
+		"\twhile i < a:\n"
+		"\t\ttotal = total + b * i\n"
+		"\t\tcount = count + i\n"
+		"\t\ti += 1\n"
+		"\tslot = count * 2\n"
+		"\tvar first = slot\n"
+		"\tslot = total * 0.5\n"
+		"\tvar v = Vector2(b, a)\n"
+		"\tv = v * 2\n"
+		"\tv = v + v\n"
+		"\tv = -v\n"
+		"\treturn [total, count, i, first, slot, v]\n"
+		"\n"
+		"static func chain_typed(a: int, b: float):\n"
+		"\tvar r := Rect2()\n"
+		"\tr.position.x = b\n"
+		"\tr.position.y = a\n"
+		"\tr.size.y = r.position.x * 2\n"
+		"\tvar t := Transform()\n"
+		"\tt.origin.z = b\n"
+		"\tt.origin.x += a\n"
+		"\tt.basis.x.y = b\n"
+		"\tvar p := Plane()\n"
+		"\tp.normal.y = a\n"
+		"\tp.d = b\n"
+		"\tvar c := Color(0, 0, 0)\n"
+		"\tc.r = a\n"
+		"\tc.g = b\n"
+		"\tvar q := Quat()\n"
+		"\tq.w = a\n"
+		"\treturn [r, t, p, c, q, r.size.y, t.origin.x, c.r]\n"
+		"\n"
+		"static func chain_generic(a, b):\n"
+		"\tvar r = Rect2()\n"
+		"\tr.position.x = b\n"
+		"\tr.position.y = a\n"
+		"\tr.size.y = r.position.x * 2\n"
+		"\tvar t = Transform()\n"
+		"\tt.origin.z = b\n"
+		"\tt.origin.x += a\n"
+		"\tt.basis.x.y = b\n"
+		"\tvar p = Plane()\n"
+		"\tp.normal.y = a\n"
+		"\tp.d = b\n"
+		"\tvar c = Color(0, 0, 0)\n"
+		"\tc.r = a\n"
+		"\tc.g = b\n"
+		"\tvar q = Quat()\n"
+		"\tq.w = a\n"
+		"\treturn [r, t, p, c, q, r.size.y, t.origin.x, c.r]\n"
+		"\n"
+		"static func fallback_typed(a, b):\n"
+		"\tvar v := Vector2(1, 2)\n"
+		"\treturn [max(a, b) + 1.5, max(a, b) * 2, -max(a, b), max(a, b) < 5, max(a, b) * v]\n"
+		"\n"
+		"static func fallback_generic(a, b):\n"
+		"\tvar m = max(a, b)\n"
+		"\tvar v = Vector2(1, 2)\n"
+		"\treturn [m + 1.5, m * 2, -m, m < 5, m * v]\n";
+
+struct ValidatedCase {
+	const char *name;
+	Variant a;
+	Variant b;
+};
+
+// Same type and same value, element by element for arrays.
+static bool _same_result(const Variant &p_a, const Variant &p_b) {
+	if (p_a.get_type() != p_b.get_type()) {
+		return false;
+	}
+
+	if (p_a.get_type() == Variant::ARRAY) {
+		Array a = p_a;
+		Array b = p_b;
+		if (a.size() != b.size()) {
+			return false;
+		}
+		for (int i = 0; i < a.size(); i++) {
+			if (!_same_result(a[i], b[i])) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	return p_a == p_b;
+}
+
+static int _count_validated(const GDScriptFunction *p_func) {
+	return p_func->get_validated_operator_count() + p_func->get_validated_member_count();
+}
+
+static void _test_validated() {
+	Ref<GDScript> script;
+	script.instance();
+	script->set_source_code(_validated_code);
+	if (script->reload() != OK) {
+		print_line("Validated opcode script failed to compile.");
+		return;
+	}
+
+	const ValidatedCase cases[] = {
+		{ "int_real", 3, 2.5 },
+		{ "int_real", -7, 0.25 },
+		{ "int_real", 4, 4.0 },
+		{ "in_place", 10, 0.5 },
+		{ "in_place", 0, -1.0 },
+		{ "chain", 3, 1.5 },
+		{ "chain", -2, -0.75 },
+		{ "fallback", 3, 8 },
+		{ "fallback", 2.5, 1.0 },
+		{ "fallback", 2, 1.5 },
+	};
+	const int case_count = sizeof(cases) / sizeof(cases[0]);
+
+	const Map<StringName, GDScriptFunction *> &funcs = script->get_member_functions();
+
+	int passed = 0;
+	for (int i = 0; i < case_count; i++) {
+		const ValidatedCase &c = cases[i];
+		StringName typed_name = String(c.name) + "_typed";
+		StringName generic_name = String(c.name) + "_generic";
+
+		String label = String(c.name) + "(" + String(c.a) + ", " + String(c.b) + ")";
+
+		if (!funcs.has(typed_name) || !funcs.has(generic_name)) {
+			print_line(label + ": missing function");
+			continue;
+		}
+		// Without specializations on one side and none on the other, nothing would be compared.
+		if (_count_validated(funcs[typed_name]) == 0 || _count_validated(funcs[generic_name]) != 0) {
+			print_line(label + ": unexpected opcodes, typed " + itos(_count_validated(funcs[typed_name])) + " generic " + itos(_count_validated(funcs[generic_name])));
+			continue;
+		}
+
+		const Variant *args[2] = { &c.a, &c.b };
+		Variant::CallError typed_err;
+		Variant::CallError generic_err;
+		Variant typed = funcs[typed_name]->call(NULL, args, 2, typed_err);
+		Variant generic = funcs[generic_name]->call(NULL, args, 2, generic_err);
+
+		bool ok = typed_err.error == Variant::CallError::CALL_OK && generic_err.error == Variant::CallError::CALL_OK && _same_result(typed, generic);
+		if (ok) {
+			passed++;
+		}
+		print_line(label + ": " + (ok ? "ok" : "mismatch, validated " + typed.get_construct_string() + " generic " + generic.get_construct_string()));
+	}
+
+	print_line("Passed " + itos(passed) + " of " + itos(case_count) + " validated opcode checks.");
+}
+
 MainLoop *test(TestType p_type) {
+	if (p_type == TEST_VALIDATED) {
+		_test_validated();
+		return NULL;
+	}
+
 	List<String> cmdlargs = OS::get_singleton()->get_cmdline_args();
 
 	if (cmdlargs.empty()) {
@@ -982,6 +1183,29 @@ MainLoop *test(TestType p_type) {
 	} else if (p_type == TEST_BYTECODE) {
 		Vector<uint8_t> buf2 = GDScriptTokenizerBuffer::parse_code_string(code);
 		String dst = test.get_basename() + ".gdc";
+
+		GDScriptParser parser;
+		Ref<GDScript> gds;
+		gds.instance();
+		GDScriptCompiler gdc;
+		Vector<uint8_t> image;
+		if (parser.parse(code) == OK && gdc.compile(&parser, gds.ptr()) == OK && GDScriptBytecode::save(gds.ptr(), buf2, image) == OK) {
+			buf2 = image;
+
+			// Show the code as it comes back from the image.
+			Ref<GDScript> loaded;
+			loaded.instance();
+			loaded->set_script_path(dst);
+			if (GDScriptBytecode::load(loaded.ptr(), image) == OK) {
+				print_line("** CLASS (from image) **");
+				_disassemble_class(loaded, lines);
+			} else {
+				print_line("Compiled image could not be loaded back.");
+			}
+		} else {
+			print_line("Script can't be stored compiled, writing tokens only.");
+		}
+
 		FileAccess *fw = FileAccess::open(dst, FileAccess::WRITE);
 		fw->store_buffer(buf2.ptr(), buf2.size());
 		memdelete(fw);
@@ -44,12 +44,16 @@
 #include "test_physics.h"
 #include "test_physics_2d.h"
 #include "test_render.h"
+#include "test_rid.h"
+#include "test_scene_tree.h"
 #include "test_shader_lang.h"
 #include "test_string.h"
+#include "test_string_name.h"
 
 const char **tests_get_names() {
 	static const char *test_names[] = {
 		"string",
+		"string_name",
 		"math",
 		"basis",
 		"physics",
@@ -62,8 +66,11 @@ const char **tests_get_names() {
 		"gd_parser",
 		"gd_compiler",
 		"gd_bytecode",
+		"gd_validated",
 		"ordered_hash_map",
 		"astar",
+		"rid",
+		"scene_tree",
 		NULL
 	};
 
@@ -75,6 +82,10 @@ MainLoop *test_main(String p_test, const List<String> &p_args) {
 		return TestString::test();
 	}
 
+	if (p_test == "string_name") {
+		return TestStringName::test();
+	}
+
 	if (p_test == "math") {
 		return TestMath::test();
 	}
@@ -125,6 +136,10 @@ MainLoop *test_main(String p_test, const List<String> &p_args) {
 		return TestGDScript::test(TestGDScript::TEST_BYTECODE);
 	}
 
+	if (p_test == "gd_validated") {
+		return TestGDScript::test(TestGDScript::TEST_VALIDATED);
+	}
+
 	if (p_test == "ordered_hash_map") {
 		return TestOrderedHashMap::test();
 	}
@@ -133,6 +148,14 @@ MainLoop *test_main(String p_test, const List<String> &p_args) {
 		return TestAStar::test();
 	}
 
+	if (p_test == "rid") {
+		return TestRID::test();
+	}
+
+	if (p_test == "scene_tree") {
+		return TestSceneTree::test();
+	}
+
 	print_line("Unknown test: " + p_test);
 	return NULL;
 }
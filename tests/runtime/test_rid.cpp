@@ -0,0 +1,192 @@
+/*************************************************************************/
+/*  test_rid.cpp                                                         */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-present Godot Engine contributors (cf. AUTHORS.md).*/
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "test_rid.h"
+
+#include "core/os/os.h"
+#include "core/rid.h"
+
+namespace TestRID {
+
+struct Item : public RID_Data {
+	int value;
+	Item() { value = 0; }
+};
+
+static bool test_validation() {
+	RID_Alloc<Item> alloc;
+	RID_Alloc<Item> other;
+
+	Vector<RID> rids;
+	for (int i = 0; i < 5000; i++) {
+		Item *item = alloc.alloc();
+		item->value = i;
+		rids.push_back(alloc.make_rid(item));
+	}
+
+	bool ok = alloc.get_rid_count() == 5000;
+	for (int i = 0; i < rids.size(); i++) {
+		ok = ok && alloc.owns(rids[i]) && alloc.get(rids[i])->value == i;
+		ok = ok && !other.owns(rids[i]);
+	}
+	ok = ok && !alloc.owns(RID());
+
+	for (int i = 0; i < rids.size(); i++) {
+		alloc.free(rids[i]);
+	}
+	ok = ok && alloc.get_rid_count() == 0;
+
+	OS::get_singleton()->print("	validation: %s\n", ok ? "ok" : "mismatch");
+	return ok;
+}
+
+static bool test_stale_rid() {
+	RID_Alloc<Item> alloc;
+
+	// Fill the first chunk, so the only free slot after the free is the one just released.
+	Vector<RID> rids;
+	rids.push_back(alloc.make_rid(alloc.alloc()));
+	while (rids.size() < (int)alloc.get_slot_count()) {
+		rids.push_back(alloc.make_rid(alloc.alloc()));
+	}
+
+	RID first = rids[0];
+	Item *first_ptr = alloc.get(first);
+	alloc.free(first);
+	bool ok = !alloc.owns(first);
+
+	RID second = alloc.make_rid(alloc.alloc());
+	bool reused = alloc.get(second) == first_ptr;
+	ok = ok && reused && alloc.owns(second) && first != second && !alloc.owns(first);
+
+	alloc.free(second);
+	for (int i = 1; i < rids.size(); i++) {
+		alloc.free(rids[i]);
+	}
+
+	OS::get_singleton()->print("	stale rid: slot reused %s, %s\n", reused ? "yes" : "no", !alloc.owns(first) && ok ? "rejected" : "accepted");
+	return ok;
+}
+
+static bool test_foreign_rid() {
+	RID_Alloc<Item> alloc;
+	RID_Owner<Item> owner;
+
+	// Neither owner may look past the owner tag of a RID it didn't make.
+	Item *owned_item = memnew(Item);
+	RID owned = owner.make_rid(owned_item);
+	RID allocated = alloc.make_rid(alloc.alloc());
+
+	bool ok = !alloc.owns(owned) && !owner.owns(allocated);
+	ok = ok && alloc.owns(allocated) && owner.owns(owned);
+
+	owner.free(owned);
+	memdelete(owned_item);
+	alloc.free(allocated);
+
+	OS::get_singleton()->print("	foreign rid: %s\n", ok ? "rejected" : "accepted");
+	return ok;
+}
+
+static bool test_dense_iteration() {
+	RID_Alloc<Item> alloc;
+
+	Vector<RID> rids;
+	for (int i = 0; i < 3000; i++) {
+		Item *item = alloc.alloc();
+		item->value = i;
+		rids.push_back(alloc.make_rid(item));
+	}
+	for (int i = 0; i < rids.size(); i += 3) {
+		alloc.free(rids[i]);
+	}
+
+	int alive = 0;
+	int64_t sum = 0;
+	for (uint32_t i = 0; i < alloc.get_slot_count(); i++) {
+		Item *item = alloc.get_slot(i);
+		if (item) {
+			alive++;
+			sum += item->value;
+		}
+	}
+
+	int64_t expected = 0;
+	for (int i = 0; i < rids.size(); i++) {
+		if (i % 3) {
+			expected += i;
+		}
+	}
+
+	List<RID> owned;
+	alloc.get_owned_list(&owned);
+
+	bool ok = alive == 2000 && sum == expected && owned.size() == 2000 && alloc.get_rid_count() == 2000;
+	OS::get_singleton()->print("	dense iteration: %d alive over %d slots\n", alive, alloc.get_slot_count());
+	return ok;
+}
+
+typedef bool (*TestFunc)(void);
+
+TestFunc test_funcs[] = {
+
+	test_validation,
+	test_stale_rid,
+	test_foreign_rid,
+	test_dense_iteration,
+	0
+
+};
+
+MainLoop *test() {
+	int count = 0;
+	int passed = 0;
+
+	while (true) {
+		if (!test_funcs[count])
+			break;
+		bool pass = test_funcs[count]();
+		if (pass)
+			passed++;
+		OS::get_singleton()->print("\t%s\n", pass ? "PASS" : "FAILED");
+
+		count++;
+	}
+
+	OS::get_singleton()->print("\n\n\n");
+	OS::get_singleton()->print("*************\n");
+	OS::get_singleton()->print("***TOTALS!***\n");
+	OS::get_singleton()->print("*************\n");
+
+	OS::get_singleton()->print("Passed %i of %i tests\n", passed, count);
+
+	return NULL;
+}
+} // namespace TestRID
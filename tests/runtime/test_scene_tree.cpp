@@ -0,0 +1,136 @@
+/*************************************************************************/
+/*  test_scene_tree.cpp                                                  */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-present Godot Engine contributors (cf. AUTHORS.md).*/
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+
+#include "test_scene_tree.h"
+
+#include "core/os/os.h"
+#include "scene/main/scene_tree.h"
+#include "scene/main/viewport.h"
+
+namespace TestSceneTree {
+
+class ProcessCounter : public Node {
+	GDCLASS(ProcessCounter, Node);
+
+public:
+	int count;
+
+	void _notification(int p_what) {
+		if (p_what == NOTIFICATION_PROCESS) {
+			count++;
+		}
+	}
+
+	ProcessCounter() { count = 0; }
+};
+
+static bool test_toggle_last_added(SceneTree *p_tree) {
+	ProcessCounter *node = memnew(ProcessCounter);
+	p_tree->get_root()->add_child(node);
+
+	// The node is the last staged entry when it is removed again.
+	node->set_process(true);
+	node->set_process(false);
+	node->set_process(true);
+	p_tree->idle(0);
+
+	bool ok = node->count == 1;
+	OS::get_singleton()->print("	toggle last added: processed %d times\n", node->count);
+
+	memdelete(node);
+	return ok;
+}
+
+static bool test_toggle_between_added(SceneTree *p_tree) {
+	ProcessCounter *nodes[3];
+	for (int i = 0; i < 3; i++) {
+		nodes[i] = memnew(ProcessCounter);
+		p_tree->get_root()->add_child(nodes[i]);
+		nodes[i]->set_process(true);
+	}
+
+	nodes[1]->set_process(false);
+	nodes[2]->set_process(false);
+	nodes[2]->set_process(true);
+	nodes[0]->set_process(false);
+	nodes[1]->set_process(true);
+	p_tree->idle(0);
+
+	bool ok = nodes[0]->count == 0 && nodes[1]->count == 1 && nodes[2]->count == 1;
+	OS::get_singleton()->print("	toggle between added: processed %d %d %d times\n", nodes[0]->count, nodes[1]->count, nodes[2]->count);
+
+	for (int i = 0; i < 3; i++) {
+		memdelete(nodes[i]);
+	}
+	return ok;
+}
+
+typedef bool (*TestFunc)(SceneTree *);
+
+TestFunc test_funcs[] = {
+
+	test_toggle_last_added,
+	test_toggle_between_added,
+	0
+
+};
+
+MainLoop *test() {
+	SceneTree *tree = memnew(SceneTree);
+	tree->init();
+
+	int count = 0;
+	int passed = 0;
+
+	while (true) {
+		if (!test_funcs[count])
+			break;
+		bool pass = test_funcs[count](tree);
+		if (pass)
+			passed++;
+		OS::get_singleton()->print("\t%s\n", pass ? "PASS" : "FAILED");
+
+		count++;
+	}
+
+	tree->finish();
+	memdelete(tree);
+
+	OS::get_singleton()->print("\n\n\n");
+	OS::get_singleton()->print("*************\n");
+	OS::get_singleton()->print("***TOTALS!***\n");
+	OS::get_singleton()->print("*************\n");
+
+	OS::get_singleton()->print("Passed %i of %i tests\n", passed, count);
+
+	return NULL;
+}
+} // namespace TestSceneTree
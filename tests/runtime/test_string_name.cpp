@@ -0,0 +1,174 @@
+/*************************************************************************/
+/*  test_string_name.cpp                                                 */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-present Godot Engine contributors (cf. AUTHORS.md).*/
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "test_string_name.h"
+
+#include "core/node_path.h"
+#include "core/os/os.h"
+#include "core/os/thread.h"
+#include "core/string_name.h"
+
+namespace TestStringName {
+
+enum {
+	NAME_COUNT = 4096,
+	ITERATIONS = 200000,
+	MAX_THREADS = 32,
+};
+
+struct StressJob {
+	const Vector<String> *names = NULL;
+	const Vector<CharString> *cnames = NULL;
+	int seed = 0;
+	int failures = 0;
+};
+
+// Interns names from a shared pool, half from String and half from C strings,
+// keeping a few alive so both the lookup and the insert/remove paths are hit.
+static void _stress_thread(void *p_userdata) {
+	StressJob *job = (StressJob *)p_userdata;
+	const String *names = job->names->ptr();
+	const CharString *cnames = job->cnames->ptr();
+
+	StringName held[16];
+	uint32_t rnd = job->seed * 2654435761u + 1;
+
+	for (int i = 0; i < ITERATIONS; i++) {
+		rnd = rnd * 1664525u + 1013904223u;
+		int idx = (rnd >> 8) % NAME_COUNT;
+
+		StringName sn = (i & 1) ? StringName(names[idx]) : StringName(cnames[idx].get_data());
+		if (sn != names[idx]) {
+			job->failures++;
+		}
+		held[i & 15] = sn;
+	}
+}
+
+static bool test_unique_across_threads() {
+	Vector<String> names;
+	Vector<CharString> cnames;
+	for (int i = 0; i < NAME_COUNT; i++) {
+		names.push_back("stress_name_" + itos(i));
+		cnames.push_back(names[i].utf8());
+	}
+
+	StressJob jobs[MAX_THREADS];
+	Thread threads[MAX_THREADS];
+
+	int failures = 0;
+
+	for (int thread_count = 1; thread_count <= MAX_THREADS; thread_count *= 2) {
+		uint64_t begin = OS::get_singleton()->get_ticks_usec();
+
+		for (int i = 0; i < thread_count; i++) {
+			jobs[i].names = &names;
+			jobs[i].cnames = &cnames;
+			jobs[i].seed = i;
+			jobs[i].failures = 0;
+			threads[i].start(_stress_thread, &jobs[i]);
+		}
+		for (int i = 0; i < thread_count; i++) {
+			threads[i].wait_to_finish();
+			failures += jobs[i].failures;
+		}
+
+		uint64_t elapsed = MAX(OS::get_singleton()->get_ticks_usec() - begin, (uint64_t)1);
+		double per_sec = double(thread_count) * ITERATIONS * 1000000.0 / elapsed;
+		OS::get_singleton()->print("\t%2d threads: %.2f M interns/s\n", thread_count, per_sec / 1000000.0);
+	}
+
+	// Every spelling must still resolve to a single entry.
+	for (int i = 0; i < NAME_COUNT; i++) {
+		StringName a = names[i];
+		StringName b = cnames[i].get_data();
+		if (a != b || StringName::search(names[i]) != a) {
+			failures++;
+		}
+	}
+
+	return failures == 0;
+}
+
+static bool test_ranges() {
+	String path = "Root/Child:property";
+	StringName child = "Child";
+	StringName named = String::utf8("n\xc3\xa4me");
+
+	bool ok = StringName(StrRange(path.ptr() + 5, 5)) == child;
+	ok = ok && StringName::search(StrRange(path.ptr() + 5, 4)) == StringName::search("Chil");
+	ok = ok && StringName(Utf8Range("Child")) == child;
+	ok = ok && StringName::search(Utf8Range("n\xc3\xa4me")) == named;
+	ok = ok && StringName::search(Utf8Range("n\xc3\xa4mex", 5)) == named;
+	ok = ok && !StringName::search(Utf8Range("n\xc3"));
+
+	NodePath node_path = path;
+	ok = ok && node_path.get_name_count() == 2 && node_path.get_name(1) == child;
+	ok = ok && node_path.get_subname_count() == 1 && node_path.get_subname(0) == "property";
+
+	OS::get_singleton()->print("\tranges: %s\n", ok ? "ok" : "mismatch");
+	return ok;
+}
+
+typedef bool (*TestFunc)(void);
+
+TestFunc test_funcs[] = {
+
+	test_unique_across_threads,
+	test_ranges,
+	0
+
+};
+
+MainLoop *test() {
+	int count = 0;
+	int passed = 0;
+
+	while (true) {
+		if (!test_funcs[count])
+			break;
+		bool pass = test_funcs[count]();
+		if (pass)
+			passed++;
+		OS::get_singleton()->print("\t%s\n", pass ? "PASS" : "FAILED");
+
+		count++;
+	}
+
+	OS::get_singleton()->print("\n\n\n");
+	OS::get_singleton()->print("*************\n");
+	OS::get_singleton()->print("***TOTALS!***\n");
+	OS::get_singleton()->print("*************\n");
+
+	OS::get_singleton()->print("Passed %i of %i tests\n", passed, count);
+
+	return NULL;
+}
+} // namespace TestStringName